@@ -68,6 +68,13 @@ static const wxChar EnableSvgImport[] = wxT( "EnableSvgImport" );
  */
 static const wxChar AllowLegacyCanvasInGtk3[] = wxT( "AllowLegacyCanvasInGtk3" );
 
+/**
+ * Directory where the interactive router saves a copy of the board and the mouse events
+ * of each routing session, to measure the router performance by replaying them.
+ * Recording is disabled when not set.
+ */
+static const wxChar PnsSessionDir[] = wxT( "PnsSessionDir" );
+
 } // namespace KEYS
 
 
@@ -186,6 +193,9 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
     configParams.push_back( new PARAM_CFG_BOOL(
             true, AC_KEYS::AllowLegacyCanvasInGtk3, &m_allowLegacyCanvasInGtk3, false ) );
 
+    configParams.push_back( new PARAM_CFG_WXSTRING(
+            true, AC_KEYS::PnsSessionDir, &m_pnsSessionDir, wxEmptyString ) );
+
     wxConfigLoadSetups( &aCfg, configParams );
 
     dumpCfg( configParams );
@@ -22,6 +22,7 @@
 #include <lib_tree_model.h>
 
 #include <algorithm>
+#include <iterator>
 #include <eda_pattern_match.h>
 #include <lib_tree_item.h>
 #include <make_unique.h>
@@ -51,6 +52,41 @@ static int matchPosScore(int aPosition, int aMaximum)
 }
 
 
+// Append the trigrams (sequences of 3 characters) of a string.  The 3 characters are
+// packed in 64 bits: a unicode code point has 21 bits.
+static void addTrigrams( const wxString& aText, std::vector<uint64_t>& aTrigrams )
+{
+    const uint64_t mask = ( (uint64_t) 1 << 63 ) - 1;
+    uint64_t       trigram = 0;
+    size_t         length = 0;
+
+    for( wxString::const_iterator it = aText.begin(); it != aText.end(); ++it )
+    {
+        trigram = ( ( trigram << 21 ) | ( wxUniChar( *it ).GetValue() & 0x1FFFFF ) ) & mask;
+
+        if( ++length >= 3 )
+            aTrigrams.push_back( trigram );
+    }
+}
+
+
+// A term can be looked for in the trigram index only if all the matchers of
+// EDA_COMBINED_MATCHER find it as a plain substring: so it cannot have any regex,
+// wildcard or relational syntax.
+static bool isPlainTerm( const wxString& aTerm )
+{
+    static const wxString specialChars = wxT( ".*+?^${}()|[]\\<>=" );
+
+    for( wxString::const_iterator it = aTerm.begin(); it != aTerm.end(); ++it )
+    {
+        if( specialChars.Find( *it ) != wxNOT_FOUND )
+            return false;
+    }
+
+    return true;
+}
+
+
 void LIB_TREE_NODE::ResetScore()
 {
     for( auto& child: Children )
@@ -60,6 +96,17 @@ void LIB_TREE_NODE::ResetScore()
 }
 
 
+void LIB_TREE_NODE::Normalize()
+{
+    if( !Normalized )
+    {
+        MatchName = MatchName.Lower();
+        SearchText = SearchText.Lower();
+        Normalized = true;
+    }
+}
+
+
 void LIB_TREE_NODE::AssignIntrinsicRanks( bool presorted )
 {
     std::vector<LIB_TREE_NODE*> sort_buf;
@@ -194,7 +241,13 @@ void LIB_TREE_NODE_LIB_ID::Update( LIB_TREE_ITEM* aItem )
 
     Desc = aItem->GetDescription();
 
-    SearchText = aItem->GetSearchText();
+    wxString searchText = aItem->GetSearchText();
+
+    // The search index of the library is built again only when a text has changed
+    if( ( Normalized ? searchText.Lower() : searchText ) != SearchText )
+        static_cast<LIB_TREE_NODE_LIB*>( Parent )->InvalidateSearchIndex();
+
+    SearchText = searchText;
     Normalized = false;
 
     IsRoot = aItem->IsRoot();
@@ -210,12 +263,7 @@ void LIB_TREE_NODE_LIB_ID::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
     if( Score <= 0 )
         return; // Leaf nodes without scores are out of the game.
 
-    if( !Normalized )
-    {
-        MatchName = MatchName.Lower();
-        SearchText = SearchText.Lower();
-        Normalized = true;
-    }
+    Normalize();
 
     // Keywords and description we only count if the match string is at
     // least two characters long. That avoids spurious, low quality
@@ -261,7 +309,8 @@ void LIB_TREE_NODE_LIB_ID::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
 
 
 LIB_TREE_NODE_LIB::LIB_TREE_NODE_LIB( LIB_TREE_NODE* aParent, wxString const& aName,
-                                      wxString const& aDesc )
+                                      wxString const& aDesc ) :
+    m_indexValid( false )
 {
     Type = LIB;
     Name = aName;
@@ -276,17 +325,125 @@ LIB_TREE_NODE_LIB_ID& LIB_TREE_NODE_LIB::AddItem( LIB_TREE_ITEM* aItem )
 {
     LIB_TREE_NODE_LIB_ID* item = new LIB_TREE_NODE_LIB_ID( this, aItem );
     Children.push_back( std::unique_ptr<LIB_TREE_NODE>( item ) );
+    m_indexValid = false;
     return *item;
 }
 
 
+void LIB_TREE_NODE_LIB::buildSearchIndex()
+{
+    std::vector<uint64_t> trigrams;
+
+    m_indexedNodes.clear();
+    m_trigramIndex.clear();
+
+    for( auto& child: Children )
+    {
+        uint32_t pos = m_indexedNodes.size();
+
+        m_indexedNodes.push_back( child.get() );
+        child->Normalize();
+
+        trigrams.clear();
+        addTrigrams( child->MatchName, trigrams );
+        addTrigrams( child->SearchText, trigrams );
+
+        std::sort( trigrams.begin(), trigrams.end() );
+        trigrams.erase( std::unique( trigrams.begin(), trigrams.end() ), trigrams.end() );
+
+        // The children are indexed in order, so each list is sorted
+        for( uint64_t trigram : trigrams )
+            m_trigramIndex[trigram].push_back( pos );
+    }
+
+    m_indexValid = true;
+}
+
+
+bool LIB_TREE_NODE_LIB::findCandidates( const wxString& aTerm, std::vector<uint32_t>& aCandidates )
+{
+    std::vector<uint64_t> trigrams;
+
+    addTrigrams( aTerm, trigrams );
+
+    // Short terms have no trigram, and the other ones may match all the children, either
+    // by the name of the library, or because they are not plain strings
+    if( trigrams.empty() || !isPlainTerm( aTerm ) || MatchName.Find( aTerm ) != wxNOT_FOUND )
+        return false;
+
+    // Children may have been removed by the adapters after the index was built
+    if( !m_indexValid || m_indexedNodes.size() != Children.size() )
+        buildSearchIndex();
+
+    std::vector<const std::vector<uint32_t>*> lists;
+
+    for( uint64_t trigram : trigrams )
+    {
+        auto it = m_trigramIndex.find( trigram );
+
+        if( it == m_trigramIndex.end() )
+        {
+            aCandidates.clear();
+            return true;
+        }
+
+        lists.push_back( &it->second );
+    }
+
+    // Start from the shortest list to keep the intersections short
+    std::sort( lists.begin(), lists.end(),
+            []( const std::vector<uint32_t>* a, const std::vector<uint32_t>* b )
+                { return a->size() < b->size(); } );
+
+    aCandidates = *lists[0];
+
+    std::vector<uint32_t> intersection;
+
+    for( size_t ii = 1; ii < lists.size() && !aCandidates.empty(); ++ii )
+    {
+        intersection.clear();
+        std::set_intersection( aCandidates.begin(), aCandidates.end(),
+                               lists[ii]->begin(), lists[ii]->end(),
+                               std::back_inserter( intersection ) );
+        aCandidates.swap( intersection );
+    }
+
+    return true;
+}
+
+
 void LIB_TREE_NODE_LIB::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
 {
     Score = 0;
 
     // We need to score leaf nodes, which are usually (but not always) children.
 
-    if( Children.size() )
+    std::vector<uint32_t> candidates;
+
+    if( Children.size() && findCandidates( aMatcher.GetPattern(), candidates ) )
+    {
+        // Only the candidates can match the term: the other children are out of the game
+        // without running the matchers
+        auto candidate = candidates.begin();
+
+        for( uint32_t pos = 0; pos < m_indexedNodes.size(); ++pos )
+        {
+            LIB_TREE_NODE* child = m_indexedNodes[pos];
+
+            if( candidate != candidates.end() && *candidate == pos )
+            {
+                child->UpdateScore( aMatcher );
+                ++candidate;
+            }
+            else if( child->Score > 0 )
+            {
+                child->Score = 0;
+            }
+
+            Score = std::max( Score, child->Score );
+        }
+    }
+    else if( Children.size() )
     {
         for( auto& child: Children )
         {
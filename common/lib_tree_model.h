@@ -22,8 +22,10 @@
 #ifndef LIB_TREE_MODEL_H
 #define LIB_TREE_MODEL_H
 
+#include <cstdint>
 #include <vector>
 #include <memory>
+#include <unordered_map>
 #include <wx/string.h>
 #include <lib_tree_item.h>
 
@@ -119,6 +121,11 @@ public:
      */
     void ResetScore();
 
+    /**
+     * Normalize MatchName and SearchText to lowercase, if not already done.
+     */
+    void Normalize();
+
     /**
      * Store intrinsic ranks on all children of this node. See IntrinsicRank
      * member doc for more information.
@@ -255,6 +262,33 @@ public:
     LIB_TREE_NODE_LIB_ID& AddItem( LIB_TREE_ITEM* aItem );
 
     virtual void UpdateScore( EDA_COMBINED_MATCHER& aMatcher ) override;
+
+    /**
+     * Mark the search index out of date, to build it again on the next search.
+     * Must be called when the name or the search text of a child changes.
+     */
+    void InvalidateSearchIndex() { m_indexValid = false; }
+
+protected:
+    /**
+     * Build the trigram index of the children: for each sequence of 3 characters found
+     * in the MatchName or SearchText of a child, the list of these children.
+     */
+    void buildSearchIndex();
+
+    /**
+     * Find the children which may match a search term, i.e. the children which have all
+     * the trigrams of the term.
+     *
+     * @param aTerm     the lowercase search term
+     * @param aCandidates   out: sorted positions of the candidates in m_indexedNodes
+     * @return false if the index cannot narrow the search for this term
+     */
+    bool findCandidates( const wxString& aTerm, std::vector<uint32_t>& aCandidates );
+
+    bool                        m_indexValid;
+    std::vector<LIB_TREE_NODE*> m_indexedNodes;     ///< children, when the index was built
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_trigramIndex;
 };
 
 
@@ -24,10 +24,26 @@
 
 
 #include <cstdarg>
+#include <cstdint>
 #include <config.h> // HAVE_FGETC_NOLOCK
 
 #include <richio.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#include <wx/filename.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined( __linux__ )
+#include <sys/vfs.h>
+#elif defined( __APPLE__ ) || defined( __FreeBSD__ ) || defined( __OpenBSD__ ) || defined( __NetBSD__ )
+#include <sys/param.h>
+#include <sys/mount.h>
+#endif
+#endif
+
 
 // Fall back to getc() when getc_unlocked() is not available on the target platform.
 #if !defined( HAVE_FGETC_NOLOCK )
@@ -225,6 +241,195 @@ char* FILE_LINE_READER::ReadLine()
 }
 
 
+/**
+ * @return true if the file is on a local file system.  A file on a network share can be
+ * truncated by another computer while it is mapped.
+ */
+#ifdef _WIN32
+static bool isLocalFile( const wxString& aFileName )
+{
+    wxFileName fn( aFileName );
+    fn.MakeAbsolute();
+
+    wxString path = fn.GetFullPath();
+
+    // UNC paths (\\server\share\...) are network paths
+    if( path.StartsWith( wxT( "\\\\" ) ) || fn.GetVolume().length() != 1 )
+        return false;
+
+    wxString root = fn.GetVolume() + wxT( ":\\" );
+
+    return GetDriveTypeW( root.wc_str() ) != DRIVE_REMOTE;
+}
+#else
+static bool isLocalFile( int aFd )
+{
+#if defined( __linux__ )
+    // The file system types which can be shared between computers
+    static const uint32_t networkFsTypes[] =
+    {
+        0x6969,         // NFS
+        0x517B,         // SMB
+        0xFF534D42,     // CIFS
+        0xFE534D42,     // SMB2
+        0x65735546,     // FUSE (sshfs...)
+        0x73757245,     // CODA
+        0x5346414F,     // AFS
+        0x01021997,     // 9P
+        0x00C36400,     // CEPH
+    };
+
+    struct statfs fs;
+
+    if( fstatfs( aFd, &fs ) != 0 )
+        return false;
+
+    for( uint32_t type : networkFsTypes )
+    {
+        if( (uint32_t) fs.f_type == type )
+            return false;
+    }
+
+    return true;
+#elif defined( MNT_LOCAL )
+    struct statfs fs;
+
+    return fstatfs( aFd, &fs ) == 0 && ( fs.f_flags & MNT_LOCAL );
+#else
+    // The file system type is unknown: the file is read with stdio
+    return false;
+#endif
+}
+#endif
+
+
+MAPPED_FILE_LINE_READER::MAPPED_FILE_LINE_READER( const wxString& aFileName,
+            unsigned aStartingLineNumber, unsigned aMaxLineLength, size_t aMinMappedSize ) :
+    FILE_LINE_READER( aFileName, aStartingLineNumber, aMaxLineLength ),
+    m_data( NULL ), m_size( 0 ), m_ndx( 0 )
+{
+    // Any failure leaves the file unmapped: it is then read like FILE_LINE_READER does.
+#ifdef _WIN32
+    m_mapping = NULL;
+
+    HANDLE          file = (HANDLE) _get_osfhandle( _fileno( m_fp ) );
+    LARGE_INTEGER   size;
+
+    if( file == INVALID_HANDLE_VALUE || GetFileType( file ) != FILE_TYPE_DISK
+            || !GetFileSizeEx( file, &size ) || size.QuadPart == 0
+            || (unsigned long long) size.QuadPart < aMinMappedSize
+            || (unsigned long long) size.QuadPart > (size_t) -1
+            || !isLocalFile( aFileName ) )
+        return;
+
+    m_mapping = CreateFileMapping( file, NULL, PAGE_READONLY, 0, 0, NULL );
+
+    if( !m_mapping )
+        return;
+
+    m_data = (const char*) MapViewOfFile( (HANDLE) m_mapping, FILE_MAP_READ, 0, 0, 0 );
+
+    if( m_data )
+    {
+        m_size = size.QuadPart;
+    }
+    else
+    {
+        CloseHandle( (HANDLE) m_mapping );
+        m_mapping = NULL;
+    }
+#else
+    struct stat st;
+    int         fd = fileno( m_fp );
+
+    if( fstat( fd, &st ) != 0 || !S_ISREG( st.st_mode ) || st.st_size == 0
+            || (size_t) st.st_size < aMinMappedSize || !isLocalFile( fd ) )
+        return;
+
+    void* data = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+    if( data == MAP_FAILED )
+        return;
+
+#ifdef MADV_SEQUENTIAL
+    madvise( data, st.st_size, MADV_SEQUENTIAL );
+#endif
+
+    m_data = (const char*) data;
+    m_size = st.st_size;
+#endif
+}
+
+
+MAPPED_FILE_LINE_READER::~MAPPED_FILE_LINE_READER()
+{
+#ifdef _WIN32
+    if( m_data )
+        UnmapViewOfFile( m_data );
+
+    if( m_mapping )
+        CloseHandle( (HANDLE) m_mapping );
+#else
+    if( m_data )
+        munmap( (void*) m_data, m_size );
+#endif
+}
+
+
+const char* MAPPED_FILE_LINE_READER::nextLine()
+{
+    const char* line = m_data + m_ndx;
+    const char* nl = (const char*) memchr( line, '\n', m_size - m_ndx );
+
+    if( nl )
+        m_length = nl - line + 1;     // include the newline, so +1
+    else
+        m_length = m_size - m_ndx;
+
+    if( m_length >= m_maxLineLength )
+        THROW_IO_ERROR( _( "Maximum line length exceeded" ) );
+
+    m_ndx += m_length;
+
+    // m_lineNum is incremented even if there was no line read, because this
+    // leads to better error reporting when we hit an end of file.
+    ++m_lineNum;
+
+    return m_length ? line : NULL;
+}
+
+
+char* MAPPED_FILE_LINE_READER::ReadLine()
+{
+    if( !m_data )
+        return FILE_LINE_READER::ReadLine();
+
+    const char* line = nextLine();
+
+    if( m_length + 1 > m_capacity )     // +1 for terminating nul
+        expandCapacity( m_length + 1 );
+
+    if( line )
+        memcpy( m_line, line, m_length );
+
+    m_line[m_length] = 0;
+
+    return m_length ? m_line : NULL;
+}
+
+
+const char* MAPPED_FILE_LINE_READER::ReadLineInPlace( unsigned* aLength )
+{
+    if( !m_data )
+        return FILE_LINE_READER::ReadLineInPlace( aLength );
+
+    const char* line = nextLine();
+
+    *aLength = m_length;
+    return line;
+}
+
+
 STRING_LINE_READER::STRING_LINE_READER( const std::string& aString, const wxString& aSource ):
     LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
     m_lines( aString ), m_ndx( 0 )
@@ -278,6 +483,27 @@ char* STRING_LINE_READER::ReadLine()
 }
 
 
+const char* STRING_LINE_READER::ReadLineInPlace( unsigned* aLength )
+{
+    size_t      nlOffset = m_lines.find( '\n', m_ndx );
+    const char* line = m_lines.data() + m_ndx;
+
+    if( nlOffset == std::string::npos )
+        m_length = m_lines.length() - m_ndx;
+    else
+        m_length = nlOffset - m_ndx + 1;     // include the newline, so +1
+
+    if( m_length >= m_maxLineLength )
+        THROW_IO_ERROR( _("Line length exceeded") );
+
+    m_ndx += m_length;
+    ++m_lineNum;      // this gets incremented even if no bytes were read
+
+    *aLength = m_length;
+    return m_length ? line : NULL;
+}
+
+
 INPUTSTREAM_LINE_READER::INPUTSTREAM_LINE_READER( wxInputStream* aStream, const wxString& aSource ) :
     LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
     m_stream( aStream )
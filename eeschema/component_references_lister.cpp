@@ -758,6 +758,9 @@ void SCH_REFERENCE::Annotate()
     m_RootCmp->SetRef( &m_SheetPath, FROM_UTF8( m_Ref.c_str() ) );
     m_RootCmp->SetUnit( m_Unit );
     m_RootCmp->SetUnitSelection( &m_SheetPath, m_Unit );
+
+    // The unit, so the pins, of the component can have changed
+    m_SheetPath.LastScreen()->SetConnectivityDirty();
 }
 
 
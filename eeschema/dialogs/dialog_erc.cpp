@@ -533,123 +533,9 @@ void DIALOG_ERC::TestErc( REPORTER& aReporter )
 
     std::unique_ptr<NETLIST_OBJECT_LIST> objectsConnectedList( m_parent->BuildNetListBase() );
 
-    // Reset the connection type indicator
-    objectsConnectedList->ResetConnectionsType();
-
-    unsigned lastItemIdx;
-    unsigned nextItemIdx = lastItemIdx = 0;
-    int MinConn    = NOC;
-
-    /* Check that a pin appears in only one net.  This check is necessary
-     * because multi-unit components that have shared pins can be wired to
-     * different nets.
-     */
-    std::unordered_map<wxString, wxString> pin_to_net_map;
-
-    /* The netlist generated by SCH_EDIT_FRAME::BuildNetListBase is sorted
-     * by net number, which means we can group netlist items into ranges
-     * that live in the same net. The range from nextItem to the current
-     * item (exclusive) needs to be checked against the current item. The
-     * lastItem variable is used as a helper to pass the last item's number
-     * from one loop iteration to the next, which simplifies the initial
-     * pass.
-     */
-
-    for( unsigned itemIdx = 0; itemIdx < objectsConnectedList->size(); itemIdx++ )
-    {
-        auto item = objectsConnectedList->GetItem( itemIdx );
-        auto lastItem = objectsConnectedList->GetItem( lastItemIdx );
-
-        auto lastNet = lastItem->GetNet();
-        auto net = item->GetNet();
-
-        wxASSERT_MSG( lastNet <= net, wxT( "Netlist not correctly ordered" ) );
-
-        if( lastNet != net )
-        {
-            // New net found:
-            MinConn      = NOC;
-            nextItemIdx = itemIdx;
-        }
-
-        switch( item->m_Type )
-        {
-        // These items do not create erc problems
-        case NET_ITEM_UNSPECIFIED:
-        case NET_SEGMENT:
-        case NET_BUS:
-        case NET_JUNCTION:
-        case NET_LABEL:
-        case NET_BUSLABELMEMBER:
-        case NET_PINLABEL:
-        case NET_GLOBBUSLABELMEMBER:
-            break;
-
-        case NET_HIERLABEL:
-        case NET_HIERBUSLABELMEMBER:
-        case NET_SHEETLABEL:
-        case NET_SHEETBUSLABELMEMBER:
-            // ERC problems when pin sheets do not match hierarchical labels.
-            // Each pin sheet must match a hierarchical label
-            // Each hierarchical label must match a pin sheet
-            objectsConnectedList->TestforNonOrphanLabel( itemIdx, nextItemIdx );
-            break;
-        case NET_GLOBLABEL:
-            if( m_tstUniqueGlobalLabels )
-                objectsConnectedList->TestforNonOrphanLabel( itemIdx, nextItemIdx );
-            break;
-
-        case NET_NOCONNECT:
-
-            // ERC problems when a noconnect symbol is connected to more than one pin.
-            MinConn = NET_NC;
-
-            if( objectsConnectedList->CountPinsInNet( nextItemIdx ) > 1 )
-                Diagnose( item, NULL, MinConn, UNC );
-
-            break;
-
-        case NET_PIN:
-        {
-            // Check if this pin has appeared before on a different net
-            if( item->m_Link )
-            {
-                auto ref = item->GetComponentParent()->GetRef( &item->m_SheetPath );
-                wxString pin_name = ref + "_" + item->m_PinNum;
-
-                if( pin_to_net_map.count( pin_name ) == 0 )
-                {
-                    pin_to_net_map[pin_name] = item->GetNetName();
-                }
-                else if( pin_to_net_map[pin_name] != item->GetNetName() )
-                {
-                    SCH_MARKER* marker = new SCH_MARKER();
-
-                    marker->SetTimeStamp( GetNewTimeStamp() );
-                    marker->SetData( ERCE_DIFFERENT_UNIT_NET, item->m_Start,
-                        wxString::Format( _( "Pin %s on %s is connected to both %s and %s" ),
-                        item->m_PinNum, ref, pin_to_net_map[pin_name], item->GetNetName() ),
-                        item->m_Start );
-                    marker->SetMarkerType( MARKER_BASE::MARKER_ERC );
-                    marker->SetErrorLevel( MARKER_BASE::MARKER_SEVERITY_ERROR );
-
-                    item->m_SheetPath.LastScreen()->Append( marker );
-                }
-            }
-
-            // Look for ERC problems between pins:
-            TestOthersItems( objectsConnectedList.get(), itemIdx, nextItemIdx, &MinConn );
-            break;
-        }
-        }
-
-        lastItemIdx = itemIdx;
-    }
-
-    // Test similar labels (i;e. labels which are identical when
-    // using case insensitive comparisons)
-    if( m_TestSimilarLabels )
-        objectsConnectedList->TestforSimilarLabels();
+    // Test the nets, on several threads
+    TestNetConnections( objectsConnectedList.get(), m_tstUniqueGlobalLabels,
+                        m_TestSimilarLabels );
 
     // Displays global results:
     updateMarkerCounts( &screens );
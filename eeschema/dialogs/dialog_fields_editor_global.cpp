@@ -626,6 +626,9 @@ public:
 
                 destField->SetText( srcValue );
             }
+
+            // The references give their name to the nets without label
+            m_componentRefs[i].GetSheetPath().LastScreen()->SetConnectivityDirty();
         }
 
         m_edited = false;
@@ -43,6 +43,12 @@
 
 #include <wx/ffile.h>
 
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <thread>
+#include <unordered_map>
+
 
 /* ERC tests :
  *  1 - conflicts between connected pins ( example: 2 connected outputs )
@@ -427,92 +433,258 @@ void Diagnose( NETLIST_OBJECT* aNetItemRef, NETLIST_OBJECT* aNetItemTst,
 }
 
 
-void TestOthersItems( NETLIST_OBJECT_LIST* aList,
-                      unsigned aNetItemRef, unsigned aNetStart,
-                      int* aMinConnexion )
+/**
+ * Class NET_ERC_TESTER
+ * runs the ERC tests of the nets of a list of connected items sorted by net code.
+ *
+ * The nets are independent, so they are tested on several threads.  The tests do not
+ * create the markers: the problems found on each item are kept, and the markers are
+ * created after the tests, in the order of the items.  So the markers are the same, in
+ * the same order, whatever the number of threads.
+ */
+class NET_ERC_TESTER
+{
+public:
+    NET_ERC_TESTER( NETLIST_OBJECT_LIST* aList, bool aTestUniqueGlobalLabels ) :
+        m_list( aList ),
+        m_testUniqueGlobalLabels( aTestUniqueGlobalLabels )
+    {
+    }
+
+    void Run( unsigned aThreadCount );
+
+private:
+    /// A problem found when testing the item m_item, to report by Diagnose()
+    struct DIAG
+    {
+        unsigned        m_item;
+        NETLIST_OBJECT* m_itemTst;
+        int             m_minConn;
+        int             m_diag;
+    };
+
+    /// The items [m_start, m_end) of a net, and the problems found on them
+    struct NET
+    {
+        unsigned          m_start;
+        unsigned          m_end;
+        std::vector<DIAG> m_diags;
+    };
+
+    /**
+     * Reads the references of the components of the pins, and finds the pins having
+     * another connected instance (same reference and pin number, for multiple parts per
+     * package).  GetRef() can update the component, so this is not done by the threads.
+     */
+    void initPins();
+
+    /// Tests the items of aNet
+    void testNet( NET& aNet );
+
+    /**
+     * Perform ERC testing for electrical conflicts between \a aNetItemRef and other items
+     * (mainly pin) of \a aNet.
+     * @param aMinConnexion = a pointer to a variable to store the minimal connection
+     * found( NOD, DRV, NPI, NET_NC)
+     */
+    void testOthersItems( NET& aNet, unsigned aNetItemRef, int* aMinConnexion );
+
+    /// Checks if the pin aItem has appeared before on a different net
+    void testPinNet( unsigned aItem, std::unordered_map<wxString, wxString>& aPinToNet );
+
+    NETLIST_OBJECT_LIST*    m_list;
+    bool                    m_testUniqueGlobalLabels;
+    std::vector<NET>        m_nets;
+    std::vector<wxString>   m_pinRefs;              ///< component reference of each pin
+    std::vector<bool>       m_connectedDuplicates;  ///< pins having another connected instance
+};
+
+
+void NET_ERC_TESTER::Run( unsigned aThreadCount )
+{
+    initPins();
+
+    for( unsigned start = 0; start < m_list->size(); )
+    {
+        unsigned end = start + 1;
+
+        while( end < m_list->size() && m_list->GetItemNet( end ) == m_list->GetItemNet( start ) )
+            end++;
+
+        wxASSERT_MSG( end == m_list->size()
+                      || m_list->GetItemNet( start ) <= m_list->GetItemNet( end ),
+                      wxT( "Netlist not correctly ordered" ) );
+
+        m_nets.push_back( { start, end, std::vector<DIAG>() } );
+        start = end;
+    }
+
+    // Each thread takes the next net when it has tested the previous one
+    std::atomic<size_t> nextNet( 0 );
+
+    auto testNets = [&]()
+    {
+        for( size_t ii = nextNet.fetch_add( 1 ); ii < m_nets.size(); ii = nextNet.fetch_add( 1 ) )
+            testNet( m_nets[ii] );
+    };
+
+    if( aThreadCount == 0 )
+        aThreadCount = std::max<unsigned>( 1, std::thread::hardware_concurrency() );
+
+    size_t threadCount = std::min<size_t>( aThreadCount, m_nets.size() );
+
+    if( threadCount <= 1 )
+    {
+        testNets();
+    }
+    else
+    {
+        std::vector<std::thread> threads;
+
+        for( size_t ii = 0; ii < threadCount; ++ii )
+            threads.push_back( std::thread( testNets ) );
+
+        for( std::thread& thread : threads )
+            thread.join();
+    }
+
+    // Create the markers, in the order of the items
+    std::unordered_map<wxString, wxString> pinToNet;
+
+    for( NET& net : m_nets )
+    {
+        auto diag = net.m_diags.begin();
+
+        for( unsigned ii = net.m_start; ii < net.m_end; ii++ )
+        {
+            if( m_list->GetItemType( ii ) == NET_PIN )
+                testPinNet( ii, pinToNet );
+
+            for( ; diag != net.m_diags.end() && diag->m_item == ii; ++diag )
+            {
+                Diagnose( m_list->GetItem( ii ), diag->m_itemTst, diag->m_minConn,
+                          diag->m_diag );
+            }
+        }
+    }
+}
+
+
+void NET_ERC_TESTER::initPins()
+{
+    m_pinRefs.assign( m_list->size(), wxEmptyString );
+    m_connectedDuplicates.assign( m_list->size(), false );
+
+    // The instances of each pin, by component reference and pin number
+    std::map<std::pair<wxString, wxString>, std::vector<unsigned>> instances;
+
+    for( unsigned ii = 0; ii < m_list->size(); ii++ )
+    {
+        NETLIST_OBJECT* item = m_list->GetItem( ii );
+
+        if( item->m_Type != NET_PIN || !item->GetComponentParent() )
+            continue;
+
+        m_pinRefs[ii] = item->GetComponentParent()->GetRef( &item->m_SheetPath );
+        instances[ std::make_pair( m_pinRefs[ii], item->m_PinNum ) ].push_back( ii );
+    }
+
+    // A pin is connected if its net has another item
+    auto isConnected = [&]( unsigned aItem ) -> bool
+    {
+        return ( aItem > 0 && m_list->GetItemNet( aItem ) == m_list->GetItemNet( aItem - 1 ) )
+               || ( aItem < m_list->size() - 1
+                    && m_list->GetItemNet( aItem ) == m_list->GetItemNet( aItem + 1 ) );
+    };
+
+    for( const auto& pin : instances )
+    {
+        const std::vector<unsigned>& pins = pin.second;
+        int connectedCount = 0;
+
+        for( unsigned item : pins )
+            connectedCount += isConnected( item ) ? 1 : 0;
+
+        for( unsigned item : pins )
+            m_connectedDuplicates[item] = connectedCount > ( isConnected( item ) ? 1 : 0 );
+    }
+}
+
+
+void NET_ERC_TESTER::testNet( NET& aNet )
+{
+    int minConn = NOC;
+
+    for( unsigned ii = aNet.m_start; ii < aNet.m_end; ii++ )
+    {
+        switch( m_list->GetItemType( ii ) )
+        {
+        // These items do not create erc problems
+        case NET_ITEM_UNSPECIFIED:
+        case NET_SEGMENT:
+        case NET_BUS:
+        case NET_JUNCTION:
+        case NET_LABEL:
+        case NET_BUSLABELMEMBER:
+        case NET_PINLABEL:
+        case NET_GLOBBUSLABELMEMBER:
+            break;
+
+        case NET_HIERLABEL:
+        case NET_HIERBUSLABELMEMBER:
+        case NET_SHEETLABEL:
+        case NET_SHEETBUSLABELMEMBER:
+            // ERC problems when pin sheets do not match hierarchical labels.
+            // Each pin sheet must match a hierarchical label
+            // Each hierarchical label must match a pin sheet
+            if( m_list->IsOrphanLabel( ii, aNet.m_start ) )
+                aNet.m_diags.push_back( { ii, NULL, -1, WAR } );
+
+            break;
+
+        case NET_GLOBLABEL:
+            if( m_testUniqueGlobalLabels && m_list->IsOrphanLabel( ii, aNet.m_start ) )
+                aNet.m_diags.push_back( { ii, NULL, -1, WAR } );
+
+            break;
+
+        case NET_NOCONNECT:
+            // ERC problems when a noconnect symbol is connected to more than one pin.
+            minConn = NET_NC;
+
+            if( m_list->CountPinsInNet( aNet.m_start ) > 1 )
+                aNet.m_diags.push_back( { ii, NULL, minConn, UNC } );
+
+            break;
+
+        case NET_PIN:
+            // Look for ERC problems between pins:
+            testOthersItems( aNet, ii, &minConn );
+            break;
+        }
+    }
+}
+
+
+void NET_ERC_TESTER::testOthersItems( NET& aNet, unsigned aNetItemRef, int* aMinConnexion )
 {
-    unsigned netItemTst = aNetStart;
     ELECTRICAL_PINTYPE jj;
     int erc = OK;
 
     /* Analysis of the table of connections. */
-    ELECTRICAL_PINTYPE ref_elect_type = aList->GetItem( aNetItemRef )->m_ElectricalPinType;
+    ELECTRICAL_PINTYPE ref_elect_type = m_list->GetItem( aNetItemRef )->m_ElectricalPinType;
     int local_minconn = NOC;
 
     if( ref_elect_type == PIN_NC )
         local_minconn = NPI;
 
     /* Test pins connected to NetItemRef */
-    for( ; ; netItemTst++ )
+    for( unsigned netItemTst = aNet.m_start; netItemTst < aNet.m_end; netItemTst++ )
     {
         if( aNetItemRef == netItemTst )
             continue;
 
-        // We examine only a given net. We stop the search if the net changes
-        if( ( netItemTst >= aList->size() ) // End of list
-            || ( aList->GetItemNet( aNetItemRef ) !=
-                 aList->GetItemNet( netItemTst ) ) ) // End of net
-        {
-            /* End net code found: minimum connection test. */
-            if( ( *aMinConnexion < NET_NC ) && ( local_minconn < NET_NC ) )
-            {
-                /* Not connected or not driven pin. */
-                bool seterr = true;
-
-                if( local_minconn == NOC &&
-                    aList->GetItemType( aNetItemRef ) == NET_PIN )
-                {
-                    /* This pin is not connected: for multiple part per
-                     * package, and duplicated pin,
-                     * search for another instance of this pin
-                     * this will be flagged only if all instances of this pin
-                     * are not connected
-                     * TODO test also if instances connected are connected to
-                     * the same net
-                     */
-                    for( unsigned duplicate = 0; duplicate < aList->size(); duplicate++ )
-                    {
-                        if( aList->GetItemType( duplicate ) != NET_PIN )
-                            continue;
-
-                        if( duplicate == aNetItemRef )
-                            continue;
-
-                        if( aList->GetItem( aNetItemRef )->m_PinNum !=
-                            aList->GetItem( duplicate )->m_PinNum )
-                            continue;
-
-                        if( ( (SCH_COMPONENT*) aList->GetItem( aNetItemRef )->
-                             m_Link )->GetRef( &aList->GetItem( aNetItemRef )-> m_SheetPath ) !=
-                            ( (SCH_COMPONENT*) aList->GetItem( duplicate )->m_Link )
-                           ->GetRef( &aList->GetItem( duplicate )->m_SheetPath ) )
-                            continue;
-
-                        // Same component and same pin. Do dot create error for this pin
-                        // if the other pin is connected (i.e. if duplicate net has another
-                        // item)
-                        if( (duplicate > 0)
-                          && ( aList->GetItemNet( duplicate ) ==
-                               aList->GetItemNet( duplicate - 1 ) ) )
-                            seterr = false;
-
-                        if( (duplicate < aList->size() - 1)
-                          && ( aList->GetItemNet( duplicate ) ==
-                               aList->GetItemNet( duplicate + 1 ) ) )
-                            seterr = false;
-                    }
-                }
-
-                if( seterr )
-                    Diagnose( aList->GetItem( aNetItemRef ), NULL, local_minconn, WAR );
-
-                *aMinConnexion = DRV;   // inhibiting other messages of this
-                                       // type for the net.
-            }
-            return;
-        }
-
-        switch( aList->GetItemType( netItemTst ) )
+        switch( m_list->GetItemType( netItemTst ) )
         {
         case NET_ITEM_UNSPECIFIED:
         case NET_SEGMENT:
@@ -534,7 +706,7 @@ void TestOthersItems( NETLIST_OBJECT_LIST* aList,
             break;
 
         case NET_PIN:
-            jj = aList->GetItem( netItemTst )->m_ElectricalPinType;
+            jj = m_list->GetItem( netItemTst )->m_ElectricalPinType;
             local_minconn = std::max( MinimalReq[ref_elect_type][jj], local_minconn );
 
             if( netItemTst <= aNetItemRef )
@@ -546,12 +718,11 @@ void TestOthersItems( NETLIST_OBJECT_LIST* aList,
 
                 if( erc != OK )
                 {
-                    if( aList->GetConnectionType( netItemTst ) == UNCONNECTED )
+                    if( m_list->GetConnectionType( netItemTst ) == UNCONNECTED )
                     {
-                        Diagnose( aList->GetItem( aNetItemRef ),
-                                  aList->GetItem( netItemTst ),
-                                  0, erc );
-                        aList->SetConnectionType( netItemTst, NOCONNECT_SYMBOL_PRESENT );
+                        aNet.m_diags.push_back( { aNetItemRef, m_list->GetItem( netItemTst ),
+                                                  0, erc } );
+                        m_list->SetConnectionType( netItemTst, NOCONNECT_SYMBOL_PRESENT );
                     }
                 }
             }
@@ -559,6 +730,71 @@ void TestOthersItems( NETLIST_OBJECT_LIST* aList,
             break;
         }
     }
+
+    /* End net code found: minimum connection test. */
+    if( ( *aMinConnexion < NET_NC ) && ( local_minconn < NET_NC ) )
+    {
+        /* Not connected or not driven pin.  For multiple part per package, and
+         * duplicated pin, this will be flagged only if all instances of this pin
+         * are not connected
+         * TODO test also if instances connected are connected to the same net
+         */
+        if( local_minconn != NOC || !m_connectedDuplicates[aNetItemRef] )
+            aNet.m_diags.push_back( { aNetItemRef, NULL, local_minconn, WAR } );
+
+        *aMinConnexion = DRV;   // inhibiting other messages of this
+                                // type for the net.
+    }
+}
+
+
+void NET_ERC_TESTER::testPinNet( unsigned aItem,
+                                 std::unordered_map<wxString, wxString>& aPinToNet )
+{
+    NETLIST_OBJECT* item = m_list->GetItem( aItem );
+
+    if( !item->m_Link )
+        return;
+
+    const wxString& ref = m_pinRefs[aItem];
+    wxString pin_name = ref + "_" + item->m_PinNum;
+
+    auto it = aPinToNet.find( pin_name );
+
+    if( it == aPinToNet.end() )
+    {
+        aPinToNet[pin_name] = item->GetNetName();
+    }
+    else if( it->second != item->GetNetName() )
+    {
+        SCH_MARKER* marker = new SCH_MARKER();
+
+        marker->SetTimeStamp( GetNewTimeStamp() );
+        marker->SetData( ERCE_DIFFERENT_UNIT_NET, item->m_Start,
+            wxString::Format( _( "Pin %s on %s is connected to both %s and %s" ),
+            item->m_PinNum, ref, it->second, item->GetNetName() ),
+            item->m_Start );
+        marker->SetMarkerType( MARKER_BASE::MARKER_ERC );
+        marker->SetErrorLevel( MARKER_BASE::MARKER_SEVERITY_ERROR );
+
+        item->m_SheetPath.LastScreen()->Append( marker );
+    }
+}
+
+
+void TestNetConnections( NETLIST_OBJECT_LIST* aList, bool aTestUniqueGlobalLabels,
+                         bool aTestSimilarLabels, unsigned aThreadCount )
+{
+    // Reset the connection type indicator
+    aList->ResetConnectionsType();
+
+    NET_ERC_TESTER tester( aList, aTestUniqueGlobalLabels );
+    tester.Run( aThreadCount );
+
+    // Test similar labels (i;e. labels which are identical when
+    // using case insensitive comparisons)
+    if( aTestSimilarLabels )
+        aList->TestforSimilarLabels();
 }
 
 int NETLIST_OBJECT_LIST::CountPinsInNet( unsigned aNetStart )
@@ -639,10 +875,9 @@ bool WriteDiagnosticERC( EDA_UNITS_T aUnits, const wxString& aFullFileName )
 }
 
 
-void NETLIST_OBJECT_LIST::TestforNonOrphanLabel( unsigned aNetItemRef, unsigned aStartNet )
+bool NETLIST_OBJECT_LIST::IsOrphanLabel( unsigned aNetItemRef, unsigned aStartNet ) const
 {
     unsigned netItemTst = aStartNet;
-    int      erc = 1;
 
     // Review the list of labels connected to NetItemRef:
     for( ; ; netItemTst++ )
@@ -654,22 +889,16 @@ void NETLIST_OBJECT_LIST::TestforNonOrphanLabel( unsigned aNetItemRef, unsigned
         if( ( netItemTst == size() )
           || ( GetItemNet( aNetItemRef ) != GetItemNet( netItemTst ) ) )
         {
-            /* End Netcode found. */
-            if( erc )
-            {
-                /* Glabel or SheetLabel orphaned. */
-                Diagnose( GetItem( aNetItemRef ), NULL, -1, WAR );
-            }
-
-            return;
+            /* End Netcode found: Glabel or SheetLabel orphaned. */
+            return true;
         }
 
         if( GetItem( aNetItemRef )->IsLabelConnected( GetItem( netItemTst ) ) )
-            erc = 0;
+            return false;
 
         //same thing, different order.
         if( GetItem( netItemTst )->IsLabelConnected( GetItem( aNetItemRef ) ) )
-            erc = 0;
+            return false;
     }
 }
 
@@ -90,17 +90,21 @@ void Diagnose( NETLIST_OBJECT* NetItemRef, NETLIST_OBJECT* NetItemTst,
                       int MinConnexion, int Diag );
 
 /**
- * Perform ERC testing for electrical conflicts between \a NetItemRef and other items
- * (mainly pin) on the same net.
- * @param aList = a reference to the list of connected objects
- * @param aNetItemRef = index in list of the current object
- * @param aNetStart = index in list of net objects of the first item
- * @param aMinConnexion = a pointer to a variable to store the minimal connection
- * found( NOD, DRV, NPI, NET_NC)
+ * Function TestNetConnections
+ * performs the ERC tests of the connected items: conflicts between pins, unconnected
+ * or not driven pins, orphan labels, pins of multi-unit components connected to
+ * different nets and, optionally, similar labels.  ERC markers are created in the
+ * screens of the items.
+ * The nets are tested on several threads, and the markers are created in the same
+ * order whatever the number of threads.
+ * @param aList = the connected items, sorted by net code (see BuildNetListBase())
+ * @param aTestUniqueGlobalLabels = true to report global labels connected to no other one
+ * @param aTestSimilarLabels = true to report labels which are equal when using case
+ *                             insensitive comparisons
+ * @param aThreadCount = number of threads, 0 for one per core
  */
-void TestOthersItems( NETLIST_OBJECT_LIST* aList,
-                             unsigned aNetItemRef, unsigned aNetStart,
-                             int* aMinConnexion );
+void TestNetConnections( NETLIST_OBJECT_LIST* aList, bool aTestUniqueGlobalLabels,
+                         bool aTestSimilarLabels, unsigned aThreadCount = 0 );
 
 /**
  * Function TestDuplicateSheetNames( )
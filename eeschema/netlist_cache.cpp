@@ -0,0 +1,137 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file eeschema/netlist_cache.cpp
+ */
+
+#include <map>
+#include <unordered_map>
+
+#include <netlist_cache.h>
+#include <sch_item_struct.h>
+#include <sch_screen.h>
+
+
+NETLIST_OBJECT_LIST* NETLIST_CACHE::Build( SCH_SHEET_LIST& aSheets )
+{
+    bool upToDate = m_connectedItems && m_sheets.size() == aSheets.size();
+
+    for( unsigned i = 0; upToDate && i < aSheets.size(); i++ )
+        upToDate = isUpToDate( *m_sheets[i], aSheets[i] );
+
+    if( !upToDate )
+    {
+        // The items of the previous build, by sheet path
+        std::map<wxString, std::unique_ptr<SHEET_ITEMS>> previous;
+
+        for( std::unique_ptr<SHEET_ITEMS>& sheetItems : m_sheets )
+            previous[ sheetItems->m_pathName ] = std::move( sheetItems );
+
+        m_sheets.clear();
+        m_connectedItems.reset( new NETLIST_OBJECT_LIST );
+
+        for( unsigned i = 0; i < aSheets.size(); i++ )
+        {
+            SCH_SHEET_PATH*              sheet = &aSheets[i];
+            std::unique_ptr<SHEET_ITEMS> sheetItems;
+
+            auto it = previous.find( sheet->Path() );
+
+            if( it != previous.end() && it->second && isUpToDate( *it->second, *sheet ) )
+            {
+                sheetItems = std::move( it->second );
+            }
+            else
+            {
+                sheetItems.reset( new SHEET_ITEMS );
+                sheetItems->m_sheetPath = *sheet;
+                sheetItems->m_pathName = sheet->Path();
+                sheetItems->m_screen = sheet->LastScreen();
+                sheetItems->m_revision = sheetItems->m_screen->GetConnectivityRevision();
+
+                for( SCH_ITEM* item = sheet->LastScreen()->GetDrawItems(); item;
+                     item = item->Next() )
+                {
+                    item->GetNetListItem( sheetItems->m_items, sheet );
+                }
+            }
+
+            // The connections are stored in the items: connect copies of them
+            for( NETLIST_OBJECT* item : sheetItems->m_items )
+                m_connectedItems->push_back( new NETLIST_OBJECT( *item ) );
+
+            m_sheets.push_back( std::move( sheetItems ) );
+        }
+
+        // The items of the sheets which were modified or removed are freed here
+        previous.clear();
+
+        m_connectedItems->ResolveConnections();
+    }
+
+    return copyList( *m_connectedItems );
+}
+
+
+void NETLIST_CACHE::Clear()
+{
+    m_sheets.clear();
+    m_connectedItems.reset();
+}
+
+
+bool NETLIST_CACHE::isUpToDate( const SHEET_ITEMS& aSheetItems, const SCH_SHEET_PATH& aSheetPath )
+{
+    // The revisions are unique over all the screens: a deleted screen cannot be mistaken
+    // for a new one allocated at the same address
+    SCH_SCREEN* screen = aSheetPath.LastScreen();
+
+    return aSheetItems.m_screen == screen
+           && aSheetItems.m_revision == screen->GetConnectivityRevision()
+           && aSheetItems.m_sheetPath == aSheetPath
+           && aSheetItems.m_pathName == aSheetPath.Path();
+}
+
+
+NETLIST_OBJECT_LIST* NETLIST_CACHE::copyList( const NETLIST_OBJECT_LIST& aList )
+{
+    std::unique_ptr<NETLIST_OBJECT_LIST> copy( new NETLIST_OBJECT_LIST );
+    std::unordered_map<const NETLIST_OBJECT*, NETLIST_OBJECT*> copies;
+
+    copy->reserve( aList.size() );
+
+    for( NETLIST_OBJECT* item : aList )
+    {
+        copy->push_back( new NETLIST_OBJECT( *item ) );
+        copies[item] = copy->back();
+    }
+
+    for( NETLIST_OBJECT* item : *copy )
+    {
+        if( item->HasNetNameCandidate() )
+            item->SetNetNameCandidate( copies[ item->GetNetNameCandidate() ] );
+    }
+
+    return copy.release();
+}
@@ -0,0 +1,99 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file eeschema/netlist_cache.h
+ */
+
+#ifndef NETLIST_CACHE_H
+#define NETLIST_CACHE_H
+
+#include <memory>
+#include <vector>
+
+#include <netlist_object.h>
+
+class SCH_SCREEN;
+
+
+/**
+ * Class NETLIST_CACHE
+ * keeps the connected items of a schematic hierarchy between two builds of the netlist.
+ *
+ * The items of each sheet are kept with the connectivity revision of the screen of the
+ * sheet (see SCH_SCREEN::GetConnectivityRevision()): only the sheets whose screen was
+ * modified since the previous build are read again.  The connections of the whole
+ * hierarchy are resolved again only when a sheet has changed, so highlighting a net or
+ * running the ERC on an unmodified schematic starts from the already resolved items.
+ */
+class NETLIST_CACHE
+{
+public:
+    NETLIST_CACHE() {}
+
+    /**
+     * Function Build
+     * builds the connected items of the flattened hierarchy aSheets, like
+     * NETLIST_OBJECT_LIST::BuildNetListInfo() does.
+     * @param aSheets = the flattened sheet list
+     * @return a new list, owned by the caller, which can be modified without changing
+     * the cache.  The list is empty if there is no item in the schematic.
+     */
+    NETLIST_OBJECT_LIST* Build( SCH_SHEET_LIST& aSheets );
+
+    /**
+     * Function Clear
+     * frees all the cached items.
+     */
+    void Clear();
+
+private:
+    /// The items of a sheet path, as built by SCH_ITEM::GetNetListItem(), not connected
+    struct SHEET_ITEMS
+    {
+        SCH_SHEET_PATH      m_sheetPath;
+        wxString            m_pathName;     ///< m_sheetPath.Path(), when the items were built
+        SCH_SCREEN*         m_screen;
+        unsigned long long  m_revision;     ///< revision of m_screen when the items were built
+        NETLIST_OBJECT_LIST m_items;
+    };
+
+    /**
+     * Function isUpToDate
+     * @return true if aSheetItems are the items of aSheetPath, and its screen was not
+     * modified since they were built.
+     */
+    static bool isUpToDate( const SHEET_ITEMS& aSheetItems, const SCH_SHEET_PATH& aSheetPath );
+
+    /**
+     * Function copyList
+     * @return a copy of aList, whose net name candidates are the copies of the candidates
+     * of aList.
+     */
+    static NETLIST_OBJECT_LIST* copyList( const NETLIST_OBJECT_LIST& aList );
+
+    std::vector<std::unique_ptr<SHEET_ITEMS>> m_sheets;     ///< in the sheet list order
+    std::unique_ptr<NETLIST_OBJECT_LIST>      m_connectedItems;
+};
+
+#endif  // NETLIST_CACHE_H
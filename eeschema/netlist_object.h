@@ -32,6 +32,10 @@
 #define NETLIST_OBJECT_H
 
 
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
 #include <sch_sheet_path.h>
 #include <lib_pin.h>
 #include <sch_item_struct.h>
@@ -177,6 +181,8 @@ public:
      */
     bool HasNetNameCandidate() { return m_netNameCandidate != NULL; }
 
+    NETLIST_OBJECT* GetNetNameCandidate() const { return m_netNameCandidate; }
+
     /**
      * Function GetPinNum
      * returns a pin number in wxString form.  Pin numbers are not always
@@ -312,6 +318,15 @@ public:
      */
     bool BuildNetListInfo( SCH_SHEET_LIST& aSheets );
 
+    /**
+     * Function ResolveConnections
+     * builds the connection info (net codes, net names ...) of the items already in
+     * the list, i.e. the second stage of BuildNetListInfo().  The items must not have
+     * been connected yet.
+     * @return true if OK, false is the list is empty
+     */
+    bool ResolveConnections();
+
     /**
      * Acces to an item in list
      */
@@ -386,14 +401,16 @@ public:
     int CountPinsInNet( unsigned aNetStart );
 
     /**
-     * Function TestforNonOrphanLabel
+     * Function IsOrphanLabel
      * Sheet labels are expected to be connected to a hierarchical label.
      * Hierarchical labels are expected to be connected to a sheet label.
      * Global labels are expected to be not orphan (connected to at least one
      * other global label.
      * This function tests the connection to another suitable label.
+     * It only reads the list, so it can be called for several nets at the same time.
+     * @return true if the label at aNetItemRef is not connected to a suitable label
      */
-    void TestforNonOrphanLabel( unsigned aNetItemRef, unsigned aStartNet );
+    bool IsOrphanLabel( unsigned aNetItemRef, unsigned aStartNet ) const;
 
     /**
      * Function TestforSimilarLabels
@@ -416,6 +433,55 @@ public:
     #endif
 
 private:
+    /**
+     * The items of a sheet, with their connection points and their segments, to find the
+     * items connected to a point without testing all the items of the sheet.
+     * The lists hold indexes of items in the list sorted by sheet, in increasing order.
+     */
+    struct SHEET_CONNECTIONS
+    {
+        /// Items by start and end point
+        std::unordered_map<uint64_t, std::vector<unsigned>> m_points;
+
+        /// Horizontal wires and buses by Y coordinate, vertical ones by X coordinate
+        std::unordered_map<int, std::vector<unsigned>>      m_hSegments;
+        std::unordered_map<int, std::vector<unsigned>>      m_vSegments;
+
+        /// Other wires and buses
+        std::vector<unsigned>                               m_otherSegments;
+    };
+
+    /*
+     * The net codes are merged in union-find forests: when a net code is merged into
+     * another one, it points to it, and the code of an item is the root of its code.
+     * So merging 2 nets does not rewrite the codes of the whole list.
+     */
+    std::vector<int>                m_netCodeParents;
+    std::vector<int>                m_busNetCodeParents;
+
+    std::vector<unsigned>           m_itemSheets;       ///< index of the sheet of each item
+    std::vector<SHEET_CONNECTIONS>  m_sheetConnections;
+
+    /// Items of label type, by label text
+    std::unordered_map<wxString, std::vector<unsigned>> m_labels;
+
+    /**
+     * Build the connection and label indexes of the list sorted by sheet.
+     */
+    void buildConnectionIndex();
+
+    /**
+     * @return the root of aNetCode in the union-find forest aParents
+     */
+    static int findNetCode( std::vector<int>& aParents, int aNetCode );
+
+    /**
+     * @return the current net code (or bus net code) of aItem, i.e. the code of its
+     * merged net.
+     */
+    int getNetCode( NETLIST_OBJECT* aItem );
+    int getBusNetCode( NETLIST_OBJECT* aItem );
+
     /*
      * Propagate aNewNetCode to items having an internal netcode aOldNetCode
      * used to interconnect group of items already physically connected,
@@ -39,6 +39,10 @@
 #include <sch_sheet.h>
 #include <sch_screen.h>
 #include <algorithm>
+#include <map>
+#include <numeric>
+#include <set>
+#include <tuple>
 
 #define IS_WIRE false
 #define IS_BUS true
@@ -92,13 +96,20 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
         }
     }
 
+    return ResolveConnections();
+}
+
+
+bool NETLIST_OBJECT_LIST::ResolveConnections()
+{
     if( size() == 0 )
         return false;
 
     // Sort objects by Sheet
     SortListbySheet();
+    buildConnectionIndex();
 
-    sheet = &(GetItem( 0 )->m_SheetPath);
+    SCH_SHEET_PATH* sheet = &(GetItem( 0 )->m_SheetPath);
     m_lastNetCode = m_lastBusNetCode = 1;
 
     for( unsigned ii = 0, istart = 0; ii < size(); ii++ )
@@ -121,12 +132,12 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
         case NET_PINLABEL:
         case NET_SHEETLABEL:
         case NET_NOCONNECT:
-            if( net_item->GetNet() != 0 )
+            if( getNetCode( net_item ) != 0 )
                 break;
 
         case NET_SEGMENT:
             // Test connections point to point type without bus.
-            if( net_item->GetNet() == 0 )
+            if( getNetCode( net_item ) == 0 )
             {
                 net_item->SetNet( m_lastNetCode );
                 m_lastNetCode++;
@@ -137,7 +148,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
 
         case NET_JUNCTION:
             // Control of the junction outside BUS.
-            if( net_item->GetNet() == 0 )
+            if( getNetCode( net_item ) == 0 )
             {
                 net_item->SetNet( m_lastNetCode );
                 m_lastNetCode++;
@@ -146,7 +157,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
             segmentToPointConnect( net_item, IS_WIRE, istart );
 
             // Control of the junction, on BUS.
-            if( net_item->m_BusNetCode == 0 )
+            if( getBusNetCode( net_item ) == 0 )
             {
                 net_item->m_BusNetCode = m_lastBusNetCode;
                 m_lastBusNetCode++;
@@ -159,7 +170,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
         case NET_HIERLABEL:
         case NET_GLOBLABEL:
             // Test connections type junction without bus.
-            if( net_item->GetNet() == 0 )
+            if( getNetCode( net_item ) == 0 )
             {
                 net_item->SetNet( m_lastNetCode );
                 m_lastNetCode++;
@@ -169,12 +180,12 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
             break;
 
         case NET_SHEETBUSLABELMEMBER:
-            if( net_item->m_BusNetCode != 0 )
+            if( getBusNetCode( net_item ) != 0 )
                 break;
 
         case NET_BUS:
             // Control type connections point to point mode bus
-            if( net_item->m_BusNetCode == 0 )
+            if( getBusNetCode( net_item ) == 0 )
             {
                 net_item->m_BusNetCode = m_lastBusNetCode;
                 m_lastBusNetCode++;
@@ -187,7 +198,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
         case NET_HIERBUSLABELMEMBER:
         case NET_GLOBBUSLABELMEMBER:
             // Control connections similar has on BUS
-            if( net_item->GetNet() == 0 )
+            if( getNetCode( net_item ) == 0 )
             {
                 net_item->m_BusNetCode = m_lastBusNetCode;
                 m_lastBusNetCode++;
@@ -207,6 +218,8 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
     connectBusLabels();
 
     // Group objects by label.
+    std::set<std::tuple<wxString, unsigned, int>> connectedLabels;
+
     for( unsigned ii = 0; ii < size(); ii++ )
     {
         switch( GetItem( ii )->m_Type )
@@ -224,7 +237,18 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
         case NET_PINLABEL:
         case NET_BUSLABELMEMBER:
         case NET_GLOBBUSLABELMEMBER:
-            labelConnect( GetItem( ii ) );
+        {
+            // The labels having the same text and type in the same sheet connect the same
+            // items: once the first one is connected, the other ones have nothing to do.
+            NETLIST_OBJECT* label = GetItem( ii );
+
+            if( getNetCode( label ) == 0
+                || connectedLabels.insert( std::make_tuple( label->m_Label, m_itemSheets[ii],
+                                                            (int) label->m_Type ) ).second )
+            {
+                labelConnect( label );
+            }
+        }
             break;
 
         case NET_SHEETBUSLABELMEMBER:
@@ -250,6 +274,19 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
             sheetLabelConnect( GetItem( ii ) );
     }
 
+    // Give to each item the code of its merged net, and release the indexes
+    for( unsigned ii = 0; ii < size(); ii++ )
+    {
+        getNetCode( GetItem( ii ) );
+        getBusNetCode( GetItem( ii ) );
+    }
+
+    m_netCodeParents.clear();
+    m_busNetCodeParents.clear();
+    m_itemSheets.clear();
+    m_sheetConnections.clear();
+    m_labels.clear();
+
     // Sort objects by NetCode
     SortListbyNetcode();
 
@@ -497,12 +534,118 @@ void NETLIST_OBJECT_LIST::findBestNetNameForEachNet()
 }
 
 
+static uint64_t pointKey( const wxPoint& aPoint )
+{
+    return ( (uint64_t) (uint32_t) aPoint.x << 32 ) | (uint32_t) aPoint.y;
+}
+
+
+void NETLIST_OBJECT_LIST::buildConnectionIndex()
+{
+    std::map<SCH_SHEETS, unsigned> sheetIndexes;
+
+    m_itemSheets.clear();
+    m_sheetConnections.clear();
+    m_labels.clear();
+    m_netCodeParents.clear();
+    m_busNetCodeParents.clear();
+
+    for( unsigned ii = 0; ii < size(); ii++ )
+    {
+        NETLIST_OBJECT* item = GetItem( ii );
+        unsigned        sheetIndex;
+
+        // The list is sorted by sheet: most items are in the sheet of the previous item.
+        // Sheet paths are equal when they have the same sheets (see SCH_SHEET_PATH::operator==)
+        if( ii > 0 && item->m_SheetPath == GetItem( ii - 1 )->m_SheetPath )
+        {
+            sheetIndex = m_itemSheets.back();
+        }
+        else
+        {
+            auto sheetIt = sheetIndexes.insert( std::make_pair(
+                    (const SCH_SHEETS&) item->m_SheetPath, (unsigned) sheetIndexes.size() ) ).first;
+
+            sheetIndex = sheetIt->second;
+
+            if( sheetIndex == m_sheetConnections.size() )
+                m_sheetConnections.emplace_back();
+        }
+
+        m_itemSheets.push_back( sheetIndex );
+
+        SHEET_CONNECTIONS& sheet = m_sheetConnections[sheetIndex];
+
+        sheet.m_points[pointKey( item->m_Start )].push_back( ii );
+
+        if( item->m_End != item->m_Start )
+            sheet.m_points[pointKey( item->m_End )].push_back( ii );
+
+        if( item->m_Type == NET_SEGMENT || item->m_Type == NET_BUS )
+        {
+            if( item->m_Start.y == item->m_End.y )
+                sheet.m_hSegments[item->m_Start.y].push_back( ii );
+            else if( item->m_Start.x == item->m_End.x )
+                sheet.m_vSegments[item->m_Start.x].push_back( ii );
+            else
+                sheet.m_otherSegments.push_back( ii );
+        }
+
+        if( item->IsLabelType() )
+            m_labels[item->m_Label].push_back( ii );
+    }
+}
+
+
+int NETLIST_OBJECT_LIST::findNetCode( std::vector<int>& aParents, int aNetCode )
+{
+    // Codes which were never merged are not in the forest
+    int root = aNetCode;
+
+    while( root < (int) aParents.size() && aParents[root] != root )
+        root = aParents[root];
+
+    // Path compression: point the whole path to the root
+    while( aNetCode != root )
+    {
+        int next = aParents[aNetCode];
+        aParents[aNetCode] = root;
+        aNetCode = next;
+    }
+
+    return root;
+}
+
+
+int NETLIST_OBJECT_LIST::getNetCode( NETLIST_OBJECT* aItem )
+{
+    int code = findNetCode( m_netCodeParents, aItem->GetNet() );
+
+    aItem->SetNet( code );
+    return code;
+}
+
+
+int NETLIST_OBJECT_LIST::getBusNetCode( NETLIST_OBJECT* aItem )
+{
+    int code = findNetCode( m_busNetCodeParents, aItem->m_BusNetCode );
+
+    aItem->m_BusNetCode = code;
+    return code;
+}
+
+
 void NETLIST_OBJECT_LIST::sheetLabelConnect( NETLIST_OBJECT* SheetLabel )
 {
-    if( SheetLabel->GetNet() == 0 )
+    if( getNetCode( SheetLabel ) == 0 )
         return;
 
-    for( unsigned ii = 0; ii < size(); ii++ )
+    auto labelIt = m_labels.find( SheetLabel->m_Label );
+
+    if( labelIt == m_labels.end() )
+        return;     // no hierarchical label with this name
+
+    for( unsigned ii : labelIt->second )
     {
         NETLIST_OBJECT* ObjetNet = GetItem( ii );
 
@@ -512,17 +655,14 @@ void NETLIST_OBJECT_LIST::sheetLabelConnect( NETLIST_OBJECT* SheetLabel )
         if( (ObjetNet->m_Type != NET_HIERLABEL ) && (ObjetNet->m_Type != NET_HIERBUSLABELMEMBER ) )
             continue;
 
-        if( ObjetNet->GetNet() == SheetLabel->GetNet() )
+        if( getNetCode( ObjetNet ) == getNetCode( SheetLabel ) )
             continue;  //already connected.
 
-        if( ObjetNet->m_Label != SheetLabel->m_Label )
-            continue;  //different names.
-
         // Propagate Netcode having all the objects of the same Netcode.
-        if( ObjetNet->GetNet() )
-            propagateNetCode( ObjetNet->GetNet(), SheetLabel->GetNet(), IS_WIRE );
+        if( getNetCode( ObjetNet ) )
+            propagateNetCode( getNetCode( ObjetNet ), getNetCode( SheetLabel ), IS_WIRE );
         else
-            ObjetNet->SetNet( SheetLabel->GetNet() );
+            ObjetNet->SetNet( getNetCode( SheetLabel ) );
     }
 }
 
@@ -532,39 +672,53 @@ void NETLIST_OBJECT_LIST::connectBusLabels()
     // Propagate the net code between all bus label member objects connected by they name.
     // If the net code is not yet existing, a new one is created
     // Search is done in the entire list
+    //
+    // The members are grouped by bus net code and member number: after the first member
+    // of a group, all the members of the group have the same net code, so the following
+    // ones have nothing to do.
+    std::map<std::pair<int, int>, std::vector<unsigned>> groups;
+
     for( unsigned ii = 0; ii < size(); ii++ )
     {
         NETLIST_OBJECT* Label = GetItem( ii );
 
         if( Label->IsLabelBusMemberType() )
-        {
-            if( Label->GetNet() == 0 )
-            {
-                // Not yet existiing net code: create a new one.
-                Label->SetNet( m_lastNetCode );
-                m_lastNetCode++;
-            }
+            groups[std::make_pair( getBusNetCode( Label ), Label->m_Member )].push_back( ii );
+    }
 
-            for( unsigned jj = ii + 1; jj < size(); jj++ )
-            {
-                NETLIST_OBJECT* LabelInTst =  GetItem( jj );
+    for( unsigned ii = 0; ii < size(); ii++ )
+    {
+        NETLIST_OBJECT* Label = GetItem( ii );
 
-                if( LabelInTst->IsLabelBusMemberType() )
-                {
-                    if( LabelInTst->m_BusNetCode != Label->m_BusNetCode )
-                        continue;
+        if( !Label->IsLabelBusMemberType() )
+            continue;
 
-                    if( LabelInTst->m_Member != Label->m_Member )
-                        continue;
+        const std::vector<unsigned>& group = groups[std::make_pair( getBusNetCode( Label ),
+                                                                    Label->m_Member )];
 
-                    if( LabelInTst->GetNet() == 0 )
-                        // Append this object to the current net
-                        LabelInTst->SetNet( Label->GetNet() );
-                    else
-                        // Merge the 2 net codes, they are connected.
-                        propagateNetCode( LabelInTst->GetNet(), Label->GetNet(), IS_WIRE );
-                }
-            }
+        if( group.front() != ii )
+            continue;
+
+        if( getNetCode( Label ) == 0 )
+        {
+            // Not yet existiing net code: create a new one.
+            Label->SetNet( m_lastNetCode );
+            m_lastNetCode++;
+        }
+
+        for( unsigned jj : group )
+        {
+            if( jj == ii )
+                continue;
+
+            NETLIST_OBJECT* LabelInTst =  GetItem( jj );
+
+            if( getNetCode( LabelInTst ) == 0 )
+                // Append this object to the current net
+                LabelInTst->SetNet( getNetCode( Label ) );
+            else
+                // Merge the 2 net codes, they are connected.
+                propagateNetCode( getNetCode( LabelInTst ), getNetCode( Label ), IS_WIRE );
         }
     }
 }
@@ -575,39 +729,56 @@ void NETLIST_OBJECT_LIST::propagateNetCode( int aOldNetCode, int aNewNetCode, bo
     if( aOldNetCode == aNewNetCode )
         return;
 
-    if( aIsBus == false )    // Propagate NetCode
-    {
-        for( unsigned jj = 0; jj < size(); jj++ )
-        {
-            NETLIST_OBJECT* object = GetItem( jj );
+    std::vector<int>& parents = aIsBus ? m_busNetCodeParents : m_netCodeParents;
 
-            if( object->GetNet() == aOldNetCode )
-                object->SetNet( aNewNetCode );
-        }
-    }
-    else               // Propagate BusNetCode
+    int oldRoot = findNetCode( parents, aOldNetCode );
+    int newRoot = findNetCode( parents, aNewNetCode );
+
+    if( oldRoot == newRoot )
+        return;
+
+    if( oldRoot >= (int) parents.size() )
     {
-        for( unsigned jj = 0; jj < size(); jj++ )
-        {
-            NETLIST_OBJECT* object = GetItem( jj );
+        int first = parents.size();
 
-            if( object->m_BusNetCode == aOldNetCode )
-                object->m_BusNetCode = aNewNetCode;
-        }
+        parents.resize( oldRoot + 1 );
+        std::iota( parents.begin() + first, parents.end(), first );
     }
+
+    // All the items of the old net now have the new net code
+    parents[oldRoot] = newRoot;
 }
 
 
 void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, int start )
 {
+    const SHEET_CONNECTIONS& sheet = m_sheetConnections[m_itemSheets[start]];
+
+    // Items connected to the start or the end of aRef, in list order
+    std::vector<unsigned> candidates;
+
+    for( const wxPoint& point : { aRef->m_Start, aRef->m_End } )
+    {
+        auto it = sheet.m_points.find( pointKey( point ) );
+
+        if( it != sheet.m_points.end() )
+            candidates.insert( candidates.end(), it->second.begin(), it->second.end() );
+    }
+
+    std::sort( candidates.begin(), candidates.end() );
+    candidates.erase( std::unique( candidates.begin(), candidates.end() ), candidates.end() );
+
     int netCode;
 
     if( aIsBus == false )    // Objects other than BUS and BUSLABELS
     {
-        netCode = aRef->GetNet();
+        netCode = getNetCode( aRef );
 
-        for( unsigned i = start; i < size(); i++ )
+        for( unsigned i : candidates )
         {
+            if( i < (unsigned) start )
+                continue;
+
             NETLIST_OBJECT* item = GetItem( i );
 
             if( item->m_SheetPath != aRef->m_SheetPath )  //used to be > (why?)
@@ -629,10 +800,10 @@ void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus
                     || aRef->m_End   == item->m_Start
                     || aRef->m_End   == item->m_End )
                 {
-                    if( item->GetNet() == 0 )
+                    if( getNetCode( item ) == 0 )
                         item->SetNet( netCode );
                     else
-                        propagateNetCode( item->GetNet(), netCode, IS_WIRE );
+                        propagateNetCode( getNetCode( item ), netCode, IS_WIRE );
                 }
                 break;
 
@@ -648,10 +819,13 @@ void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus
     }
     else    // Object type BUS, BUSLABELS, and junctions.
     {
-        netCode = aRef->m_BusNetCode;
+        netCode = getBusNetCode( aRef );
 
-        for( unsigned i = start; i < size(); i++ )
+        for( unsigned i : candidates )
         {
+            if( i < (unsigned) start )
+                continue;
+
             NETLIST_OBJECT* item = GetItem( i );
 
             if( item->m_SheetPath != aRef->m_SheetPath )
@@ -681,10 +855,10 @@ void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus
                   || aRef->m_End   == item->m_Start
                   || aRef->m_End   == item->m_End )
                 {
-                    if( item->m_BusNetCode == 0 )
+                    if( getBusNetCode( item ) == 0 )
                         item->m_BusNetCode = netCode;
                     else
-                        propagateNetCode( item->m_BusNetCode, netCode, IS_BUS );
+                        propagateNetCode( getBusNetCode( item ), netCode, IS_BUS );
                 }
                 break;
             }
@@ -696,8 +870,29 @@ void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus
 void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction,
                                                  bool aIsBus, int aIdxStart )
 {
-    for( unsigned i = aIdxStart; i < size(); i++ )
+    const SHEET_CONNECTIONS& sheet = m_sheetConnections[m_itemSheets[aIdxStart]];
+    const wxPoint&           pos = aJonction->m_Start;
+
+    // The segments which can go through the junction, in list order
+    std::vector<unsigned> candidates( sheet.m_otherSegments );
+
+    auto hIt = sheet.m_hSegments.find( pos.y );
+
+    if( hIt != sheet.m_hSegments.end() )
+        candidates.insert( candidates.end(), hIt->second.begin(), hIt->second.end() );
+
+    auto vIt = sheet.m_vSegments.find( pos.x );
+
+    if( vIt != sheet.m_vSegments.end() )
+        candidates.insert( candidates.end(), vIt->second.begin(), vIt->second.end() );
+
+    std::sort( candidates.begin(), candidates.end() );
+
+    for( unsigned i : candidates )
     {
+        if( i < (unsigned) aIdxStart )
+            continue;
+
         NETLIST_OBJECT* segment = GetItem( i );
 
         // if different sheets, obviously no physical connection between elements.
@@ -720,17 +915,17 @@ void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction,
             // Propagation Netcode has all the objects of the same Netcode.
             if( aIsBus == IS_WIRE )
             {
-                if( segment->GetNet() )
-                    propagateNetCode( segment->GetNet(), aJonction->GetNet(), aIsBus );
+                if( getNetCode( segment ) )
+                    propagateNetCode( getNetCode( segment ), getNetCode( aJonction ), aIsBus );
                 else
-                    segment->SetNet( aJonction->GetNet() );
+                    segment->SetNet( getNetCode( aJonction ) );
             }
             else
             {
-                if( segment->m_BusNetCode )
-                    propagateNetCode( segment->m_BusNetCode, aJonction->m_BusNetCode, aIsBus );
+                if( getBusNetCode( segment ) )
+                    propagateNetCode( getBusNetCode( segment ), getBusNetCode( aJonction ), aIsBus );
                 else
-                    segment->m_BusNetCode = aJonction->m_BusNetCode;
+                    segment->m_BusNetCode = getBusNetCode( aJonction );
             }
         }
     }
@@ -739,14 +934,20 @@ void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction,
 
 void NETLIST_OBJECT_LIST::labelConnect( NETLIST_OBJECT* aLabelRef )
 {
-    if( aLabelRef->GetNet() == 0 )
+    if( getNetCode( aLabelRef ) == 0 )
+        return;
+
+    // Only the labels having the same text can be connected
+    auto labelIt = m_labels.find( aLabelRef->m_Label );
+
+    if( labelIt == m_labels.end() )
         return;
 
-    for( unsigned i = 0; i < size(); i++ )
+    for( unsigned i : labelIt->second )
     {
         NETLIST_OBJECT* item = GetItem( i );
 
-        if( item->GetNet() == aLabelRef->GetNet() )
+        if( getNetCode( item ) == getNetCode( aLabelRef ) )
             continue;
 
         if( item->m_SheetPath != aLabelRef->m_SheetPath )
@@ -766,16 +967,10 @@ void NETLIST_OBJECT_LIST::labelConnect( NETLIST_OBJECT* aLabelRef )
         // NET_LABEL are local to a sheet
         // NET_GLOBLABEL are global.
         // NET_PINLABEL is a kind of global label (generated by a power pin invisible)
-        if( item->IsLabelType() )
-        {
-            if( item->m_Label != aLabelRef->m_Label )
-                continue;
-
-            if( item->GetNet() )
-                propagateNetCode( item->GetNet(), aLabelRef->GetNet(), IS_WIRE );
-            else
-                item->SetNet( aLabelRef->GetNet() );
-        }
+        if( getNetCode( item ) )
+            propagateNetCode( getNetCode( item ), getNetCode( aLabelRef ), IS_WIRE );
+        else
+            item->SetNet( getNetCode( aLabelRef ) );
     }
 }
 
@@ -44,6 +44,7 @@
 #include <netlist.h>
 #include <lib_pin.h>
 #include <class_library.h>
+#include <netlist_cache.h>
 #include <sch_edit_frame.h>
 #include <sch_component.h>
 #include <symbol_lib_table.h>
@@ -374,6 +375,7 @@ SCH_EDIT_FRAME::SCH_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ):
     m_showAxis = false;                 // true to show axis
     m_showBorderAndTitleBlock = true;   // true to show sheet references
     m_CurrentSheet = new SCH_SHEET_PATH;
+    m_netListCache = new NETLIST_CACHE;
     m_DefaultSchematicFileName = NAMELESS_PROJECT;
     m_DefaultSchematicFileName += wxT( ".sch" );
     m_showAllPins = false;
@@ -463,6 +465,7 @@ SCH_EDIT_FRAME::~SCH_EDIT_FRAME()
 
     delete m_CurrentSheet;          // a SCH_SHEET_PATH, on the heap.
     delete m_undoItem;
+    delete m_netListCache;
     delete m_findReplaceData;
     delete m_findReplaceStatus;
 
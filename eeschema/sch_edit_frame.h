@@ -58,6 +58,7 @@ class SCH_SHEET_PATH;
 class SCH_SHEET_PIN;
 class SCH_COMPONENT;
 class SCH_FIELD;
+class NETLIST_CACHE;
 class LIB_PIN;
 class SCH_JUNCTION;
 class DIALOG_SCH_FIND;
@@ -137,6 +138,7 @@ private:
     SCH_COLLECTOR           m_collectedItems;     ///< List of collected items.
     SCH_FIND_COLLECTOR      m_foundItems;         ///< List of find/replace items.
     SCH_ITEM*               m_undoItem;           ///< Copy of the current item being edited.
+    NETLIST_CACHE*          m_netListCache;       ///< Connected items of the last netlist build.
     wxString                m_simulatorCommand;   ///< Command line used to call the circuit
                                                   ///< simulator (gnucap, spice, ...)
     wxString                m_netListerCommand;   ///< Command line to call a custom net list
@@ -503,6 +505,9 @@ public:
     /**
      * Create a flat list which stores all connected objects.
      *
+     * Only the sheets modified since the previous call are read again, and the connections
+     * are resolved again only if a sheet was modified (see NETLIST_CACHE).
+     *
      * @param updateStatusText decides if window StatusText should be modified.
      * @return NETLIST_OBJECT_LIST* - caller owns the object.
      */
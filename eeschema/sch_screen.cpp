@@ -90,12 +90,17 @@ static GRID_TYPE SchematicGridList[] = {
 };
 
 
+/// The last revision given to the connections of a screen
+static unsigned long long s_lastConnectivityRevision = 0;
+
+
 SCH_SCREEN::SCH_SCREEN( KIWAY* aKiway ) :
     BASE_SCREEN( SCH_SCREEN_T ),
     KIWAY_HOLDER( aKiway ),
     m_paper( wxT( "A4" ) )
 {
     m_modification_sync = 0;
+    SetConnectivityDirty();
 
     SetZoom( 32 );
 
@@ -130,6 +135,12 @@ SCH_SCREEN::~SCH_SCREEN()
 }
 
 
+void SCH_SCREEN::SetConnectivityDirty()
+{
+    m_connectivityRevision = ++s_lastConnectivityRevision;
+}
+
+
 void SCH_SCREEN::IncRefCount()
 {
     m_refCount++;
@@ -155,6 +166,8 @@ void SCH_SCREEN::Append( SCH_SCREEN* aScreen )
     // This screen owns the objects now.  This prevents the object from being delete when
     // aSheet is deleted.
     aScreen->m_drawList.SetOwnership( false );
+
+    SetConnectivityDirty();
 }
 
 
@@ -172,12 +185,16 @@ void SCH_SCREEN::Clear()
 void SCH_SCREEN::FreeDrawList()
 {
     m_drawList.DeleteAll();
+    SetConnectivityDirty();
 }
 
 
 void SCH_SCREEN::Remove( SCH_ITEM* aItem )
 {
     m_drawList.Remove( aItem );
+
+    if( aItem->Type() != SCH_MARKER_T )
+        SetConnectivityDirty();
 }
 
 
@@ -494,6 +511,9 @@ void SCH_SCREEN::UpdateSymbolLinks( bool aForce )
             SCH_COMPONENT::ResolveAll( c, *libs, Prj().SchLibs()->GetCacheLibrary() );
 
             m_modification_sync = mod_hash;     // note the last mod_hash
+
+            // The pins of the components can have changed
+            SetConnectivityDirty();
         }
         // Resolving will update the pin caches but we must ensure that this happens
         // even if the libraries don't change.
@@ -719,6 +739,9 @@ void SCH_SCREEN::ClearAnnotation( SCH_SHEET_PATH* aSheetPath )
             component->ClearFlags();
         }
     }
+
+    // The unit selection of the components can have changed
+    SetConnectivityDirty();
 }
 
 
@@ -95,6 +95,9 @@ private:
     int     m_modification_sync;        ///< inequality with PART_LIBS::GetModificationHash()
                                         ///< will trigger ResolveAll().
 
+    unsigned long long m_connectivityRevision;  ///< changes when the connections can change,
+                                                ///< unique over all the screens.
+
     /**
      * Add items connected at \a aPosition to the block pick list.
      * <p>
@@ -163,6 +166,10 @@ public:
     {
         m_drawList.Append( aItem );
         --m_modification_sync;
+
+        // Markers are added by the ERC, they do not change the connections
+        if( aItem->Type() != SCH_MARKER_T )
+            SetConnectivityDirty();
     }
 
     /**
@@ -186,6 +193,33 @@ public:
     {
         m_drawList.Append( aList );
         --m_modification_sync;
+        SetConnectivityDirty();
+    }
+
+    /**
+     * Function GetConnectivityRevision
+     * @return the revision of the connections of the screen items.  It changes each time
+     * the items which can be connected, or their connections, can have changed, and two
+     * screens never have the same revision: so the netlist items built from a screen
+     * can be kept until its revision changes (see NETLIST_CACHE).
+     */
+    unsigned long long GetConnectivityRevision() const { return m_connectivityRevision; }
+
+    /**
+     * Function SetConnectivityDirty
+     * gives a new revision to the connections of the screen items, to be called after
+     * each change of the items (SetModify() calls it).
+     */
+    void SetConnectivityDirty();
+
+    /**
+     * Marks the screen as modified, and gives a new revision to its connections: the edits
+     * which move or change an item in place only call SetModify()
+     */
+    void SetModify() override
+    {
+        BASE_SCREEN::SetModify();
+        SetConnectivityDirty();
     }
 
     /**
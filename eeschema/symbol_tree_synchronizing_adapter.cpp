@@ -168,6 +168,7 @@ void SYMBOL_TREE_SYNCHRONIZING_ADAPTER::updateLibrary( LIB_TREE_NODE_LIB& aLibNo
             {
                 // node does not exist in the library manager, remove the corresponding node
                 nodeIt = aLibNode.Children.erase( nodeIt );
+                aLibNode.InvalidateSearchIndex();
             }
         }
 
@@ -186,6 +187,8 @@ LIB_TREE_NODE::PTR_VECTOR::iterator SYMBOL_TREE_SYNCHRONIZING_ADAPTER::deleteLib
 {
     LIB_TREE_NODE* node = aLibNodeIt->get();
     m_libHashes.erase( node->Name );
+
+    // the search index is kept by the library node: it is deleted with it
     auto it = m_tree.Children.erase( aLibNodeIt );
     return it;
 }
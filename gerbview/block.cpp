@@ -208,14 +208,24 @@ void GERBVIEW_FRAME::Block_Move()
         if( gerber == NULL )    // Graphic layer not yet used
             continue;
 
-        /* Move items in block */
-        for( GERBER_DRAW_ITEM* item = gerber->GetItemsList(); item; item = item->Next() )
-        {
-            GERBER_DRAW_ITEM* gerb_item = item;
+        /* Move items in block: only the items whose bounding box intersects the block
+         * can have an end point inside it */
+        std::vector<GERBER_DRAW_ITEM*> moved;
 
-            if( gerb_item->HitTest( GetScreen()->m_BlockLocate ) )
-                gerb_item->MoveAB( delta );
-        }
+        gerber->GetItemIndex().Query( GetScreen()->m_BlockLocate,
+                [&]( GERBER_DRAW_ITEM* aItem ) -> bool
+                {
+                    if( aItem->HitTest( GetScreen()->m_BlockLocate ) )
+                        moved.push_back( aItem );
+
+                    return true;
+                } );
+
+        for( GERBER_DRAW_ITEM* item : moved )
+            item->MoveAB( delta );
+
+        if( !moved.empty() )
+            gerber->BuildItemIndex();
     }
 
     m_canvas->Refresh( true );
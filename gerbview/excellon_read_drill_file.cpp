@@ -252,10 +252,23 @@ bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName )
     if( gerber_layer )
         Erase_Current_DrawLayer( false );
 
-    EXCELLON_IMAGE* drill_layer = new EXCELLON_IMAGE( layerId );
+    // The file can be already read by preloadFiles()
+    GERBER_FILE_IMAGE* preloaded = takePreloadedImage( aFullFileName );
+    EXCELLON_IMAGE* drill_layer = dynamic_cast<EXCELLON_IMAGE*>( preloaded );
+    bool success = true;
 
-    // Read the Excellon drill file:
-    bool success = drill_layer->LoadFile( aFullFileName );
+    if( drill_layer )
+    {
+        drill_layer->m_GraphicLayer = layerId;
+    }
+    else
+    {
+        delete preloaded;   // Not read as a drill file
+        drill_layer = new EXCELLON_IMAGE( layerId );
+
+        // Read the Excellon drill file:
+        success = drill_layer->LoadFile( aFullFileName );
+    }
 
     if( !success )
     {
@@ -324,6 +337,9 @@ bool EXCELLON_IMAGE::LoadFile( const wxString & aFullFileName )
     if( m_Current_File == NULL )
         return false;
 
+    // Read the file in large chunks rather than in the small default buffer of the FILE
+    setvbuf( m_Current_File, NULL, _IOFBF, 1 << 20 );
+
     wxString msg;
     m_FileName = aFullFileName;
 
@@ -396,6 +412,8 @@ bool EXCELLON_IMAGE::LoadFile( const wxString & aFullFileName )
     delete m_FileFunction;
     m_FileFunction = new X2_ATTRIBUTE_FILEFUNCTION( dummy );
 
+    BuildItemIndex();
+
     m_InUse = true;
 
     return true;
@@ -673,8 +691,7 @@ bool EXCELLON_IMAGE::Execute_Drill_Command( char*& text )
                     return false;
                 }
 
-                gbritem = new GERBER_DRAW_ITEM( this );
-                m_Drawings.Append( gbritem );
+                gbritem = m_Drawings.Create( this );
 
                 if( m_SlotOn )  // Oblong hole
                 {
@@ -907,7 +924,7 @@ void EXCELLON_IMAGE::FinishRouteCommand()
 
     for( size_t ii = 1; ii < m_RoutePositions.size(); ii++ )
     {
-        GERBER_DRAW_ITEM* gbritem = new GERBER_DRAW_ITEM( this );
+        GERBER_DRAW_ITEM* gbritem = m_Drawings.Create( this );
 
         if( m_RoutePositions[ii].m_rmode == 0 )     // linear routing
         {
@@ -934,8 +951,6 @@ void EXCELLON_IMAGE::FinishRouteCommand()
                          false );
         }
 
-        m_Drawings.Append( gbritem );
-
         StepAndRepeatItem( *gbritem );
     }
 
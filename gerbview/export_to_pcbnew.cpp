@@ -260,7 +260,17 @@ bool GBR_TO_PCB_EXPORTER::ExportPcb( LAYER_NUM* aLayerLookUpTable, int aCopperLa
         GERBER_DRAW_ITEM* gerb_item = gerber->GetItemsList();
 
         for( ; gerb_item; gerb_item = gerb_item->Next() )
+        {
             export_non_copper_item( gerb_item, pcb_layer_number );
+
+            // The other instances of a step and repeat block are exported as moved copies
+            for( int ii = 1; ii < gerb_item->GetInstanceCount(); ++ii )
+            {
+                GERBER_DRAW_ITEM instance( *gerb_item );
+                instance.MoveXY( gerb_item->GetInstanceOffset( ii ) );
+                export_non_copper_item( &instance, pcb_layer_number );
+            }
+        }
     }
 
     // Copper layers
@@ -279,7 +289,17 @@ bool GBR_TO_PCB_EXPORTER::ExportPcb( LAYER_NUM* aLayerLookUpTable, int aCopperLa
         GERBER_DRAW_ITEM* gerb_item = gerber->GetItemsList();
 
         for( ; gerb_item; gerb_item = gerb_item->Next() )
+        {
             export_copper_item( gerb_item, pcb_layer_number );
+
+            // The other instances of a step and repeat block are exported as moved copies
+            for( int ii = 1; ii < gerb_item->GetInstanceCount(); ++ii )
+            {
+                GERBER_DRAW_ITEM instance( *gerb_item );
+                instance.MoveXY( gerb_item->GetInstanceOffset( ii ) );
+                export_copper_item( &instance, pcb_layer_number );
+            }
+        }
     }
 
     fprintf( m_fp, ")\n" );
@@ -22,6 +22,11 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+
 #include <fctsys.h>
 #include <wx/fs_zip.h>
 #include <wx/wfstream.h>
@@ -289,13 +294,29 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
     wxString msg;
     WX_STRING_REPORTER reporter( &msg );
 
-    // Show progress dialog after 1 second of loading
+    // Show progress dialog after 1 second of loading a single file
     static const long long progressShowDelay = 1000;
 
     auto startTime = wxGetUTCTimeMillis();
     std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
+    bool cancelled = false;
 
-    for( unsigned ii = 0; ii < aFilenameList.GetCount(); ii++ )
+    // Several files are read at the same time before being added to the image list: the
+    // progress of the reading is shown, as it takes most of the loading time
+    if( aFilenameList.GetCount() > 1 )
+    {
+        progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
+                        _( "Loading Gerber files..." ), 2, true );
+        progress->Report( _( "Loading Gerber files..." ) );
+        progress->KeepRefreshing();
+
+        cancelled = !preloadFiles( aPath, aFilenameList, aFileType, progress.get() );
+
+        progress->AdvancePhase();
+        progress->SetMaxProgress( aFilenameList.GetCount() );
+    }
+
+    for( unsigned ii = 0; ii < aFilenameList.GetCount() && !cancelled; ii++ )
     {
         filename = aFilenameList[ii];
 
@@ -321,9 +342,9 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
             progress->SetMaxProgress( aFilenameList.GetCount() - 1 );
             progress->Report( _("Loading Gerber files..." ) );
         }
-        else if( progress )
+        else if( progress && !progress->KeepRefreshing() )
         {
-            progress->KeepRefreshing();
+            break;
         }
 
         m_lastFileName = filename.GetFullPath();
@@ -379,6 +400,9 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
             progress->AdvanceProgress();
     }
 
+    // The files which were not loaded for lack of layers
+    clearPreloadedImages();
+
     if( !success )
     {
         wxSafeYield();  // Allows slice of time to redraw the screen
@@ -409,6 +433,156 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
 }
 
 
+bool GERBVIEW_FRAME::preloadFiles( const wxString& aPath, const wxArrayString& aFilenameList,
+                                   const std::vector<int>* aFileType,
+                                   PROGRESS_REPORTER* aProgress )
+{
+    clearPreloadedImages();
+
+    struct PRELOADED_FILE
+    {
+        wxString           m_fullFileName;
+        bool               m_isDrillFile;
+        GERBER_FILE_IMAGE* m_image;
+    };
+
+    std::vector<PRELOADED_FILE> files;
+
+    for( unsigned ii = 0; ii < aFilenameList.GetCount(); ii++ )
+    {
+        wxFileName filename = aFilenameList[ii];
+
+        if( !filename.IsAbsolute() )
+            filename.SetPath( aPath );
+
+        bool isDrillFile = aFileType && (*aFileType)[ii] == 1;
+
+        // Missing files and job files are reported by loadListOfGerberAndDrillFiles()
+        if( !filename.FileExists() )
+            continue;
+
+        if( !isDrillFile && filename.GetExt() == GerberJobFileExtension.c_str() )
+            continue;
+
+        files.push_back( PRELOADED_FILE{ filename.GetFullPath(), isDrillFile, nullptr } );
+    }
+
+    // A single file is read by Read_GERBER_File() or Read_EXCELLON_File()
+    if( files.size() < 2 )
+        return true;
+
+    aProgress->SetMaxProgress( files.size() );
+
+    size_t parallelThreadCount = std::max<size_t>( 1,
+            std::min<size_t>( std::thread::hardware_concurrency(), files.size() ) );
+
+    // setlocale() changes the locale of the whole process: switch to the C locale once
+    // for all the threads
+    LOCALE_IO toggle;
+
+    std::atomic<size_t> nextFile( 0 );
+    std::atomic<bool> cancelled( false );
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+    auto load_lambda = [&nextFile, &files, &cancelled, aProgress]() -> size_t
+    {
+        for( size_t i = nextFile++; i < files.size() && !cancelled; i = nextFile++ )
+        {
+            PRELOADED_FILE& file = files[i];
+
+            // The graphic layer is set when the image is added to the image list
+            bool               success;
+            GERBER_FILE_IMAGE* image;
+
+            if( file.m_isDrillFile )
+            {
+                EXCELLON_IMAGE* drill_layer = new EXCELLON_IMAGE( 0 );
+                image = drill_layer;
+                success = drill_layer->LoadFile( file.m_fullFileName );
+            }
+            else
+            {
+                image = new GERBER_FILE_IMAGE( 0 );
+                success = image->LoadGerberFile( file.m_fullFileName );
+            }
+
+            if( success )
+                file.m_image = image;
+            else
+                delete image;   // Read again (and reported) by loadListOfGerberAndDrillFiles()
+
+            aProgress->AdvanceProgress();
+        }
+
+        return 1;
+    };
+
+    // The files are read on worker threads, even when there is a single core: the main
+    // thread keeps the progress dialog alive, and stops the reading when it is cancelled
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii] = std::async( std::launch::async, load_lambda );
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+    {
+        while( returns[ii].wait_for( std::chrono::milliseconds( 50 ) )
+                != std::future_status::ready )
+        {
+            if( !cancelled && !aProgress->KeepRefreshing() )
+                cancelled = true;
+        }
+    }
+
+    for( PRELOADED_FILE& file : files )
+    {
+        if( !file.m_image )
+            continue;
+
+        if( cancelled )
+        {
+            delete file.m_image;
+            continue;
+        }
+
+        // A file given twice is read again by the second load
+        if( !m_preloadedImages.emplace( file.m_fullFileName, file.m_image ).second )
+            delete file.m_image;
+    }
+
+    // All the threads are done and the images are stored: an exception thrown by a load
+    // can be passed on
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+    {
+        if( returns[ii].valid() )
+            returns[ii].get();
+    }
+
+    return !cancelled;
+}
+
+
+GERBER_FILE_IMAGE* GERBVIEW_FRAME::takePreloadedImage( const wxString& aFullFileName )
+{
+    auto it = m_preloadedImages.find( aFullFileName );
+
+    if( it == m_preloadedImages.end() )
+        return nullptr;
+
+    GERBER_FILE_IMAGE* image = it->second;
+    m_preloadedImages.erase( it );
+
+    return image;
+}
+
+
+void GERBVIEW_FRAME::clearPreloadedImages()
+{
+    for( auto& entry : m_preloadedImages )
+        delete entry.second;
+
+    m_preloadedImages.clear();
+}
+
+
 bool GERBVIEW_FRAME::LoadExcellonFiles( const wxString& aFullFileName )
 {
     wxString   filetypes;
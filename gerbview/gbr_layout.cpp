@@ -383,10 +383,14 @@ void GBR_LAYOUT::DrawItemsDCodeID( EDA_DRAW_PANEL* aPanel, wxDC* aDC,
             int size_pixel = aDC->LogicalToDeviceXRel( size );
             const int threshold = 5;
 
-            if( size_pixel >= threshold )
+            if( size_pixel < threshold )
+                continue;
+
+            // Each instance of a step and repeat block shows its D code
+            for( int ii = 0; ii < item->GetInstanceCount(); ++ii )
             {
-                DrawGraphicText( aPanel->GetClipBox(), aDC, pos, aDrawColor, Line,
-                                 orient, wxSize( size, size ),
+                DrawGraphicText( aPanel->GetClipBox(), aDC, pos + item->GetABInstanceOffset( ii ),
+                                 aDrawColor, Line, orient, wxSize( size, size ),
                                  GR_TEXT_HJUSTIFY_CENTER, GR_TEXT_VJUSTIFY_CENTER,
                                  0, false, false );
             }
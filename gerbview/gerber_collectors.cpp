@@ -19,6 +19,10 @@
 
 #include "gerber_collectors.h"
 
+#include <gbr_layout.h>
+#include <gerber_file_image.h>
+#include <gerber_file_image_list.h>
+
 const KICAD_T GERBER_COLLECTOR::AllItems[] = {
     GERBER_IMAGE_LIST_T,
     GERBER_IMAGE_T,
@@ -62,7 +66,39 @@ void GERBER_COLLECTOR::Collect( EDA_ITEM* aItem, const KICAD_T aScanList[],
     // the Inspect() function.
     SetRefPos( aRefPos );
 
-    aItem->Visit( m_inspector, NULL, m_ScanTypes );
+    bool scanDrawItems = false;
+
+    for( const KICAD_T* p = m_ScanTypes; *p != EOT; ++p )
+    {
+        if( *p == GERBER_DRAW_ITEM_T )
+            scanDrawItems = true;
+    }
+
+    if( aItem->Type() == GERBER_LAYOUT_T && scanDrawItems )
+    {
+        // Only the items whose bounding box contains aRefPos can be hit:
+        // get them from the item index of each image
+        GERBER_FILE_IMAGE_LIST* images = static_cast<GBR_LAYOUT*>( aItem )->GetImagesList();
+
+        for( unsigned layer = 0; layer < images->ImagesMaxCount(); ++layer )
+        {
+            GERBER_FILE_IMAGE* gerber = images->GetGbrImage( layer );
+
+            if( gerber == NULL )    // Graphic layer not yet used
+                continue;
+
+            gerber->GetItemIndex().Query( aRefPos,
+                    [&]( GERBER_DRAW_ITEM* aGbrItem ) -> bool
+                    {
+                        Inspect( aGbrItem, NULL );
+                        return true;
+                    } );
+        }
+    }
+    else
+    {
+        aItem->Visit( m_inspector, NULL, m_ScanTypes );
+    }
 
     SetTimeNow();               // when snapshot was taken
 
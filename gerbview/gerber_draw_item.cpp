@@ -182,6 +182,16 @@ wxPoint GERBER_DRAW_ITEM::GetABPosition( const wxPoint& aXYPosition ) const
 }
 
 
+wxPoint GERBER_DRAW_ITEM::GetABInstanceOffset( int aIndex ) const
+{
+    if( aIndex == 0 )
+        return wxPoint( 0, 0 );
+
+    // The XY to AB transform is affine: an offset is transformed by its linear part
+    return GetABPosition( GetInstanceOffset( aIndex ) ) - GetABPosition( wxPoint( 0, 0 ) );
+}
+
+
 wxPoint GERBER_DRAW_ITEM::GetXYPosition( const wxPoint& aABPosition ) const
 {
     // do the inverse transform made by GetABPosition
@@ -284,6 +294,27 @@ D_CODE* GERBER_DRAW_ITEM::GetDcodeDescr() const
 
 
 const EDA_RECT GERBER_DRAW_ITEM::GetBoundingBox() const
+{
+    EDA_RECT bbox = GetShapeBoundingBox();
+
+    if( GetInstanceCount() == 1 )
+        return bbox;
+
+    // The other instances are translated copies of this item
+    EDA_RECT shapeBox = bbox;
+
+    for( int ii = 1; ii < GetInstanceCount(); ++ii )
+    {
+        EDA_RECT instanceBox = shapeBox;
+        instanceBox.Move( GetABInstanceOffset( ii ) );
+        bbox.Merge( instanceBox );
+    }
+
+    return bbox;
+}
+
+
+const EDA_RECT GERBER_DRAW_ITEM::GetShapeBoundingBox() const
 {
     // return a rectangle which is (pos,dim) in nature.  therefore the +1
     EDA_RECT bbox( m_Start, wxSize( 1, 1 ) );
@@ -452,6 +483,37 @@ bool GERBER_DRAW_ITEM::HasNegativeItems()
 
 void GERBER_DRAW_ITEM::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDrawMode,
                              const wxPoint& aOffset, GBR_DISPLAY_OPTIONS* aDrawOptions )
+{
+    if( GetInstanceCount() == 1 )
+    {
+        drawShape( aPanel, aDC, aDrawMode, aOffset, wxPoint( 0, 0 ), aDrawOptions );
+        return;
+    }
+
+    // The other instances of a step and repeat block are the same shape, drawn at their
+    // offset.  Only the instances inside the clip box are drawn
+    EDA_RECT* clipBox = aPanel->GetClipBox();
+    EDA_RECT  shapeBox = GetShapeBoundingBox();
+
+    for( int ii = 0; ii < GetInstanceCount(); ++ii )
+    {
+        if( clipBox )
+        {
+            EDA_RECT instanceBox = shapeBox;
+            instanceBox.Move( GetABInstanceOffset( ii ) );
+
+            if( !clipBox->Intersects( instanceBox ) )
+                continue;
+        }
+
+        drawShape( aPanel, aDC, aDrawMode, aOffset, GetInstanceOffset( ii ), aDrawOptions );
+    }
+}
+
+
+void GERBER_DRAW_ITEM::drawShape( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDrawMode,
+                                  const wxPoint& aOffset, const wxPoint& aInstanceOffset,
+                                  GBR_DISPLAY_OPTIONS* aDrawOptions )
 {
     // used when a D_CODE is not found. default D_CODE to draw a flashed item
     static D_CODE dummyD_CODE( 0 );
@@ -461,6 +523,11 @@ void GERBER_DRAW_ITEM::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDra
     static bool   show_err;
     D_CODE*       d_codeDescr = GetDcodeDescr();
 
+    // The positions of the drawn instance
+    wxPoint       start = m_Start + aInstanceOffset;
+    wxPoint       end = m_End + aInstanceOffset;
+    wxPoint       arcCentre = m_ArcCentre + aInstanceOffset;
+
     if( d_codeDescr == NULL )
         d_codeDescr = &dummyD_CODE;
 
@@ -493,25 +560,25 @@ void GERBER_DRAW_ITEM::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDra
         if( !isDark )
             isFilled = true;
 
-        DrawGbrPoly( aPanel->GetClipBox(), aDC, color, aOffset, isFilled );
+        DrawGbrPoly( aPanel->GetClipBox(), aDC, color, aOffset + aInstanceOffset, isFilled );
         break;
 
     case GBR_CIRCLE:
-        radius = KiROUND( GetLineLength( m_Start, m_End ) );
+        radius = KiROUND( GetLineLength( start, end ) );
 
         halfPenWidth = m_Size.x >> 1;
 
         if( !isFilled )
         {
             // draw the border of the pen's path using two circles, each as narrow as possible
-            GRCircle( aPanel->GetClipBox(), aDC, GetABPosition( m_Start ),
+            GRCircle( aPanel->GetClipBox(), aDC, GetABPosition( start ),
                       radius - halfPenWidth, 0, color );
-            GRCircle( aPanel->GetClipBox(), aDC, GetABPosition( m_Start ),
+            GRCircle( aPanel->GetClipBox(), aDC, GetABPosition( start ),
                       radius + halfPenWidth, 0, color );
         }
         else    // Filled mode
         {
-            GRCircle( aPanel->GetClipBox(), aDC, GetABPosition( m_Start ),
+            GRCircle( aPanel->GetClipBox(), aDC, GetABPosition( start ),
                       radius, m_Size.x, color );
         }
         break;
@@ -521,22 +588,22 @@ void GERBER_DRAW_ITEM::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDra
         // a round pen only is expected.
 
 #if 0   // for arc debug only
-        GRLine( aPanel->GetClipBox(), aDC, GetABPosition( m_Start ),
-                GetABPosition( m_ArcCentre ), 0, color );
-        GRLine( aPanel->GetClipBox(), aDC, GetABPosition( m_End ),
-                GetABPosition( m_ArcCentre ), 0, color );
+        GRLine( aPanel->GetClipBox(), aDC, GetABPosition( start ),
+                GetABPosition( arcCentre ), 0, color );
+        GRLine( aPanel->GetClipBox(), aDC, GetABPosition( end ),
+                GetABPosition( arcCentre ), 0, color );
 #endif
 
         if( !isFilled )
         {
-            GRArc1( aPanel->GetClipBox(), aDC, GetABPosition( m_Start ),
-                    GetABPosition( m_End ), GetABPosition( m_ArcCentre ),
+            GRArc1( aPanel->GetClipBox(), aDC, GetABPosition( start ),
+                    GetABPosition( end ), GetABPosition( arcCentre ),
                     0, color );
         }
         else
         {
-            GRArc1( aPanel->GetClipBox(), aDC, GetABPosition( m_Start ),
-                    GetABPosition( m_End ), GetABPosition( m_ArcCentre ),
+            GRArc1( aPanel->GetClipBox(), aDC, GetABPosition( start ),
+                    GetABPosition( end ), GetABPosition( arcCentre ),
                     m_Size.x, color );
         }
 
@@ -549,7 +616,7 @@ void GERBER_DRAW_ITEM::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDra
     case GBR_SPOT_MACRO:
         isFilled = aDrawOptions->m_DisplayFlashedItemsFill;
         d_codeDescr->DrawFlashedShape( this, aPanel->GetClipBox(), aDC, color,
-                                       m_Start, isFilled );
+                                       start, isFilled );
         break;
 
     case GBR_SEGMENT:
@@ -563,19 +630,19 @@ void GERBER_DRAW_ITEM::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDra
             if( m_Polygon.OutlineCount() == 0 )
                 ConvertSegmentToPolygon();
 
-            DrawGbrPoly( aPanel->GetClipBox(), aDC, color, aOffset, isFilled );
+            DrawGbrPoly( aPanel->GetClipBox(), aDC, color, aOffset + aInstanceOffset, isFilled );
         }
         else
         {
             if( !isFilled )
             {
-                    GRCSegm( aPanel->GetClipBox(), aDC, GetABPosition( m_Start ),
-                             GetABPosition( m_End ), m_Size.x, color );
+                    GRCSegm( aPanel->GetClipBox(), aDC, GetABPosition( start ),
+                             GetABPosition( end ), m_Size.x, color );
             }
             else
             {
-                GRFilledSegment( aPanel->GetClipBox(), aDC, GetABPosition( m_Start ),
-                                 GetABPosition( m_End ), m_Size.x, color );
+                GRFilledSegment( aPanel->GetClipBox(), aDC, GetABPosition( start ),
+                                 GetABPosition( end ), m_Size.x, color );
             }
         }
 
@@ -806,6 +873,18 @@ BITMAP_DEF GERBER_DRAW_ITEM::GetMenuImage() const
 
 
 bool GERBER_DRAW_ITEM::HitTest( const wxPoint& aRefPos ) const
+{
+    for( int ii = 0; ii < GetInstanceCount(); ++ii )
+    {
+        if( hitTestShape( aRefPos - GetABInstanceOffset( ii ) ) )
+            return true;
+    }
+
+    return false;
+}
+
+
+bool GERBER_DRAW_ITEM::hitTestShape( const wxPoint& aRefPos ) const
 {
     // In case the item has a very tiny width defined, allow it to be selected
     const int MIN_HIT_TEST_RADIUS = Millimeter2iu( 0.01 );
@@ -827,11 +906,11 @@ bool GERBER_DRAW_ITEM::HitTest( const wxPoint& aRefPos ) const
         return poly.Contains( VECTOR2I( ref_pos ), 0 );
 
     case GBR_SPOT_RECT:
-        return GetBoundingBox().Contains( aRefPos );
+        return GetShapeBoundingBox().Contains( aRefPos );
 
     case GBR_SPOT_OVAL:
         {
-        EDA_RECT bbox = GetBoundingBox();
+        EDA_RECT bbox = GetShapeBoundingBox();
 
             if( ! bbox.Contains( aRefPos ) )
                 return false;
@@ -925,15 +1004,19 @@ bool GERBER_DRAW_ITEM::HitTest( const wxPoint& aRefPos ) const
 
 bool GERBER_DRAW_ITEM::HitTest( const EDA_RECT& aRefArea ) const
 {
-    wxPoint pos = GetABPosition( m_Start );
+    wxPoint start = GetABPosition( m_Start );
+    wxPoint end = GetABPosition( m_End );
 
-    if( aRefArea.Contains( pos ) )
-        return true;
+    for( int ii = 0; ii < GetInstanceCount(); ++ii )
+    {
+        wxPoint offset = GetABInstanceOffset( ii );
 
-    pos = GetABPosition( m_End );
+        if( aRefArea.Contains( start + offset ) )
+            return true;
 
-    if( aRefArea.Contains( pos ) )
-        return true;
+        if( aRefArea.Contains( end + offset ) )
+            return true;
+    }
 
     return false;
 }
@@ -29,6 +29,9 @@
 #ifndef GERBER_DRAW_ITEM_H
 #define GERBER_DRAW_ITEM_H
 
+#include <memory>
+#include <vector>
+
 #include <base_struct.h>
 #include <dlist.h>
 #include <layers_id_colors_and_visibility.h>
@@ -68,7 +71,9 @@ enum Gbr_Basic_Shapes {
 class GERBER_DRAW_ITEM : public EDA_ITEM
 {
     // make SetNext() and SetBack() private so that they may not be called from anywhere.
-    // list management is done on GERBER_DRAW_ITEMs using DLIST<GERBER_DRAW_ITEM> only.
+    // list management is done on GERBER_DRAW_ITEMs using GERBER_DRAW_ITEM_STORE only.
+    friend class GERBER_DRAW_ITEM_STORE;
+
 private:
     void SetNext( EDA_ITEM* aNext )       { Pnext = aNext; }
     void SetBack( EDA_ITEM* aBack )       { Pback = aBack; }
@@ -118,6 +123,10 @@ private:
     GBR_NETLIST_METADATA m_netAttributes;   ///< the string given by a %TO attribute set in aperture
                                             ///< (dcode). Stored in each item, because %TO is
                                             ///< a dynamic object attribute
+    std::shared_ptr<const std::vector<wxPoint>> m_repeatOffsets;
+                                            ///< the offsets (in XY gerber axis) of the other
+                                            ///< instances of this item, when it is in a step and
+                                            ///< repeat block.  Shared by all the block items
 
 public:
     GERBER_DRAW_ITEM( GERBER_FILE_IMAGE* aGerberparams );
@@ -129,6 +138,41 @@ public:
     void SetNetAttributes( const GBR_NETLIST_METADATA& aNetAttributes );
     const GBR_NETLIST_METADATA& GetNetAttributes() const { return m_netAttributes; }
 
+    /**
+     * Function SetRepeatOffsets
+     * makes this item the base of the instances of a step and repeat block.
+     * @param aOffsets = the offsets of the other instances from this item, in XY gerber axis
+     */
+    void SetRepeatOffsets( const std::shared_ptr<const std::vector<wxPoint>>& aOffsets )
+    {
+        m_repeatOffsets = aOffsets;
+    }
+
+    /**
+     * Function GetInstanceCount
+     * @return the number of times this item is drawn: 1, or the number of copies of its
+     * step and repeat block.  The instance 0 is the item itself.
+     */
+    int GetInstanceCount() const
+    {
+        return m_repeatOffsets ? (int) m_repeatOffsets->size() + 1 : 1;
+    }
+
+    /**
+     * Function GetInstanceOffset
+     * @return the offset of the instance aIndex from this item, in XY gerber axis
+     */
+    wxPoint GetInstanceOffset( int aIndex ) const
+    {
+        return aIndex == 0 ? wxPoint( 0, 0 ) : (*m_repeatOffsets)[aIndex - 1];
+    }
+
+    /**
+     * Function GetABInstanceOffset
+     * @return the offset of the instance aIndex from this item, in A,B plotter axis
+     */
+    wxPoint GetABInstanceOffset( int aIndex ) const;
+
     /**
      * Function GetLayer
      * returns the layer this item is on.
@@ -234,9 +278,20 @@ public:
      */
     D_CODE* GetDcodeDescr() const;
 
+    /**
+     * Function GetBoundingBox
+     * @return the bounding box of all the instances of this item
+     */
     const EDA_RECT GetBoundingBox() const override;
 
-    /* Display on screen: */
+    /**
+     * Function GetShapeBoundingBox
+     * @return the bounding box of this item, without the other instances of its step and
+     * repeat block
+     */
+    const EDA_RECT GetShapeBoundingBox() const;
+
+    /* Display on screen (the instances inside the clip box): */
     void Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC,
                GR_DRAWMODE aDrawMode, const wxPoint&aOffset, GBR_DISPLAY_OPTIONS* aDrawOptions );
 
@@ -264,7 +319,7 @@ public:
 
     /**
      * Function HitTest
-     * tests if the given wxPoint is within the bounds of this object.
+     * tests if the given wxPoint is within the bounds of one of the instances of this object.
      * @param aRefPos a wxPoint to test
      * @return bool - true if a hit, else false
      */
@@ -272,7 +327,7 @@ public:
 
     /**
      * Function HitTest (overloaded)
-     * tests if the given wxRect intersect this object.
+     * tests if the given wxRect intersect one of the instances of this object.
      * For now, an ending point must be inside this rect.
      * @param aRefArea a wxPoint to test
      * @return bool - true if a hit, else false
@@ -289,28 +344,6 @@ public:
         return wxT( "GERBER_DRAW_ITEM" );
     }
 
-    /**
-     * Function UnLink
-     * detaches this object from its owner.
-     */
-    void UnLink()
-    {
-        DLIST<GERBER_DRAW_ITEM>* list = (DLIST<GERBER_DRAW_ITEM>*) GetList();
-        wxASSERT( list );
-
-        if( list )
-            list->Remove( this );
-    }
-
-    /**
-     * Function DeleteStructure
-     * deletes this object after UnLink()ing it from its owner.
-     */
-    void DeleteStructure()
-    {
-        UnLink();
-        delete this;
-    }
 #if defined(DEBUG)
     void Show( int nestLevel, std::ostream& os ) const override;
 #endif
@@ -332,6 +365,15 @@ public:
 
     ///> @copydoc EDA_ITEM::GetMenuImage()
     BITMAP_DEF GetMenuImage() const override;
+
+private:
+    /// Draws the instance of this item at aInstanceOffset (in XY gerber axis, see Draw())
+    void drawShape( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDrawMode,
+                    const wxPoint& aOffset, const wxPoint& aInstanceOffset,
+                    GBR_DISPLAY_OPTIONS* aDrawOptions );
+
+    /// Tests if aRefPos is inside the instance 0 of this item (see HitTest())
+    bool hitTestShape( const wxPoint& aRefPos ) const;
 };
 
 
@@ -0,0 +1,127 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file gerber_draw_item_store.cpp
+ */
+
+#include <fctsys.h>
+
+#include <gerber_draw_item_store.h>
+
+
+GERBER_DRAW_ITEM_STORE::GERBER_DRAW_ITEM_STORE() :
+    m_lastChunkCount( 0 ),
+    m_first( nullptr ),
+    m_last( nullptr ),
+    m_count( 0 )
+{
+}
+
+
+GERBER_DRAW_ITEM_STORE::~GERBER_DRAW_ITEM_STORE()
+{
+    DeleteAll();
+}
+
+
+void* GERBER_DRAW_ITEM_STORE::allocate()
+{
+    if( m_chunks.empty() || m_lastChunkCount == CHUNK_SIZE )
+    {
+        m_chunks.emplace_back( new SLOT[CHUNK_SIZE] );
+        m_lastChunkCount = 0;
+    }
+
+    return &m_chunks.back()[m_lastChunkCount++];
+}
+
+
+GERBER_DRAW_ITEM* GERBER_DRAW_ITEM_STORE::append( GERBER_DRAW_ITEM* aItem )
+{
+    // A copied item has the links of its model: chain it again
+    aItem->SetList( nullptr );
+    aItem->SetNext( nullptr );
+    aItem->SetBack( m_last );
+
+    if( m_last )
+        m_last->SetNext( aItem );
+    else
+        m_first = aItem;
+
+    m_last = aItem;
+    m_count++;
+
+    return aItem;
+}
+
+
+GERBER_DRAW_ITEM* GERBER_DRAW_ITEM_STORE::Create( GERBER_FILE_IMAGE* aGerberImageFile )
+{
+    void* mem = allocate();
+
+    try
+    {
+        return append( new( mem ) GERBER_DRAW_ITEM( aGerberImageFile ) );
+    }
+    catch( ... )
+    {
+        // The slot is not built: give it back
+        m_lastChunkCount--;
+        throw;
+    }
+}
+
+
+GERBER_DRAW_ITEM* GERBER_DRAW_ITEM_STORE::Create( const GERBER_DRAW_ITEM& aItem )
+{
+    void* mem = allocate();
+
+    try
+    {
+        return append( new( mem ) GERBER_DRAW_ITEM( aItem ) );
+    }
+    catch( ... )
+    {
+        m_lastChunkCount--;
+        throw;
+    }
+}
+
+
+void GERBER_DRAW_ITEM_STORE::DeleteAll()
+{
+    GERBER_DRAW_ITEM* item = m_first;
+
+    while( item )
+    {
+        GERBER_DRAW_ITEM* next = item->Next();
+        item->~GERBER_DRAW_ITEM();
+        item = next;
+    }
+
+    m_chunks.clear();
+    m_lastChunkCount = 0;
+    m_first = m_last = nullptr;
+    m_count = 0;
+}
@@ -0,0 +1,105 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file gerber_draw_item_store.h
+ */
+
+#ifndef GERBER_DRAW_ITEM_STORE_H
+#define GERBER_DRAW_ITEM_STORE_H
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <gerber_draw_item.h>
+
+class GERBER_FILE_IMAGE;
+
+/**
+ * Class GERBER_DRAW_ITEM_STORE
+ * owns the draw items of a GERBER_FILE_IMAGE.
+ *
+ * A gerber file can have millions of items, and they are never deleted one by one:
+ * so they are built in large chunks of memory instead of one heap block per item, and
+ * they are all deleted at once.  An item keeps its address until DeleteAll().
+ *
+ * The items are also chained in creation order, so the items can still be walked by
+ * GetFirst() and GERBER_DRAW_ITEM::Next(), like in a DLIST.
+ */
+class GERBER_DRAW_ITEM_STORE
+{
+public:
+    GERBER_DRAW_ITEM_STORE();
+    ~GERBER_DRAW_ITEM_STORE();
+
+    /**
+     * Function Create
+     * builds a new item at the end of the store.
+     * @param aGerberImageFile = the image which owns the store
+     * @return the new item, owned by the store
+     */
+    GERBER_DRAW_ITEM* Create( GERBER_FILE_IMAGE* aGerberImageFile );
+
+    /**
+     * Function Create
+     * builds a copy of aItem at the end of the store.
+     * @return the new item, owned by the store
+     */
+    GERBER_DRAW_ITEM* Create( const GERBER_DRAW_ITEM& aItem );
+
+    /**
+     * Function DeleteAll
+     * deletes all the items, and frees their memory.
+     */
+    void DeleteAll();
+
+    GERBER_DRAW_ITEM* GetFirst() const  { return m_first; }
+    GERBER_DRAW_ITEM* GetLast() const   { return m_last; }
+    unsigned GetCount() const           { return m_count; }
+
+private:
+    /// Number of items in a chunk of memory
+    static const unsigned CHUNK_SIZE = 1024;
+
+    typedef std::aligned_storage<sizeof( GERBER_DRAW_ITEM ),
+                                 alignof( GERBER_DRAW_ITEM )>::type SLOT;
+
+    /// @return the memory of a new item, in the last chunk
+    void* allocate();
+
+    /// chains aItem after the last item
+    GERBER_DRAW_ITEM* append( GERBER_DRAW_ITEM* aItem );
+
+    std::vector<std::unique_ptr<SLOT[]>> m_chunks;
+    unsigned            m_lastChunkCount;   // number of items built in the last chunk
+    GERBER_DRAW_ITEM*   m_first;
+    GERBER_DRAW_ITEM*   m_last;
+    unsigned            m_count;
+
+    // The store cannot be copied: it owns the items
+    GERBER_DRAW_ITEM_STORE( const GERBER_DRAW_ITEM_STORE& ) = delete;
+    GERBER_DRAW_ITEM_STORE& operator=( const GERBER_DRAW_ITEM_STORE& ) = delete;
+};
+
+#endif  // GERBER_DRAW_ITEM_STORE_H
@@ -124,7 +124,7 @@ GERBER_FILE_IMAGE::~GERBER_FILE_IMAGE()
  */
 GERBER_DRAW_ITEM * GERBER_FILE_IMAGE::GetItemsList()
 {
-    return m_Drawings;
+    return m_Drawings.GetFirst();
 }
 
 
@@ -179,6 +179,7 @@ void GERBER_FILE_IMAGE::ResetDefaultValues()
 {
     m_InUse         = false;
     m_GBRLayerParams.ResetDefaultValues();
+    StartStepAndRepeatBlock();
     m_FileName.Empty();
     m_ImageName     = wxT( "no name" );             // Image name from the IN command
     m_ImageNegative = false;                        // true = Negative image
@@ -234,6 +235,26 @@ void GERBER_FILE_IMAGE::ResetDefaultValues()
 }
 
 
+void GERBER_FILE_IMAGE::BuildItemIndex()
+{
+    m_itemIndex.RemoveAll();
+
+    for( GERBER_DRAW_ITEM* item = GetItemsList(); item; item = item->Next() )
+    {
+        // One box per instance of a step and repeat block: the box of the whole block
+        // would be hit by most of the searches inside the block
+        EDA_RECT shapeBox = item->GetShapeBoundingBox();
+
+        for( int ii = 0; ii < item->GetInstanceCount(); ++ii )
+        {
+            EDA_RECT instanceBox = shapeBox;
+            instanceBox.Move( item->GetABInstanceOffset( ii ) );
+            m_itemIndex.Insert( item, instanceBox );
+        }
+    }
+}
+
+
 /* Function HasNegativeItems
  * return true if at least one item must be drawn in background color
  * used to optimize screen refresh
@@ -300,31 +321,40 @@ void GERBER_FILE_IMAGE::InitToolTable()
  * (i.e when m_XRepeatCount or m_YRepeatCount are > 1)
  * @param aItem = the item to repeat
  */
-void GERBER_FILE_IMAGE::StepAndRepeatItem( const GERBER_DRAW_ITEM& aItem )
+void GERBER_FILE_IMAGE::StepAndRepeatItem( GERBER_DRAW_ITEM& aItem )
 {
     if( GetLayerParams().m_XRepeatCount < 2 &&
         GetLayerParams().m_YRepeatCount < 2 )
         return; // Nothing to repeat
 
-    // Duplicate item:
-    for( int ii = 0; ii < GetLayerParams().m_XRepeatCount; ii++ )
+    // The offsets of the copies are the same for all the items of the block:
+    // build them once, when the first item of the block is found
+    if( !m_repeatOffsets )
     {
-        for( int jj = 0; jj < GetLayerParams().m_YRepeatCount; jj++ )
+        auto offsets = std::make_shared<std::vector<wxPoint>>();
+
+        for( int ii = 0; ii < GetLayerParams().m_XRepeatCount; ii++ )
         {
-            // the first gerber item already exists (this is the template)
-            // create duplicate only if ii or jj > 0
-            if( jj == 0 && ii == 0 )
-                continue;
-            GERBER_DRAW_ITEM* dupItem = new GERBER_DRAW_ITEM( aItem );
-            wxPoint           move_vector;
-            move_vector.x = scaletoIU( ii * GetLayerParams().m_StepForRepeat.x,
-                                   GetLayerParams().m_StepForRepeatMetric );
-            move_vector.y = scaletoIU( jj * GetLayerParams().m_StepForRepeat.y,
-                                   GetLayerParams().m_StepForRepeatMetric );
-            dupItem->MoveXY( move_vector );
-            m_Drawings.Append( dupItem );
+            for( int jj = 0; jj < GetLayerParams().m_YRepeatCount; jj++ )
+            {
+                // the first gerber item already exists (this is the template)
+                // create an offset only if ii or jj > 0
+                if( jj == 0 && ii == 0 )
+                    continue;
+
+                wxPoint move_vector;
+                move_vector.x = scaletoIU( ii * GetLayerParams().m_StepForRepeat.x,
+                                           GetLayerParams().m_StepForRepeatMetric );
+                move_vector.y = scaletoIU( jj * GetLayerParams().m_StepForRepeat.y,
+                                           GetLayerParams().m_StepForRepeatMetric );
+                offsets->push_back( move_vector );
+            }
         }
+
+        m_repeatOffsets = offsets;
     }
+
+    aItem.SetRepeatOffsets( m_repeatOffsets );
 }
 
 
@@ -416,7 +446,7 @@ SEARCH_RESULT GERBER_FILE_IMAGE::Visit( INSPECTOR inspector, void* testData, con
             break;
 
         case GERBER_DRAW_ITEM_T:
-            result = IterateForward( &m_Drawings[0], inspector, testData, p );
+            result = IterateForward( m_Drawings.GetFirst(), inspector, testData, p );
             ++p;
             break;
 
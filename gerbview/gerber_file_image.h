@@ -30,6 +30,8 @@
 
 #include <dcode.h>
 #include <gerber_draw_item.h>
+#include <gerber_draw_item_store.h>
+#include <gerber_item_rtree.h>
 #include <am_primitive.h>
 #include <gbr_netlist_metadata.h>
 
@@ -112,7 +114,7 @@ class GERBER_FILE_IMAGE : public EDA_ITEM
     GERBER_LAYER       m_GBRLayerParams; // hold params for the current gerber layer
 
 public:
-    DLIST<GERBER_DRAW_ITEM> m_Drawings;                         // linked list of Gerber Items to draw
+    GERBER_DRAW_ITEM_STORE m_Drawings;                          // the Gerber Items to draw
 
     bool               m_InUse;                                 // true if this image is currently in use
                                                                 // (a file is loaded in it)
@@ -179,6 +181,9 @@ public:
     std::map<wxString, int> m_NetnamesList;                     // list of net names
 
 private:
+    GERBER_ITEM_RTREE  m_itemIndex;                             // The bounding boxes of the items
+    std::shared_ptr<const std::vector<wxPoint>> m_repeatOffsets;  // The instance offsets of the current
+                                                                // step and repeat block, shared by its items
     wxArrayString      m_messagesList;                          // A list of messages created when reading a file
     int                m_hasNegativeItems;                      // true if the image is negative or has some negative items
                                                                 // Used to optimize drawing, because when there are no
@@ -277,6 +282,19 @@ public:
      */
     GERBER_DRAW_ITEM * GetItemsList();
 
+    /**
+     * Function BuildItemIndex
+     * builds the spatial index of the items, used to locate them.
+     * Must be called when the file is loaded, and after the items are moved.
+     */
+    void BuildItemIndex();
+
+    /**
+     * Function GetItemIndex
+     * @return the spatial index of the items
+     */
+    const GERBER_ITEM_RTREE& GetItemIndex() const { return m_itemIndex; }
+
     /**
      * Function GetLayerParams
      * @return the current layers params
@@ -376,9 +394,18 @@ public:
      * This function must be called when reading a gerber file and
      * after creating a new gerber item that must be repeated
      * (i.e when m_XRepeatCount or m_YRepeatCount are > 1)
+     * The item is not copied: it becomes the base of the instances of the block,
+     * which are drawn and located from it.
      * @param aItem = the item to repeat
      */
-    void            StepAndRepeatItem( const GERBER_DRAW_ITEM& aItem );
+    void            StepAndRepeatItem( GERBER_DRAW_ITEM& aItem );
+
+    /**
+     * Function StartStepAndRepeatBlock
+     * must be called when a Step and Repeat command changes the layer parameters:
+     * the items created after are in a new block.
+     */
+    void            StartStepAndRepeatBlock() { m_repeatOffsets.reset(); }
 
     /**
      * Function DisplayImageInfo
@@ -0,0 +1,144 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file gerber_item_rtree.h
+ */
+
+#ifndef GERBER_ITEM_RTREE_H
+#define GERBER_ITEM_RTREE_H
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include <eda_rect.h>
+#include <convert_to_biu.h>
+#include <geometry/rtree.h>
+
+class GERBER_DRAW_ITEM;
+
+/**
+ * Class GERBER_ITEM_RTREE
+ * implements a R-tree over the bounding boxes of the draw items of a gerber image,
+ * to find the items which can be hit by a point or a block without testing all of them.
+ * The items are visited in the order they were inserted, so a search gives the same
+ * items in the same order as a walk through the item list.
+ * Non-owning.  The index must be built again when the items are moved.
+ */
+class GERBER_ITEM_RTREE
+{
+public:
+    /**
+     * Function Insert()
+     * Inserts an item, with the bounding box of one of its instances.  The other instances
+     * of an item are inserted right after it, each one with its own box: the item keeps
+     * a single rank, and is visited once by a search.
+     */
+    void Insert( GERBER_DRAW_ITEM* aItem, const EDA_RECT& aBBox )
+    {
+        EDA_RECT  bbox = aBBox;
+        bbox.Normalize();
+
+        const int mmin[2] = { bbox.GetX(), bbox.GetY() };
+        const int mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+
+        if( m_items.empty() || m_items.back() != aItem )
+            m_items.push_back( aItem );
+
+        m_tree.Insert( mmin, mmax, (int) m_items.size() - 1 );
+    }
+
+    /**
+     * Function RemoveAll()
+     * Removes all items from the index.
+     */
+    void RemoveAll()
+    {
+        m_tree.RemoveAll();
+        m_items.clear();
+    }
+
+    /**
+     * Function Query()
+     * Executes aVisitor for each item whose bounding box intersects aArea, in insertion
+     * order.  The visitor returns false to stop the search.
+     */
+    void Query( const EDA_RECT& aArea, std::function<bool( GERBER_DRAW_ITEM* )> aVisitor ) const
+    {
+        EDA_RECT  area = aArea;
+        area.Normalize();
+
+        const int mmin[2] = { area.GetX(), area.GetY() };
+        const int mmax[2] = { area.GetRight(), area.GetBottom() };
+
+        std::vector<int> found;
+
+        m_tree.Search( mmin, mmax,
+                [&]( const int& aIndex ) -> bool
+                {
+                    found.push_back( aIndex );
+                    return true;
+                } );
+
+        // An item is found once for each of its instances in aArea
+        std::sort( found.begin(), found.end() );
+        found.erase( std::unique( found.begin(), found.end() ), found.end() );
+
+        for( int index : found )
+        {
+            if( !aVisitor( m_items[index] ) )
+                break;
+        }
+    }
+
+    /**
+     * Function Query()
+     * Executes aVisitor for each item which can be hit at aPosition, in insertion order.
+     * The visitor returns false to stop the search.
+     */
+    void Query( const wxPoint& aPosition, std::function<bool( GERBER_DRAW_ITEM* )> aVisitor ) const
+    {
+        // GERBER_DRAW_ITEM::HitTest() accepts thin lines from a small distance
+        // (MIN_HIT_TEST_RADIUS), which can be outside of their bounding box
+        const int margin = Millimeter2iu( 0.01 );
+
+        EDA_RECT area( aPosition, wxSize( 0, 0 ) );
+        area.Inflate( margin );
+
+        Query( area, aVisitor );
+    }
+
+    /**
+     * Function size()
+     * @return the number of items in the index
+     */
+    size_t size() const { return m_items.size(); }
+
+private:
+    // The tree stores the index of the items in m_items, i.e. their insertion order
+    RTree<int, int, 2, double>      m_tree;
+    std::vector<GERBER_DRAW_ITEM*>  m_items;
+};
+
+#endif  // GERBER_ITEM_RTREE_H
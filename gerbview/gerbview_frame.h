@@ -35,6 +35,8 @@
 #include <gbr_display_options.h>
 #include <colors_design_settings.h>
 
+#include <map>
+
 extern COLORS_DESIGN_SETTINGS g_ColorsSettings;
 
 #define NO_AVAILABLE_LAYERS UNDEFINED_LAYER
@@ -46,6 +48,7 @@ class GERBER_DRAW_ITEM;
 class GERBER_FILE_IMAGE;
 class GERBER_FILE_IMAGE_LIST;
 class REPORTER;
+class PROGRESS_REPORTER;
 
 
 /**
@@ -177,6 +180,9 @@ private:
 
     bool            m_show_layer_manager_tools;
 
+    // The images read by preloadFiles(), by full file name, not yet added to the image list
+    std::map<wxString, GERBER_FILE_IMAGE*> m_preloadedImages;
+
     void            updateComponentListSelectBox();
     void            updateNetnameListSelectBox();
     void            updateAperAttributesSelectBox();
@@ -203,6 +209,30 @@ private:
                                         const wxArrayString& aFilenameList,
                                         const std::vector<int>* aFileType = nullptr );
 
+    /**
+     * Reads the Gerber and NC drill files of a list at the same time, on several threads.
+     * The images are kept until Read_GERBER_File() or Read_EXCELLON_File() adds them to
+     * the image list, so these functions do not read the files again.  Only the files which
+     * were successfully read are kept.
+     * @param aPath is the base path for the filenames if they are relative
+     * @param aFilenameList is a list of filenames to load
+     * @param aFileType is a list of type of files to load (0 = Gerber, 1 = NC drill)
+     * if nullptr, files are expected Gerber type.
+     * @param aProgress is the reporter of the reading, kept refreshed until it is done
+     * @return false if the reading was cancelled: no file is kept then
+     */
+    bool preloadFiles( const wxString& aPath, const wxArrayString& aFilenameList,
+                       const std::vector<int>* aFileType, PROGRESS_REPORTER* aProgress );
+
+    /**
+     * @return the image read from aFullFileName by preloadFiles(), now owned by the caller,
+     * or nullptr if this file was not preloaded
+     */
+    GERBER_FILE_IMAGE* takePreloadedImage( const wxString& aFullFileName );
+
+    /// Deletes the preloaded images which were not used
+    void clearPreloadedImages();
+
 public:
     GERBVIEW_FRAME( KIWAY* aKiway, wxWindow* aParent );
     ~GERBVIEW_FRAME();
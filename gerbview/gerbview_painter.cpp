@@ -172,8 +172,53 @@ bool GERBVIEW_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
     switch( item->Type() )
     {
     case GERBER_DRAW_ITEM_T:
-        draw( static_cast<GERBER_DRAW_ITEM*>( const_cast<EDA_ITEM*>( item ) ), aLayer );
+    {
+        GERBER_DRAW_ITEM* gbrItem = static_cast<GERBER_DRAW_ITEM*>( const_cast<EDA_ITEM*>( item ) );
+
+        if( gbrItem->GetInstanceCount() == 1 )
+        {
+            draw( gbrItem, aLayer );
+            break;
+        }
+
+        // The other instances of a step and repeat block are the same shapes, translated.
+        // A cached layer records all the instances in the item group.  Other layers are
+        // drawn again at each redraw: only the instances inside the screen are drawn.
+        bool  cull = m_gal->GetTarget() != TARGET_CACHED;
+        BOX2D screen;
+
+        if( cull )
+        {
+            const MATRIX3x3D& screenToWorld = m_gal->GetScreenWorldMatrix();
+
+            screen.SetOrigin( screenToWorld * VECTOR2D( 0, 0 ) );
+            screen.SetEnd( screenToWorld * VECTOR2D( m_gal->GetScreenPixelSize() ) );
+            screen.Normalize();
+        }
+
+        EDA_RECT shapeBox = gbrItem->GetShapeBoundingBox();
+
+        for( int ii = 0; ii < gbrItem->GetInstanceCount(); ++ii )
+        {
+            VECTOR2D offset( gbrItem->GetABInstanceOffset( ii ) );
+
+            if( cull )
+            {
+                BOX2D instanceBox( VECTOR2D( shapeBox.GetOrigin() ) + offset,
+                                   VECTOR2D( shapeBox.GetSize() ) );
+
+                if( !screen.Intersects( instanceBox ) )
+                    continue;
+            }
+
+            m_gal->Save();
+            m_gal->Translate( offset );
+            draw( gbrItem, aLayer );
+            m_gal->Restore();
+        }
+
         break;
+    }
 
     default:
         // Painter does not know how to draw the object
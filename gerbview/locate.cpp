@@ -55,17 +55,20 @@ GERBER_DRAW_ITEM* GERBVIEW_FRAME::Locate( const wxPoint& aPosition, int aTypeloc
 
     // Search first on active layer
     // A not used graphic layer can be selected. So gerber can be NULL
-    if( gerber && gerber->m_IsVisible )
+    // The item index gives the items which can be hit at ref, in the item list order
+    auto findItem = [&]( GERBER_DRAW_ITEM* aItem ) -> bool
     {
-        for( auto item = gerber->GetItemsList(); item; item = item->Next() )
+        if( aItem->HitTest( ref ) )
         {
-            if( item->HitTest( ref ) )
-            {
-                gerb_item = item;
-                break;
-            }
+            gerb_item = aItem;
+            return false;
         }
-    }
+
+        return true;
+    };
+
+    if( gerber && gerber->m_IsVisible )
+        gerber->GetItemIndex().Query( ref, findItem );
 
     if( gerb_item == nullptr ) // Search on all layers
     {
@@ -82,14 +85,7 @@ GERBER_DRAW_ITEM* GERBVIEW_FRAME::Locate( const wxPoint& aPosition, int aTypeloc
             if( layer == GetActiveLayer() )
                 continue;
 
-            for( auto item = gerber->GetItemsList(); item; item = item->Next() )
-            {
-                if( item->HitTest( ref ) )
-                {
-                    gerb_item = item;
-                    break;
-                }
-            }
+            gerber->GetItemIndex().Query( ref, findItem );
 
             if( gerb_item )
                 break;
@@ -50,11 +50,22 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
         Erase_Current_DrawLayer( false );
     }
 
-    gerber = new GERBER_FILE_IMAGE( layer );
+    // The file can be already read by preloadFiles()
+    gerber = takePreloadedImage( GERBER_FullFileName );
+    bool success = true;
 
-    // Read the gerber file. The image will be added only if it can be read
-    // to avoid broken data.
-    bool success = gerber->LoadGerberFile( GERBER_FullFileName );
+    if( gerber )
+    {
+        gerber->m_GraphicLayer = layer;
+    }
+    else
+    {
+        gerber = new GERBER_FILE_IMAGE( layer );
+
+        // Read the gerber file. The image will be added only if it can be read
+        // to avoid broken data.
+        success = gerber->LoadGerberFile( GERBER_FullFileName );
+    }
 
     if( !success )
     {
@@ -113,8 +124,10 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
 // size of a single line of text from a gerber file.
 // warning: some files can have *very long* lines, so the buffer must be large.
 #define GERBER_BUFZ 1000000
-// A large buffer to store one line
-static char lineBuffer[GERBER_BUFZ+1];
+
+// size of the chunks read from the gerber file: the lines are cut from large reads
+// instead of from the small default buffer of the FILE
+#define GERBER_READ_CHUNK_SIZE ( 1 << 20 )
 
 bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 {
@@ -131,8 +144,14 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
     if( m_Current_File == 0 )
         return false;
 
+    setvbuf( m_Current_File, NULL, _IOFBF, GERBER_READ_CHUNK_SIZE );
+
     m_FileName = aFullFileName;
 
+    // The line buffer belongs to this load, so several files can be read at the same time
+    std::unique_ptr<char[]> buffer( new char[GERBER_BUFZ+1] );
+    char* lineBuffer = buffer.get();
+
     LOCALE_IO toggleIo;
 
     wxString msg;
@@ -221,6 +240,8 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 
     fclose( m_Current_File );
 
+    BuildItemIndex();
+
     m_InUse = true;
 
     return true;
@@ -510,6 +510,7 @@ bool GERBER_FILE_IMAGE::ExecuteRS274XCommand( int aCommand, char* aBuff,
 
     case STEP_AND_REPEAT:   // command SR, like %SRX3Y2I5.0J2*%
         m_Iterpolation = GERB_INTERPOL_LINEAR_1X;       // Start a new Gerber layer
+        StartStepAndRepeatBlock();
         GetLayerParams().m_StepForRepeat.x = 0.0;
         GetLayerParams().m_StepForRepeat.x = 0.0;       // offset for Step and Repeat command
         GetLayerParams().m_XRepeatCount = 1;
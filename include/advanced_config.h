@@ -24,6 +24,8 @@
 #ifndef ADVANCED_CFG__H
 #define ADVANCED_CFG__H
 
+#include <wx/string.h>
+
 class wxConfigBase;
 
 /**
@@ -73,6 +75,13 @@ public:
      */
     bool m_enableSvgImport;
 
+    /**
+     * Directory where the interactive router records its routing sessions, with the
+     * board they start from, to replay them with the pns_replay qa tool.  Nothing is
+     * recorded if empty.
+     */
+    wxString m_pnsSessionDir;
+
     /**
      * Helper to determine if legacy canvas is allowed (according to platform
      * and config)
@@ -165,6 +165,7 @@ private:
 };
 
 
-extern BASIC_GAL basic_gal;
+// One instance per thread, so texts can be plotted from several threads at the same time
+extern thread_local BASIC_GAL basic_gal;
 
 #endif      // define BASIC_GAL_H
@@ -168,6 +168,13 @@ public:
     BOARD_ITEM* GetMainItem( BOARD* aBoard ) const;
     BOARD_ITEM* GetAuxiliaryItem( BOARD* aBoard ) const;
 
+    /**
+     * Access to A and B items pointers, without looking for them in the BOARD.
+     * The items may have been deleted: the pointers must only be compared.
+     */
+    const void* GetMainItemWeakRef() const { return m_mainItemWeakRef; }
+    const void* GetAuxItemWeakRef() const { return m_auxItemWeakRef; }
+
     /**
      * Function ShowHtml
      * translates this object into a fragment of HTML suitable for the
@@ -107,6 +107,7 @@ protected:
 
     int                 curTok;                 ///< the current token obtained on last NextTok()
     std::string         curText;                ///< the text of the current token
+    std::string         curLine;                ///< nul terminated copy of the current line
 
     const KEYWORD*      keywords;               ///< table sorted by CMake for bsearch()
     unsigned            keywordCount;           ///< count of keywords table
@@ -118,13 +119,14 @@ protected:
     {
         if( reader )
         {
-            reader->ReadLine();
+            unsigned len = 0;
 
-            unsigned len = reader->Length();
+            // The line may be returned in place by the reader (e.g. in a mapped file): it
+            // is not nul terminated, and only [start, limit) may be read.
+            start = reader->ReadLineInPlace( &len );
 
-            // start may have changed in ReadLine(), which can resize and
-            // relocate reader's line buffer.
-            start = reader->Line();
+            if( !start )
+                start = dummy;
 
             next  = start;
             limit = next + len;
@@ -516,7 +518,9 @@ public:
      */
     const char* CurLine()
     {
-        return (const char*)(*reader);
+        // The current line is not always nul terminated
+        curLine.assign( start, limit );
+        return curLine.c_str();
     }
 
     /**
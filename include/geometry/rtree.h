@@ -99,6 +99,11 @@ public:
 public:
 
     RTree();
+
+    /// Copy the tree structure of another tree: much faster than inserting its entries again,
+    /// as no node has to be chosen nor split.
+    RTree( const RTree& aOther );
+
     virtual ~RTree();
 
     /// Insert entry
@@ -508,6 +513,7 @@ protected:
     }
 
     void    RemoveAllRec( Node* a_node );
+    Node*   CopyRec( const Node* a_node );
     void    Reset();
     void    CountRec( Node* a_node, int& a_count );
 
@@ -628,6 +634,14 @@ RTREE_TEMPLATE RTREE_QUAL::RTree()
 }
 
 
+RTREE_TEMPLATE
+RTREE_QUAL::RTree( const RTree& aOther )
+{
+    m_root = CopyRec( aOther.m_root );
+    m_unitSphereVolume = aOther.m_unitSphereVolume;
+}
+
+
 RTREE_TEMPLATE
 RTREE_QUAL::~RTree() {
     Reset(); // Free, or reset node memory
@@ -1024,6 +1038,25 @@ void RTREE_QUAL::RemoveAllRec( Node* a_node )
 }
 
 
+RTREE_TEMPLATE
+typename RTREE_QUAL::Node* RTREE_QUAL::CopyRec( const Node* a_node )
+{
+    ASSERT( a_node );
+    ASSERT( a_node->m_level >= 0 );
+
+    Node* newNode = AllocNode();
+    *newNode = *a_node;
+
+    if( newNode->IsInternalNode() )
+    {
+        for( int index = 0; index < newNode->m_count; ++index )
+            newNode->m_branch[index].m_child = CopyRec( a_node->m_branch[index].m_child );
+    }
+
+    return newNode;
+}
+
+
 RTREE_TEMPLATE
 typename RTREE_QUAL::Node* RTREE_QUAL::AllocNode()
 {
@@ -206,6 +206,14 @@ class SHAPE_INDEX
 
         SHAPE_INDEX();
 
+        /**
+         * Copy constructor
+         *
+         * Copies the R-tree of another index, without computing the bounding boxes
+         * of its objects again.
+         */
+        SHAPE_INDEX( const SHAPE_INDEX& aOther );
+
         ~SHAPE_INDEX();
 
         /**
@@ -300,6 +308,12 @@ SHAPE_INDEX<T>::SHAPE_INDEX()
     this->m_tree = new RTree<T, int, 2, double>();
 }
 
+template <class T>
+SHAPE_INDEX<T>::SHAPE_INDEX( const SHAPE_INDEX& aOther )
+{
+    this->m_tree = new RTree<T, int, 2, double>( *aOther.m_tree );
+}
+
 template <class T>
 SHAPE_INDEX<T>::~SHAPE_INDEX()
 {
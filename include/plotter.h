@@ -33,6 +33,7 @@
 #define PLOT_COMMON_H_
 
 #include <vector>
+#include <unordered_map>
 #include <math/box2.h>
 #include <draw_graphic_text.h>
 #include <page_info.h>
@@ -1269,6 +1270,35 @@ protected:
     std::vector<APERTURE>           apertures;
     std::vector<APERTURE>::iterator currentAperture;
 
+    /// The key of an aperture in m_apertureIndex
+    struct APERTURE_KEY
+    {
+        APERTURE::APERTURE_TYPE m_Type;
+        wxSize                  m_Size;
+        int                     m_ApertureAttribute;
+
+        bool operator==( const APERTURE_KEY& aOther ) const
+        {
+            return m_Type == aOther.m_Type && m_Size == aOther.m_Size
+                   && m_ApertureAttribute == aOther.m_ApertureAttribute;
+        }
+    };
+
+    struct APERTURE_KEY_HASH
+    {
+        size_t operator()( const APERTURE_KEY& aKey ) const
+        {
+            size_t seed = std::hash<int>()( aKey.m_Size.x );
+            seed ^= std::hash<int>()( aKey.m_Size.y ) + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 );
+            seed ^= std::hash<int>()( aKey.m_Type * 65536 + aKey.m_ApertureAttribute )
+                    + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 );
+            return seed;
+        }
+    };
+
+    /// The index in apertures of each aperture, to find them without scanning the list
+    std::unordered_map<APERTURE_KEY, size_t, APERTURE_KEY_HASH> m_apertureIndex;
+
     bool     m_gerberUnitInch;  // true if the gerber units are inches, false for mm
     int      m_gerberUnitFmt;   // number of digits in mantissa.
                                 // usually 6 in Inches and 5 or 6  in mm
@@ -120,6 +120,24 @@ public:
      */
     virtual char* ReadLine() = 0;
 
+    /**
+     * Function ReadLineInPlace
+     * reads a line of text like ReadLine(), but a reader which holds the whole text in
+     * memory returns the line where it is stored, without copying it into the line buffer.
+     * Such a line is not nul terminated, Line() is not updated, and the line remains valid
+     * as long as the reader exists.  The default implementation calls ReadLine().
+     * @param aLength is set to the number of bytes in the line.
+     * @return const char* - The beginning of the read line, or NULL if EOF.
+     * @throw IO_ERROR when a line is too long.
+     */
+    virtual const char* ReadLineInPlace( unsigned* aLength )
+    {
+        const char* line = ReadLine();
+
+        *aLength = m_length;
+        return line;
+    }
+
     /**
      * Function GetSource
      * returns the name of the source of the lines in an abstract sense.
@@ -247,6 +265,85 @@ public:
 };
 
 
+/**
+/// Files smaller than this are read with stdio by MAPPED_FILE_LINE_READER: mapping them
+/// costs more than it saves
+#define MAPPED_FILE_DEFAULT_MIN_SIZE        ( 256 * 1024 )
+
+/**
+ * Class MAPPED_FILE_LINE_READER
+ * is a FILE_LINE_READER which maps the whole file in memory instead of reading it
+ * one character at a time.  ReadLineInPlace() returns the lines in the mapped file,
+ * without any copy.  When the file cannot be mapped, or is small, the lines are read
+ * from the open file as FILE_LINE_READER does.
+ *
+ * The mapping is private, but not a copy: if the file is truncated while it is read,
+ * reading past the new end of the file raises SIGBUS on POSIX systems (an access violation
+ * on Windows).  So only regular files of a local file system are mapped: files on network
+ * shares, which other computers can change, and pipes or devices are read with stdio.
+ * This reader is meant to load a file once, as fast as possible, and must not be kept open.
+ */
+class MAPPED_FILE_LINE_READER : public FILE_LINE_READER
+{
+protected:
+    const char* m_data;     ///< the mapped file, or NULL if the file is not mapped
+    size_t      m_size;     ///< size of the mapped file
+    size_t      m_ndx;      ///< offset of the next line in the mapped file
+
+#ifdef _WIN32
+    void*       m_mapping;  ///< the file mapping object handle
+#endif
+
+    /**
+     * Function nextLine
+     * finds the next line in the mapped file and advances past it.
+     * @return the beginning of the line, or NULL if EOF.
+     */
+    const char* nextLine();
+
+public:
+
+    /**
+     * Constructor MAPPED_FILE_LINE_READER
+     * opens and maps @a aFileName.
+     * @param aFileName is the name of the file to open and to use for error reporting purposes.
+     * @param aStartingLineNumber is the initial line number to report on error.
+     * @param aMaxLineLength is the maximum allowed length of a line.
+     * @param aMinMappedSize is the size below which the file is not mapped.
+     * @throw IO_ERROR if @a aFileName cannot be opened.
+     */
+    MAPPED_FILE_LINE_READER( const wxString& aFileName,
+            unsigned aStartingLineNumber = 0,
+            unsigned aMaxLineLength = LINE_READER_LINE_DEFAULT_MAX,
+            size_t aMinMappedSize = MAPPED_FILE_DEFAULT_MIN_SIZE );
+
+    ~MAPPED_FILE_LINE_READER();
+
+    char* ReadLine() override;
+
+    const char* ReadLineInPlace( unsigned* aLength ) override;
+
+    /**
+     * Function IsMapped
+     * @return true if the file is mapped in memory, false if it is read with stdio.
+     */
+    bool IsMapped() const
+    {
+        return m_data != NULL;
+    }
+
+    /**
+     * Function Rewind
+     * rewinds the file and resets the line number back to zero.
+     */
+    void Rewind()
+    {
+        FILE_LINE_READER::Rewind();
+        m_ndx = 0;
+    }
+};
+
+
 /**
  * Class STRING_LINE_READER
  * is a LINE_READER that reads from a multiline 8 bit wide std::string
@@ -280,6 +377,8 @@ public:
     STRING_LINE_READER( const STRING_LINE_READER& aStartingPoint );
 
     char* ReadLine() override;
+
+    const char* ReadLineInPlace( unsigned* aLength ) override;
 };
 
 
@@ -362,6 +362,9 @@ void PCB_EDIT_FRAME::SpreadFootprints( std::vector<MODULE*>* aFootprints,
     if( aPrepareUndoCommand )
         SaveCopyInUndoList( undoList, UR_CHANGED );
 
+    // The footprints are moved without a BOARD_COMMIT
+    GetBoard()->InvalidateIncrementalData();
+
     OnModify();
 
     m_canvas->Refresh();
@@ -76,6 +76,10 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
         int changeFlags = ent.m_type & CHT_FLAGS;
         BOARD_ITEM* boardItem = static_cast<BOARD_ITEM*>( ent.m_item );
 
+        // Remember the areas touched by this change, for incremental zone refill
+        board->ZoneFillDirtyAreas().AddItem( boardItem,
+                                             static_cast<BOARD_ITEM*>( ent.m_copy ) );
+
         // Module items need to be saved in the undo buffer before modification
         if( m_editModules )
         {
@@ -276,6 +280,10 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
 
                 auto boardItem = static_cast<BOARD_ITEM*>( ent.m_item );
 
+                // The net of the item has changed: so have its clearances to the zones
+                board->ZoneFillDirtyAreas().AddItem( boardItem,
+                                                     static_cast<BOARD_ITEM*>( ent.m_copy ) );
+
                 if( aCreateUndoEntry )
                 {
                     ITEM_PICKER itemWrapper( boardItem, UR_CHANGED );
@@ -304,7 +312,31 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
 
     frame->UpdateMsgPanel();
 
+    // Collect the changes for the board listeners (the markers are of no interest to them)
+    std::vector<BOARD_ITEM*> changedItems;
+    std::vector<BOARD_ITEM*> removedItems;
+
+    if( !m_editModules )
+    {
+        for( COMMIT_LINE& ent : m_changes )
+        {
+            BOARD_ITEM* boardItem = static_cast<BOARD_ITEM*>( ent.m_item );
+
+            if( boardItem->Type() == PCB_MARKER_T )
+                continue;
+
+            if( ( ent.m_type & CHT_TYPE ) == CHT_REMOVE )
+                removedItems.push_back( boardItem );
+            else
+                changedItems.push_back( boardItem );
+        }
+    }
+
     clear();
+
+    // Listeners are called last, as they can push their own commits
+    if( !changedItems.empty() || !removedItems.empty() )
+        board->NotifyItemsChanged( changedItems, removedItems );
 }
 
 
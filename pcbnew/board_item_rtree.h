@@ -0,0 +1,150 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef PCBNEW_BOARD_ITEM_RTREE_H
+#define PCBNEW_BOARD_ITEM_RTREE_H
+
+#include <climits>
+#include <functional>
+
+#include <math/box2.h>
+#include <layers_id_colors_and_visibility.h>
+#include <geometry/rtree.h>
+
+class BOARD_ITEM;
+
+/**
+ * Class BOARD_ITEM_RTREE
+ * implements one R-tree per board layer, for fast spatial queries of board items.
+ * Items are inserted with an explicit bounding box, so the caller can store boxes
+ * inflated by the item clearance.
+ * Non-owning.  Queries are const and can be run concurrently once the tree is built.
+ */
+class BOARD_ITEM_RTREE
+{
+public:
+    typedef RTree<BOARD_ITEM*, int, 2, double> LAYER_TREE;
+
+    BOARD_ITEM_RTREE() :
+        m_count( 0 )
+    {
+    }
+
+    /**
+     * Function Insert()
+     * Inserts an item in the trees of all the layers of aLayers.
+     */
+    void Insert( BOARD_ITEM* aItem, LSET aLayers, const BOX2I& aBBox )
+    {
+        BOX2I     bbox = aBBox;
+        bbox.Normalize();
+
+        const int mmin[2] = { bbox.GetX(), bbox.GetY() };
+        const int mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+
+        for( PCB_LAYER_ID layer : aLayers.Seq() )
+            m_tree[layer].Insert( mmin, mmax, aItem );
+
+        m_count++;
+    }
+
+    /**
+     * Function Remove()
+     * Removes an item from the trees of all the layers of aLayers. aBBox must be the
+     * box used to insert the item, otherwise the whole tree is searched.
+     */
+    void Remove( BOARD_ITEM* aItem, LSET aLayers, const BOX2I& aBBox )
+    {
+        BOX2I     bbox = aBBox;
+        bbox.Normalize();
+
+        const int mmin[2] = { bbox.GetX(), bbox.GetY() };
+        const int mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+        bool      found = false;
+
+        for( PCB_LAYER_ID layer : aLayers.Seq() )
+        {
+            // Remove() returns true when the item was not found
+            if( m_tree[layer].Remove( mmin, mmax, aItem ) )
+            {
+                const int mmin2[2] = { INT_MIN, INT_MIN };
+                const int mmax2[2] = { INT_MAX, INT_MAX };
+
+                found |= !m_tree[layer].Remove( mmin2, mmax2, aItem );
+            }
+            else
+            {
+                found = true;
+            }
+        }
+
+        if( found && m_count > 0 )
+            m_count--;
+    }
+
+    /**
+     * Function RemoveAll()
+     * Removes all items from the trees.
+     */
+    void RemoveAll()
+    {
+        for( LAYER_TREE& tree : m_tree )
+            tree.RemoveAll();
+
+        m_count = 0;
+    }
+
+    /**
+     * Function Query()
+     * Executes aVisitor for each item of aLayer whose bounding box intersects aBounds.
+     * The visitor returns false to stop the search.
+     * @return the number of items found
+     */
+    int Query( PCB_LAYER_ID aLayer, const BOX2I& aBounds,
+               std::function<bool( BOARD_ITEM* )> aVisitor ) const
+    {
+        BOX2I     bounds = aBounds;
+        bounds.Normalize();
+
+        const int mmin[2] = { bounds.GetX(), bounds.GetY() };
+        const int mmax[2] = { bounds.GetRight(), bounds.GetBottom() };
+
+        return m_tree[aLayer].Search( mmin, mmax,
+                [&]( BOARD_ITEM* const& aItem ) -> bool
+                {
+                    return aVisitor( aItem );
+                } );
+    }
+
+    /**
+     * Function size()
+     * @return the number of items in the index (an item on several layers counts once)
+     */
+    size_t size() const { return m_count; }
+
+private:
+    LAYER_TREE  m_tree[PCB_LAYER_ID_COUNT];
+    size_t      m_count;
+};
+
+#endif // PCBNEW_BOARD_ITEM_RTREE_H
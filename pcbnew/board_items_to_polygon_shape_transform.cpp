@@ -59,7 +59,9 @@ struct TSEGM_2_POLY_PRMS {
     int m_textCircle2SegmentCount;
     SHAPE_POLY_SET* m_cornerBuffer;
 };
-TSEGM_2_POLY_PRMS prms;
+
+// One instance per thread: the shapes of the board can be built from several threads
+static thread_local TSEGM_2_POLY_PRMS prms;
 
 // The max error is the distance between the middle of a segment, and the circle
 // for circle/arc to segment approximation.
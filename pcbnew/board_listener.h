@@ -0,0 +1,71 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __BOARD_LISTENER_H
+#define __BOARD_LISTENER_H
+
+#include <vector>
+
+class BOARD;
+class BOARD_ITEM;
+
+/**
+ * Class BOARD_LISTENER
+ * is the interface of the objects which follow the changes of a BOARD (for instance the
+ * online DRC).  Listeners are registered with BOARD::AddListener(), and unregister
+ * themselves with BOARD::RemoveListener(), or are told by OnBoardDeleted() that the
+ * board is deleted.
+ */
+class BOARD_LISTENER
+{
+public:
+    virtual ~BOARD_LISTENER() { }
+
+    /**
+     * Function OnBoardItemsChanged
+     * is called by BOARD_COMMIT::Push() once the changes are applied to the board.
+     * Markers are not reported.
+     * @param aBoard is the changed board
+     * @param aChanged are the items added to the board or modified
+     * @param aRemoved are the items removed from the board.  They are still allocated,
+     * but they must only be used as keys
+     */
+    virtual void OnBoardItemsChanged( BOARD& aBoard, const std::vector<BOARD_ITEM*>& aChanged,
+                                      const std::vector<BOARD_ITEM*>& aRemoved ) = 0;
+
+    /**
+     * Function OnBoardInvalidated
+     * is called when the board has changed without a BOARD_COMMIT (undo/redo, design
+     * rules edition, ...): the listener cannot rely on the changes reported so far.
+     */
+    virtual void OnBoardInvalidated( BOARD& aBoard ) = 0;
+
+    /**
+     * Function OnBoardDeleted
+     * is called by the destructor of the board, for the listeners which do not unregister
+     * themselves before: they must not use the board any more.
+     */
+    virtual void OnBoardDeleted( BOARD& aBoard ) { }
+};
+
+#endif
@@ -160,6 +160,47 @@ BOARD::~BOARD()
 
     delete m_CurrentZoneContour;
     m_CurrentZoneContour = NULL;
+
+    std::vector<BOARD_LISTENER*> listeners = m_listeners;
+
+    for( BOARD_LISTENER* listener : listeners )
+        listener->OnBoardDeleted( *this );
+}
+
+
+void BOARD::InvalidateIncrementalData()
+{
+    m_zoneFillDirtyAreas.Invalidate();
+
+    // A listener can unregister itself when called
+    std::vector<BOARD_LISTENER*> listeners = m_listeners;
+
+    for( BOARD_LISTENER* listener : listeners )
+        listener->OnBoardInvalidated( *this );
+}
+
+
+void BOARD::AddListener( BOARD_LISTENER* aListener )
+{
+    if( std::find( m_listeners.begin(), m_listeners.end(), aListener ) == m_listeners.end() )
+        m_listeners.push_back( aListener );
+}
+
+
+void BOARD::RemoveListener( BOARD_LISTENER* aListener )
+{
+    m_listeners.erase( std::remove( m_listeners.begin(), m_listeners.end(), aListener ),
+                       m_listeners.end() );
+}
+
+
+void BOARD::NotifyItemsChanged( const std::vector<BOARD_ITEM*>& aChanged,
+                                const std::vector<BOARD_ITEM*>& aRemoved )
+{
+    std::vector<BOARD_LISTENER*> listeners = m_listeners;
+
+    for( BOARD_LISTENER* listener : listeners )
+        listener->OnBoardItemsChanged( *this, aChanged, aRemoved );
 }
 
 
@@ -42,6 +42,8 @@
 #include <board_design_settings.h>
 #include <title_block.h>
 #include <zone_settings.h>
+#include <zone_fill_dirty_areas.h>
+#include <board_listener.h>
 #include <pcb_plot_params.h>
 #include <board_item_container.h>
 #include <eda_rect.h>
@@ -200,6 +202,12 @@ private:
     PCB_PLOT_PARAMS         m_plotOptions;
     NETINFO_LIST            m_NetInfo;              ///< net info list (name, design constraints ..
 
+    /// areas changed since the last zone fill, used by incremental zone refill
+    ZONE_FILL_DIRTY_AREAS   m_zoneFillDirtyAreas;
+
+    /// objects following the changes of the board (not owned)
+    std::vector<BOARD_LISTENER*> m_listeners;
+
     /**
      * Function chainMarkedSegments
      * is used by MarkTrace() to set the BUSY flag of connected segments of the trace
@@ -550,8 +558,42 @@ public:
     void SetDesignSettings( const BOARD_DESIGN_SETTINGS& aDesignSettings )
     {
         m_designSettings = aDesignSettings;
+        InvalidateIncrementalData();
     }
 
+    /**
+     * Function ZoneFillDirtyAreas
+     * @return the areas changed since the last zone fill (see ZONE_FILLER::SetIncremental)
+     */
+    ZONE_FILL_DIRTY_AREAS& ZoneFillDirtyAreas() { return m_zoneFillDirtyAreas; }
+
+    /**
+     * Function InvalidateIncrementalData
+     * must be called when the board is changed without a BOARD_COMMIT (undo/redo, design
+     * rules edition, ...): the incremental zone refill and the board listeners cannot
+     * rely on the changes recorded so far.
+     */
+    void InvalidateIncrementalData();
+
+    /**
+     * Function AddListener
+     * registers a listener, which is called after each change of the board.
+     */
+    void AddListener( BOARD_LISTENER* aListener );
+
+    /**
+     * Function RemoveListener
+     * unregisters a listener registered by AddListener().
+     */
+    void RemoveListener( BOARD_LISTENER* aListener );
+
+    /**
+     * Function NotifyItemsChanged
+     * calls BOARD_LISTENER::OnBoardItemsChanged() for all the listeners.
+     */
+    void NotifyItemsChanged( const std::vector<BOARD_ITEM*>& aChanged,
+                             const std::vector<BOARD_ITEM*>& aRemoved );
+
     const PAGE_INFO& GetPageSettings() const                { return m_paper; }
     void SetPageSettings( const PAGE_INFO& aPageSettings )  { m_paper = aPageSettings; }
 
@@ -31,6 +31,8 @@
 #include <mutex>
 #include <algorithm>
 #include <future>
+#include <map>
+#include <unordered_map>
 
 #ifdef PROFILE
 #include <profile.h>
@@ -201,9 +203,6 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
 
     m_itemList.RemoveInvalidItems( garbage );
 
-    for( auto item : garbage )
-        delete item;
-
 #ifdef PROFILE
     garbage_collection.Show();
     PROF_COUNTER search_basic( "search-basic" );
@@ -274,6 +273,12 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
 
     m_itemList.ClearDirtyFlags();
 
+    // The removed items are deleted once the clusters they were in are updated
+    updateClusterTags( garbage, dirtyItems );
+
+    for( auto item : garbage )
+        delete item;
+
 #ifdef CONNECTIVITY_DEBUG
     printf("Search end\n");
 #endif
@@ -281,6 +286,275 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
 }
 
 
+int CN_CONNECTIVITY_ALGO::newClusterTag()
+{
+    m_tagParent.push_back( m_tagParent.size() );
+    m_tagSize.push_back( 1 );
+
+    return m_tagParent.size() - 1;
+}
+
+
+int CN_CONNECTIVITY_ALGO::findClusterTag( int aTag )
+{
+    while( m_tagParent[aTag] != aTag )
+    {
+        // Path halving
+        m_tagParent[aTag] = m_tagParent[ m_tagParent[aTag] ];
+        aTag = m_tagParent[aTag];
+    }
+
+    return aTag;
+}
+
+
+void CN_CONNECTIVITY_ALGO::mergeClusterTags( int aTagA, int aTagB )
+{
+    int rootA = findClusterTag( aTagA );
+    int rootB = findClusterTag( aTagB );
+
+    if( rootA == rootB )
+        return;
+
+    if( m_tagSize[rootA] < m_tagSize[rootB] )
+        std::swap( rootA, rootB );
+
+    m_tagParent[rootB] = rootA;
+    m_tagSize[rootA] += m_tagSize[rootB];
+}
+
+
+bool CN_CONNECTIVITY_ALGO::inCluster( CN_ITEM* aItem, int aRootTag )
+{
+    return aItem->ClusterTag() >= 0 && findClusterTag( aItem->ClusterTag() ) == aRootTag;
+}
+
+
+void CN_CONNECTIVITY_ALGO::splitCluster( const std::vector<CN_ITEM*>& aSeeds )
+{
+    // Removing an item touching a single other item of its cluster cannot split it
+    if( aSeeds.size() < 2 )
+        return;
+
+    int root = findClusterTag( aSeeds[0]->ClusterTag() );
+
+    // One breadth first search is started from each seed.  When two searches meet, they
+    // are merged in a group.  When all the searches of a group are finished before meeting
+    // the other groups, the group is a separate part of the cluster.
+    struct SEARCH
+    {
+        std::deque<CN_ITEM*>  m_queue;
+        std::vector<CN_ITEM*> m_items;
+    };
+
+    std::vector<SEARCH>                 searches;
+    std::vector<int>                    groups;     // union-find of the searches
+    std::unordered_map<CN_ITEM*, int>   owner;      // search which found each item
+
+    for( CN_ITEM* seed : aSeeds )
+    {
+        if( owner.count( seed ) )
+            continue;
+
+        owner[seed] = searches.size();
+        groups.push_back( searches.size() );
+        searches.emplace_back();
+        searches.back().m_queue.push_back( seed );
+        searches.back().m_items.push_back( seed );
+    }
+
+    auto findGroup = [&groups]( int aSearch ) -> int
+    {
+        while( groups[aSearch] != aSearch )
+            aSearch = groups[aSearch] = groups[ groups[aSearch] ];
+
+        return aSearch;
+    };
+
+    std::vector<bool> finished( searches.size(), false );
+    int               activeGroups = searches.size();
+
+    while( activeGroups > 1 )
+    {
+        // Advance each search by one item
+        for( size_t ii = 0; ii < searches.size() && activeGroups > 1; ++ii )
+        {
+            SEARCH& search = searches[ii];
+
+            if( search.m_queue.empty() || finished[ findGroup( ii ) ] )
+                continue;
+
+            CN_ITEM* current = search.m_queue.front();
+            search.m_queue.pop_front();
+
+            for( CN_ITEM* n : current->ConnectedItems() )
+            {
+                if( !n->Valid() || !inCluster( n, root ) )
+                    continue;
+
+                auto it = owner.find( n );
+
+                if( it == owner.end() )
+                {
+                    owner[n] = ii;
+                    search.m_queue.push_back( n );
+                    search.m_items.push_back( n );
+                }
+                else if( findGroup( it->second ) != findGroup( ii ) )
+                {
+                    groups[ findGroup( it->second ) ] = findGroup( ii );
+                    activeGroups--;
+                }
+            }
+        }
+
+        // Give a new tag to the groups which cannot grow anymore
+        std::vector<bool> growing( searches.size(), false );
+
+        for( size_t ii = 0; ii < searches.size(); ++ii )
+        {
+            if( !searches[ii].m_queue.empty() )
+                growing[ findGroup( ii ) ] = true;
+        }
+
+        for( size_t ii = 0; ii < searches.size() && activeGroups > 1; ++ii )
+        {
+            int group = findGroup( ii );
+
+            if( group != (int) ii || finished[group] || growing[group] )
+                continue;
+
+            int tag = newClusterTag();
+
+            for( size_t jj = 0; jj < searches.size(); ++jj )
+            {
+                if( findGroup( jj ) != group )
+                    continue;
+
+                for( CN_ITEM* item : searches[jj].m_items )
+                    item->SetClusterTag( tag, item->ClusterNet() );
+            }
+
+            finished[group] = true;
+            activeGroups--;
+        }
+    }
+}
+
+
+void CN_CONNECTIVITY_ALGO::updateClusterTags( const std::vector<CN_ITEM*>& aGarbage,
+                                              const std::vector<CN_ITEM*>& aNewItems )
+{
+    if( !m_tagsValid )
+        return;
+
+    // A removed item can split its cluster: gather the items it touched, by cluster
+    std::map<int, std::vector<CN_ITEM*>> seeds;
+
+    for( CN_ITEM* item : aGarbage )
+    {
+        if( item->ClusterTag() < 0 )
+            continue;
+
+        // The parent of a removed item can be deleted: use the net the item was tagged with
+        MarkNetAsDirty( item->ClusterNet() );
+
+        int root = findClusterTag( item->ClusterTag() );
+
+        for( CN_ITEM* connected : item->ConnectedItems() )
+        {
+            if( connected->Valid() && inCluster( connected, root ) )
+                seeds[root].push_back( connected );
+        }
+    }
+
+    for( const auto& cluster : seeds )
+        splitCluster( cluster.second );
+
+    // A new item merges the clusters it touches
+    for( CN_ITEM* item : aNewItems )
+    {
+        if( !item->Valid() )
+            continue;
+
+        int net = item->Net();
+
+        if( net <= 0 )
+        {
+            item->SetClusterTag( -1, net );
+            continue;
+        }
+
+        int tag = newClusterTag();
+        item->SetClusterTag( tag, net );
+
+        for( CN_ITEM* connected : item->ConnectedItems() )
+        {
+            if( connected->Valid() && connected->ClusterTag() >= 0
+                    && connected->ClusterNet() == net )
+                mergeClusterTags( tag, connected->ClusterTag() );
+        }
+    }
+}
+
+
+void CN_CONNECTIVITY_ALGO::retagClusters( const std::vector<bool>* aNets )
+{
+    std::vector<CN_ITEM*> items;
+
+    if( !aNets )
+    {
+        m_tagParent.clear();
+        m_tagSize.clear();
+    }
+
+    for( CN_ITEM* item : m_itemList )
+    {
+        if( !item->Valid() )
+            continue;
+
+        int net = item->Net();
+
+        if( aNets && ( net < 0 || net >= (int) aNets->size() || !(*aNets)[net] ) )
+            continue;
+
+        item->SetClusterTag( -1, net );
+        items.push_back( item );
+    }
+
+    std::deque<CN_ITEM*> Q;
+
+    for( CN_ITEM* item : items )
+    {
+        int net = item->Net();
+
+        if( item->ClusterTag() >= 0 || net <= 0 )
+            continue;
+
+        int tag = newClusterTag();
+
+        item->SetClusterTag( tag, net );
+        Q.push_back( item );
+
+        while( Q.size() )
+        {
+            CN_ITEM* current = Q.front();
+
+            Q.pop_front();
+
+            for( CN_ITEM* n : current->ConnectedItems() )
+            {
+                if( n->Valid() && n->ClusterTag() < 0 && n->Net() == net )
+                {
+                    n->SetClusterTag( tag, net );
+                    Q.push_back( n );
+                }
+            }
+        }
+    }
+}
+
+
 const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUSTER_SEARCH_MODE aMode )
 {
     constexpr KICAD_T types[] = { PCB_TRACE_T, PCB_PAD_T, PCB_VIA_T, PCB_ZONE_AREA_T, PCB_MODULE_T, EOT };
@@ -294,7 +568,7 @@ const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUST
 
 
 const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUSTER_SEARCH_MODE aMode,
-        const KICAD_T aTypes[], int aSingleNet )
+        const KICAD_T aTypes[], int aSingleNet, bool aDirtyNetsOnly )
 {
     bool withinAnyNet = ( aMode != CSM_PROPAGATE );
 
@@ -302,10 +576,14 @@ const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUST
     CN_ITEM* head = nullptr;
     CLUSTERS clusters;
 
+    // When aDirtyNetsOnly is set, the clusters are only searched from these items
+    std::vector<CN_ITEM*> roots;
+
     if( m_itemList.IsDirty() )
         searchConnections();
 
-    auto addToSearchList = [&head, withinAnyNet, aSingleNet, aTypes] ( CN_ITEM *aItem )
+    auto addToSearchList = [&head, &roots, withinAnyNet, aSingleNet, aTypes, aDirtyNetsOnly, this]
+                           ( CN_ITEM *aItem )
     {
         if( withinAnyNet && aItem->Net() <= 0 )
             return;
@@ -337,16 +615,31 @@ const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUST
             head = aItem;
         else
             head->ListInsert( aItem );
+
+        if( aDirtyNetsOnly && IsNetDirty( aItem->Net() ) )
+            roots.push_back( aItem );
     };
 
     std::for_each( m_itemList.begin(), m_itemList.end(), addToSearchList );
 
-    while( head )
+    size_t nextRoot = 0;
+
+    auto getRoot = [&]() -> CN_ITEM*
+    {
+        if( !aDirtyNetsOnly )
+            return head;
+
+        while( nextRoot < roots.size() && roots[nextRoot]->Visited() )
+            nextRoot++;
+
+        return nextRoot < roots.size() ? roots[nextRoot] : nullptr;
+    };
+
+    while( CN_ITEM* root = getRoot() )
     {
         CN_CLUSTER_PTR cluster ( new CN_CLUSTER() );
 
         Q.clear();
-        CN_ITEM* root = head;
         root->SetVisited ( true );
 
         head = root->ListRemove();
@@ -502,7 +795,11 @@ void CN_CONNECTIVITY_ALGO::propagateConnections( BOARD_COMMIT* aCommit )
 
 void CN_CONNECTIVITY_ALGO::PropagateNets( BOARD_COMMIT* aCommit )
 {
-    m_connClusters = SearchClusters( CSM_PROPAGATE );
+    constexpr KICAD_T no_zones[] = { PCB_TRACE_T, PCB_PAD_T, PCB_VIA_T, PCB_MODULE_T, EOT };
+
+    // The clusters without items of the dirty nets have not changed since the last
+    // propagation
+    m_connClusters = SearchClusters( CSM_PROPAGATE, no_zones, -1, true );
     propagateConnections( aCommit );
 }
 
@@ -573,7 +870,88 @@ void CN_CONNECTIVITY_ALGO::FindIsolatedCopperIslands( std::vector<CN_ZONE_ISOLAT
 
 const CN_CONNECTIVITY_ALGO::CLUSTERS& CN_CONNECTIVITY_ALGO::GetClusters()
 {
-    m_ratsnestClusters = SearchClusters( CSM_RATSNEST );
+    if( m_itemList.IsDirty() )
+        searchConnections();
+
+    // Start again from scratch when the union-find is mostly made of stale tags
+    if( m_tagParent.size() > 4 * (size_t) m_itemList.Size() + 1024 )
+        m_tagsValid = false;
+
+    bool allNets = !m_tagsValid;
+
+    if( allNets )
+    {
+        retagClusters( nullptr );
+        m_tagsValid = true;
+    }
+    else
+    {
+        // The items whose net has changed without Remove()/Add() (for instance by the net
+        // propagation) are tagged again with the other items of their old and new nets
+        std::vector<bool> changedNets;
+
+        for( CN_ITEM* item : m_itemList )
+        {
+            if( !item->Valid() || item->Net() == item->ClusterNet() )
+                continue;
+
+            for( int net : { item->Net(), item->ClusterNet() } )
+            {
+                if( net < 0 )
+                    continue;
+
+                if( net >= (int) changedNets.size() )
+                    changedNets.resize( net + 1, false );
+
+                changedNets[net] = true;
+                MarkNetAsDirty( net );
+            }
+        }
+
+        if( !changedNets.empty() )
+            retagClusters( &changedNets );
+    }
+
+    // Keep the clusters of the other nets, and build the clusters of the dirty nets
+    // from the tags
+    CLUSTERS                                clusters;
+    std::unordered_map<int, CN_CLUSTER_PTR> tagClusters;
+
+    if( !allNets )
+    {
+        for( const CN_CLUSTER_PTR& cluster : m_ratsnestClusters )
+        {
+            if( !IsNetDirty( cluster->OriginNet() ) )
+                clusters.push_back( cluster );
+        }
+    }
+
+    for( CN_ITEM* item : m_itemList )
+    {
+        if( !item->Valid() || item->ClusterTag() < 0 )
+            continue;
+
+        if( !allNets && !IsNetDirty( item->Net() ) )
+            continue;
+
+        CN_CLUSTER_PTR& cluster = tagClusters[ findClusterTag( item->ClusterTag() ) ];
+
+        if( !cluster )
+        {
+            cluster.reset( new CN_CLUSTER() );
+            clusters.push_back( cluster );
+        }
+
+        cluster->Add( item );
+    }
+
+    std::stable_sort( clusters.begin(), clusters.end(),
+                      []( const CN_CLUSTER_PTR& a, const CN_CLUSTER_PTR& b )
+                      {
+                          return a->OriginNet() < b->OriginNet();
+                      } );
+
+    m_ratsnestClusters = clusters;
     return m_ratsnestClusters;
 }
 
@@ -728,6 +1106,9 @@ void CN_CONNECTIVITY_ALGO::Clear()
     m_connClusters.clear();
     m_itemMap.clear();
     m_itemList.Clear();
+    m_tagParent.clear();
+    m_tagSize.clear();
+    m_tagsValid = false;
 
 }
 
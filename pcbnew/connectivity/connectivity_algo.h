@@ -152,8 +152,55 @@ private:
     std::vector<bool> m_dirtyNets;
     PROGRESS_REPORTER* m_progressReporter = nullptr;
 
+    /*
+     * The ratsnest clusters (the connected items of a net) are kept between the updates.
+     * Each item has a cluster tag, and the tags of a cluster are merged in a union-find:
+     * - a new item merges the clusters of the items it touches,
+     * - a removed item can split its cluster: the items it touched are searched
+     *   simultaneously, and the search stops as soon as they all meet.  Only the parts
+     *   which are actually disconnected are tagged again.
+     * So a change of a large net only costs the search of the changed area.
+     */
+
+    ///> union-find of the cluster tags: parent tag of each tag
+    std::vector<int> m_tagParent;
+
+    ///> number of tags merged in each root tag
+    std::vector<int> m_tagSize;
+
+    ///> false when the tags must be computed from scratch
+    bool m_tagsValid = false;
+
     void    searchConnections();
 
+    int     newClusterTag();
+
+    ///> @return the root tag of the cluster of aTag
+    int     findClusterTag( int aTag );
+
+    void    mergeClusterTags( int aTagA, int aTagB );
+
+    ///> @return true if aItem is tagged, and belongs to the cluster of root tag aRootTag
+    bool    inCluster( CN_ITEM* aItem, int aRootTag );
+
+    /**
+     * Finds out if the items of aSeeds, which belong to the same cluster, are still
+     * connected, and gives new tags to the parts of the cluster which are not.
+     */
+    void    splitCluster( const std::vector<CN_ITEM*>& aSeeds );
+
+    /**
+     * Updates the cluster tags after searchConnections(): splits the clusters of the
+     * removed items, and merges the clusters touched by the new items.
+     * @param aGarbage are the removed items, which are not deleted yet
+     * @param aNewItems are the new items
+     */
+    void    updateClusterTags( const std::vector<CN_ITEM*>& aGarbage,
+                               const std::vector<CN_ITEM*>& aNewItems );
+
+    ///> Tags again all the items of the nets set in aNets (all the items if aNets is null)
+    void    retagClusters( const std::vector<bool>* aNets );
+
     void    update();
 
     void    propagateConnections( BOARD_COMMIT* aCommit = nullptr );
@@ -188,6 +235,10 @@ public:
         if( aNet < 0 )
             return false;
 
+        // A net which was never marked is new
+        if( aNet >= (int) m_dirtyNets.size() )
+            return true;
+
         return m_dirtyNets[ aNet ];
     }
 
@@ -221,7 +272,13 @@ public:
     bool    Remove( BOARD_ITEM* aItem );
     bool    Add( BOARD_ITEM* aItem );
 
-    const CLUSTERS  SearchClusters( CLUSTER_SEARCH_MODE aMode, const KICAD_T aTypes[], int aSingleNet );
+    /**
+     * Searches the clusters of connected items
+     * @param aDirtyNetsOnly when true, only the clusters containing items of the dirty nets
+     * are returned
+     */
+    const CLUSTERS  SearchClusters( CLUSTER_SEARCH_MODE aMode, const KICAD_T aTypes[],
+                                    int aSingleNet, bool aDirtyNetsOnly = false );
     const CLUSTERS  SearchClusters( CLUSTER_SEARCH_MODE aMode );
 
     /**
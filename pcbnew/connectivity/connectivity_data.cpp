@@ -35,6 +35,9 @@
 #include <connectivity/connectivity_algo.h>
 #include <ratsnest_data.h>
 
+// A bulk ratsnest update starts one thread for this number of nodes (in large nets)
+static const size_t MIN_NODES_PER_THREAD = 2000;
+
 CONNECTIVITY_DATA::CONNECTIVITY_DATA()
 {
     m_connAlgo.reset( new CN_CONNECTIVITY_ALGO );
@@ -107,9 +110,23 @@ void CONNECTIVITY_DATA::updateRatsnest()
     std::copy_if( m_nets.begin() + 1, m_nets.end(), std::back_inserter( dirty_nets ),
             [] ( RN_NET* aNet ) { return aNet->IsDirty() && aNet->GetNodeCount() > 0; } );
 
-    // We don't want to spin up a new thread for fewer than 8 nets (overhead costs)
+    // Update the largest nets first, so they do not delay the end of the update
+    std::stable_sort( dirty_nets.begin(), dirty_nets.end(),
+            [] ( const RN_NET* aNet1, const RN_NET* aNet2 )
+            {
+                return aNet1->GetNodeCount() > aNet2->GetNodeCount();
+            } );
+
+    // We don't want to spin up a new thread for fewer than 8 nets (overhead costs), unless
+    // the nets are large (bulk update, as at board load): then each large net gets its thread
+    size_t nodeCount = 0;
+
+    for( const RN_NET* net : dirty_nets )
+        nodeCount += net->GetNodeCount();
+
     size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
-            ( dirty_nets.size() + 7 ) / 8 );
+            std::max<size_t>( ( dirty_nets.size() + 7 ) / 8, nodeCount / MIN_NODES_PER_THREAD ) );
+    parallelThreadCount = std::min( parallelThreadCount, dirty_nets.size() );
 
     std::atomic<size_t> nextNet( 0 );
     std::vector<std::future<size_t>> returns( parallelThreadCount );
@@ -175,6 +175,12 @@ private:
     ///> mutex protecting this item's connected_items set to allow parallel connection threads
     std::mutex m_listLock;
 
+    ///> tag of the cluster of the item in CN_CONNECTIVITY_ALGO (-1 if none)
+    int m_clusterTag;
+
+    ///> net of the item when it was tagged
+    int m_clusterNet;
+
 protected:
     ///> dirty flag, used to identify recently added item not yet scanned into the connectivity search
     bool m_dirty;
@@ -195,6 +201,8 @@ public:
         m_visited = false;
         m_valid = true;
         m_dirty = true;
+        m_clusterTag = -1;
+        m_clusterNet = -1;
         m_anchors.reserve( 2 );
         m_layers = LAYER_RANGE( 0, PCB_LAYER_ID_COUNT );
     }
@@ -311,6 +319,22 @@ public:
         return m_canChangeNet;
     }
 
+    void SetClusterTag( int aTag, int aNet )
+    {
+        m_clusterTag = aTag;
+        m_clusterNet = aNet;
+    }
+
+    int ClusterTag() const
+    {
+        return m_clusterTag;
+    }
+
+    int ClusterNet() const
+    {
+        return m_clusterNet;
+    }
+
     void Connect( CN_ITEM* b )
     {
         std::lock_guard<std::mutex> lock( m_listLock );
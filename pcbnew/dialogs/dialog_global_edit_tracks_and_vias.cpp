@@ -339,6 +339,9 @@ bool DIALOG_GLOBAL_EDIT_TRACKS_AND_VIAS::TransferDataFromWindow()
     {
         m_parent->SaveCopyInUndoList( itemsListPicker, UR_CHANGED );
 
+        // The widths are changed without a BOARD_COMMIT
+        m_brd->InvalidateIncrementalData();
+
         if( m_parent->IsGalCanvasActive() )
         {
             for( TRACK* segment = m_brd->m_Track; segment != nullptr; segment = segment->Next() )
@@ -27,6 +27,7 @@
 #include <confirm.h>
 #include <pcb_edit_frame.h>
 #include <pcbplot.h>
+#include <plot_job_queue.h>
 #include <gerber_jobfile_writer.h>
 #include <reporter.h>
 #include <wildcards_and_files_ext.h>
@@ -822,6 +823,9 @@ void DIALOG_PLOT::Plot( wxCommandEvent& event )
 
     wxBusyCursor dummy;
 
+    // Gerber layers are plotted at the same time, each one in its own file
+    PLOT_JOB_QUEUE plotJobs( board, m_plotOpts );
+
     for( LSEQ seq = m_plotOpts.GetLayerSelection().UIOrder();  seq;  ++seq )
     {
         PCB_LAYER_ID layer = *seq;
@@ -847,29 +851,12 @@ void DIALOG_PLOT::Plot( wxCommandEvent& event )
         wxString fullname = fn.GetFullName();
         jobfile_writer.AddGbrFile( layer, fullname );
 
-        LOCALE_IO toggle;
-
-        PLOTTER*    plotter = StartPlotBoard( board, &m_plotOpts, layer, fn.GetFullPath(), wxEmptyString );
-
-        // Print diags in messages box:
-        wxString msg;
-
-        if( plotter )
-        {
-            PlotOneBoardLayer( board, plotter, layer, m_plotOpts );
-            plotter->EndPlot();
-            delete plotter;
-
-            msg.Printf( _( "Plot file \"%s\" created." ), GetChars( fn.GetFullPath() ) );
-            reporter.Report( msg, REPORTER::RPT_ACTION );
-        }
-        else
-        {
-            msg.Printf( _( "Unable to create file \"%s\"." ), GetChars( fn.GetFullPath() ) );
-            reporter.Report( msg, REPORTER::RPT_ERROR );
-        }
+        plotJobs.AddLayer( layer, fn.GetFullPath() );
     }
 
+    // Print diags in messages box, in the layer order
+    plotJobs.Run( reporter );
+
     if( m_plotOpts.GetFormat() == PLOT_FORMAT_GERBER && m_plotOpts.GetCreateGerberJobFile() )
     {
         // Pick the basename from the board file
@@ -27,6 +27,10 @@
  * @file drc.cpp
  */
 
+#include <thread>
+#include <future>
+#include <atomic>
+
 #include <fctsys.h>
 #include <pcb_edit_frame.h>
 #include <trigo.h>
@@ -59,6 +63,7 @@
 #include <geometry/shape_arc.h>
 
 #include <drc/courtyard_overlap.h>
+#include <zone_filler.h>
 
 void DRC::ShowDRCDialog( wxWindow* aParent )
 {
@@ -101,6 +106,13 @@ void DRC::ShowDRCDialog( wxWindow* aParent )
 
 void DRC::addMarkerToPcb( MARKER_PCB* aMarker )
 {
+    // In a worker of runParallel(), the markers are added to the board by the caller
+    if( m_markerSink )
+    {
+        m_markerSink->push_back( aMarker );
+        return;
+    }
+
     // In legacy routing mode, do not add markers to the board.
     // only shows the drc error message
     if( m_drcInLegacyRoutingMode )
@@ -111,10 +123,106 @@ void DRC::addMarkerToPcb( MARKER_PCB* aMarker )
     }
     else
     {
-        BOARD_COMMIT commit( m_pcbEditorFrame );
-        commit.Add( aMarker );
-        commit.Push( wxEmptyString, false, false );
+        addMarkersToPcb( { aMarker } );
+    }
+}
+
+
+void DRC::addMarkersToPcb( const std::vector<MARKER_PCB*>& aMarkers )
+{
+    if( aMarkers.empty() )
+        return;
+
+    m_markerCount += aMarkers.size();
+
+    if( m_markerHandler )
+    {
+        for( MARKER_PCB* marker : aMarkers )
+            m_markerHandler( marker );
+
+        return;
+    }
+
+    BOARD_COMMIT commit( m_pcbEditorFrame );
+
+    for( MARKER_PCB* marker : aMarkers )
+        commit.Add( marker );
+
+    commit.Push( wxEmptyString, false, false );
+}
+
+
+EDA_UNITS_T DRC::userUnits() const
+{
+    return m_pcbEditorFrame ? m_pcbEditorFrame->GetUserUnits() : m_units;
+}
+
+
+void DRC::runParallel( size_t aCount, const std::function<void( DRC*, size_t )>& aTest,
+                       const std::function<bool( size_t )>& aProgress )
+{
+    if( aCount == 0 )
+        return;
+
+    std::vector<std::vector<MARKER_PCB*>> markers( aCount );
+    std::atomic<size_t> nextItem( 0 );
+    std::atomic<size_t> doneCount( 0 );
+    std::atomic<bool>   cancelled( false );
+
+    size_t parallelThreadCount = std::min<size_t>(
+            std::max<size_t>( 1, std::thread::hardware_concurrency() ), aCount );
+
+    auto test_lambda = [&]() -> size_t
+    {
+        DRC    worker( this );
+        size_t num = 0;
+
+        for( size_t ii = nextItem.fetch_add( 1 ); ii < aCount && !cancelled;
+             ii = nextItem.fetch_add( 1 ) )
+        {
+            worker.m_markerSink = &markers[ii];
+            aTest( &worker, ii );
+            doneCount++;
+            num++;
+        }
+
+        return num;
+    };
+
+    if( parallelThreadCount <= 1 && !aProgress )
+        test_lambda();
+    else
+    {
+        std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, test_lambda );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        {
+            // Here we balance returns with a 100ms timeout to allow UI updating
+            std::future_status status;
+            do
+            {
+                if( aProgress && !cancelled && !aProgress( doneCount ) )
+                    cancelled = true;
+
+                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
+            } while( status != std::future_status::ready );
+        }
+    }
+
+    // The buffers are merged in test order, so the markers are the same from run to run.
+    // The workers only recorded their markers: their texts are built here.
+    std::vector<MARKER_PCB*> allMarkers;
+
+    for( std::vector<MARKER_PCB*>& list : markers )
+    {
+        for( MARKER_PCB* marker : list )
+            allMarkers.push_back( m_markerFactory.BuildRecordedMarker( marker ) );
     }
+
+    addMarkersToPcb( allMarkers );
 }
 
 
@@ -149,6 +257,9 @@ DRC::DRC( PCB_EDIT_FRAME* aPcbWindow )
     // m_rptFilename set to empty by its constructor
 
     m_currentMarker = NULL;
+    m_markerSink = nullptr;
+    m_units = aPcbWindow->GetUserUnits();
+    m_markerCount = 0;
 
     m_segmAngle  = 0;
     m_segmLength = 0;
@@ -159,11 +270,93 @@ DRC::DRC( PCB_EDIT_FRAME* aPcbWindow )
     m_ycliphi = 0;
 
     m_markerFactory.SetUnitsProvider( [=]() { return aPcbWindow->GetUserUnits(); } );
+
+    m_onlineBoard = nullptr;
+    m_onlineEnabled = false;
+    SetBoard( m_pcb );
+}
+
+
+DRC::DRC( BOARD* aBoard, EDA_UNITS_T aUnits,
+          const std::function<void( MARKER_PCB* )>& aMarkerHandler )
+{
+    m_pcbEditorFrame = nullptr;
+    m_pcb = aBoard;
+    m_drcDialog  = NULL;
+
+    m_drcInLegacyRoutingMode = false;
+    m_doPad2PadTest     = true;
+    m_doUnconnectedTest = true;
+    m_doZonesTest = false;
+    m_doKeepoutTest = true;
+    m_refillZones = false;
+    m_reportAllTrackErrors = false;
+    m_doCreateRptFile = false;
+
+    m_currentMarker = NULL;
+    m_markerSink = nullptr;
+    m_units = aUnits;
+    m_markerHandler = aMarkerHandler;
+    m_markerCount = 0;
+
+    m_segmAngle  = 0;
+    m_segmLength = 0;
+
+    m_xcliplo = 0;
+    m_ycliplo = 0;
+    m_xcliphi = 0;
+    m_ycliphi = 0;
+
+    m_markerFactory.SetUnits( aUnits );
+
+    m_onlineBoard = nullptr;
+    m_onlineEnabled = false;
+}
+
+
+DRC::DRC( const DRC* aParent )
+{
+    m_pcbEditorFrame = aParent->m_pcbEditorFrame;
+    m_pcb = aParent->m_pcb;
+    m_drcDialog  = NULL;
+
+    m_drcInLegacyRoutingMode = false;
+    m_doPad2PadTest     = aParent->m_doPad2PadTest;
+    m_doUnconnectedTest = aParent->m_doUnconnectedTest;
+    m_doZonesTest = aParent->m_doZonesTest;
+    m_doKeepoutTest = aParent->m_doKeepoutTest;
+    m_refillZones = aParent->m_refillZones;
+    m_reportAllTrackErrors = aParent->m_reportAllTrackErrors;
+    m_doCreateRptFile = false;
+
+    m_currentMarker = NULL;
+    m_markerSink = nullptr;     // set by runParallel() before each test
+    m_units = aParent->m_units;
+    m_markerCount = 0;
+
+    m_segmAngle  = 0;
+    m_segmLength = 0;
+
+    m_xcliplo = 0;
+    m_ycliplo = 0;
+    m_xcliphi = 0;
+    m_ycliphi = 0;
+
+    m_board_outlines = aParent->m_board_outlines;
+    m_markerFactory = aParent->m_markerFactory;
+    m_markerFactory.SetRecordMode( true );
+    m_itemIndex = aParent->m_itemIndex;
+
+    m_onlineBoard = nullptr;
+    m_onlineEnabled = false;
 }
 
 
 DRC::~DRC()
 {
+    if( m_onlineBoard )
+        m_onlineBoard->RemoveListener( this );
+
     // maybe someday look at pointainer.h  <- google for "pointainer.h"
     for( unsigned i = 0; i<m_unconnected.size();  ++i )
         delete m_unconnected[i];
@@ -217,9 +410,8 @@ int DRC::DrcOnCreatingTrack( TRACK* aRefSegm, TRACK* aList )
 
 int DRC::TestZoneToZoneOutline( ZONE_CONTAINER* aZone, bool aCreateMarkers )
 {
-    BOARD* board = m_pcbEditorFrame->GetBoard();
-    BOARD_COMMIT commit( m_pcbEditorFrame );
-    int nerrors = 0;
+    BOARD* board = m_pcbEditorFrame ? m_pcbEditorFrame->GetBoard() : m_pcb;
+    std::atomic<int> nerrors( 0 );
 
     std::vector<SHAPE_POLY_SET> smoothed_polys;
     smoothed_polys.resize( board->GetAreaCount() );
@@ -231,16 +423,17 @@ int DRC::TestZoneToZoneOutline( ZONE_CONTAINER* aZone, bool aCreateMarkers )
     }
 
     // iterate through all areas
-    for( int ia = 0; ia < board->GetAreaCount(); ia++ )
+    runParallel( board->GetAreaCount(), [&]( DRC* aWorker, size_t aIndex )
     {
+        int             ia = aIndex;
         ZONE_CONTAINER* zoneRef = board->GetArea( ia );
 
         if( !zoneRef->IsOnCopperLayer() )
-            continue;
+            return;
 
         // When testing only a single area, skip all others
         if( aZone && ( aZone != zoneRef) )
-            continue;
+            return;
 
         // If we are testing a single zone, then iterate through all other zones
         // Otherwise, we have already tested the zone combination
@@ -288,7 +481,7 @@ int DRC::TestZoneToZoneOutline( ZONE_CONTAINER* aZone, bool aCreateMarkers )
                 if( smoothed_polys[ia2].Contains( currentVertex ) )
                 {
                     if( aCreateMarkers )
-                        commit.Add( m_markerFactory.NewMarker(
+                        aWorker->addMarkerToPcb( aWorker->m_markerFactory.NewMarker(
                                 pt, zoneRef, zoneToTest, DRCE_ZONES_INTERSECT ) );
 
                     nerrors++;
@@ -304,7 +497,7 @@ int DRC::TestZoneToZoneOutline( ZONE_CONTAINER* aZone, bool aCreateMarkers )
                 if( smoothed_polys[ia].Contains( currentVertex ) )
                 {
                     if( aCreateMarkers )
-                        commit.Add( m_markerFactory.NewMarker(
+                        aWorker->addMarkerToPcb( aWorker->m_markerFactory.NewMarker(
                                 pt, zoneToTest, zoneRef, DRCE_ZONES_INTERSECT ) );
 
                     nerrors++;
@@ -353,16 +546,13 @@ int DRC::TestZoneToZoneOutline( ZONE_CONTAINER* aZone, bool aCreateMarkers )
             for( wxPoint pt : conflictPoints )
             {
                 if( aCreateMarkers )
-                    commit.Add( m_markerFactory.NewMarker(
+                    aWorker->addMarkerToPcb( aWorker->m_markerFactory.NewMarker(
                             pt, zoneRef, zoneToTest, DRCE_ZONES_TOO_CLOSE ) );
 
                 nerrors++;
             }
         }
-    }
-
-    if( aCreateMarkers )
-        commit.Push( wxEmptyString, false, false );
+    } );
 
     return nerrors;
 }
@@ -399,7 +589,32 @@ void DRC::RunTests( wxTextCtrl* aMessages )
 {
     // be sure m_pcb is the current board, not a old one
     // ( the board can be reloaded )
-    m_pcb = m_pcbEditorFrame->GetBoard();
+    if( m_pcbEditorFrame )
+        m_pcb = m_pcbEditorFrame->GetBoard();
+
+    m_testStats.clear();
+
+    // The online DRC starts again from the results of this run
+    m_onlineEnabled = false;
+    m_onlineIndex.reset();
+
+    // Runs aTest, and records its run time and the number of violations it found
+    auto runTest = [&]( const wxString& aName, const std::function<void()>& aTest )
+    {
+        TEST_STATS stats;
+        int        markerCount = m_markerCount;
+        size_t     unconnectedCount = m_unconnected.size();
+        auto       start = std::chrono::steady_clock::now();
+
+        aTest();
+
+        stats.m_name = aName;
+        stats.m_duration = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start );
+        stats.m_violations = m_markerCount - markerCount
+                             + int( m_unconnected.size() - unconnectedCount );
+        m_testStats.push_back( stats );
+    };
 
     if( aMessages )
     {
@@ -407,10 +622,14 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         wxSafeYield();
     }
 
-    testOutline();
+    runTest( "outline", [&]() { testOutline(); } );
+
+    bool netclassesOk = true;
+
+    runTest( "netclasses", [&]() { netclassesOk = testNetClasses(); } );
 
     // someone should have cleared the two lists before calling this.
-    if( !testNetClasses() )
+    if( !netclassesOk )
     {
         // testing the netclasses is a special case because if the netclasses
         // do not pass the BOARD_DESIGN_SETTINGS checks, then every member of a net
@@ -425,6 +644,9 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         return;
     }
 
+    // Index the pads and tracks, for the pad and track clearance tests
+    runTest( "item_index", [&]() { buildItemIndex(); } );
+
     // test pad to pad clearances, nothing to do with tracks, vias or zones.
     if( m_doPad2PadTest )
     {
@@ -434,7 +656,7 @@ void DRC::RunTests( wxTextCtrl* aMessages )
             wxSafeYield();
         }
 
-        testPad2Pad();
+        runTest( "pad_clearance", [&]() { testPad2Pad(); } );
     }
 
     // test clearances between drilled holes
@@ -444,7 +666,7 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         wxSafeYield();
     }
 
-    testDrilledHoles();
+    runTest( "drill_clearance", [&]() { testDrilledHoles(); } );
 
     // caller (a wxTopLevelFrame) is the wxDialog or the Pcb Editor frame that call DRC:
     wxWindow* caller = aMessages ? aMessages->GetParent() : m_pcbEditorFrame;
@@ -454,9 +676,25 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         if( aMessages )
             aMessages->AppendText( _( "Refilling all zones...\n" ) );
 
-        m_pcbEditorFrame->Fill_All_Zones( caller );
+        runTest( "zone_fill", [&]()
+                {
+                    if( m_pcbEditorFrame )
+                    {
+                        m_pcbEditorFrame->Fill_All_Zones( caller );
+                    }
+                    else
+                    {
+                        std::vector<ZONE_CONTAINER*> toFill;
+
+                        for( ZONE_CONTAINER* zone : m_pcb->Zones() )
+                            toFill.push_back( zone );
+
+                        ZONE_FILLER filler( m_pcb );
+                        filler.Fill( toFill );
+                    }
+                } );
     }
-    else
+    else if( m_pcbEditorFrame )
     {
         if( aMessages )
             aMessages->AppendText( _( "Checking zone fills...\n" ) );
@@ -471,7 +709,19 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         wxSafeYield();
     }
 
-    testTracks( aMessages ? aMessages->GetParent() : m_pcbEditorFrame, true );
+    runTest( "track_clearance", [&]()
+            {
+                testTracks( caller, m_pcbEditorFrame != nullptr );
+            } );
+
+    // From now on, the changes of the board are checked by the online DRC
+    if( m_pcb == m_onlineBoard )
+    {
+        m_onlineIndex = m_itemIndex;
+        m_onlineEnabled = true;
+    }
+
+    m_itemIndex.reset();
 
     // test zone clearances to other zones
     if( aMessages )
@@ -480,7 +730,7 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         wxSafeYield();
     }
 
-    testZones();
+    runTest( "zone_clearance", [&]() { testZones(); } );
 
     // find and gather unconnected pads.
     if( m_doUnconnectedTest )
@@ -491,7 +741,7 @@ void DRC::RunTests( wxTextCtrl* aMessages )
             aMessages->Refresh();
         }
 
-        testUnconnected();
+        runTest( "unconnected", [&]() { testUnconnected(); } );
     }
 
     // find and gather vias, tracks, pads inside keepout areas.
@@ -503,7 +753,7 @@ void DRC::RunTests( wxTextCtrl* aMessages )
             aMessages->Refresh();
         }
 
-        testKeepoutAreas();
+        runTest( "keepout", [&]() { testKeepoutAreas(); } );
     }
 
     // find and gather vias, tracks, pads inside text boxes.
@@ -513,7 +763,7 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         wxSafeYield();
     }
 
-    testCopperTextAndGraphics();
+    runTest( "copper_text_graphics", [&]() { testCopperTextAndGraphics(); } );
 
     // find overlapping courtyard ares.
     if( m_pcb->GetDesignSettings().m_ProhibitOverlappingCourtyards
@@ -525,11 +775,11 @@ void DRC::RunTests( wxTextCtrl* aMessages )
             aMessages->Refresh();
         }
 
-        doFootprintOverlappingDrc();
+        runTest( "courtyard", [&]() { doFootprintOverlappingDrc(); } );
     }
 
     // Check if there are items on disabled layers
-    testDisabledLayers();
+    runTest( "disabled_layers", [&]() { testDisabledLayers(); } );
 
     if( aMessages )
     {
@@ -561,7 +811,8 @@ void DRC::ListUnconnectedPads()
 void DRC::updatePointers()
 {
     // update my pointers, m_pcbEditorFrame is the only unchangeable one
-    m_pcb = m_pcbEditorFrame->GetBoard();
+    if( m_pcbEditorFrame )
+        m_pcb = m_pcbEditorFrame->GetBoard();
 
     if( m_drcDialog )  // Use diag list boxes only in DRC dialog
     {
@@ -581,7 +832,7 @@ bool DRC::doNetClass( const NETCLASSPTR& nc, wxString& msg )
 
     const BOARD_DESIGN_SETTINGS& g = m_pcb->GetDesignSettings();
 
-#define FmtVal( x ) GetChars( StringFromValue( m_pcbEditorFrame->GetUserUnits(), x ) )
+#define FmtVal( x ) GetChars( StringFromValue( userUnits(), x ) )
 
 #if 0   // set to 1 when (if...) BOARD_DESIGN_SETTINGS has a m_MinClearance value
     if( nc->GetClearance() < g.m_MinClearance )
@@ -683,6 +934,100 @@ bool DRC::testNetClasses()
 }
 
 
+void DRC::ITEM_INDEX::AddPad( D_PAD* aPad )
+{
+    const LSET all_cu = LSET::AllCuMask();
+    LSET       layers = aPad->GetLayerSet() & all_cu;
+    EDA_RECT   bbox = aPad->GetBoundingBox();
+
+    // The bounding radius is cached on first use: compute it now, before the pads
+    // are shared between the test threads
+    aPad->GetBoundingRadius();
+
+    // The hole of a pad must be tested against the items of all copper layers
+    if( aPad->GetDrillSize().x != 0 || aPad->GetDrillSize().y != 0 )
+    {
+        // The (possibly rotated) hole is inside this circle
+        int      radius = std::max( aPad->GetDrillSize().x, aPad->GetDrillSize().y ) / 2;
+        EDA_RECT hole( aPad->GetPosition() - wxPoint( radius, radius ),
+                       wxSize( 2 * radius, 2 * radius ) );
+
+        bbox.Merge( hole );
+        layers = all_cu;
+    }
+
+    bbox.Inflate( aPad->GetClearance() );
+    m_pads.Insert( aPad, layers, bbox );
+    m_entries[aPad] = { true, layers, bbox };
+    m_modulePads[aPad->GetParent()].push_back( aPad );
+    m_order[aPad] = m_nextOrder++;
+}
+
+
+void DRC::ITEM_INDEX::AddTrack( TRACK* aTrack )
+{
+    LSET     layers = aTrack->GetLayerSet() & LSET::AllCuMask();
+    EDA_RECT bbox = aTrack->GetBoundingBox();
+
+    bbox.Inflate( aTrack->GetClearance() );
+    m_tracks.Insert( aTrack, layers, bbox );
+    m_entries[aTrack] = { false, layers, bbox };
+    m_order[aTrack] = m_nextOrder++;
+}
+
+
+void DRC::ITEM_INDEX::Remove( const BOARD_ITEM* aItem )
+{
+    auto it = m_entries.find( aItem );
+
+    if( it == m_entries.end() )
+        return;
+
+    // The trees do not modify the items
+    BOARD_ITEM*  item = const_cast<BOARD_ITEM*>( aItem );
+    const ENTRY& entry = it->second;
+
+    if( entry.m_isPad )
+        m_pads.Remove( item, entry.m_layers, entry.m_bbox );
+    else
+        m_tracks.Remove( item, entry.m_layers, entry.m_bbox );
+
+    m_entries.erase( it );
+    m_order.erase( aItem );
+}
+
+
+std::vector<D_PAD*> DRC::ITEM_INDEX::RemoveModulePads( const BOARD_ITEM* aModule )
+{
+    std::vector<D_PAD*> pads;
+    auto                it = m_modulePads.find( aModule );
+
+    if( it == m_modulePads.end() )
+        return pads;
+
+    pads.swap( it->second );
+    m_modulePads.erase( it );
+
+    for( D_PAD* pad : pads )
+        Remove( pad );
+
+    return pads;
+}
+
+
+void DRC::buildItemIndex()
+{
+    m_itemIndex.reset( new ITEM_INDEX );
+
+    // The pads and the tracks are ranked in board list order
+    for( D_PAD* pad : m_pcb->GetPads() )
+        m_itemIndex->AddPad( pad );
+
+    for( TRACK* track : m_pcb->Tracks() )
+        m_itemIndex->AddTrack( track );
+}
+
+
 void DRC::testPad2Pad()
 {
     std::vector<D_PAD*> sortedPads;
@@ -692,6 +1037,74 @@ void DRC::testPad2Pad()
     if( sortedPads.size() == 0 )
         return;
 
+    if( m_itemIndex )
+    {
+        const LSET all_cu = LSET::AllCuMask();
+
+        // Rank of the pads in sortedPads: each pair is tested once, from the first pad
+        std::unordered_map<const BOARD_ITEM*, size_t> rank;
+
+        for( size_t i = 0; i < sortedPads.size(); ++i )
+            rank[sortedPads[i]] = i;
+
+        runParallel( sortedPads.size(),
+                [&]( DRC* aWorker, size_t i )
+                {
+                    D_PAD*   pad = sortedPads[i];
+                    LSET     layers = pad->GetLayerSet() & all_cu;
+                    EDA_RECT bbox = pad->GetBoundingBox();
+
+                    // The hole is tested against the pads of all copper layers
+                    if( pad->GetDrillSize().x != 0 || pad->GetDrillSize().y != 0 )
+                    {
+                        int radius = std::max( pad->GetDrillSize().x, pad->GetDrillSize().y ) / 2;
+
+                        bbox.Merge( EDA_RECT( pad->GetPosition() - wxPoint( radius, radius ),
+                                              wxSize( 2 * radius, 2 * radius ) ) );
+                        layers = all_cu;
+                    }
+
+                    bbox.Inflate( pad->GetClearance() );
+
+                    std::vector<D_PAD*> candidates;
+
+                    for( PCB_LAYER_ID layer : layers.Seq() )
+                    {
+                        m_itemIndex->m_pads.Query( layer, bbox,
+                                [&]( BOARD_ITEM* aItem ) -> bool
+                                {
+                                    if( rank.at( aItem ) > i )
+                                        candidates.push_back( static_cast<D_PAD*>( aItem ) );
+
+                                    return true;
+                                } );
+                    }
+
+                    if( candidates.empty() )
+                        return;
+
+                    std::sort( candidates.begin(), candidates.end(),
+                               [&]( const D_PAD* a, const D_PAD* b )
+                               {
+                                   return rank.at( a ) < rank.at( b );
+                               } );
+
+                    candidates.erase( std::unique( candidates.begin(), candidates.end() ),
+                                      candidates.end() );
+
+                    D_PAD** listEnd = &candidates[0] + candidates.size();
+
+                    if( !aWorker->doPadToPadsDrc( pad, &candidates[0], listEnd, INT_MAX ) )
+                    {
+                        wxASSERT( aWorker->m_currentMarker );
+                        aWorker->addMarkerToPcb( aWorker->m_currentMarker );
+                        aWorker->m_currentMarker = nullptr;
+                    }
+                } );
+
+        return;
+    }
+
     // find the max size of the pads (used to stop the test)
     int max_size = 0;
 
@@ -790,7 +1203,7 @@ void DRC::testDrilledHoles()
             if( KiROUND( GetLineLength( checkHole.m_location, refHole.m_location ) )
                     <  checkHole.m_drillRadius + refHole.m_drillRadius + holeToHoleMin )
             {
-                addMarkerToPcb( new MARKER_PCB( m_pcbEditorFrame->GetUserUnits(),
+                addMarkerToPcb( new MARKER_PCB( userUnits(),
                                                 DRCE_DRILLED_HOLES_TOO_CLOSE, refHole.m_location,
                                                 refHole.m_owner, refHole.m_location,
                                                 checkHole.m_owner, checkHole.m_location ) );
@@ -805,12 +1218,12 @@ void DRC::testTracks( wxWindow *aActiveWindow, bool aShowProgressBar )
     wxProgressDialog * progressDialog = NULL;
     const int delta = 500;  // This is the number of tests between 2 calls to the
                             // progress bar
-    int count = 0;
+    std::vector<TRACK*> tracks;
 
-    for( TRACK* segm = m_pcb->m_Track; segm && segm->Next(); segm = segm->Next() )
-        count++;
+    for( TRACK* segm = m_pcb->m_Track; segm; segm = segm->Next() )
+        tracks.push_back( segm );
 
-    int deltamax = count/delta;
+    int deltamax = tracks.size() / delta;
 
     if( aShowProgressBar && deltamax > 3 )
     {
@@ -822,38 +1235,40 @@ void DRC::testTracks( wxWindow *aActiveWindow, bool aShowProgressBar )
         progressDialog->Update( 0, wxEmptyString );
     }
 
-    int ii = 0;
-    count = 0;
-
-    for( TRACK* segm = m_pcb->m_Track; segm; segm = segm->Next() )
+    auto testTrack = [&]( DRC* aWorker, size_t aIndex )
     {
-        if( ii++ > delta )
-        {
-            ii = 0;
-            count++;
-
-            if( progressDialog )
-            {
-                if( !progressDialog->Update( count, wxEmptyString ) )
-                    break;  // Aborted by user
-#ifdef __WXMAC__
-                // Work around a dialog z-order issue on OS X
-                if( count == deltamax )
-                    aActiveWindow->Raise();
-#endif
-            }
-        }
+        TRACK* segm = tracks[aIndex];
 
         // Test new segment against tracks and pads, optionally against copper zones
-        if( !doTrackDrc( segm, segm->Next(), true, m_doZonesTest ) )
+        if( !aWorker->doTrackDrc( segm, segm->Next(), true, m_doZonesTest ) )
         {
-            if( m_currentMarker )
+            if( aWorker->m_currentMarker )
             {
-                addMarkerToPcb ( m_currentMarker );
-                m_currentMarker = nullptr;
+                aWorker->addMarkerToPcb( aWorker->m_currentMarker );
+                aWorker->m_currentMarker = nullptr;
             }
         }
-    }
+    };
+
+    auto updateProgress = [&]( size_t aDone ) -> bool
+    {
+        int count = std::min<int>( aDone / delta, deltamax );
+
+        if( !progressDialog->Update( count, wxEmptyString ) )
+            return false;   // Aborted by user
+
+#ifdef __WXMAC__
+        // Work around a dialog z-order issue on OS X
+        if( count == deltamax )
+            aActiveWindow->Raise();
+#endif
+        return true;
+    };
+
+    if( progressDialog )
+        runParallel( tracks.size(), testTrack, updateProgress );
+    else
+        runParallel( tracks.size(), testTrack );
 
     if( progressDialog )
         progressDialog->Destroy();
@@ -877,7 +1292,7 @@ void DRC::testUnconnected()
         auto src = edge.GetSourcePos();
         auto dst = edge.GetTargetPos();
 
-        m_unconnected.emplace_back( new DRC_ITEM( m_pcbEditorFrame->GetUserUnits(),
+        m_unconnected.emplace_back( new DRC_ITEM( userUnits(),
                                                   DRCE_UNCONNECTED_ITEMS,
                                                   edge.GetSourceNode()->Parent(),
                                                   wxPoint( src.x, src.y ),
@@ -927,64 +1342,65 @@ void DRC::testZones()
 void DRC::testKeepoutAreas()
 {
     // Test keepout areas for vias, tracks and pads inside keepout areas
-    for( int ii = 0; ii < m_pcb->GetAreaCount(); ii++ )
+    runParallel( m_pcb->GetAreaCount(), [&]( DRC* aWorker, size_t aIndex )
     {
-        ZONE_CONTAINER* area = m_pcb->GetArea( ii );
+        ZONE_CONTAINER* area = m_pcb->GetArea( aIndex );
 
-        if( !area->GetIsKeepout() )
-        {
-            continue;
-        }
+        if( area->GetIsKeepout() )
+            aWorker->testKeepoutArea( area );
+    } );
+}
 
-        for( TRACK* segm = m_pcb->m_Track; segm != NULL; segm = segm->Next() )
+
+void DRC::testKeepoutArea( ZONE_CONTAINER* aArea )
+{
+    for( TRACK* segm = m_pcb->m_Track; segm != NULL; segm = segm->Next() )
+    {
+        if( segm->Type() == PCB_TRACE_T )
         {
-            if( segm->Type() == PCB_TRACE_T )
-            {
-                if( !area->GetDoNotAllowTracks()  )
-                    continue;
+            if( !aArea->GetDoNotAllowTracks()  )
+                continue;
 
-                // Ignore if the keepout zone is not on the same layer
-                if( !area->IsOnLayer( segm->GetLayer() ) )
-                    continue;
+            // Ignore if the keepout zone is not on the same layer
+            if( !aArea->IsOnLayer( segm->GetLayer() ) )
+                continue;
 
-                SEG trackSeg( segm->GetStart(), segm->GetEnd() );
+            SEG trackSeg( segm->GetStart(), segm->GetEnd() );
 
-                if( area->Outline()->Distance( trackSeg, segm->GetWidth() ) == 0 )
-                    addMarkerToPcb(
-                            m_markerFactory.NewMarker( segm, area, DRCE_TRACK_INSIDE_KEEPOUT ) );
-            }
-            else if( segm->Type() == PCB_VIA_T )
-            {
-                if( ! area->GetDoNotAllowVias()  )
-                    continue;
+            if( aArea->Outline()->Distance( trackSeg, segm->GetWidth() ) == 0 )
+                addMarkerToPcb(
+                        m_markerFactory.NewMarker( segm, aArea, DRCE_TRACK_INSIDE_KEEPOUT ) );
+        }
+        else if( segm->Type() == PCB_VIA_T )
+        {
+            if( ! aArea->GetDoNotAllowVias()  )
+                continue;
 
-                auto viaLayers = segm->GetLayerSet();
+            auto viaLayers = segm->GetLayerSet();
 
-                if( !area->CommonLayerExists( viaLayers ) )
-                    continue;
+            if( !aArea->CommonLayerExists( viaLayers ) )
+                continue;
 
-                if( area->Outline()->Distance( segm->GetPosition() ) < segm->GetWidth()/2 )
-                    addMarkerToPcb(
-                            m_markerFactory.NewMarker( segm, area, DRCE_VIA_INSIDE_KEEPOUT ) );
-            }
+            if( aArea->Outline()->Distance( segm->GetPosition() ) < segm->GetWidth()/2 )
+                addMarkerToPcb(
+                        m_markerFactory.NewMarker( segm, aArea, DRCE_VIA_INSIDE_KEEPOUT ) );
         }
-        // Test pads: TODO
     }
+    // Test pads: TODO
 }
 
 
 void DRC::testCopperTextAndGraphics()
 {
     // Test copper items for clearance violations with vias, tracks and pads
+    std::vector<BOARD_ITEM*> items;
 
     for( BOARD_ITEM* brdItem : m_pcb->Drawings() )
     {
         if( IsCopperLayer( brdItem->GetLayer() ) )
         {
-            if( brdItem->Type() == PCB_TEXT_T )
-                testCopperTextItem( brdItem );
-            else if( brdItem->Type() == PCB_LINE_T )
-                testCopperDrawItem( static_cast<DRAWSEGMENT*>( brdItem ));
+            if( brdItem->Type() == PCB_TEXT_T || brdItem->Type() == PCB_LINE_T )
+                items.push_back( brdItem );
         }
     }
 
@@ -994,10 +1410,10 @@ void DRC::testCopperTextAndGraphics()
         TEXTE_MODULE& val = module->Value();
 
         if( ref.IsVisible() && IsCopperLayer( ref.GetLayer() ) )
-            testCopperTextItem( &ref );
+            items.push_back( &ref );
 
         if( val.IsVisible() && IsCopperLayer( val.GetLayer() ) )
-            testCopperTextItem( &val );
+            items.push_back( &val );
 
         if( module->IsNetTie() )
             continue;
@@ -1007,12 +1423,34 @@ void DRC::testCopperTextAndGraphics()
             if( IsCopperLayer( item->GetLayer() ) )
             {
                 if( item->Type() == PCB_MODULE_TEXT_T && ( (TEXTE_MODULE*) item )->IsVisible() )
-                    testCopperTextItem( item );
+                    items.push_back( item );
                 else if( item->Type() == PCB_MODULE_EDGE_T )
-                    testCopperDrawItem( static_cast<DRAWSEGMENT*>( item ));
+                    items.push_back( item );
             }
         }
     }
+
+    // The text shapes are built by the (single) stroke font renderer, so they are built
+    // here, before the tests are sharded.
+    std::vector<std::vector<wxPoint>> textShapes( items.size() );
+
+    for( size_t ii = 0; ii < items.size(); ++ii )
+    {
+        EDA_TEXT* text = dynamic_cast<EDA_TEXT*>( items[ii] );
+
+        if( text )
+            text->TransformTextShapeToSegmentList( textShapes[ii] );
+    }
+
+    runParallel( items.size(), [&]( DRC* aWorker, size_t aIndex )
+    {
+        BOARD_ITEM* item = items[aIndex];
+
+        if( item->Type() == PCB_LINE_T || item->Type() == PCB_MODULE_EDGE_T )
+            aWorker->testCopperDrawItem( static_cast<DRAWSEGMENT*>( item ) );
+        else
+            aWorker->testCopperTextItem( item, textShapes[aIndex] );
+    } );
 }
 
 
@@ -1134,19 +1572,16 @@ void DRC::testCopperDrawItem( DRAWSEGMENT* aItem )
 }
 
 
-void DRC::testCopperTextItem( BOARD_ITEM* aTextItem )
+void DRC::testCopperTextItem( BOARD_ITEM* aTextItem, const std::vector<wxPoint>& aTextShape )
 {
     EDA_TEXT* text = dynamic_cast<EDA_TEXT*>( aTextItem );
 
     if( text == nullptr )
         return;
 
-    std::vector<wxPoint> textShape;      // a buffer to store the text shape (set of segments)
+    const std::vector<wxPoint>& textShape = aTextShape;
     int textWidth = text->GetThickness();
 
-    // So far the bounding box makes up the text-area
-    text->TransformTextShapeToSegmentList( textShape );
-
     if( textShape.size() == 0 )     // Should not happen (empty text?)
         return;
 
@@ -1235,7 +1670,7 @@ void DRC::testOutline()
 
 void DRC::testDisabledLayers()
 {
-    BOARD* board = m_pcbEditorFrame->GetBoard();
+    BOARD* board = m_pcb;
     wxCHECK( board, /*void*/ );
     LSET disabledLayers = board->GetEnabledLayers().flip();
 
@@ -31,8 +31,13 @@
 
 #include <vector>
 #include <memory>
+#include <functional>
+#include <chrono>
+#include <unordered_map>
 #include <geometry/seg.h>
 #include <geometry/shape_poly_set.h>
+#include <board_item_rtree.h>
+#include <board_listener.h>
 
 #include <drc/drc_marker_factory.h>
 
@@ -172,11 +177,26 @@ typedef std::vector<DRC_ITEM*> DRC_LIST;
  * be sent to a text file on disk.
  * This class is given access to the windows and the BOARD
  * that it needs via its constructor or public access functions.
+ *
+ * Once RunTests() has checked the board of the editor frame, the DRC follows the changes
+ * of the board (online DRC): after each BOARD_COMMIT, the clearances of the changed
+ * tracks and pads are tested again, and their markers are updated.
  */
-class DRC
+class DRC : public BOARD_LISTENER
 {
     friend class DIALOG_DRC_CONTROL;
 
+public:
+    /**
+     * Run time and violation count of one of the tests run by RunTests()
+     */
+    struct TEST_STATS
+    {
+        wxString                  m_name;
+        std::chrono::microseconds m_duration;
+        int                       m_violations;
+    };
+
 private:
 
     //  protected or private functions() are lowercase first character.
@@ -224,7 +244,8 @@ private:
     int                 m_xcliphi;
     int                 m_ycliphi;
 
-    PCB_EDIT_FRAME*     m_pcbEditorFrame;   ///< The pcb frame editor which owns the board
+    PCB_EDIT_FRAME*     m_pcbEditorFrame;   ///< The pcb frame editor which owns the board,
+                                            ///< nullptr when running without UI
     BOARD*              m_pcb;
     SHAPE_POLY_SET      m_board_outlines;   ///< The board outline including cutouts
     DIALOG_DRC_CONTROL* m_drcDialog;
@@ -232,6 +253,71 @@ private:
 
     DRC_LIST            m_unconnected;      ///< list of unconnected pads, as DRC_ITEMs
 
+    std::vector<TEST_STATS> m_testStats;    ///< Stats of the tests of the last RunTests()
+
+    EDA_UNITS_T         m_units;            ///< Message units when there is no editor frame
+
+    /// When set (no editor frame), the markers are given to it instead of the board
+    std::function<void( MARKER_PCB* )> m_markerHandler;
+
+    int                 m_markerCount;      ///< Number of markers created by RunTests()
+
+    /**
+     * Spatial index of the copper items, built by RunTests() so the clearance tests only
+     * compare the items which are close to each other.  Boxes are inflated by the item
+     * clearance.  m_order gives the rank of an item in the board pad or track list, and is
+     * used to test each pair only once and to keep the markers in the list order.
+     */
+    struct ITEM_INDEX
+    {
+        /// Layers and box of an indexed item, to remove it from the trees
+        struct ENTRY
+        {
+            bool  m_isPad;
+            LSET  m_layers;
+            BOX2I m_bbox;
+        };
+
+        BOARD_ITEM_RTREE                                m_pads;
+        BOARD_ITEM_RTREE                                m_tracks;
+        std::unordered_map<const BOARD_ITEM*, int>      m_order;
+        std::unordered_map<const BOARD_ITEM*, ENTRY>    m_entries;
+
+        /// Indexed pads of each module
+        std::unordered_map<const BOARD_ITEM*, std::vector<D_PAD*>> m_modulePads;
+
+        int m_nextOrder = 0;
+
+        void AddPad( D_PAD* aPad );
+        void AddTrack( TRACK* aTrack );
+
+        /// Removes a track or a pad.  aItem is not dereferenced.
+        void Remove( const BOARD_ITEM* aItem );
+
+        /**
+         * Removes the pads of aModule as they were indexed (the module can have lost pads
+         * since), and returns them.  The pads are not dereferenced.
+         */
+        std::vector<D_PAD*> RemoveModulePads( const BOARD_ITEM* aModule );
+    };
+
+    std::shared_ptr<ITEM_INDEX> m_itemIndex;    ///< nullptr outside of RunTests()
+
+    BOARD*                      m_onlineBoard;  ///< The board followed by the online DRC
+    bool                        m_onlineEnabled;    ///< true after a RunTests() of m_onlineBoard
+
+    /**
+     * Index of the followed board, updated after each commit.  nullptr until the next
+     * commit when the board has changed without a commit (undo/redo, ...).
+     */
+    std::shared_ptr<ITEM_INDEX> m_onlineIndex;
+
+    /**
+     * In the workers of runParallel(), the markers are stored in this buffer instead of
+     * being added to the board.  nullptr in the main DRC.
+     */
+    std::vector<MARKER_PCB*>*   m_markerSink;
+
 
     /**
      * Update needed pointers from the one pointer which is known not to change.
@@ -243,6 +329,61 @@ private:
      */
     void addMarkerToPcb( MARKER_PCB* aMarker );
 
+    /**
+     * Adds a list of DRC markers to the PCB through a single COMMIT (or gives them to
+     * m_markerHandler when running without UI).
+     */
+    void addMarkersToPcb( const std::vector<MARKER_PCB*>& aMarkers );
+
+    /**
+     * @return the units used in the messages
+     */
+    EDA_UNITS_T userUnits() const;
+
+    /**
+     * Runs aTest( worker, ii ) for each ii from 0 to aCount - 1, sharded across threads.
+     *
+     * The DRC tests store intermediate results in members, so each thread uses its own
+     * worker DRC (see the worker constructor), and the markers found for each index are
+     * buffered.  When all the threads are done, the markers are added to the board in
+     * index order, so the marker list does not depend on the thread scheduling.
+     *
+     * The tests must only read the board.
+     *
+     * @param aCount is the number of tests to run
+     * @param aTest runs the test of index ii with the given worker
+     * @param aProgress if not null, is called periodically from the calling thread with
+     * the number of tests done, and returns false to cancel the remaining tests
+     */
+    void runParallel( size_t aCount, const std::function<void( DRC*, size_t )>& aTest,
+                      const std::function<bool( size_t )>& aProgress = nullptr );
+
+    /**
+     * Builds m_itemIndex from the pads and tracks of the board.
+     */
+    void buildItemIndex();
+
+    /**
+     * Fills aPads with the pads of the board which can violate the clearance of aRefSeg,
+     * in board pad list order.  Uses m_itemIndex when it is built, else returns all pads.
+     */
+    void collectPadCandidates( TRACK* aRefSeg, std::vector<D_PAD*>& aPads ) const;
+
+    /**
+     * Fills aTracks with the tracks of the list starting at aStart which can violate the
+     * clearance of aRefSeg, in list order.  Uses m_itemIndex when it is built, else walks
+     * the list.
+     */
+    void collectTrackCandidates( TRACK* aRefSeg, TRACK* aStart,
+                                 std::vector<TRACK*>& aTracks ) const;
+
+    /**
+     * Tests again the changed tracks and pads, and the tracks close to the changed pads,
+     * and replaces their clearance markers.  Removes the markers of the removed items.
+     */
+    void testChangedItems( const std::vector<BOARD_ITEM*>& aChanged,
+                           const std::vector<BOARD_ITEM*>& aRemoved );
+
     //-----<categorical group tests>-----------------------------------------
 
     /**
@@ -276,8 +417,12 @@ private:
 
     void testKeepoutAreas();
 
+    void testKeepoutArea( ZONE_CONTAINER* aArea );
+
     // aTextItem is type BOARD_ITEM* to accept either TEXTE_PCB or TEXTE_MODULE
-    void testCopperTextItem( BOARD_ITEM* aTextItem );
+    // aTextShape is the text shape (set of segments) built by
+    // EDA_TEXT::TransformTextShapeToSegmentList(), which cannot run in a worker thread
+    void testCopperTextItem( BOARD_ITEM* aTextItem, const std::vector<wxPoint>& aTextShape );
 
     void testCopperDrawItem( DRAWSEGMENT* aDrawing );
 
@@ -298,14 +443,12 @@ private:
     /**
      * Test the clearance between aRefPad and other pads.
      *
-     * The pad list must be sorted by x coordinate.
-     *
      * @param aRefPad is the pad to test
      * @param aStart is the first pad of the list to test against aRefPad
      * @param aEnd is the end of the list and is not included
-     * @param x_limit is used to stop the test
-     * (i.e. when the current pad pos X in list exceeds this limit, because the list
-     * is sorted by X coordinate)
+     * @param x_limit is used to stop the test when the list is sorted by x coordinate
+     * (i.e. when the current pad pos X in list exceeds this limit).  Use INT_MAX for
+     * an unsorted list.
      */
     bool doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_limit );
 
@@ -402,11 +545,36 @@ private:
 
     //-----</single tests>---------------------------------------------
 
+    /**
+     * Creates a worker for runParallel(): it shares the board, the settings and the item
+     * index of aParent, but has its own intermediate results.  Its markers are only
+     * recorded (see DRC_MARKER_FACTORY::SetRecordMode()).
+     */
+    DRC( const DRC* aParent );
+
 public:
     DRC( PCB_EDIT_FRAME* aPcbWindow );
 
+    /**
+     * Creates a DRC without UI (for batch runs): the markers are not added to aBoard, but
+     * given to aMarkerHandler which takes their ownership.
+     */
+    DRC( BOARD* aBoard, EDA_UNITS_T aUnits,
+         const std::function<void( MARKER_PCB* )>& aMarkerHandler );
+
     ~DRC();
 
+    /**
+     * Follows the changes of aBoard (the board of the editor frame) instead of the
+     * previous one.  The online DRC starts after the next RunTests().
+     */
+    void SetBoard( BOARD* aBoard );
+
+    void OnBoardItemsChanged( BOARD& aBoard, const std::vector<BOARD_ITEM*>& aChanged,
+                              const std::vector<BOARD_ITEM*>& aRemoved ) override;
+
+    void OnBoardInvalidated( BOARD& aBoard ) override;
+
     /**
      * Function Drc
      * tests the current segment and returns the result and displays the error
@@ -512,6 +680,14 @@ public:
      */
     void ListUnconnectedPads();
 
+    /**
+     * @return the run time and violation count of each test of the last RunTests()
+     */
+    const std::vector<TEST_STATS>& GetTestStats() const
+    {
+        return m_testStats;
+    }
+
     /**
      * @return a pointer to the current marker (last created marker
      */
@@ -45,7 +45,35 @@
 const int EPSILON = Mils2iu( 5 );
 
 
-DRC_MARKER_FACTORY::DRC_MARKER_FACTORY()
+/**
+ * A marker created in record mode: it has no text, only the data to build the marker.
+ */
+class RECORDED_MARKER : public MARKER_PCB
+{
+public:
+    RECORDED_MARKER( int aErrorCode, const wxPoint& aMarkerPos, BOARD_ITEM* aItem,
+                     const wxPoint& aPos, BOARD_ITEM* bItem, const wxPoint& bPos ) :
+        MARKER_PCB( nullptr ),
+        m_errorCode( aErrorCode ),
+        m_markerPos( aMarkerPos ),
+        m_item( aItem ),
+        m_pos( aPos ),
+        m_bItem( bItem ),
+        m_bPos( bPos )
+    {
+    }
+
+    int         m_errorCode;
+    wxPoint     m_markerPos;
+    BOARD_ITEM* m_item;
+    wxPoint     m_pos;
+    BOARD_ITEM* m_bItem;
+    wxPoint     m_bPos;
+};
+
+
+DRC_MARKER_FACTORY::DRC_MARKER_FACTORY() :
+    m_recordMode( false )
 {
     SetUnits( EDA_UNITS_T::MILLIMETRES );
 }
@@ -63,6 +91,32 @@ void DRC_MARKER_FACTORY::SetUnits( EDA_UNITS_T aUnits )
 }
 
 
+MARKER_PCB* DRC_MARKER_FACTORY::newMarker( int aErrorCode, const wxPoint& aMarkerPos,
+        BOARD_ITEM* aItem, const wxPoint& aPos, BOARD_ITEM* bItem, const wxPoint& bPos ) const
+{
+    if( m_recordMode )
+        return new RECORDED_MARKER( aErrorCode, aMarkerPos, aItem, aPos, bItem, bPos );
+
+    return new MARKER_PCB( getCurrentUnits(), aErrorCode, aMarkerPos, aItem, aPos, bItem, bPos );
+}
+
+
+MARKER_PCB* DRC_MARKER_FACTORY::BuildRecordedMarker( MARKER_PCB* aMarker ) const
+{
+    RECORDED_MARKER* recorded = dynamic_cast<RECORDED_MARKER*>( aMarker );
+
+    if( !recorded )
+        return aMarker;
+
+    MARKER_PCB* marker = new MARKER_PCB( getCurrentUnits(), recorded->m_errorCode,
+                                         recorded->m_markerPos, recorded->m_item,
+                                         recorded->m_pos, recorded->m_bItem, recorded->m_bPos );
+    delete recorded;
+
+    return marker;
+}
+
+
 MARKER_PCB* DRC_MARKER_FACTORY::NewMarker(
         TRACK* aTrack, ZONE_CONTAINER* aConflictZone, int aErrorCode ) const
 {
@@ -102,7 +156,7 @@ MARKER_PCB* DRC_MARKER_FACTORY::NewMarker(
         markerPos = pt1;
     }
 
-    return new MARKER_PCB( getCurrentUnits(), aErrorCode, markerPos, aTrack, aTrack->GetPosition(),
+    return newMarker( aErrorCode, markerPos, aTrack, aTrack->GetPosition(),
             aConflictZone, aConflictZone->GetPosition() );
 }
 
@@ -126,7 +180,7 @@ MARKER_PCB* DRC_MARKER_FACTORY::NewMarker(
     // Once we're within EPSILON pt1 and pt2 are "equivalent"
     markerPos = pt1;
 
-    return new MARKER_PCB( getCurrentUnits(), aErrorCode, markerPos, aTrack, aTrack->GetPosition(),
+    return newMarker( aErrorCode, markerPos, aTrack, aTrack->GetPosition(),
             aConflitItem, aConflitItem->GetPosition() );
 }
 
@@ -134,7 +188,7 @@ MARKER_PCB* DRC_MARKER_FACTORY::NewMarker(
 MARKER_PCB* DRC_MARKER_FACTORY::NewMarker(
         D_PAD* aPad, BOARD_ITEM* aConflictItem, int aErrorCode ) const
 {
-    return new MARKER_PCB( getCurrentUnits(), aErrorCode, aPad->GetPosition(), aPad,
+    return newMarker( aErrorCode, aPad->GetPosition(), aPad,
             aPad->GetPosition(), aConflictItem, aConflictItem->GetPosition() );
 }
 
@@ -142,15 +196,14 @@ MARKER_PCB* DRC_MARKER_FACTORY::NewMarker(
 MARKER_PCB* DRC_MARKER_FACTORY::NewMarker(
         const wxPoint& aPos, BOARD_ITEM* aItem, int aErrorCode ) const
 {
-    return new MARKER_PCB(
-            getCurrentUnits(), aErrorCode, aPos, aItem, aPos, nullptr, wxPoint() );
+    return newMarker( aErrorCode, aPos, aItem, aPos, nullptr, wxPoint() );
 }
 
 
 MARKER_PCB* DRC_MARKER_FACTORY::NewMarker(
         const wxPoint& aPos, BOARD_ITEM* aItem, BOARD_ITEM* bItem, int aErrorCode ) const
 {
-    return new MARKER_PCB( getCurrentUnits(), aErrorCode, aPos, aItem, aItem->GetPosition(), bItem,
+    return newMarker( aErrorCode, aPos, aItem, aItem->GetPosition(), bItem,
             bItem->GetPosition() );
 }
 
@@ -92,13 +92,31 @@ public:
      */
     MARKER_PCB* NewMarker( int aErrorCode, const wxString& aMessage ) const;
 
+    /**
+     * Set the record mode, used by the DRC threads.  The marker texts are translated, which
+     * is not thread-safe: in record mode, the new markers only record the error code, the
+     * items and the positions, and the markers are built by BuildRecordedMarker().
+     */
+    void SetRecordMode( bool aRecord ) { m_recordMode = aRecord; }
+
+    /**
+     * Build the marker recorded by aMarker in record mode, and delete aMarker.
+     * Any other marker is returned as is.  Must be called by the main thread.
+     */
+    MARKER_PCB* BuildRecordedMarker( MARKER_PCB* aMarker ) const;
+
 private:
     EDA_UNITS_T getCurrentUnits() const
     {
         return m_units_provider();
     }
 
+    /// Create (or record, in record mode) a marker on one or two items
+    MARKER_PCB* newMarker( int aErrorCode, const wxPoint& aMarkerPos, BOARD_ITEM* aItem,
+                           const wxPoint& aPos, BOARD_ITEM* bItem, const wxPoint& bPos ) const;
+
     UNITS_PROVIDER m_units_provider;
+    bool           m_recordMode;
 };
 
 #endif // DRC_DRC_MARKER_FACTORY__H
\ No newline at end of file
@@ -135,9 +135,96 @@ bool convex2pointDRC( wxPoint* aTref, int aTrefCount, wxPoint aPcompare, int aDi
 }
 
 
+void DRC::collectPadCandidates( TRACK* aRefSeg, std::vector<D_PAD*>& aPads ) const
+{
+    aPads.clear();
+
+    if( !m_itemIndex )
+    {
+        aPads = m_pcb->GetPads();
+        return;
+    }
+
+    // The pad boxes in the index are inflated by the pad clearance, so inflating the
+    // reference box by its own clearance finds all the pads closer than the largest of
+    // both clearances.  The netclass clearance is also used for the pad hole tests.
+    EDA_RECT bbox = aRefSeg->GetBoundingBox();
+    bbox.Inflate( std::max( aRefSeg->GetClearance(), aRefSeg->GetNetClass()->GetClearance() ) );
+
+    for( PCB_LAYER_ID layer : ( aRefSeg->GetLayerSet() & LSET::AllCuMask() ).Seq() )
+    {
+        m_itemIndex->m_pads.Query( layer, bbox,
+                [&]( BOARD_ITEM* aItem ) -> bool
+                {
+                    aPads.push_back( static_cast<D_PAD*>( aItem ) );
+                    return true;
+                } );
+    }
+
+    // Keep the board pad list order (and remove the pads found on several layers)
+    auto& order = m_itemIndex->m_order;
+
+    std::sort( aPads.begin(), aPads.end(),
+               [&]( const D_PAD* a, const D_PAD* b )
+               {
+                   return order.at( a ) < order.at( b );
+               } );
+
+    aPads.erase( std::unique( aPads.begin(), aPads.end() ), aPads.end() );
+}
+
+
+void DRC::collectTrackCandidates( TRACK* aRefSeg, TRACK* aStart,
+                                  std::vector<TRACK*>& aTracks ) const
+{
+    aTracks.clear();
+
+    if( !aStart )
+        return;
+
+    // The index only knows the tracks of the board (not, for instance, the track being
+    // created in the legacy router)
+    if( !m_itemIndex || !m_itemIndex->m_order.count( aStart ) )
+    {
+        for( TRACK* track = aStart; track; track = track->Next() )
+            aTracks.push_back( track );
+
+        return;
+    }
+
+    auto& order = m_itemIndex->m_order;
+
+    // Only the tracks from aStart to the end of the list are tested (testTracks() gives
+    // the next track, so each pair is tested once).  The online DRC gives the head of the
+    // list, and the new tracks are ranked last, so the whole list is tested in this case.
+    int      first = ( aStart == m_pcb->m_Track ) ? INT_MIN : order.at( aStart );
+    EDA_RECT bbox = aRefSeg->GetBoundingBox();
+    bbox.Inflate( aRefSeg->GetClearance() );
+
+    for( PCB_LAYER_ID layer : ( aRefSeg->GetLayerSet() & LSET::AllCuMask() ).Seq() )
+    {
+        m_itemIndex->m_tracks.Query( layer, bbox,
+                [&]( BOARD_ITEM* aItem ) -> bool
+                {
+                    if( order.at( aItem ) >= first )
+                        aTracks.push_back( static_cast<TRACK*>( aItem ) );
+
+                    return true;
+                } );
+    }
+
+    std::sort( aTracks.begin(), aTracks.end(),
+               [&]( const TRACK* a, const TRACK* b )
+               {
+                   return order.at( a ) < order.at( b );
+               } );
+
+    aTracks.erase( std::unique( aTracks.begin(), aTracks.end() ), aTracks.end() );
+}
+
+
 bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool aTestPads, bool aTestZones )
 {
-    TRACK*    track;
     wxPoint   delta;           // length on X and Y axis of segments
     LSET layerMask;
     int       net_code_ref;
@@ -158,14 +245,14 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool aTestPads, bool aTestZ
                 markers.pop_back();
             }
         }
+        else if( m_markerSink )
+        {
+            m_markerSink->insert( m_markerSink->end(), markers.begin(), markers.end() );
+            markers.clear();
+        }
         else
         {
-            BOARD_COMMIT commit( m_pcbEditorFrame );
-
-            for( auto marker : markers )
-                commit.Add( marker );
-
-            commit.Push( wxEmptyString, false, false );
+            addMarkersToPcb( markers );
         }
     };
 
@@ -356,13 +443,12 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool aTestPads, bool aTestZ
     // Compute the min distance to pads
     if( aTestPads )
     {
-        unsigned pad_count = m_pcb->GetPadCount();
+        std::vector<D_PAD*> pads;
 
-        auto pads = m_pcb->GetPads();
+        collectPadCandidates( aRefSeg, pads );
 
-        for( unsigned ii = 0; ii < pad_count; ++ii )
+        for( D_PAD* pad : pads )
         {
-            D_PAD* pad = pads[ii];
             SEG padSeg( pad->GetPosition(), pad->GetPosition() );
 
 
@@ -431,7 +517,11 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool aTestPads, bool aTestZ
     wxPoint segStartPoint;
     wxPoint segEndPoint;
 
-    for( track = aStart; track; track = track->Next() )
+    std::vector<TRACK*> tracks;
+
+    collectTrackCandidates( aRefSeg, aStart, tracks );
+
+    for( TRACK* track : tracks )
     {
         // No problem if segments have the same net code:
         if( net_code_ref == track->GetNetCode() )
@@ -0,0 +1,445 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file drc_online.cpp
+ * Online DRC: the clearances of the items changed by a BOARD_COMMIT are tested again
+ * against their neighbours, using the item index built by the last full DRC.
+ */
+
+#include <set>
+#include <unordered_set>
+
+#include <fctsys.h>
+#include <pcb_edit_frame.h>
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <class_pad.h>
+#include <class_zone.h>
+#include <class_marker_pcb.h>
+#include <board_commit.h>
+
+#include <drc.h>
+
+
+/**
+ * @return true if aCode is one of the error codes of doTrackDrc() and doPadToPadsDrc(),
+ * i.e. if the marker is created again when its items are tested again
+ */
+static bool isClearanceError( int aCode, bool aTestZones )
+{
+    switch( aCode )
+    {
+    case DRCE_TRACK_NEAR_THROUGH_HOLE:
+    case DRCE_TRACK_NEAR_PAD:
+    case DRCE_TRACK_NEAR_VIA:
+    case DRCE_VIA_NEAR_VIA:
+    case DRCE_VIA_NEAR_TRACK:
+    case DRCE_TRACK_ENDS1:
+    case DRCE_TRACK_ENDS2:
+    case DRCE_TRACK_ENDS3:
+    case DRCE_TRACK_ENDS4:
+    case DRCE_TRACK_SEGMENTS_TOO_CLOSE:
+    case DRCE_TRACKS_CROSSING:
+    case DRCE_ENDS_PROBLEM1:
+    case DRCE_ENDS_PROBLEM2:
+    case DRCE_ENDS_PROBLEM3:
+    case DRCE_ENDS_PROBLEM4:
+    case DRCE_ENDS_PROBLEM5:
+    case DRCE_PAD_NEAR_PAD1:
+    case DRCE_VIA_HOLE_BIGGER:
+    case DRCE_MICRO_VIA_INCORRECT_LAYER_PAIR:
+    case DRCE_HOLE_NEAR_PAD:
+    case DRCE_TOO_SMALL_TRACK_WIDTH:
+    case DRCE_TOO_SMALL_VIA:
+    case DRCE_TOO_SMALL_MICROVIA:
+    case DRCE_TOO_SMALL_VIA_DRILL:
+    case DRCE_TOO_SMALL_MICROVIA_DRILL:
+    case DRCE_MICRO_VIA_NOT_ALLOWED:
+    case DRCE_BURIED_VIA_NOT_ALLOWED:
+    case DRCE_TRACK_NEAR_EDGE:
+        return true;
+
+    case DRCE_TRACK_NEAR_ZONE:
+        return aTestZones;
+
+    default:
+        return false;
+    }
+}
+
+
+void DRC::SetBoard( BOARD* aBoard )
+{
+    if( aBoard == m_onlineBoard )
+        return;
+
+    if( m_onlineBoard )
+        m_onlineBoard->RemoveListener( this );
+
+    m_onlineBoard = aBoard;
+    m_onlineEnabled = false;
+    m_onlineIndex.reset();
+
+    if( m_onlineBoard )
+        m_onlineBoard->AddListener( this );
+}
+
+
+void DRC::OnBoardInvalidated( BOARD& aBoard )
+{
+    // The index is built again on the next commit
+    m_onlineIndex.reset();
+}
+
+
+void DRC::OnBoardItemsChanged( BOARD& aBoard, const std::vector<BOARD_ITEM*>& aChanged,
+                               const std::vector<BOARD_ITEM*>& aRemoved )
+{
+    if( !m_onlineEnabled || &aBoard != m_onlineBoard )
+        return;
+
+    m_pcb = m_onlineBoard;
+
+    if( !m_onlineIndex )
+    {
+        // The board has changed without a commit: index it again.  The changes of this
+        // commit are already indexed, but indexing them again is harmless.
+        m_board_outlines.RemoveAllContours();
+        m_pcb->GetBoardPolygonOutlines( m_board_outlines );
+
+        buildItemIndex();
+        m_onlineIndex = m_itemIndex;
+        m_itemIndex.reset();
+    }
+
+    testChangedItems( aChanged, aRemoved );
+}
+
+
+void DRC::testChangedItems( const std::vector<BOARD_ITEM*>& aChanged,
+                            const std::vector<BOARD_ITEM*>& aRemoved )
+{
+    std::vector<TRACK*>             tracks;         // the tracks to test again
+    std::vector<D_PAD*>             pads;           // the pads to test again
+    std::unordered_set<const void*> retested;       // tracks and pads to test again
+    std::unordered_set<const void*> removed;        // items which are not on the board
+    std::unordered_set<const void*> changedZones;   // zones whose markers are replaced
+    bool                            outlineChanged = false;
+
+    // Copper layers and box of the changed zones and board edges
+    std::vector<std::pair<LSET, BOX2I>> changedAreas;
+
+    // The tracks and pads near a changed zone or board edge are tested again
+    auto addChangedArea = [&]( BOARD_ITEM* aItem )
+    {
+        BOX2I area = aItem->GetBoundingBox();
+        area.Normalize();
+        area.Inflate( m_pcb->GetDesignSettings().GetBiggestClearanceValue() );
+
+        // A board edge is tested against the items of all copper layers
+        LSET layers = LSET::AllCuMask();
+
+        if( aItem->Type() == PCB_ZONE_AREA_T )
+            layers &= aItem->GetLayerSet();
+
+        changedAreas.emplace_back( layers, area );
+    };
+
+    for( BOARD_ITEM* item : aRemoved )
+    {
+        removed.insert( item );
+
+        if( item->Type() == PCB_MODULE_T )
+        {
+            for( D_PAD* pad : m_onlineIndex->RemoveModulePads( item ) )
+                removed.insert( pad );
+        }
+        else
+        {
+            m_onlineIndex->Remove( item );
+        }
+
+        if( item->Type() == PCB_LINE_T && item->GetLayer() == Edge_Cuts )
+        {
+            outlineChanged = true;
+            addChangedArea( item );
+        }
+        else if( item->Type() == PCB_ZONE_AREA_T )
+        {
+            addChangedArea( item );
+        }
+    }
+
+    for( BOARD_ITEM* item : aChanged )
+    {
+        switch( item->Type() )
+        {
+        case PCB_TRACE_T:
+        case PCB_VIA_T:
+            m_onlineIndex->Remove( item );
+            m_onlineIndex->AddTrack( static_cast<TRACK*>( item ) );
+
+            if( retested.insert( item ).second )
+                tracks.push_back( static_cast<TRACK*>( item ) );
+
+            break;
+
+        case PCB_MODULE_T:
+        {
+            MODULE* module = static_cast<MODULE*>( item );
+
+            // The pads which are no more in the module are handled as removed items
+            for( D_PAD* pad : m_onlineIndex->RemoveModulePads( module ) )
+                removed.insert( pad );
+
+            for( D_PAD* pad : module->Pads() )
+            {
+                removed.erase( pad );
+                m_onlineIndex->AddPad( pad );
+
+                if( retested.insert( pad ).second )
+                    pads.push_back( pad );
+            }
+
+            break;
+        }
+
+        case PCB_LINE_T:
+            if( item->GetLayer() == Edge_Cuts )
+            {
+                outlineChanged = true;
+                addChangedArea( item );
+            }
+
+            break;
+
+        case PCB_ZONE_AREA_T:
+            changedZones.insert( item );
+            addChangedArea( item );
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    if( outlineChanged )
+    {
+        m_board_outlines.RemoveAllContours();
+        m_pcb->GetBoardPolygonOutlines( m_board_outlines );
+    }
+
+    auto retestTrack = [&]( BOARD_ITEM* aItem )
+    {
+        if( retested.insert( aItem ).second )
+            tracks.push_back( static_cast<TRACK*>( aItem ) );
+
+        return true;
+    };
+
+    auto retestPad = [&]( BOARD_ITEM* aItem )
+    {
+        if( retested.insert( aItem ).second )
+            pads.push_back( static_cast<D_PAD*>( aItem ) );
+
+        return true;
+    };
+
+    for( const auto& area : changedAreas )
+    {
+        for( PCB_LAYER_ID layer : area.first.Seq() )
+        {
+            m_onlineIndex->m_tracks.Query( layer, area.second, retestTrack );
+            m_onlineIndex->m_pads.Query( layer, area.second, retestPad );
+        }
+    }
+
+    // The old position of a changed zone or edge is unknown: the tracks of its markers
+    // are tested again
+    if( outlineChanged || !changedZones.empty() )
+    {
+        for( int ii = 0; ii < m_pcb->GetMARKERCount(); ++ii )
+        {
+            const DRC_ITEM& drcItem = m_pcb->GetMARKER( ii )->GetReporter();
+            const void*     mainItem = drcItem.GetMainItemWeakRef();
+
+            if( ( outlineChanged && drcItem.GetErrorCode() == DRCE_TRACK_NEAR_EDGE )
+                || changedZones.count( drcItem.GetAuxItemWeakRef() ) )
+            {
+                auto entry = m_onlineIndex->m_entries.find(
+                        static_cast<const BOARD_ITEM*>( mainItem ) );
+
+                if( entry != m_onlineIndex->m_entries.end() && !entry->second.m_isPad )
+                    retestTrack( const_cast<BOARD_ITEM*>( entry->first ) );
+            }
+        }
+    }
+
+    // The tracks close to the changed pads are tested again, because their markers with
+    // these pads are replaced
+    for( D_PAD* pad : pads )
+    {
+        const ITEM_INDEX::ENTRY& entry = m_onlineIndex->m_entries.at( pad );
+
+        for( PCB_LAYER_ID layer : entry.m_layers.Seq() )
+        {
+            m_onlineIndex->m_tracks.Query( layer, entry.m_bbox, retestTrack );
+        }
+    }
+
+    // Collect the markers to replace: the markers of the removed items, and the clearance
+    // markers of the items tested again
+    std::vector<MARKER_PCB*> oldMarkers;
+
+    for( int ii = 0; ii < m_pcb->GetMARKERCount(); ++ii )
+    {
+        MARKER_PCB*     marker = m_pcb->GetMARKER( ii );
+        const DRC_ITEM& drcItem = marker->GetReporter();
+        const void*     mainItem = drcItem.GetMainItemWeakRef();
+        const void*     auxItem = drcItem.GetAuxItemWeakRef();
+
+        if( removed.count( mainItem ) || removed.count( auxItem ) )
+        {
+            oldMarkers.push_back( marker );
+        }
+        else if( isClearanceError( drcItem.GetErrorCode(), m_doZonesTest )
+                 && ( retested.count( mainItem ) || retested.count( auxItem ) ) )
+        {
+            oldMarkers.push_back( marker );
+        }
+    }
+
+    // Test the items again, against all their neighbours
+    std::vector<MARKER_PCB*> newMarkers;
+
+    m_itemIndex = m_onlineIndex;
+    m_markerSink = &newMarkers;
+
+    for( TRACK* track : tracks )
+        doTrackDrc( track, m_pcb->m_Track, true, m_doZonesTest );
+
+    if( m_doPad2PadTest )
+    {
+        auto& order = m_onlineIndex->m_order;
+
+        for( D_PAD* pad : pads )
+        {
+            const ITEM_INDEX::ENTRY& entry = m_onlineIndex->m_entries.at( pad );
+            std::vector<D_PAD*>      candidates;
+
+            for( PCB_LAYER_ID layer : entry.m_layers.Seq() )
+            {
+                m_onlineIndex->m_pads.Query( layer, entry.m_bbox,
+                        [&]( BOARD_ITEM* aItem ) -> bool
+                        {
+                            if( aItem != pad )
+                                candidates.push_back( static_cast<D_PAD*>( aItem ) );
+
+                            return true;
+                        } );
+            }
+
+            if( candidates.empty() )
+                continue;
+
+            std::sort( candidates.begin(), candidates.end(),
+                       [&]( const D_PAD* a, const D_PAD* b )
+                       {
+                           return order.at( a ) < order.at( b );
+                       } );
+
+            candidates.erase( std::unique( candidates.begin(), candidates.end() ),
+                              candidates.end() );
+
+            D_PAD** listEnd = &candidates[0] + candidates.size();
+
+            if( !doPadToPadsDrc( pad, &candidates[0], listEnd, INT_MAX ) )
+            {
+                wxASSERT( m_currentMarker );
+                addMarkerToPcb( m_currentMarker );
+                m_currentMarker = nullptr;
+            }
+        }
+    }
+
+    m_markerSink = nullptr;
+    m_itemIndex.reset();
+
+    // When both items of a pair were tested again, the pair can have two markers
+    std::set<std::pair<const void*, const void*>> pairs;
+
+    auto isDuplicate = [&]( const MARKER_PCB* aMarker ) -> bool
+    {
+        const void* mainItem = aMarker->GetReporter().GetMainItemWeakRef();
+        const void* auxItem = aMarker->GetReporter().GetAuxItemWeakRef();
+
+        if( !mainItem || !auxItem )
+            return false;
+
+        if( auxItem < mainItem )
+            std::swap( mainItem, auxItem );
+
+        return !pairs.insert( std::make_pair( mainItem, auxItem ) ).second;
+    };
+
+    std::vector<MARKER_PCB*> markers;
+
+    for( MARKER_PCB* marker : newMarkers )
+    {
+        if( isDuplicate( marker ) )
+            delete marker;
+        else
+            markers.push_back( marker );
+    }
+
+    if( oldMarkers.empty() && markers.empty() )
+        return;
+
+    // Without UI, the markers are not on the board: only the new ones are reported
+    if( m_markerHandler )
+    {
+        addMarkersToPcb( markers );
+        return;
+    }
+
+    BOARD_COMMIT commit( m_pcbEditorFrame );
+
+    for( MARKER_PCB* marker : oldMarkers )
+        commit.Remove( marker );
+
+    for( MARKER_PCB* marker : markers )
+        commit.Add( marker );
+
+    commit.Push( wxEmptyString, false, false );
+
+    // The removed markers are not stored in the undo list
+    for( MARKER_PCB* marker : oldMarkers )
+        delete marker;
+
+    m_markerCount += markers.size();
+
+    // update the m_drcDialog listboxes
+    updatePointers();
+}
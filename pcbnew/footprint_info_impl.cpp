@@ -37,9 +37,10 @@
 #include <pgm_base.h>
 #include <wildcards_and_files_ext.h>
 #include <widgets/progress_reporter.h>
-#include <wx/txtstrm.h>
+#include <wx/datstrm.h>
 #include <wx/wfstream.h>
 
+#include <climits>
 #include <thread>
 #include <mutex>
 
@@ -185,19 +186,50 @@ void FOOTPRINT_LIST_IMPL::StartWorkers( FP_LIB_TABLE* aTable, wxString const* aN
     // Clear data before reading files
     m_count_finished.store( 0 );
     m_errors.clear();
-    m_list.clear();
     m_threads.clear();
     m_queue_in.clear();
     m_queue_out.clear();
+    m_new_timestamps.clear();
+    m_lib_weights.clear();
+
+    std::vector<wxString> nicknames;
 
     if( aNickname )
-        m_queue_in.push( *aNickname );
+        nicknames.push_back( *aNickname );
     else
+        nicknames = aTable->GetLogicalLibs();
+
+    for( const wxString& nickname : nicknames )
+        m_new_timestamps[nickname] = aTable->GenerateTimestamp( &nickname );
+
+    // Keep the footprints of the libraries which did not change since they were read (or
+    // since the cache file was written), and read the other libraries only.
+    FPILIST                       upToDateList;
+    std::map<wxString, long long> upToDateTimestamps;
+
+    for( const wxString& nickname : nicknames )
     {
-        for( auto const& nickname : aTable->GetLogicalLibs() )
+        auto cached = m_lib_timestamps.find( nickname );
+
+        if( cached != m_lib_timestamps.end() && cached->second == m_new_timestamps[nickname] )
+            upToDateTimestamps.insert( *cached );
+        else
             m_queue_in.push( nickname );
     }
 
+    for( std::unique_ptr<FOOTPRINT_INFO>& fpinfo : m_list )
+    {
+        wxString nickname = fpinfo->GetLibNickname();
+
+        if( upToDateTimestamps.count( nickname ) )
+            upToDateList.push_back( std::move( fpinfo ) );
+        else
+            m_lib_weights[nickname]++;
+    }
+
+    m_list = std::move( upToDateList );
+    m_lib_timestamps = std::move( upToDateTimestamps );
+
     m_loader->m_total_libs = m_queue_in.size();
 
     for( unsigned i = 0; i < aNThreads; ++i )
@@ -239,8 +271,6 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
         m_count_finished.store( 0 );
     }
 
-    size_t total_count = m_queue_out.size();
-
     LOCALE_IO toggle_locale;
 
     // Parse the footprints in parallel. WARNING! This requires changing the locale, which is
@@ -251,44 +281,77 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
     // TODO: blast LOCALE_IO into the sun
 
     SYNC_QUEUE<std::unique_ptr<FOOTPRINT_INFO>> queue_parsed;
-    std::vector<std::thread>                    threads;
 
-    for( size_t ii = 0; ii < std::thread::hardware_concurrency() + 1; ++ii )
-    {
-        threads.push_back( std::thread( [this, &queue_parsed]() {
-            wxString nickname;
+    parseLibraries( queue_parsed );
+
+    std::unique_ptr<FOOTPRINT_INFO> fpi;
+
+    while( queue_parsed.pop( fpi ) )
+        m_list.push_back( std::move( fpi ) );
+
+    std::sort( m_list.begin(), m_list.end(), []( std::unique_ptr<FOOTPRINT_INFO> const& lhs,
+                                                 std::unique_ptr<FOOTPRINT_INFO> const& rhs ) -> bool
+                                             {
+                                                 return *lhs < *rhs;
+                                             } );
+
+    return m_errors.empty();
+}
+
+
+void FOOTPRINT_LIST_IMPL::parseLibraries( SYNC_QUEUE<std::unique_ptr<FOOTPRINT_INFO>>& aQueueParsed )
+{
+    std::vector<wxString> nicknames;
+    wxString              nickname;
+
+    while( m_queue_out.pop( nickname ) )
+        nicknames.push_back( nickname );
 
-            while( this->m_queue_out.pop( nickname ) && !m_cancelled )
+    // The libraries which were never read are not sized: start with them
+    auto weight = [this]( const wxString& aNickname ) -> unsigned
+    {
+        auto it = m_lib_weights.find( aNickname );
+        return it == m_lib_weights.end() ? UINT_MAX : it->second;
+    };
+
+    std::stable_sort( nicknames.begin(), nicknames.end(),
+                      [&weight]( const wxString& lhs, const wxString& rhs ) -> bool
+                      {
+                          return weight( lhs ) > weight( rhs );
+                      } );
+
+    // Each thread takes the next library when it has finished the previous one
+    std::atomic<size_t>      nextLib( 0 );
+    std::mutex               timestampsLock;
+    std::vector<std::thread> threads;
+    size_t                   threadCount = std::min<size_t>( nicknames.size(),
+                                                   std::thread::hardware_concurrency() + 1 );
+
+    for( size_t ii = 0; ii < threadCount; ++ii )
+    {
+        threads.push_back( std::thread( [&]() {
+            for( size_t lib = nextLib.fetch_add( 1 ); lib < nicknames.size() && !m_cancelled;
+                    lib = nextLib.fetch_add( 1 ) )
             {
-                wxArrayString fpnames;
+                const wxString& libNickname = nicknames[lib];
+                wxArrayString   fpnames;
 
-                try
-                {
-                    m_lib_table->FootprintEnumerate( fpnames, nickname, false );
-                }
-                catch( const IO_ERROR& ioe )
-                {
-                    m_errors.move_push( std::make_unique<IO_ERROR>( ioe ) );
-                }
-                catch( const std::exception& se )
-                {
-                    // This is a round about way to do this, but who knows what THROW_IO_ERROR()
-                    // may be tricked out to do someday, keep it in the game.
-                    try
-                    {
-                        THROW_IO_ERROR( se.what() );
-                    }
-                    catch( const IO_ERROR& ioe )
-                    {
-                        m_errors.move_push( std::make_unique<IO_ERROR>( ioe ) );
-                    }
-                }
+                bool ok = CatchErrors( [&]() {
+                    m_lib_table->FootprintEnumerate( fpnames, libNickname, false );
+                } );
 
                 for( unsigned jj = 0; jj < fpnames.size() && !m_cancelled; ++jj )
                 {
                     wxString fpname = fpnames[jj];
-                    FOOTPRINT_INFO* fpinfo = new FOOTPRINT_INFO_IMPL( this, nickname, fpname );
-                    queue_parsed.move_push( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
+                    FOOTPRINT_INFO* fpinfo = new FOOTPRINT_INFO_IMPL( this, libNickname, fpname );
+                    aQueueParsed.move_push( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
+                }
+
+                // A library read with errors, or partially read, will be read again next time
+                if( ok && !m_cancelled )
+                {
+                    std::lock_guard<std::mutex> lock( timestampsLock );
+                    m_lib_timestamps[libNickname] = m_new_timestamps[libNickname];
                 }
 
                 if( m_progress_reporter )
@@ -299,7 +362,7 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
         } ) );
     }
 
-    while( !m_cancelled && (size_t)m_count_finished.load() < total_count )
+    while( !m_cancelled && (size_t)m_count_finished.load() < nicknames.size() )
     {
         if( m_progress_reporter && !m_progress_reporter->KeepRefreshing() )
             m_cancelled = true;
@@ -309,19 +372,6 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
 
     for( auto& thr : threads )
         thr.join();
-
-    std::unique_ptr<FOOTPRINT_INFO> fpi;
-
-    while( queue_parsed.pop( fpi ) )
-        m_list.push_back( std::move( fpi ) );
-
-    std::sort( m_list.begin(), m_list.end(), []( std::unique_ptr<FOOTPRINT_INFO> const& lhs,
-                                                 std::unique_ptr<FOOTPRINT_INFO> const& rhs ) -> bool
-                                             {
-                                                 return *lhs < *rhs;
-                                             } );
-
-    return m_errors.empty();
 }
 
 
@@ -341,34 +391,59 @@ FOOTPRINT_LIST_IMPL::~FOOTPRINT_LIST_IMPL()
 }
 
 
+/*
+ * The cache file is a binary file.  It has a section for each library read without error:
+ * the nickname and the timestamp of the library, then its footprints.  So a library which
+ * has changed since the file was written is read again alone.
+ */
+static const wxUint32 FP_INFO_CACHE_MAGIC   = 0x4346504B;     // "KFPC"
+static const wxUint32 FP_INFO_CACHE_VERSION = 1;
+
+
 void FOOTPRINT_LIST_IMPL::WriteCacheToFile( const wxString& aFilePath )
 {
     wxFileName          tmpFileName = wxFileName::CreateTempFileName( aFilePath );
     wxFFileOutputStream outStream( tmpFileName.GetFullPath() );
-    wxTextOutputStream  txtStream( outStream );
+    wxDataOutputStream  dataStream( outStream );
 
     if( !outStream.IsOk() )
     {
         return;
     }
 
-    txtStream << wxString::Format( "%lld", m_list_timestamp ) << endl;
+    std::map<wxString, std::vector<FOOTPRINT_INFO*>> libraries;
 
     for( std::unique_ptr<FOOTPRINT_INFO>& fpinfo : m_list )
+        libraries[fpinfo->GetLibNickname()].push_back( fpinfo.get() );
+
+    dataStream.Write32( FP_INFO_CACHE_MAGIC );
+    dataStream.Write32( FP_INFO_CACHE_VERSION );
+    dataStream.Write32( (wxUint32) m_lib_timestamps.size() );
+
+    for( const auto& lib : m_lib_timestamps )
     {
-        txtStream << fpinfo->GetLibNickname() << endl;
-        txtStream << fpinfo->GetName() << endl;
-        txtStream << EscapeString( fpinfo->GetDescription() ) << endl;
-        txtStream << EscapeString( fpinfo->GetKeywords() ) << endl;
-        txtStream << wxString::Format( "%d", fpinfo->GetOrderNum() ) << endl;
-        txtStream << wxString::Format( "%u", fpinfo->GetPadCount() ) << endl;
-        txtStream << wxString::Format( "%u", fpinfo->GetUniquePadCount() ) << endl;
+        const std::vector<FOOTPRINT_INFO*>& fpinfos = libraries[lib.first];
+
+        dataStream.WriteString( lib.first );
+        dataStream.Write64( (wxUint64) lib.second );
+        dataStream.Write32( (wxUint32) fpinfos.size() );
+
+        for( FOOTPRINT_INFO* fpinfo : fpinfos )
+        {
+            dataStream.WriteString( fpinfo->GetName() );
+            dataStream.WriteString( fpinfo->GetDescription() );
+            dataStream.WriteString( fpinfo->GetKeywords() );
+            dataStream.Write32( (wxUint32) fpinfo->GetOrderNum() );
+            dataStream.Write32( fpinfo->GetPadCount() );
+            dataStream.Write32( fpinfo->GetUniquePadCount() );
+        }
     }
 
-    txtStream.Flush();
+    bool ok = outStream.IsOk();
+
     outStream.Close();
 
-    if( !wxRenameFile( tmpFileName.GetFullPath(), aFilePath, true ) )
+    if( !ok || !wxRenameFile( tmpFileName.GetFullPath(), aFilePath, true ) )
     {
         // cleanup incase rename failed
         // its also not the end of the world since this is just a cache file
@@ -379,43 +454,71 @@ void FOOTPRINT_LIST_IMPL::WriteCacheToFile( const wxString& aFilePath )
 
 void FOOTPRINT_LIST_IMPL::ReadCacheFromFile( const wxString& aFilePath )
 {
-    wxTextFile cacheFile( aFilePath );
-
     m_list_timestamp = 0;
     m_list.clear();
+    m_lib_timestamps.clear();
+
+    if( !wxFileName::FileExists( aFilePath ) )
+        return;
 
     try
     {
-        if( cacheFile.Exists() && cacheFile.Open() )
+        wxFFileInputStream inStream( aFilePath );
+        wxDataInputStream  dataStream( inStream );
+
+        // A cache file of another version (or the text file of older versions) is not read:
+        // all the libraries will be read again
+        if( !inStream.IsOk()
+                || dataStream.Read32() != FP_INFO_CACHE_MAGIC
+                || dataStream.Read32() != FP_INFO_CACHE_VERSION )
         {
-            cacheFile.GetFirstLine().ToLongLong( &m_list_timestamp );
+            return;
+        }
+
+        wxUint32 libCount = dataStream.Read32();
 
-            while( cacheFile.GetCurrentLine() + 6 < cacheFile.GetLineCount() )
+        for( wxUint32 ii = 0; ii < libCount && dataStream.IsOk(); ++ii )
+        {
+            wxString  libNickname = dataStream.ReadString();
+            long long timestamp   = (long long) dataStream.Read64();
+            wxUint32  fpCount     = dataStream.Read32();
+
+            for( wxUint32 jj = 0; jj < fpCount && dataStream.IsOk(); ++jj )
             {
-                wxString     libNickname    = cacheFile.GetNextLine();
-                wxString     name           = cacheFile.GetNextLine();
-                wxString     description    = UnescapeString( cacheFile.GetNextLine() );
-                wxString     keywords       = UnescapeString( cacheFile.GetNextLine() );
-                int          orderNum       = wxAtoi( cacheFile.GetNextLine() );
-                unsigned int padCount       = (unsigned) wxAtoi( cacheFile.GetNextLine() );
-                unsigned int uniquePadCount = (unsigned) wxAtoi( cacheFile.GetNextLine() );
+                wxString     name           = dataStream.ReadString();
+                wxString     description    = dataStream.ReadString();
+                wxString     keywords       = dataStream.ReadString();
+                int          orderNum       = (int) dataStream.Read32();
+                unsigned int padCount       = dataStream.Read32();
+                unsigned int uniquePadCount = dataStream.Read32();
 
                 auto* fpinfo = new FOOTPRINT_INFO_IMPL( libNickname, name, description, keywords,
                                                         orderNum, padCount, uniquePadCount );
                 m_list.emplace_back( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
             }
+
+            if( dataStream.IsOk() )
+                m_lib_timestamps[libNickname] = timestamp;
+        }
+
+        // A truncated file: whatever was read is suspect
+        if( !dataStream.IsOk() )
+        {
+            m_list.clear();
+            m_lib_timestamps.clear();
         }
     }
     catch( ... )
     {
         // whatever went wrong, invalidate the cache
-        m_list_timestamp = 0;
+        m_list.clear();
+        m_lib_timestamps.clear();
     }
 
     // Sanity check: an empty list is very unlikely to be correct.
     if( m_list.size() == 0 )
-        m_list_timestamp = 0;
+        m_lib_timestamps.clear();
 
-    if( cacheFile.IsOpened() )
-        cacheFile.Close();
+    for( const auto& lib : m_lib_timestamps )
+        m_list_timestamp += lib.second;
 }
@@ -22,6 +22,7 @@
 
 #include <atomic>
 #include <functional>
+#include <map>
 #include <memory>
 #include <thread>
 #include <vector>
@@ -93,6 +94,15 @@ class FOOTPRINT_LIST_IMPL : public FOOTPRINT_LIST
     std::atomic_bool         m_cancelled;
     std::mutex               m_join;
 
+    /// Timestamps of the libraries whose footprints are in m_list, when they were read
+    std::map<wxString, long long> m_lib_timestamps;
+
+    /// Timestamps of the libraries being loaded
+    std::map<wxString, long long> m_new_timestamps;
+
+    /// Footprint counts of the libraries being loaded, when they were last read
+    std::map<wxString, unsigned>  m_lib_weights;
+
     /**
      * Call aFunc, pushing any IO_ERRORs and std::exceptions it throws onto m_errors.
      *
@@ -113,6 +123,15 @@ protected:
      */
     void loader_job();
 
+    /**
+     * Function parseLibraries
+     * builds the footprint infos of the libraries of m_queue_out on several threads.
+     * The libraries are sorted by their size when they were last read, largest first: a
+     * library is read by one thread only, and a few large libraries left to the end would
+     * keep one thread busy while the other ones are idle.
+     */
+    void parseLibraries( SYNC_QUEUE<std::unique_ptr<FOOTPRINT_INFO>>& aQueueParsed );
+
 public:
     FOOTPRINT_LIST_IMPL();
     virtual ~FOOTPRINT_LIST_IMPL();
@@ -1880,7 +1880,8 @@ PCB_IO::~PCB_IO()
 
 BOARD* PCB_IO::Load( const wxString& aFileName, BOARD* aAppendToMe, const PROPERTIES* aProperties )
 {
-    FILE_LINE_READER    reader( aFileName );
+    // The board is lexed in place in the mapped file, or read with stdio if it cannot be mapped
+    MAPPED_FILE_LINE_READER reader( aFileName );
 
     init( aProperties );
 
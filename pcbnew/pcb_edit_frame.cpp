@@ -296,6 +296,7 @@ PCB_EDIT_FRAME::PCB_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ) :
     m_showAxis = false;                 // true to display X and Y axis
     m_showOriginAxis = true;
     m_showGridAxis = true;
+    m_drc = nullptr;
     m_SelTrackWidthBox = NULL;
     m_SelViaSizeBox = NULL;
     m_SelLayerBox = NULL;
@@ -490,6 +491,10 @@ PCB_EDIT_FRAME::~PCB_EDIT_FRAME()
 
 void PCB_EDIT_FRAME::SetBoard( BOARD* aBoard )
 {
+    // The DRC follows the changes of the board being edited
+    if( m_drc )
+        m_drc->SetBoard( aBoard );
+
     PCB_BASE_EDIT_FRAME::SetBoard( aBoard );
 
     if( IsGalCanvasActive() )
@@ -752,6 +757,10 @@ void PCB_EDIT_FRAME::DoShowBoardSetupDialog( const wxString& aInitialPage,
     {
         SaveProjectSettings( false );
 
+        // Clearances may have changed: zones cannot be refilled incrementally, and the
+        // online DRC must index the board again
+        GetBoard()->InvalidateIncrementalData();
+
         UpdateUserInterface();
         ReCreateAuxiliaryToolbar();
 
@@ -1017,6 +1026,11 @@ void PCB_EDIT_FRAME::OnModify( )
 {
     PCB_BASE_FRAME::OnModify();
 
+    // The legacy canvas edits the board without BOARD_COMMIT: the changes are not known
+    // by the incremental zone refill and the board listeners
+    if( !IsGalCanvasActive() )
+        GetBoard()->InvalidateIncrementalData();
+
     Update3DView();
 
     m_ZoneFillsDirty = true;
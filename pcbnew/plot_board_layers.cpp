@@ -371,10 +371,9 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             extraSize.x += width_adj;
             extraSize.y += width_adj;
 
-            // Store these parameters that can be modified to plot inflated/deflated pads shape
-            wxSize deltaSize = pad->GetDelta(); // has meaning only for trapezoidal pads
-            PAD_SHAPE_T padShape = pad->GetShape();
-            double padCornerRadius = pad->GetRoundRectCornerRadius();
+            // The inflated/deflated pad shape is plotted from a copy of the pad, so the board
+            // is not modified and several layers can be plotted at the same time
+            D_PAD padPlot( *pad );
 
             if( pad->GetShape() == PAD_SHAPE_TRAPEZOID )
             {   // The easy way is to use BuildPadPolygon to calculate
@@ -407,7 +406,7 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
                 else
                     delta.y = coord[1].x - coord[0].x;
 
-                pad->SetDelta( delta );
+                padPlot.SetDelta( delta );
             }
             else
                 padPlotsSize = pad->GetSize() + extraSize;
@@ -424,43 +423,40 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             if( pad->GetLayerSet()[F_Cu] )
                 color = color.LegacyMix( aBoard->Colors().GetItemColor( LAYER_PAD_FR ) );
 
-            // Temporary set the pad size to the required plot size:
-            wxSize tmppadsize = pad->GetSize();
-
+            // Set the pad size to the required plot size:
             switch( pad->GetShape() )
             {
             case PAD_SHAPE_CIRCLE:
             case PAD_SHAPE_OVAL:
-                pad->SetSize( padPlotsSize );
+                padPlot.SetSize( padPlotsSize );
 
                 if( aPlotOpt.GetSkipPlotNPTH_Pads() &&
-                    ( pad->GetSize() == pad->GetDrillSize() ) &&
-                    ( pad->GetAttribute() == PAD_ATTRIB_HOLE_NOT_PLATED ) )
+                    ( padPlot.GetSize() == padPlot.GetDrillSize() ) &&
+                    ( padPlot.GetAttribute() == PAD_ATTRIB_HOLE_NOT_PLATED ) )
                     break;
 
-                itemplotter.PlotPad( pad, color, plotMode );
+                itemplotter.PlotPad( &padPlot, color, plotMode );
                 break;
 
             case PAD_SHAPE_RECT:
                 if( margin.x > 0 )
                 {
-                    pad->SetShape( PAD_SHAPE_ROUNDRECT );
-                    pad->SetSize( padPlotsSize );
-                    pad->SetRoundRectCornerRadius( margin.x );
+                    padPlot.SetShape( PAD_SHAPE_ROUNDRECT );
+                    padPlot.SetSize( padPlotsSize );
+                    padPlot.SetRoundRectCornerRadius( margin.x );
                 }
                 // Fall through
 
             case PAD_SHAPE_TRAPEZOID:
             case PAD_SHAPE_ROUNDRECT:
-                pad->SetSize( padPlotsSize );
-                itemplotter.PlotPad( pad, color, plotMode );
+                padPlot.SetSize( padPlotsSize );
+                itemplotter.PlotPad( &padPlot, color, plotMode );
                 break;
 
             case PAD_SHAPE_CUSTOM:
                 // inflate/deflate a custom shape is a bit complex.
                 // so build a similar pad shape, and inflate/deflate the polygonal shape
                 {
-                D_PAD dummy( *pad );
                 SHAPE_POLY_SET shape;
                 pad->MergePrimitivesAsPolygon( &shape, 64 );
                 // shape polygon can have holes linked to the main outline.
@@ -468,26 +464,20 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
                 // bad shapes if margin.x is < 0
                 shape.InflateWithLinkedHoles( margin.x, ARC_APPROX_SEGMENTS_COUNT_HIGH_DEF,
                                               SHAPE_POLY_SET::PM_FAST );
-                dummy.DeletePrimitivesList();
-                dummy.AddPrimitive( shape, 0 );
-                dummy.MergePrimitivesAsPolygon();
+                padPlot.DeletePrimitivesList();
+                padPlot.AddPrimitive( shape, 0 );
+                padPlot.MergePrimitivesAsPolygon();
 
                 // Be sure the anchor pad is not bigger than the deflated shape
                 // because this anchor will be added to the pad shape when plotting
                 // the pad. So now the polygonal shape is built, we can clamp the anchor size
                 if( margin.x < 0 )  // we expect margin.x = margin.y for custom pads
-                    dummy.SetSize( padPlotsSize );
+                    padPlot.SetSize( padPlotsSize );
 
-                itemplotter.PlotPad( &dummy, color, plotMode );
+                itemplotter.PlotPad( &padPlot, color, plotMode );
                 }
                 break;
             }
-
-            // Restore the pad parameters modified by the plot code
-            pad->SetSize( tmppadsize );     // Restore the pad size
-            pad->SetDelta( deltaSize );
-            pad->SetShape( padShape );
-            pad->SetRoundRectCornerRadius( padCornerRadius );
         }
 
         aPlotter->EndBlock( NULL );
@@ -662,7 +662,7 @@ void BRDITEMS_PLOTTER::PlotFilledAreas( ZONE_CONTAINER* aZone )
     }
 
     // We need a buffer to store corners coordinates:
-    static std::vector< wxPoint > cornerList;
+    std::vector< wxPoint > cornerList;
     cornerList.clear();
 
     m_plotter->SetColor( getColor( aZone->GetLayer() ) );
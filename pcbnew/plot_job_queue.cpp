@@ -0,0 +1,215 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file plot_job_queue.cpp
+ */
+
+#include <algorithm>
+#include <future>
+#include <thread>
+
+#include <fctsys.h>
+#include <common.h>
+#include <plotter.h>
+#include <reporter.h>
+#include <class_board.h>
+#include <class_module.h>
+
+#include <pcbplot.h>
+#include <plot_job_queue.h>
+
+
+/**
+ * Stores the messages of a job, to report them once all the jobs are done.
+ */
+class JOB_REPORTER : public REPORTER
+{
+public:
+    REPORTER& Report( const wxString& aText, SEVERITY aSeverity = RPT_UNDEFINED ) override
+    {
+        m_messages.push_back( MESSAGE{ aText, aSeverity, LOC_BODY } );
+        return *this;
+    }
+
+    REPORTER& ReportHead( const wxString& aText, SEVERITY aSeverity = RPT_UNDEFINED ) override
+    {
+        m_messages.push_back( MESSAGE{ aText, aSeverity, LOC_HEAD } );
+        return *this;
+    }
+
+    REPORTER& ReportTail( const wxString& aText, SEVERITY aSeverity = RPT_UNDEFINED ) override
+    {
+        m_messages.push_back( MESSAGE{ aText, aSeverity, LOC_TAIL } );
+        return *this;
+    }
+
+    bool HasMessage() const override { return !m_messages.empty(); }
+
+    /// Report the stored messages to aReporter
+    void Flush( REPORTER& aReporter ) const
+    {
+        for( const MESSAGE& msg : m_messages )
+        {
+            switch( msg.m_location )
+            {
+            case LOC_HEAD: aReporter.ReportHead( msg.m_text, msg.m_severity ); break;
+            case LOC_TAIL: aReporter.ReportTail( msg.m_text, msg.m_severity ); break;
+            default:       aReporter.Report( msg.m_text, msg.m_severity );     break;
+            }
+        }
+    }
+
+private:
+    struct MESSAGE
+    {
+        wxString m_text;
+        SEVERITY m_severity;
+        LOCATION m_location;
+    };
+
+    std::vector<MESSAGE> m_messages;
+};
+
+
+PLOT_JOB_QUEUE::PLOT_JOB_QUEUE( BOARD* aBoard, const PCB_PLOT_PARAMS& aPlotOpts ) :
+    m_board( aBoard ),
+    m_plotOpts( aPlotOpts ),
+    m_failures( 0 )
+{
+}
+
+
+void PLOT_JOB_QUEUE::AddLayer( PCB_LAYER_ID aLayer, const wxString& aFullFileName,
+                               const wxString& aSheetDesc )
+{
+    // The translations are not thread-safe: the messages are built here, by the caller
+    PLOT_MESSAGES messages;
+
+    messages.m_created.Printf( _( "Plot file \"%s\" created." ), GetChars( aFullFileName ) );
+    messages.m_failed.Printf( _( "Unable to create file \"%s\"." ), GetChars( aFullFileName ) );
+
+    m_jobs.push_back( [this, aLayer, aFullFileName, aSheetDesc, messages]( REPORTER& aReporter )
+                      {
+                          plotLayer( aReporter, aLayer, aFullFileName, aSheetDesc, messages );
+                      } );
+}
+
+
+void PLOT_JOB_QUEUE::AddJob( const JOB& aJob )
+{
+    m_jobs.push_back( aJob );
+}
+
+
+void PLOT_JOB_QUEUE::plotLayer( REPORTER& aReporter, PCB_LAYER_ID aLayer,
+                                const wxString& aFullFileName, const wxString& aSheetDesc,
+                                const PLOT_MESSAGES& aMessages )
+{
+    PLOTTER* plotter;
+
+    {
+        std::lock_guard<std::mutex> lock( m_startMutex );
+        plotter = StartPlotBoard( m_board, &m_plotOpts, aLayer, aFullFileName, aSheetDesc );
+    }
+
+    // Print diags in messages box:
+    if( plotter )
+    {
+        PlotOneBoardLayer( m_board, plotter, aLayer, m_plotOpts );
+        plotter->EndPlot();
+        delete plotter;
+
+        aReporter.Report( aMessages.m_created, REPORTER::RPT_ACTION );
+    }
+    else
+    {
+        aReporter.Report( aMessages.m_failed, REPORTER::RPT_ERROR );
+        m_failures++;
+    }
+}
+
+
+int PLOT_JOB_QUEUE::Run( REPORTER& aReporter, unsigned aThreadCount )
+{
+    std::vector<JOB> jobs;
+    jobs.swap( m_jobs );
+    m_failures = 0;
+
+    std::vector<JOB_REPORTER> reporters( jobs.size() );
+
+    if( aThreadCount == 0 )
+        aThreadCount = std::thread::hardware_concurrency();
+
+    // Only the Gerber plotter and the drill file writers are known to be safe to run on
+    // several threads.  The other plotters (PDF, SVG, PS, DXF, HPGL) use shared data, such
+    // as the wxWidgets image handlers used to plot bitmaps: they plot one file at a time.
+    if( m_plotOpts.GetFormat() != PLOT_FORMAT_GERBER )
+        aThreadCount = 1;
+
+    size_t parallelThreadCount = std::max<size_t>( 1,
+            std::min<size_t>( aThreadCount, jobs.size() ) );
+
+    // setlocale() changes the locale of the whole process: switch to the C locale once
+    // for all the threads
+    LOCALE_IO toggle;
+
+    std::atomic<size_t> nextJob( 0 );
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+    auto plot_lambda = [&nextJob, &jobs, &reporters]() -> size_t
+    {
+        for( size_t i = nextJob++; i < jobs.size(); i = nextJob++ )
+            jobs[i]( reporters[i] );
+
+        return 1;
+    };
+
+    if( parallelThreadCount == 1 )
+        plot_lambda();
+    else
+    {
+        // A pad computes its bounding radius on its first use: compute them all before
+        // the threads read them
+        for( auto module : m_board->Modules() )
+        {
+            for( auto pad : module->Pads() )
+                pad->GetBoundingRadius();
+        }
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, plot_lambda );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].wait();
+
+        // All the threads are done: an exception thrown by a job can be passed on
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].get();
+    }
+
+    for( const JOB_REPORTER& reporter : reporters )
+        reporter.Flush( aReporter );
+
+    return m_failures;
+}
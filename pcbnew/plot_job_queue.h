@@ -0,0 +1,119 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file plot_job_queue.h
+ * @brief Plot of several board layers (and drill files) at the same time.
+ */
+
+#ifndef PLOT_JOB_QUEUE_H_
+#define PLOT_JOB_QUEUE_H_
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <wx/string.h>
+#include <pcb_plot_params.h>
+#include <layers_id_colors_and_visibility.h>
+
+class BOARD;
+class REPORTER;
+
+/**
+ * Class PLOT_JOB_QUEUE
+ * plots independent outputs of a board (one file per layer, drill files...) on several
+ * threads.  Each job writes its own files with its own plotter, and the messages of the
+ * jobs are reported in the order the jobs were queued once they are all done, so the files
+ * and the messages are the same as when the jobs are run one after the other.
+ *
+ * Only the Gerber files and the drill files are plotted on several threads: with any other
+ * plot format, the jobs are run one after the other.
+ *
+ * The board must not be modified while the jobs run.  The wxWidgets translations are not
+ * thread-safe either: the messages of the jobs are translated before the jobs are queued.
+ *
+ * The plot dialog only queues layers: the drill files have their own dialog.  Drill files
+ * are plotted alongside the layers by the batch tools (see qa/pcbnew_tools/batch_plot).
+ */
+class PLOT_JOB_QUEUE
+{
+public:
+    /**
+     * A job writes its files, and reports its messages to the given reporter.
+     * Jobs are run at the same time: they must not modify the board, and must not
+     * translate their messages (build them before queuing the job).
+     */
+    typedef std::function<void( REPORTER& aReporter )> JOB;
+
+    PLOT_JOB_QUEUE( BOARD* aBoard, const PCB_PLOT_PARAMS& aPlotOpts );
+
+    /**
+     * Function AddLayer
+     * queues the plot of one layer in its own file, using the plot options of the queue.
+     * @param aLayer = the layer to plot
+     * @param aFullFileName = the full name of the plot file
+     * @param aSheetDesc = the sheet description, used by the frame reference
+     */
+    void AddLayer( PCB_LAYER_ID aLayer, const wxString& aFullFileName,
+                   const wxString& aSheetDesc = wxEmptyString );
+
+    /**
+     * Function AddJob
+     * queues another job, for instance the creation of the drill files.
+     * Jobs are started in the order they are queued: long jobs should be queued first.
+     */
+    void AddJob( const JOB& aJob );
+
+    /**
+     * Function Run
+     * runs all the queued jobs, and empties the queue.
+     * @param aReporter = the reporter of the messages of all the jobs
+     * @param aThreadCount = the max number of threads, 0 for one thread per core.
+     *                       It is always 1 when the plot format is not Gerber.
+     * @return the number of layers which were not plotted (their file cannot be created)
+     */
+    int Run( REPORTER& aReporter, unsigned aThreadCount = 0 );
+
+private:
+    /// The messages of a layer job, translated when the job is queued
+    struct PLOT_MESSAGES
+    {
+        wxString m_created;
+        wxString m_failed;
+    };
+
+    void plotLayer( REPORTER& aReporter, PCB_LAYER_ID aLayer, const wxString& aFullFileName,
+                    const wxString& aSheetDesc, const PLOT_MESSAGES& aMessages );
+
+    BOARD*              m_board;
+    PCB_PLOT_PARAMS     m_plotOpts;
+    std::vector<JOB>    m_jobs;
+    std::atomic<int>    m_failures;
+
+    // StartPlotBoard() plots the frame reference, whose page layout is shared
+    std::mutex          m_startMutex;
+};
+
+#endif // PLOT_JOB_QUEUE_H_
@@ -66,86 +66,66 @@ static const std::vector<CN_EDGE> kruskalMST( std::list<CN_EDGE>& aEdges,
     // The output
     std::vector<CN_EDGE> mst;
 
-    // Set tags for marking cycles
-    std::unordered_map<CN_ANCHOR_PTR, int> tags;
-    unsigned int tag = 0;
+    // Union-find of the nodes to detect cycles in the graph.  The tag of a node is its index.
+    std::vector<int> parent( nodeNumber );
 
-    for( auto& node : aNodes )
+    for( unsigned int i = 0; i < nodeNumber; ++i )
     {
-        node->SetTag( tag );
-        tags[node] = tag++;
+        aNodes[i]->SetTag( i );
+        parent[i] = i;
     }
 
-    // Lists of nodes connected together (subtrees) to detect cycles in the graph
-    std::vector<std::list<int> > cycles( nodeNumber );
+    auto findRoot = [&parent]( int aTag ) -> int
+    {
+        while( parent[aTag] != aTag )
+            aTag = parent[aTag] = parent[ parent[aTag] ];
 
-    for( unsigned int i = 0; i < nodeNumber; ++i )
-        cycles[i].push_back( i );
+        return aTag;
+    };
 
     // Kruskal algorithm requires edges to be sorted by their weight
-    aEdges.sort( sortWeight );
+    std::vector<CN_EDGE> edges( aEdges.begin(), aEdges.end() );
+    std::stable_sort( edges.begin(), edges.end(), sortWeight );
 
-    while( mstSize < mstExpectedSize && !aEdges.empty() )
+    for( const CN_EDGE& dt : edges )
     {
-        //printf("mstSize %d %d\n", mstSize, mstExpectedSize);
-        auto& dt = aEdges.front();
+        if( mstSize >= mstExpectedSize )
+            break;
 
-        int srcTag  = tags[dt.GetSourceNode()];
-        int trgTag  = tags[dt.GetTargetNode()];
+        int srcTag = findRoot( dt.GetSourceNode()->GetTag() );
+        int trgTag = findRoot( dt.GetTargetNode()->GetTag() );
 
         // Check if by adding this edge we are going to join two different forests
-        if( srcTag != trgTag )
-        {
-            // Because edges are sorted by their weight, first we always process connected
-            // items (weight == 0). Once we stumble upon an edge with non-zero weight,
-            // it means that the rest of the lines are ratsnest.
-            if( !ratsnestLines && dt.GetWeight() != 0 )
-                ratsnestLines = true;
-
-            // Update tags
-            if( ratsnestLines )
-            {
-                for( auto it = cycles[trgTag].begin(); it != cycles[trgTag].end(); ++it )
-                {
-                    tags[aNodes[*it]] = srcTag;
-                }
+        if( srcTag == trgTag )
+            continue;
 
-                // Do a copy of edge, but make it RN_EDGE_MST. In contrary to RN_EDGE,
-                // RN_EDGE_MST saves both source and target node and does not require any other
-                // edges to exist for getting source/target nodes
-                CN_EDGE newEdge ( dt.GetSourceNode(), dt.GetTargetNode(), dt.GetWeight() );
+        // Because edges are sorted by their weight, first we always process connected
+        // items (weight == 0). Once we stumble upon an edge with non-zero weight,
+        // it means that the rest of the lines are ratsnest.
+        if( !ratsnestLines && dt.GetWeight() != 0 )
+            ratsnestLines = true;
 
-                assert( newEdge.GetSourceNode()->GetTag() != newEdge.GetTargetNode()->GetTag() );
-                assert( newEdge.GetWeight() > 0 );
+        parent[trgTag] = srcTag;
 
-                mst.push_back( newEdge );
-                ++mstSize;
-            }
-            else
-            {
-                // for( it = cycles[trgTag].begin(), itEnd = cycles[trgTag].end(); it != itEnd; ++it )
-                // for( auto it : cycles[trgTag] )
-                for( auto it = cycles[trgTag].begin(); it != cycles[trgTag].end(); ++it )
-                {
-                    tags[aNodes[*it]] = srcTag;
-                    aNodes[*it]->SetTag( srcTag );
-                }
+        if( ratsnestLines )
+        {
+            // Do a copy of edge, but make it RN_EDGE_MST. In contrary to RN_EDGE,
+            // RN_EDGE_MST saves both source and target node and does not require any other
+            // edges to exist for getting source/target nodes
+            CN_EDGE newEdge ( dt.GetSourceNode(), dt.GetTargetNode(), dt.GetWeight() );
 
-                // Processing a connection, decrease the expected size of the ratsnest MST
-                --mstExpectedSize;
-            }
+            assert( newEdge.GetWeight() > 0 );
 
-            // Move nodes that were marked with old tag to the list marked with the new tag
-            cycles[srcTag].splice( cycles[srcTag].end(), cycles[trgTag] );
+            mst.push_back( newEdge );
+            ++mstSize;
+        }
+        else
+        {
+            // Processing a connection, decrease the expected size of the ratsnest MST
+            --mstExpectedSize;
         }
-
-        // Remove the edge that was just processed
-        aEdges.erase( aEdges.begin() );
     }
 
-    // Probably we have discarded some of edges, so reduce the size
-    mst.resize( mstSize );
-
     return mst;
 }
 
@@ -386,9 +366,281 @@ void RN_NET::compute()
 
 
 
+/**
+ * A possible ratsnest edge between two clusters (or groups of clusters) of a net
+ */
+struct RN_CANDIDATE
+{
+    int      nodeA, nodeB;      // indices in RN_NET::m_nodes
+    uint64_t weight;
+};
+
+
+bool RN_NET::updateIncremental()
+{
+    if( m_prevClusterNodes.empty() || m_nodes.size() <= 2 )
+        return false;
+
+    // The clusters of the net are rebuilt on each update: match them with the clusters
+    // of the last update by their nodes.  The nodes are not shared between the clusters,
+    // and their position does not change.
+    std::unordered_map<const CN_ANCHOR*, int> prevCluster;
+
+    for( unsigned int i = 0; i < m_prevClusterNodes.size(); i++ )
+    {
+        for( const auto& node : m_prevClusterNodes[i] )
+            prevCluster[node.get()] = i;
+    }
+
+    int                 clusterCount = m_clusterNodes.size();
+    std::vector<int>    kept( m_prevClusterNodes.size(), -1 );  // new index of the kept clusters
+    std::vector<bool>   isNew( clusterCount, true );
+    size_t              changedNodes = 0;
+
+    for( int i = 0; i < clusterCount; i++ )
+    {
+        const auto& nodes = m_clusterNodes[i];
+        auto        it = prevCluster.find( nodes[0].get() );
+
+        if( it != prevCluster.end() && kept[it->second] < 0
+                && m_prevClusterNodes[it->second].size() == nodes.size()
+                && std::all_of( nodes.begin(), nodes.end(), [&]( const CN_ANCHOR_PTR& aNode )
+                        {
+                            auto jt = prevCluster.find( aNode.get() );
+                            return jt != prevCluster.end() && jt->second == it->second;
+                        } ) )
+        {
+            kept[it->second] = i;
+            isNew[i] = false;
+        }
+        else
+        {
+            changedNodes += nodes.size();
+        }
+    }
+
+    std::unordered_map<const CN_ANCHOR*, int> nodeIndex;
+    std::vector<int>                          nodeCluster( m_nodes.size() );
+    int                                       node = 0;
+
+    for( int i = 0; i < clusterCount; i++ )
+    {
+        for( const auto& clusterNode : m_clusterNodes[i] )
+        {
+            nodeIndex[clusterNode.get()] = node;
+            nodeCluster[node++] = i;
+        }
+    }
+
+    // Union-find of the clusters
+    std::vector<int> parent( clusterCount );
+
+    for( int i = 0; i < clusterCount; i++ )
+        parent[i] = i;
+
+    auto findRoot = [&parent]( int aCluster ) -> int
+    {
+        while( parent[aCluster] != aCluster )
+            aCluster = parent[aCluster] = parent[ parent[aCluster] ];
+
+        return aCluster;
+    };
+
+    auto resetRoots = [&parent, clusterCount]()
+    {
+        for( int i = 0; i < clusterCount; i++ )
+            parent[i] = i;
+    };
+
+    // The edges of the last ratsnest between kept clusters are still in the ratsnest of the
+    // kept clusters: each one is still the shortest edge across the cut it closed.
+    std::vector<RN_CANDIDATE> tree;
+
+    for( const auto& edge : m_prevRnEdges )
+    {
+        auto itA = prevCluster.find( edge.GetSourceNode().get() );
+        auto itB = prevCluster.find( edge.GetTargetNode().get() );
+
+        if( itA == prevCluster.end() || itB == prevCluster.end() )
+            continue;
+
+        int a = kept[itA->second];
+        int b = kept[itB->second];
+
+        if( a < 0 || b < 0 )
+            continue;
+
+        tree.push_back( { nodeIndex.at( edge.GetSourceNode().get() ),
+                          nodeIndex.at( edge.GetTargetNode().get() ),
+                          std::max<uint64_t>( 1, getDistance( edge.GetSourceNode(),
+                                                              edge.GetTargetNode() ) ) } );
+        parent[ findRoot( b ) ] = findRoot( a );
+    }
+
+    // The kept clusters are now split in groups, connected together by the removed clusters.
+    // Only the groups other than the largest one are searched for their shortest edges,
+    // so the cost of the update only depends on the size of the change.
+    std::vector<std::vector<int>> groupNodes( clusterCount );   // indices in m_nodes
+
+    for( unsigned int i = 0; i < m_nodes.size(); i++ )
+    {
+        if( !isNew[ nodeCluster[i] ] )
+            groupNodes[ findRoot( nodeCluster[i] ) ].push_back( i );
+    }
+
+    int largest = -1;
+
+    for( int i = 0; i < clusterCount; i++ )
+    {
+        if( !groupNodes[i].empty()
+                && ( largest < 0 || groupNodes[i].size() > groupNodes[largest].size() ) )
+            largest = i;
+    }
+
+    size_t searchedNodes = changedNodes;
+
+    for( int i = 0; i < clusterCount; i++ )
+    {
+        if( i != largest )
+            searchedNodes += groupNodes[i].size();
+    }
+
+    // The incremental update costs O( searchedNodes * nodes ), the full update
+    // O( nodes * log( nodes ) ) with a much larger constant
+    size_t maxSearchedNodes = 64;
+
+    for( size_t n = m_nodes.size(); n > 1; n >>= 1 )
+        maxSearchedNodes += 8;
+
+    if( largest < 0 || searchedNodes > maxSearchedNodes )
+        return false;
+
+    std::vector<RN_CANDIDATE> best( clusterCount );
+
+    // Finds the shortest edges from the nodes aFrom to the groups of the nodes aTo
+    auto searchEdges = [&]( const std::vector<int>& aFrom, const std::vector<int>& aTo,
+                            std::function<int( int )> aGroup, std::vector<RN_CANDIDATE>& aEdges )
+    {
+        for( auto& candidate : best )
+            candidate.weight = std::numeric_limits<uint64_t>::max();
+
+        int from = aGroup( aFrom[0] );
+
+        for( int i : aFrom )
+        {
+            for( int j : aTo )
+            {
+                int to = aGroup( j );
+
+                if( to == from )
+                    continue;
+
+                uint64_t weight = std::max<uint64_t>( 1, getDistance( m_nodes[i], m_nodes[j] ) );
+
+                if( weight < best[to].weight )
+                    best[to] = { i, j, weight };
+            }
+        }
+
+        for( const auto& candidate : best )
+        {
+            if( candidate.weight != std::numeric_limits<uint64_t>::max() )
+                aEdges.push_back( candidate );
+        }
+    };
+
+    auto kruskal = [&]( std::vector<RN_CANDIDATE>& aEdges, std::vector<RN_CANDIDATE>& aTree )
+    {
+        std::stable_sort( aEdges.begin(), aEdges.end(),
+                [] ( const RN_CANDIDATE& aEdge1, const RN_CANDIDATE& aEdge2 )
+                {
+                    return aEdge1.weight < aEdge2.weight;
+                } );
+
+        for( const auto& edge : aEdges )
+        {
+            int a = findRoot( nodeCluster[edge.nodeA] );
+            int b = findRoot( nodeCluster[edge.nodeB] );
+
+            if( a != b )
+            {
+                parent[b] = a;
+                aTree.push_back( edge );
+            }
+        }
+    };
+
+    // Connect the groups of kept clusters together
+    std::vector<int> keptNodes;
+
+    for( const auto& nodes : groupNodes )
+        keptNodes.insert( keptNodes.end(), nodes.begin(), nodes.end() );
+
+    std::vector<RN_CANDIDATE> candidates;
+    std::vector<int>          groupOf( clusterCount );
+
+    for( int i = 0; i < clusterCount; i++ )
+        groupOf[i] = findRoot( i );
+
+    for( int i = 0; i < clusterCount; i++ )
+    {
+        if( i != largest && !groupNodes[i].empty() )
+        {
+            searchEdges( groupNodes[i], keptNodes,
+                         [&]( int aNode ) { return groupOf[ nodeCluster[aNode] ]; }, candidates );
+        }
+    }
+
+    kruskal( candidates, tree );
+
+    // Add the new clusters: the new ratsnest only uses the edges of the ratsnest of the kept
+    // clusters, and edges of the new clusters
+    if( changedNodes > 0 )
+    {
+        std::vector<std::vector<int>> clusterNodeIndices( clusterCount );
+        std::vector<int>              allNodes( m_nodes.size() );
+
+        for( unsigned int i = 0; i < m_nodes.size(); i++ )
+        {
+            clusterNodeIndices[ nodeCluster[i] ].push_back( i );
+            allNodes[i] = i;
+        }
+
+        candidates = tree;
+        tree.clear();
+
+        for( int i = 0; i < clusterCount; i++ )
+        {
+            if( isNew[i] )
+            {
+                searchEdges( clusterNodeIndices[i], allNodes,
+                             [&]( int aNode ) { return nodeCluster[aNode]; }, candidates );
+            }
+        }
+
+        resetRoots();
+        kruskal( candidates, tree );
+    }
+
+    if( (int) tree.size() != clusterCount - 1 )
+        return false;
+
+    m_rnEdges.clear();
+
+    for( const auto& edge : tree )
+        m_rnEdges.emplace_back( m_nodes[edge.nodeA], m_nodes[edge.nodeB], edge.weight );
+
+    return true;
+}
+
+
 void RN_NET::Update()
 {
-    compute();
+    if( !updateIncremental() )
+        compute();
+
+    m_prevClusterNodes.clear();
+    m_prevRnEdges.clear();
 
     m_dirty = false;
 }
@@ -396,9 +648,23 @@ void RN_NET::Update()
 
 void RN_NET::Clear()
 {
+    // Keep the last ratsnest: the next update can start from it
+    if( !m_dirty )
+    {
+        m_prevClusterNodes = std::move( m_clusterNodes );
+        m_prevRnEdges = std::move( m_rnEdges );
+    }
+    else
+    {
+        m_prevClusterNodes.clear();
+        m_prevRnEdges.clear();
+    }
+
     m_rnEdges.clear();
     m_boardEdges.clear();
     m_nodes.clear();
+    m_sortedNodes.clear();
+    m_clusterNodes.clear();
 
     m_dirty = true;
 }
@@ -407,6 +673,7 @@ void RN_NET::Clear()
 void RN_NET::AddCluster( CN_CLUSTER_PTR aCluster )
 {
     CN_ANCHOR_PTR firstAnchor;
+    std::vector<CN_ANCHOR_PTR> clusterNodes;
 
     for( auto item : *aCluster )
     {
@@ -421,6 +688,8 @@ void RN_NET::AddCluster( CN_CLUSTER_PTR aCluster )
         {
             anchors[i]->SetCluster( aCluster );
             m_nodes.push_back(anchors[i]);
+            m_sortedNodes.clear();
+            clusterNodes.push_back( anchors[i] );
 
             if( firstAnchor )
             {
@@ -435,23 +704,46 @@ void RN_NET::AddCluster( CN_CLUSTER_PTR aCluster )
             }
         }
     }
+
+    if( !clusterNodes.empty() )
+        m_clusterNodes.push_back( std::move( clusterNodes ) );
 }
 
 
 bool RN_NET::NearestBicoloredPair( const RN_NET& aOtherNet, CN_ANCHOR_PTR& aNode1,
-        CN_ANCHOR_PTR& aNode2 ) const
+        CN_ANCHOR_PTR& aNode2 )
 {
     bool rv = false;
 
     VECTOR2I::extended_type distMax = VECTOR2I::ECOORD_MAX;
 
-    for( auto nodeA : m_nodes )
+    // The net does not change during a move: its nodes are sorted on the first search
+    if( m_sortedNodes.empty() )
+    {
+        m_sortedNodes = m_nodes;
+
+        std::sort( m_sortedNodes.begin(), m_sortedNodes.end(),
+                []( const CN_ANCHOR_PTR& aFirst, const CN_ANCHOR_PTR& aSecond )
+                {
+                    return aFirst->Pos().x < aSecond->Pos().x;
+                } );
+    }
+
+    for( auto nodeB : aOtherNet.m_nodes )
     {
-        for( auto nodeB : aOtherNet.m_nodes )
+        const VECTOR2I& posB = nodeB->Pos();
+
+        // Returns false when nodeA, and the nodes after it, are too far in X
+        auto testNode = [&]( const CN_ANCHOR_PTR& nodeA ) -> bool
         {
+            VECTOR2I::extended_type dx = nodeA->Pos().x - posB.x;
+
+            if( dx * dx >= distMax )
+                return false;
+
             if( !nodeA->GetNoLine() )
             {
-                auto squaredDist = (nodeA->Pos() - nodeB->Pos() ).SquaredEuclideanNorm();
+                auto squaredDist = ( nodeA->Pos() - posB ).SquaredEuclideanNorm();
 
                 if( squaredDist < distMax )
                 {
@@ -461,7 +753,22 @@ bool RN_NET::NearestBicoloredPair( const RN_NET& aOtherNet, CN_ANCHOR_PTR& aNode
                     aNode2  = nodeB;
                 }
             }
-        }
+
+            return true;
+        };
+
+        // Walk away from the X coordinate of nodeB, on both sides
+        auto start = std::lower_bound( m_sortedNodes.begin(), m_sortedNodes.end(), posB.x,
+                []( const CN_ANCHOR_PTR& aNode, int aX )
+                {
+                    return aNode->Pos().x < aX;
+                } );
+
+        for( auto it = start; it != m_sortedNodes.end() && testNode( *it ); ++it )
+            ;
+
+        for( auto it = start; it != m_sortedNodes.begin() && testNode( *( it - 1 ) ); --it )
+            ;
     }
 
     return rv;
@@ -142,15 +142,43 @@ public:
      */
     const CN_ANCHOR_PTR GetClosestNode( const CN_ANCHOR_PTR& aNode ) const;
 
-    bool NearestBicoloredPair( const RN_NET& aOtherNet, CN_ANCHOR_PTR& aNode1, CN_ANCHOR_PTR& aNode2 ) const;
+    /**
+     * Function NearestBicoloredPair()
+     * Finds the shortest line between a node of this net and a node of aOtherNet (the
+     * dynamic ratsnest of the moved items).  The nodes of this net are sorted once: the
+     * following searches, done at each step of a move, only visit the nodes near aOtherNet.
+     * @return false if no node of this net can be used
+     */
+    bool NearestBicoloredPair( const RN_NET& aOtherNet, CN_ANCHOR_PTR& aNode1, CN_ANCHOR_PTR& aNode2 );
 
 protected:
     ///> Recomputes ratsnest from scratch.
     void compute();
 
+    /**
+     * Function updateIncremental()
+     * Computes the ratsnest from the ratsnest of the last update, when only a few clusters
+     * have changed since then (for instance when a module is moved).
+     * This is only used by the board ratsnest, after a commit: the dynamic ratsnest shown
+     * during a move uses NearestBicoloredPair() (see CONNECTIVITY_DATA::ComputeDynamicRatsnest()).
+     * @return false if too many clusters have changed: the ratsnest must be computed from
+     * scratch.
+     */
+    bool updateIncremental();
+
     ///> Vector of nodes
     std::vector<CN_ANCHOR_PTR> m_nodes;
 
+    ///> Nodes sorted by X coordinate, for NearestBicoloredPair().  Empty until it is used.
+    std::vector<CN_ANCHOR_PTR> m_sortedNodes;
+
+    ///> Nodes of each cluster of the net
+    std::vector<std::vector<CN_ANCHOR_PTR>> m_clusterNodes;
+
+    ///> Nodes of each cluster, and ratsnest, of the last update
+    std::vector<std::vector<CN_ANCHOR_PTR>> m_prevClusterNodes;
+    std::vector<CN_EDGE> m_prevRnEdges;
+
     ///> Vector of edges that make pre-defined connections
     std::vector<CN_EDGE> m_boardEdges;
 
@@ -22,6 +22,10 @@
 #ifndef __PNS_DEBUG_DECORATOR_H
 #define __PNS_DEBUG_DECORATOR_H
 
+#include <cstdint>
+#include <map>
+#include <string>
+
 #include <math/vector2d.h>
 #include <math/box2.h>
 #include <geometry/seg.h>
@@ -44,6 +48,19 @@ public:
     virtual void AddBox( BOX2I aB, int aColor ) {};
     virtual void AddDirections( VECTOR2D aP, int aMask, int aColor ) {};
     virtual void Clear() {};
+
+    ///> Adds aValue to the counter aName (e.g. the hits of a cache), kept until ClearCounters()
+    void AddToCounter( const std::string& aName, int64_t aValue )
+    {
+        m_counters[aName] += aValue;
+    }
+
+    const std::map<std::string, int64_t>& Counters() const { return m_counters; }
+
+    void ClearCounters() { m_counters.clear(); }
+
+private:
+    std::map<std::string, int64_t> m_counters;
 };
 
 }
@@ -29,6 +29,19 @@ INDEX::INDEX()
 }
 
 
+INDEX::INDEX( const INDEX& aOther ) :
+    m_netMap( aOther.m_netMap ),
+    m_allItems( aOther.m_allItems )
+{
+    for( int i = 0; i < MaxSubIndices; ++i )
+    {
+        const ITEM_SHAPE_INDEX* idx = aOther.m_subIndices[i];
+
+        m_subIndices[i] = idx ? new ITEM_SHAPE_INDEX( *idx ) : NULL;
+    }
+}
+
+
 INDEX::~INDEX()
 {
     Clear();
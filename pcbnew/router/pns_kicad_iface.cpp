@@ -432,6 +432,9 @@ public:
 
     void AddLine( const SHAPE_LINE_CHAIN& aLine, int aType, int aWidth ) override
     {
+        if( !m_view )
+            return;
+
         ROUTER_PREVIEW_ITEM* pitem = new ROUTER_PREVIEW_ITEM( NULL, m_view );
 
         pitem->Line( aLine, aWidth, aType );
@@ -468,13 +471,19 @@ PNS_KICAD_IFACE::PNS_KICAD_IFACE()
     m_view = nullptr;
     m_previewItems = nullptr;
     m_router = nullptr;
-    m_debugDecorator = nullptr;
+    m_debugDecorator = new PNS_PCBNEW_DEBUG_DECORATOR();   // replaced by SetView()
     m_dispOptions = nullptr;
+    m_world = nullptr;
+    m_worstPadClearance = 0;
+    m_committing = false;
 }
 
 
 PNS_KICAD_IFACE::~PNS_KICAD_IFACE()
 {
+    if( m_board )
+        m_board->RemoveListener( this );
+
     delete m_ruleResolver;
     delete m_debugDecorator;
 
@@ -799,7 +808,7 @@ bool PNS_KICAD_IFACE::syncZone( PNS::NODE* aWorld, ZONE_CONTAINER* aZone )
                 solid->SetShape( triShape );
                 solid->SetRoutable( false );
 
-                aWorld->Add( std::move( solid ) );
+                addSolid( aWorld, aZone, std::move( solid ) );
             }
         }
     }
@@ -808,7 +817,8 @@ bool PNS_KICAD_IFACE::syncZone( PNS::NODE* aWorld, ZONE_CONTAINER* aZone )
 }
 
 
-bool PNS_KICAD_IFACE::syncTextItem( PNS::NODE* aWorld, EDA_TEXT* aText, PCB_LAYER_ID aLayer )
+bool PNS_KICAD_IFACE::syncTextItem( PNS::NODE* aWorld, const BOARD_ITEM* aSource, EDA_TEXT* aText,
+                                    PCB_LAYER_ID aLayer )
 {
     if( !IsCopperLayer( aLayer ) )
         return false;
@@ -833,7 +843,7 @@ bool PNS_KICAD_IFACE::syncTextItem( PNS::NODE* aWorld, EDA_TEXT* aText, PCB_LAYE
         solid->SetShape( new SHAPE_SEGMENT( start, end, textWidth ) );
         solid->SetRoutable( false );
 
-        aWorld->Add( std::move( solid ) );
+        addSolid( aWorld, aSource, std::move( solid ) );
     }
 
     return true;
@@ -860,7 +870,8 @@ bool PNS_KICAD_IFACE::syncTextItem( PNS::NODE* aWorld, EDA_TEXT* aText, PCB_LAYE
 }
 
 
-bool PNS_KICAD_IFACE::syncGraphicalItem( PNS::NODE* aWorld, DRAWSEGMENT* aItem )
+bool PNS_KICAD_IFACE::syncGraphicalItem( PNS::NODE* aWorld, const BOARD_ITEM* aSource,
+                                         DRAWSEGMENT* aItem )
 {
     std::vector<SHAPE_SEGMENT*> segs;
 
@@ -947,7 +958,7 @@ bool PNS_KICAD_IFACE::syncGraphicalItem( PNS::NODE* aWorld, DRAWSEGMENT* aItem )
         solid->SetShape( seg );
         solid->SetRoutable( false );
 
-        aWorld->Add( std::move( solid ) );
+        addSolid( aWorld, aSource, std::move( solid ) );
     }
 
     return true;
@@ -956,8 +967,19 @@ bool PNS_KICAD_IFACE::syncGraphicalItem( PNS::NODE* aWorld, DRAWSEGMENT* aItem )
 
 void PNS_KICAD_IFACE::SetBoard( BOARD* aBoard )
 {
+    if( aBoard == m_board )
+        return;
+
+    if( m_board )
+        m_board->RemoveListener( this );
+
     m_board = aBoard;
+    m_world = nullptr;
     wxLogTrace( "PNS", "m_board = %p", m_board );
+
+    // The world follows the commits of the board
+    if( m_board )
+        m_board->AddListener( this );
 }
 
 
@@ -1016,7 +1038,9 @@ bool PNS_KICAD_IFACE::IsItemVisible( const PNS::ITEM* aItem )
 
 void PNS_KICAD_IFACE::SyncWorld( PNS::NODE *aWorld )
 {
-    int worstPadClearance = 0;
+    m_world = nullptr;
+    m_syncedItems.clear();
+    m_worstPadClearance = 0;
 
     if( !m_board )
     {
@@ -1025,74 +1049,252 @@ void PNS_KICAD_IFACE::SyncWorld( PNS::NODE *aWorld )
     }
 
     for( auto gitem : m_board->Drawings() )
+        syncBoardItem( aWorld, gitem );
+
+    for( auto zone : m_board->Zones() )
+        syncBoardItem( aWorld, zone );
+
+    for( auto module : m_board->Modules() )
+        syncBoardItem( aWorld, module );
+
+    for( auto t : m_board->Tracks() )
+        syncBoardItem( aWorld, t );
+
+    syncRules( aWorld );
+
+    m_world = aWorld;
+}
+
+
+void PNS_KICAD_IFACE::syncModule( PNS::NODE* aWorld, MODULE* aModule )
+{
+    for( auto pad : aModule->Pads() )
     {
-        if ( gitem->Type() == PCB_LINE_T )
+        if( auto solid = syncPad( pad ) )
+            addSolid( aWorld, aModule, std::move( solid ) );
+
+        m_worstPadClearance = std::max( m_worstPadClearance, pad->GetLocalClearance() );
+    }
+
+    syncTextItem( aWorld, aModule, &aModule->Reference(), aModule->Reference().GetLayer() );
+    syncTextItem( aWorld, aModule, &aModule->Value(), aModule->Value().GetLayer() );
+
+    if( aModule->IsNetTie() )
+        return;
+
+    for( auto mgitem : aModule->GraphicalItems() )
+    {
+        if( mgitem->Type() == PCB_MODULE_EDGE_T )
         {
-            syncGraphicalItem( aWorld, static_cast<DRAWSEGMENT*>( gitem ) );
+            syncGraphicalItem( aWorld, aModule, static_cast<DRAWSEGMENT*>( mgitem ) );
         }
-        else if( gitem->Type() == PCB_TEXT_T )
+        else if( mgitem->Type() == PCB_MODULE_TEXT_T )
         {
-            syncTextItem( aWorld, static_cast<TEXTE_PCB*>( gitem ), gitem->GetLayer() );
+            syncTextItem( aWorld, aModule, dynamic_cast<TEXTE_MODULE*>( mgitem ),
+                          mgitem->GetLayer() );
         }
     }
+}
 
-    for( auto zone : m_board->Zones() )
-    {
-        syncZone( aWorld, zone );
-    }
 
-    for( auto module : m_board->Modules() )
+void PNS_KICAD_IFACE::syncBoardItem( PNS::NODE* aWorld, BOARD_ITEM* aItem )
+{
+    switch( aItem->Type() )
     {
-        for( auto pad : module->Pads() )
-        {
-            if( auto solid = syncPad( pad ) )
-                aWorld->Add( std::move( solid ) );
+    case PCB_LINE_T:
+        syncGraphicalItem( aWorld, aItem, static_cast<DRAWSEGMENT*>( aItem ) );
+        break;
 
-            worstPadClearance = std::max( worstPadClearance, pad->GetLocalClearance() );
-        }
+    case PCB_TEXT_T:
+        syncTextItem( aWorld, aItem, static_cast<TEXTE_PCB*>( aItem ), aItem->GetLayer() );
+        break;
 
-        syncTextItem( aWorld, &module->Reference(), module->Reference().GetLayer() );
-        syncTextItem( aWorld, &module->Value(), module->Value().GetLayer() );
+    case PCB_ZONE_AREA_T:
+        syncZone( aWorld, static_cast<ZONE_CONTAINER*>( aItem ) );
+        break;
 
-        if( module->IsNetTie() )
-            continue;
+    case PCB_MODULE_T:
+        syncModule( aWorld, static_cast<MODULE*>( aItem ) );
+        break;
+
+    case PCB_TRACE_T:
+    {
+        std::unique_ptr<PNS::SEGMENT> segment = syncTrack( static_cast<TRACK*>( aItem ) );
+        PNS::SEGMENT* added = segment.get();
+
+        // zero-length and redundant segments are not added
+        if( segment && aWorld->Add( std::move( segment ) ) )
+            m_syncedItems[aItem].push_back( added );
+
+        break;
+    }
 
-        for( auto mgitem : module->GraphicalItems() )
+    case PCB_VIA_T:
+        if( auto via = syncVia( static_cast<VIA*>( aItem ) ) )
         {
-            if( mgitem->Type() == PCB_MODULE_EDGE_T )
-            {
-                syncGraphicalItem( aWorld, static_cast<DRAWSEGMENT*>( mgitem ) );
-            }
-            else if( mgitem->Type() == PCB_MODULE_TEXT_T )
-            {
-                syncTextItem( aWorld, dynamic_cast<TEXTE_MODULE*>( mgitem ), mgitem->GetLayer() );
-            }
+            m_syncedItems[aItem].push_back( via.get() );
+            aWorld->Add( std::move( via ) );
         }
+
+        break;
+
+    default:
+        break;
     }
+}
 
-    for( auto t : m_board->Tracks() )
+
+std::vector<int> PNS_KICAD_IFACE::netClassRules() const
+{
+    std::vector<int> rules;
+    NETCLASSES&      netClasses = m_board->GetDesignSettings().m_NetClasses;
+
+    rules.reserve( 2 * m_board->GetNetCount() );
+
+    for( unsigned int i = 0; i < m_board->GetNetCount(); i++ )
     {
-        KICAD_T type = t->Type();
+        NETINFO_ITEM* ni = m_board->FindNet( i );
 
-        if( type == PCB_TRACE_T )
-        {
-            if( auto segment = syncTrack( t ) )
-                aWorld->Add( std::move( segment ) );
-        }
-        else if( type == PCB_VIA_T )
-        {
-            if( auto via = syncVia( static_cast<VIA*>( t ) ) )
-                aWorld->Add( std::move( via ) );
-        }
+        if( ni == NULL )
+            continue;
+
+        NETCLASSPTR nc = netClasses.Find( ni->GetClassName() );
+
+        rules.push_back( nc->GetClearance() );
+        rules.push_back( nc->GetDiffPairGap() );
     }
 
+    return rules;
+}
+
+
+void PNS_KICAD_IFACE::syncRules( PNS::NODE* aWorld )
+{
     int worstRuleClearance = m_board->GetDesignSettings().GetBiggestClearanceValue();
 
+    m_netClassRules = netClassRules();
+
     delete m_ruleResolver;
     m_ruleResolver = new PNS_PCBNEW_RULE_RESOLVER( m_board, m_router );
 
     aWorld->SetRuleResolver( m_ruleResolver );
-    aWorld->SetMaxClearance( 4 * std::max(worstPadClearance, worstRuleClearance ) );
+    aWorld->SetMaxClearance( 4 * std::max( m_worstPadClearance, worstRuleClearance ) );
+}
+
+
+void PNS_KICAD_IFACE::addSolid( PNS::NODE* aWorld, const BOARD_ITEM* aSource,
+                                std::unique_ptr<PNS::SOLID> aSolid )
+{
+    m_syncedItems[aSource].push_back( aSolid.get() );
+    aWorld->Add( std::move( aSolid ) );
+}
+
+
+void PNS_KICAD_IFACE::removeBoardItem( PNS::NODE* aWorld, const BOARD_ITEM* aSource )
+{
+    auto it = m_syncedItems.find( aSource );
+
+    if( it == m_syncedItems.end() )
+        return;
+
+    for( PNS::ITEM* item : it->second )
+        aWorld->Remove( item );
+
+    m_syncedItems.erase( it );
+}
+
+
+bool PNS_KICAD_IFACE::IsWorldUpToDate( const BOARD* aBoard ) const
+{
+    // The router deletes its world in ClearWorld(), and builds a new one with SyncWorld()
+    return m_board && aBoard == m_board && m_world && m_router
+           && m_router->GetWorld() == m_world;
+}
+
+
+void PNS_KICAD_IFACE::OnBoardItemsChanged( BOARD& aBoard, const std::vector<BOARD_ITEM*>& aChanged,
+                                           const std::vector<BOARD_ITEM*>& aRemoved )
+{
+    // The changes pushed by Commit() are already in the world
+    if( m_committing || !IsWorldUpToDate( &aBoard ) )
+        return;
+
+    // The branches of a route in progress refer to the items of the world: build it again
+    // when the route is done
+    if( m_world->HasChildren() )
+    {
+        m_world = nullptr;
+        return;
+    }
+
+    // The rule resolver caches the clearances of the pads
+    bool padsChanged = false;
+
+    auto isPadOrModule = []( const BOARD_ITEM* aItem )
+    {
+        return aItem->Type() == PCB_PAD_T || aItem->Type() == PCB_MODULE_T;
+    };
+
+    for( BOARD_ITEM* item : aRemoved )
+    {
+        padsChanged |= isPadOrModule( item );
+        removeBoardItem( m_world, item );
+    }
+
+    for( BOARD_ITEM* item : aChanged )
+    {
+        padsChanged |= isPadOrModule( item );
+
+        // The items of a module are synced with their module
+        switch( item->Type() )
+        {
+        case PCB_PAD_T:
+        case PCB_MODULE_TEXT_T:
+        case PCB_MODULE_EDGE_T:
+            item = static_cast<BOARD_ITEM*>( item->GetParent() );
+            break;
+
+        default:
+            break;
+        }
+
+        removeBoardItem( m_world, item );
+        syncBoardItem( m_world, item );
+    }
+
+    // The rule resolver is built again when the pads, or the net classes of the nets,
+    // have changed
+    if( padsChanged || netClassRules() != m_netClassRules )
+        syncRules( m_world );
+
+    wxLogTrace( "PNS", "World updated: %d changed, %d removed board items",
+                (int) aChanged.size(), (int) aRemoved.size() );
+}
+
+
+void PNS_KICAD_IFACE::OnBoardInvalidated( BOARD& aBoard )
+{
+    if( &aBoard != m_board )
+        return;
+
+    // The board items of the world can have been deleted: drop the world now, so no item
+    // keeps a freed parent until the world is built again (see TOOL_BASE::syncWorld()).
+    // The branches of a route in progress still need it: it is dropped after the route.
+    if( IsWorldUpToDate( &aBoard ) && !m_world->HasChildren() )
+        m_router->ClearWorld();
+
+    m_syncedItems.clear();
+    m_world = nullptr;
+}
+
+
+void PNS_KICAD_IFACE::OnBoardDeleted( BOARD& aBoard )
+{
+    if( &aBoard == m_board )
+    {
+        m_board = nullptr;
+        m_world = nullptr;
+    }
 }
 
 
@@ -1118,6 +1320,9 @@ void PNS_KICAD_IFACE::DisplayItem( const PNS::ITEM* aItem, int aColor, int aClea
 {
     wxLogTrace( "PNS", "DisplayItem %p", aItem );
 
+    if( !m_previewItems )
+        return;
+
     ROUTER_PREVIEW_ITEM* pitem = new ROUTER_PREVIEW_ITEM( aItem, m_view );
 
     if( aColor >= 0 )
@@ -1164,7 +1369,7 @@ void PNS_KICAD_IFACE::HideItem( PNS::ITEM* aItem )
 {
     BOARD_CONNECTED_ITEM* parent = aItem->Parent();
 
-    if( parent )
+    if( parent && m_view )
     {
         if( m_view->IsVisible( parent ) )
             m_hiddenItems.insert( parent );
@@ -1179,9 +1384,12 @@ void PNS_KICAD_IFACE::RemoveItem( PNS::ITEM* aItem )
 {
     BOARD_CONNECTED_ITEM* parent = aItem->Parent();
 
-    if( parent )
+    if( parent && m_commit )
     {
         m_commit->Remove( parent );
+
+        // aItem is removed from the world by ROUTER::CommitRouting()
+        m_syncedItems.erase( parent );
     }
 }
 
@@ -1190,6 +1398,10 @@ void PNS_KICAD_IFACE::AddItem( PNS::ITEM* aItem )
 {
     BOARD_CONNECTED_ITEM* newBI = NULL;
 
+    // Without host tool, the changes are only committed to the world of the router
+    if( !m_commit )
+        return;
+
     switch( aItem->Kind() )
     {
     case PNS::ITEM::SEGMENT_T:
@@ -1232,6 +1444,9 @@ void PNS_KICAD_IFACE::AddItem( PNS::ITEM* aItem )
         newBI->ClearFlags();
 
         m_commit->Add( newBI );
+
+        // aItem is added to the world by ROUTER::CommitRouting()
+        m_syncedItems[newBI].push_back( aItem );
     }
 }
 
@@ -1239,7 +1454,14 @@ void PNS_KICAD_IFACE::AddItem( PNS::ITEM* aItem )
 void PNS_KICAD_IFACE::Commit()
 {
     EraseView();
+
+    if( !m_commit )
+        return;
+
+    m_committing = true;
     m_commit->Push( _( "Added a track" ) );
+    m_committing = false;
+
     m_commit.reset( new BOARD_COMMIT( m_tool ) );
 }
 
@@ -23,6 +23,10 @@
 #define __PNS_KICAD_IFACE_H
 
 #include <unordered_set>
+#include <unordered_map>
+#include <vector>
+
+#include <board_listener.h>
 
 #include "pns_router.h"
 
@@ -30,6 +34,8 @@ class PNS_PCBNEW_RULE_RESOLVER;
 class PNS_PCBNEW_DEBUG_DECORATOR;
 
 class BOARD;
+class BOARD_ITEM;
+class MODULE;
 class BOARD_COMMIT;
 class PCB_DISPLAY_OPTIONS;
 class PCB_TOOL;
@@ -39,7 +45,19 @@ namespace KIGFX
     class VIEW;
 }
 
-class PNS_KICAD_IFACE : public PNS::ROUTER_IFACE {
+/**
+ * Class PNS_KICAD_IFACE
+ * connects the router to the board being edited.
+ *
+ * The world built by SyncWorld() follows the commits of the board: the items of the changed
+ * board items are built again, so the world can be reused by the next router invocations
+ * (see IsWorldUpToDate()) instead of being built again from the whole board.
+ *
+ * Without view and host tool (see SetView() and SetHostTool()), the router runs headless:
+ * nothing is displayed, and the routed items are committed only to its world, not to the
+ * board.  This is used to replay the recorded routing sessions (see PNS::SESSION_LOG).
+ */
+class PNS_KICAD_IFACE : public PNS::ROUTER_IFACE, public BOARD_LISTENER {
 public:
     PNS_KICAD_IFACE();
     ~PNS_KICAD_IFACE();
@@ -62,6 +80,18 @@ public:
 
     void UpdateNet( int aNetCode ) override;
 
+    /**
+     * Function IsWorldUpToDate
+     * @return true if the world of the router was built by SyncWorld() from aBoard, and
+     * updated with all the changes of aBoard since.
+     */
+    bool IsWorldUpToDate( const BOARD* aBoard ) const;
+
+    void OnBoardItemsChanged( BOARD& aBoard, const std::vector<BOARD_ITEM*>& aChanged,
+                              const std::vector<BOARD_ITEM*>& aRemoved ) override;
+    void OnBoardInvalidated( BOARD& aBoard ) override;
+    void OnBoardDeleted( BOARD& aBoard ) override;
+
     PNS::RULE_RESOLVER* GetRuleResolver() override;
     PNS::DEBUG_DECORATOR* GetDebugDecorator() override;
 
@@ -72,9 +102,23 @@ private:
     std::unique_ptr<PNS::SOLID> syncPad( D_PAD* aPad );
     std::unique_ptr<PNS::SEGMENT> syncTrack( TRACK* aTrack );
     std::unique_ptr<PNS::VIA> syncVia( VIA* aVia );
-    bool syncTextItem( PNS::NODE* aWorld, EDA_TEXT* aText, PCB_LAYER_ID aLayer );
-    bool syncGraphicalItem( PNS::NODE* aWorld, DRAWSEGMENT* aItem );
+    bool syncTextItem( PNS::NODE* aWorld, const BOARD_ITEM* aSource, EDA_TEXT* aText,
+                       PCB_LAYER_ID aLayer );
+    bool syncGraphicalItem( PNS::NODE* aWorld, const BOARD_ITEM* aSource, DRAWSEGMENT* aItem );
     bool syncZone( PNS::NODE* aWorld, ZONE_CONTAINER* aZone );
+    void syncModule( PNS::NODE* aWorld, MODULE* aModule );
+    void syncBoardItem( PNS::NODE* aWorld, BOARD_ITEM* aItem );
+    void syncRules( PNS::NODE* aWorld );
+
+    ///> @return the clearance and diff pair gap of the net class of each net
+    std::vector<int> netClassRules() const;
+
+    ///> adds aSolid to the world, as an item built for aSource
+    void addSolid( PNS::NODE* aWorld, const BOARD_ITEM* aSource,
+                   std::unique_ptr<PNS::SOLID> aSolid );
+
+    ///> removes from the world the items built for aSource
+    void removeBoardItem( PNS::NODE* aWorld, const BOARD_ITEM* aSource );
 
     KIGFX::VIEW* m_view;
     KIGFX::VIEW_GROUP* m_previewItems;
@@ -85,6 +129,21 @@ private:
     PCB_TOOL* m_tool;
     std::unique_ptr<BOARD_COMMIT> m_commit;
     PCB_DISPLAY_OPTIONS* m_dispOptions;
+
+    ///> the world synced with m_board, nullptr if it must be built again
+    PNS::NODE* m_world;
+
+    ///> the items of m_world built for each board item (a module for its pads and texts)
+    std::unordered_map<const BOARD_ITEM*, std::vector<PNS::ITEM*>> m_syncedItems;
+
+    ///> the net class rules used by the rule resolver (see netClassRules())
+    std::vector<int> m_netClassRules;
+
+    ///> the largest local clearance of the synced pads.  It is only reset when the world
+    ///> is built again: a removed or changed pad never lowers it, so it is an upper bound,
+    ///> which only makes the max clearance of the world (the search distance) larger.
+    int  m_worstPadClearance;
+    bool m_committing;      ///< true while the changes of the router are pushed
 };
 
 #endif
@@ -21,6 +21,7 @@
 
 #include <vector>
 #include <cassert>
+#include <atomic>
 
 #include <math/vector2d.h>
 
@@ -37,6 +38,7 @@
 #include "pns_joint.h"
 #include "pns_index.h"
 #include "pns_router.h"
+#include "pns_timing.h"
 
 
 namespace PNS {
@@ -45,6 +47,9 @@ namespace PNS {
 static std::unordered_set<NODE*> allocNodes;
 #endif
 
+// The last revision given to a node
+static std::atomic<uint64_t> lastRevision( 0 );
+
 NODE::NODE()
 {
     wxLogTrace( "PNS", "NODE::create %p", this );
@@ -53,7 +58,10 @@ NODE::NODE()
     m_parent = NULL;
     m_maxClearance = 800000;    // fixme: depends on how thick traces are.
     m_ruleResolver = NULL;
-    m_index = new INDEX;
+    m_index = std::make_shared<INDEX>();
+    m_joints = std::make_shared<JOINT_MAP>();
+    m_override = std::make_shared<OVERRIDE_SET>();
+    bumpRevision();
 
 #ifdef DEBUG
     allocNodes.insert( this );
@@ -81,7 +89,7 @@ NODE::~NODE()
     allocNodes.erase( this );
 #endif
 
-    m_joints.clear();
+    m_joints.reset();
 
     for( INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
     {
@@ -91,8 +99,6 @@ NODE::~NODE()
 
     releaseGarbage();
     unlinkParent();
-
-    delete m_index;
 }
 
 int NODE::GetClearance( const ITEM* aA, const ITEM* aB ) const
@@ -104,6 +110,12 @@ int NODE::GetClearance( const ITEM* aA, const ITEM* aB ) const
 }
 
 
+void NODE::bumpRevision()
+{
+    m_revision = ++lastRevision;
+}
+
+
 NODE* NODE::Branch()
 {
     NODE* child = new NODE;
@@ -119,21 +131,18 @@ NODE* NODE::Branch()
     child->m_maxClearance = m_maxClearance;
 
     // immmediate offspring of the root branch needs not copy anything.
-    // For the rest, deep-copy joints, overridden item map and pointers
-    // to stored items.
+    // The rest shares the joints, the overridden item map and the index of
+    // the stored items with this node: they are copied only when the child
+    // or this node modifies them, so branching is cheap even in deep shoves.
     if( !isRoot() )
     {
-        JOINT_MAP::iterator j;
-
-        for( INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
-            child->m_index->Add( *i );
-
+        child->m_index = m_index;
         child->m_joints = m_joints;
         child->m_override = m_override;
     }
 
     wxLogTrace( "PNS", "%d items, %d joints, %d overrides",
-            child->m_index->Size(), (int) child->m_joints.size(), (int) child->m_override.size() );
+            child->m_index->Size(), (int) child->m_joints->size(), (int) child->m_override->size() );
 
     return child;
 }
@@ -260,6 +269,8 @@ struct NODE::DEFAULT_OBSTACLE_VISITOR : public OBSTACLE_VISITOR
 
 int NODE::QueryColliding( const ITEM* aItem, OBSTACLE_VISITOR& aVisitor )
 {
+    TIMING::SCOPE timing( TP_COLLISION );
+
     aVisitor.SetWorld( this, NULL );
     m_index->Query( aItem, m_maxClearance, aVisitor );
 
@@ -277,6 +288,8 @@ int NODE::QueryColliding( const ITEM* aItem, OBSTACLE_VISITOR& aVisitor )
 int NODE::QueryColliding( const ITEM* aItem,
         NODE::OBSTACLES& aObstacles, int aKindMask, int aLimitCount, bool aDifferentNetsOnly, int aForceClearance )
 {
+    TIMING::SCOPE timing( TP_COLLISION );
+
     DEFAULT_OBSTACLE_VISITOR visitor( aObstacles, aItem, aKindMask, aDifferentNetsOnly );
 
 #ifdef DEBUG
@@ -536,7 +549,8 @@ void NODE::addSolid( SOLID* aSolid )
     if( aSolid->IsRoutable() )
         linkJoint( aSolid->Pos(), aSolid->Layers(), aSolid->Net(), aSolid );
 
-    m_index->Add( aSolid );
+    writable( m_index ).Add( aSolid );
+    bumpRevision();
 }
 
 void NODE::Add( std::unique_ptr< SOLID > aSolid )
@@ -548,7 +562,8 @@ void NODE::Add( std::unique_ptr< SOLID > aSolid )
 void NODE::addVia( VIA* aVia )
 {
     linkJoint( aVia->Pos(), aVia->Layers(), aVia->Net(), aVia );
-    m_index->Add( aVia );
+    writable( m_index ).Add( aVia );
+    bumpRevision();
 }
 
 void NODE::Add( std::unique_ptr< VIA > aVia )
@@ -591,7 +606,8 @@ void NODE::addSegment( SEGMENT* aSeg )
     linkJoint( aSeg->Seg().A, aSeg->Layers(), aSeg->Net(), aSeg );
     linkJoint( aSeg->Seg().B, aSeg->Layers(), aSeg->Net(), aSeg );
 
-    m_index->Add( aSeg );
+    writable( m_index ).Add( aSeg );
+    bumpRevision();
 }
 
 bool NODE::Add( std::unique_ptr< SEGMENT > aSegment, bool aAllowRedundant )
@@ -642,12 +658,14 @@ void NODE::doRemove( ITEM* aItem )
     // case 1: removing an item that is stored in the root node from any branch:
     // mark it as overridden, but do not remove
     if( aItem->BelongsTo( m_root ) && !isRoot() )
-        m_override.insert( aItem );
+        writable( m_override ).insert( aItem );
 
     // case 2: the item belongs to this branch or a parent, non-root branch,
     // or the root itself and we are the root: remove from the index
     else if( !aItem->BelongsTo( m_root ) || isRoot() )
-        m_index->Remove( aItem );
+        writable( m_index ).Remove( aItem );
+
+    bumpRevision();
 
     // the item belongs to this particular branch: un-reference it
     if( aItem->BelongsTo( this ) )
@@ -677,6 +695,7 @@ void NODE::removeViaIndex( VIA* aVia )
 
     JOINT* jt = FindJoint( p, vLayers.Start(), net );
     JOINT::LINKED_ITEMS links( jt->LinkList() );
+    JOINT_MAP& joints = writable( m_joints );
 
     tag.net = net;
     tag.pos = p;
@@ -685,9 +704,9 @@ void NODE::removeViaIndex( VIA* aVia )
     do
     {
         split = false;
-        std::pair<JOINT_MAP::iterator, JOINT_MAP::iterator> range = m_joints.equal_range( tag );
+        std::pair<JOINT_MAP::iterator, JOINT_MAP::iterator> range = joints.equal_range( tag );
 
-        if( range.first == m_joints.end() )
+        if( range.first == joints.end() )
             break;
 
         // find and remove all joints containing the via to be removed
@@ -696,7 +715,7 @@ void NODE::removeViaIndex( VIA* aVia )
         {
             if( aVia->LayersOverlap( &f->second ) )
             {
-                m_joints.erase( f );
+                joints.erase( f );
                 split = true;
                 break;
             }
@@ -975,12 +994,12 @@ JOINT* NODE::FindJoint( const VECTOR2I& aPos, int aLayer, int aNet )
     tag.net = aNet;
     tag.pos = aPos;
 
-    JOINT_MAP::iterator f = m_joints.find( tag ), end = m_joints.end();
+    JOINT_MAP::iterator f = m_joints->find( tag ), end = m_joints->end();
 
     if( f == end && !isRoot() )
     {
-        end = m_root->m_joints.end();
-        f = m_root->m_joints.find( tag );    // m_root->FindJoint(aPos, aLayer, aNet);
+        end = m_root->m_joints->end();
+        f = m_root->m_joints->find( tag );    // m_root->FindJoint(aPos, aLayer, aNet);
     }
 
     if( f == end )
@@ -1012,18 +1031,20 @@ JOINT& NODE::touchJoint( const VECTOR2I& aPos, const LAYER_RANGE& aLayers, int a
     tag.pos = aPos;
     tag.net = aNet;
 
+    JOINT_MAP& joints = writable( m_joints );
+
     // try to find the joint in this node.
-    JOINT_MAP::iterator f = m_joints.find( tag );
+    JOINT_MAP::iterator f = joints.find( tag );
 
     std::pair<JOINT_MAP::iterator, JOINT_MAP::iterator> range;
 
     // not found and we are not root? find in the root and copy results here.
-    if( f == m_joints.end() && !isRoot() )
+    if( f == joints.end() && !isRoot() )
     {
-        range = m_root->m_joints.equal_range( tag );
+        range = m_root->m_joints->equal_range( tag );
 
         for( f = range.first; f != range.second; ++f )
-            m_joints.insert( *f );
+            joints.insert( *f );
     }
 
     // now insert and combine overlapping joints
@@ -1034,9 +1055,9 @@ JOINT& NODE::touchJoint( const VECTOR2I& aPos, const LAYER_RANGE& aLayers, int a
     do
     {
         merged  = false;
-        range   = m_joints.equal_range( tag );
+        range   = joints.equal_range( tag );
 
-        if( range.first == m_joints.end() )
+        if( range.first == joints.end() )
             break;
 
         for( f = range.first; f != range.second; ++f )
@@ -1044,7 +1065,7 @@ JOINT& NODE::touchJoint( const VECTOR2I& aPos, const LAYER_RANGE& aLayers, int a
             if( aLayers.Overlaps( f->second.Layers() ) )
             {
                 jt.Merge( f->second );
-                m_joints.erase( f );
+                joints.erase( f );
                 merged = true;
                 break;
             }
@@ -1052,7 +1073,7 @@ JOINT& NODE::touchJoint( const VECTOR2I& aPos, const LAYER_RANGE& aLayers, int a
     }
     while( merged );
 
-    return m_joints.insert( TagJointPair( tag, jt ) )->second;
+    return joints.insert( TagJointPair( tag, jt ) )->second;
 }
 
 
@@ -1165,13 +1186,13 @@ void NODE::Dump( bool aLong )
 
 void NODE::GetUpdatedItems( ITEM_VECTOR& aRemoved, ITEM_VECTOR& aAdded )
 {
-    aRemoved.reserve( m_override.size() );
+    aRemoved.reserve( m_override->size() );
     aAdded.reserve( m_index->Size() );
 
     if( isRoot() )
         return;
 
-    for( ITEM* item : m_override )
+    for( ITEM* item : *m_override )
         aRemoved.push_back( item );
 
     for( INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
@@ -1211,7 +1232,7 @@ void NODE::Commit( NODE* aNode )
         if( aNode->isRoot() )
             return;
 
-        for( ITEM* item : aNode->m_override )
+        for( ITEM* item : *aNode->m_override )
             Remove( item );
 
         for( auto i : *aNode->m_index )
@@ -24,8 +24,11 @@
 
 #include <vector>
 #include <list>
+#include <algorithm>
+#include <cstdint>
 #include <unordered_set>
 #include <unordered_map>
+#include <memory>
 
 #include <core/optional.h>
 
@@ -156,12 +159,26 @@ public:
     void SetMaxClearance( int aClearance )
     {
         m_maxClearance = aClearance;
+        bumpRevision();
     }
 
     ///> Assigns a clerance resolution function object
     void SetRuleResolver( RULE_RESOLVER* aFunc )
     {
         m_ruleResolver = aFunc;
+        bumpRevision();
+    }
+
+    /**
+     * Function Revision()
+     *
+     * Returns a number which changes whenever the result of a collision query in this
+     * node may change: when items are added to or removed from this node or from the root
+     * node, or when the rules change.  A revision is never used twice, even by another node.
+     */
+    uint64_t Revision() const
+    {
+        return isRoot() ? m_revision : std::max( m_revision, m_root->m_revision );
     }
 
     RULE_RESOLVER* GetRuleResolver()
@@ -172,7 +189,7 @@ public:
     ///> Returns the number of joints
     int JointCount() const
     {
-        return m_joints.size();
+        return m_joints->size();
     }
 
     ///> Returns the number of nodes in the inheritance chain (wrs to the root node)
@@ -415,13 +432,14 @@ public:
     ///> from the root branch.
     bool Overrides( ITEM* aItem ) const
     {
-        return m_override.find( aItem ) != m_override.end();
+        return m_override->find( aItem ) != m_override->end();
     }
 
 private:
     struct DEFAULT_OBSTACLE_VISITOR;
     typedef std::unordered_multimap<JOINT::HASH_TAG, JOINT, JOINT::JOINT_TAG_HASH> JOINT_MAP;
     typedef JOINT_MAP::value_type TagJointPair;
+    typedef std::unordered_set<ITEM*> OVERRIDE_SET;
 
     /// nodes are not copyable
     NODE( const NODE& aB );
@@ -453,11 +471,25 @@ private:
     void releaseChildren();
     void releaseGarbage();
 
+    ///> gives a new revision to this node, see Revision()
+    void bumpRevision();
+
     bool isRoot() const
     {
         return m_parent == NULL;
     }
 
+    ///> returns the object pointed by aShared, after copying it if it is shared with
+    ///> other nodes (copy on write).
+    template <class T>
+    static T& writable( std::shared_ptr<T>& aShared )
+    {
+        if( aShared.use_count() > 1 )
+            aShared = std::make_shared<T>( *aShared );
+
+        return *aShared;
+    }
+
     SEGMENT* findRedundantSegment( const VECTOR2I& A, const VECTOR2I& B,
                                    const LAYER_RANGE & lr, int aNet );
     SEGMENT* findRedundantSegment( SEGMENT* aSeg );
@@ -473,8 +505,9 @@ private:
                      bool        aStopAtLockedJoints );
 
     ///> hash table with the joints, linking the items. Joints are hashed by
-    ///> their position, layer set and net.
-    JOINT_MAP m_joints;
+    ///> their position, layer set and net. Shared with the branches of this node
+    ///> until one of them modifies it.
+    std::shared_ptr<JOINT_MAP> m_joints;
 
     ///> node this node was branched from
     NODE* m_parent;
@@ -485,8 +518,8 @@ private:
     ///> list of nodes branched from this one
     std::set<NODE*> m_children;
 
-    ///> hash of root's items that have been changed in this node
-    std::unordered_set<ITEM*> m_override;
+    ///> hash of root's items that have been changed in this node (copy on write)
+    std::shared_ptr<OVERRIDE_SET> m_override;
 
     ///> worst case item-item clearance
     int m_maxClearance;
@@ -494,12 +527,15 @@ private:
     ///> Design rules resolver
     RULE_RESOLVER* m_ruleResolver;
 
-    ///> Geometric/Net index of the items
-    INDEX* m_index;
+    ///> Geometric/Net index of the items (copy on write)
+    std::shared_ptr<INDEX> m_index;
 
     ///> depth of the node (number of parent nodes in the inheritance chain)
     int m_depth;
 
+    ///> revision of the items and rules of this node, see Revision()
+    uint64_t m_revision;
+
     std::unordered_set<ITEM*> m_garbageItems;
 };
 
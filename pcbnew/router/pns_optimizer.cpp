@@ -32,6 +32,8 @@
 #include "../../include/geometry/shape_simple.h"
 #include "pns_utils.h"
 #include "pns_router.h"
+#include "pns_timing.h"
+#include "pns_debug_decorator.h"
 
 namespace PNS {
 
@@ -128,8 +130,17 @@ OPTIMIZER::OPTIMIZER( NODE* aWorld ) :
     m_collisionKindMask( ITEM::ANY_T ),
     m_effortLevel( MERGE_SEGMENTS ),
     m_keepPostures( false ),
-    m_restrictAreaActive( false )
+    m_restrictAreaActive( false ),
+    m_memoWorld( nullptr ),
+    m_memoRevision( 0 ),
+    m_memoHits( 0 ),
+    m_memoMisses( 0 ),
+    m_debugDecorator( nullptr )
 {
+    ROUTER* router = ROUTER::GetInstance();
+
+    if( router && router->GetInterface() )
+        m_debugDecorator = router->GetInterface()->GetDebugDecorator();
 }
 
 
@@ -382,36 +393,86 @@ bool LINE_RESTRICTIONS::Check( int aVertex1, int aVertex2, const SHAPE_LINE_CHAI
 }
 
 
-bool OPTIMIZER::checkColliding( ITEM* aItem, bool aUpdateCache )
+bool OPTIMIZER::MEMO_KEY::operator==( const MEMO_KEY& aOther ) const
+{
+    return m_a == aOther.m_a && m_b == aOther.m_b && m_width == aOther.m_width
+           && m_layerStart == aOther.m_layerStart && m_layerEnd == aOther.m_layerEnd
+           && m_net == aOther.m_net;
+}
+
+
+std::size_t OPTIMIZER::MEMO_KEY_HASH::operator()( const MEMO_KEY& aKey ) const
 {
-    CACHE_VISITOR v( aItem, m_world, m_collisionKindMask );
+    const int values[] = { aKey.m_a.x, aKey.m_a.y, aKey.m_b.x, aKey.m_b.y, aKey.m_width,
+                           aKey.m_layerStart, aKey.m_layerEnd, aKey.m_net };
+    std::size_t seed = 0;
+
+    for( int value : values )
+        seed ^= std::hash<int>()( value ) + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 );
 
-    return static_cast<bool>( m_world->CheckColliding( aItem ) );
+    return seed;
+}
 
-#if 0
-    // something is wrong with the cache, need to investigate.
-    m_cache.Query( aItem->Shape(), m_world->GetMaxClearance(), v, false );
 
-    if( !v.m_collidingItem )
+bool OPTIMIZER::checkColliding( const SEGMENT& aSeg )
+{
+    // The memo is valid only for the world and the revision it was filled from
+    if( m_memoWorld != m_world || m_memoRevision != m_world->Revision() )
     {
-        NODE::OPT_OBSTACLE obs = m_world->CheckColliding( aItem );
+        m_collisionMemo.clear();
+        m_memoWorld = m_world;
+        m_memoRevision = m_world->Revision();
+    }
 
-        if( obs )
-        {
-            if( aUpdateCache )
-                cacheAdd( obs->m_item );
+    MEMO_KEY key;
+    key.m_a = aSeg.Seg().A;
+    key.m_b = aSeg.Seg().B;
+    key.m_width = aSeg.Width();
+    key.m_layerStart = aSeg.Layers().Start();
+    key.m_layerEnd = aSeg.Layers().End();
+    key.m_net = aSeg.Net();
 
-            return true;
-        }
+    auto it = m_collisionMemo.find( key );
+
+    if( it != m_collisionMemo.end() )
+    {
+        m_memoHits++;
+        return it->second;
     }
-    else
+
+    m_memoMisses++;
+
+    bool colliding = static_cast<bool>( m_world->CheckColliding( &aSeg ) );
+    m_collisionMemo[key] = colliding;
+
+    return colliding;
+}
+
+
+bool OPTIMIZER::checkColliding( ITEM* aItem, bool aUpdateCache )
+{
+    // Same as NODE::CheckColliding(), but the segments are checked through the memo
+    if( aItem->Kind() == ITEM::SEGMENT_T )
+        return checkColliding( *static_cast<SEGMENT*>( aItem ) );
+
+    if( aItem->Kind() != ITEM::LINE_T )
+        return static_cast<bool>( m_world->CheckColliding( aItem ) );
+
+    const LINE* line = static_cast<const LINE*>( aItem );
+    const SHAPE_LINE_CHAIN& l = line->CLine();
+
+    for( int i = 0; i < l.SegmentCount(); i++ )
     {
-        m_cacheTags[v.m_collidingItem].m_hits++;
-        return true;
+        const SEGMENT s( *line, l.CSegment( i ) );
+
+        if( checkColliding( s ) )
+            return true;
     }
 
+    if( line->EndsWithVia() )
+        return static_cast<bool>( m_world->CheckColliding( &line->Via() ) );
+
     return false;
-#endif
 }
 
 
@@ -553,6 +614,8 @@ bool OPTIMIZER::mergeFull( LINE* aLine )
 
 bool OPTIMIZER::Optimize( LINE* aLine, LINE* aResult )
 {
+    TIMING::SCOPE timing( TP_OPTIMIZER );
+
     if( !aResult )
         aResult = aLine;
     else
@@ -560,6 +623,11 @@ bool OPTIMIZER::Optimize( LINE* aLine, LINE* aResult )
 
     m_keepPostures = false;
 
+    // The collisions are kept for a single pass: the world can be modified between passes
+    m_collisionMemo.clear();
+    m_memoHits = 0;
+    m_memoMisses = 0;
+
     bool rv = false;
 
     if( m_effortLevel & MERGE_SEGMENTS )
@@ -574,6 +642,12 @@ bool OPTIMIZER::Optimize( LINE* aLine, LINE* aResult )
     if( m_effortLevel & FANOUT_CLEANUP )
         rv |= fanoutCleanup( aResult );
 
+    if( m_debugDecorator )
+    {
+        m_debugDecorator->AddToCounter( "optimizer.collision_memo.hits", m_memoHits );
+        m_debugDecorator->AddToCounter( "optimizer.collision_memo.misses", m_memoMisses );
+    }
+
     return rv;
 }
 
@@ -1012,7 +1086,7 @@ bool OPTIMIZER::fanoutCleanup( LINE* aLine )
             LINE repl;
             repl = LINE( *aLine, l2 );
 
-            if( !m_world->CheckColliding( &repl ) )
+            if( !checkColliding( &repl ) )
             {
                 aLine->SetShape( repl.CLine() );
                 return true;
@@ -1232,6 +1306,8 @@ bool OPTIMIZER::mergeDpSegments( DIFF_PAIR* aPair )
 
 bool OPTIMIZER::Optimize( DIFF_PAIR* aPair )
 {
+    TIMING::SCOPE timing( TP_OPTIMIZER );
+
     return mergeDpSegments( aPair );
 }
 
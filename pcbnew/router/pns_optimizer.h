@@ -22,6 +22,7 @@
 #ifndef __PNS_OPTIMIZER_H
 #define __PNS_OPTIMIZER_H
 
+#include <cstdint>
 #include <unordered_map>
 #include <memory>
 
@@ -35,7 +36,9 @@ namespace PNS {
 class NODE;
 class ROUTER;
 class LINE;
+class SEGMENT;
 class DIFF_PAIR;
+class DEBUG_DECORATOR;
 
 /**
  * Class COST_ESTIMATOR
@@ -130,6 +133,13 @@ public:
         m_restrictAreaActive = true;
     }
 
+    ///> Sets the decorator which counts the hits of the collision memo (by default, the
+    ///> one of the current router)
+    void SetDebugDecorator( DEBUG_DECORATOR* aDecorator )
+    {
+        m_debugDecorator = aDecorator;
+    }
+
 private:
     static const int MaxCachedItems = 256;
 
@@ -143,6 +153,24 @@ private:
         bool m_isStatic;
     };
 
+    ///> A segment in the collision memo: its geometry, width, layers and net
+    struct MEMO_KEY
+    {
+        VECTOR2I m_a;
+        VECTOR2I m_b;
+        int m_width;
+        int m_layerStart;
+        int m_layerEnd;
+        int m_net;
+
+        bool operator==( const MEMO_KEY& aOther ) const;
+    };
+
+    struct MEMO_KEY_HASH
+    {
+        std::size_t operator()( const MEMO_KEY& aKey ) const;
+    };
+
     bool mergeObtuse( LINE* aLine );
     bool mergeFull( LINE* aLine );
     bool removeUglyCorners( LINE* aLine );
@@ -155,6 +183,9 @@ private:
     bool checkColliding( ITEM* aItem, bool aUpdateCache = true );
     bool checkColliding( LINE* aLine, const SHAPE_LINE_CHAIN& aOptPath );
 
+    ///> checks the collisions of aSeg with the world, through the collision memo
+    bool checkColliding( const SEGMENT& aSeg );
+
     void cacheAdd( ITEM* aItem, bool aIsStatic );
     void removeCachedSegments( LINE* aLine, int aStartVertex = 0, int aEndVertex = -1 );
 
@@ -179,6 +210,17 @@ private:
 
     BOX2I m_restrictArea;
     bool m_restrictAreaActive;
+
+    ///> The candidate simplifications of a line test the same segments again and again:
+    ///> their collisions are kept during an optimization pass, while the world is not
+    ///> modified (see NODE::Revision())
+    std::unordered_map<MEMO_KEY, bool, MEMO_KEY_HASH> m_collisionMemo;
+    NODE* m_memoWorld;
+    uint64_t m_memoRevision;
+    int m_memoHits;
+    int m_memoMisses;
+
+    DEBUG_DECORATOR* m_debugDecorator;
 };
 
 }
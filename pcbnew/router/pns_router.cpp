@@ -49,6 +49,7 @@
 #include "pns_meander_placer.h"
 #include "pns_meander_skew_placer.h"
 #include "pns_dp_meander_placer.h"
+#include "pns_session_log.h"
 
 #include <router/router_preview_item.h>
 
@@ -72,6 +73,7 @@ ROUTER::ROUTER()
     m_snapshotIter = 0;
     m_violation = false;
     m_iface = nullptr;
+    m_sessionLog = nullptr;
 }
 
 
@@ -81,10 +83,19 @@ ROUTER* ROUTER::GetInstance()
 }
 
 
+void ROUTER::SetInstance( ROUTER* aRouter )
+{
+    theRouter = aRouter;
+}
+
+
 ROUTER::~ROUTER()
 {
     ClearWorld();
-    theRouter = nullptr;
+
+    // the router of another tool can be the current one
+    if( theRouter == this )
+        theRouter = nullptr;
 }
 
 
@@ -126,6 +137,11 @@ const ITEM_SET ROUTER::QueryHoverItems( const VECTOR2I& aP )
 
 bool ROUTER::StartDragging( const VECTOR2I& aP, ITEM* aStartItem, int aDragMode )
 {
+    if( m_sessionLog )
+    {
+        m_sessionLog->Clear( m_mode, m_settings, m_sizes );
+        m_sessionLog->Log( SESSION_LOG::EVT_START_DRAG, aP, aStartItem, aDragMode );
+    }
 
     if( aDragMode & DM_FREE_ANGLE )
         m_forceMarkObstaclesMode = true;
@@ -175,6 +191,11 @@ bool ROUTER::isStartingPointRoutable( const VECTOR2I& aWhere, int aLayer )
 
 bool ROUTER::StartRouting( const VECTOR2I& aP, ITEM* aStartItem, int aLayer )
 {
+    if( m_sessionLog )
+    {
+        m_sessionLog->Clear( m_mode, m_settings, m_sizes );
+        m_sessionLog->Log( SESSION_LOG::EVT_START_ROUTE, aP, aStartItem, aLayer );
+    }
 
     if( ! isStartingPointRoutable( aP, aLayer ) )
     {
@@ -230,6 +251,9 @@ void ROUTER::DisplayItems( const ITEM_SET& aItems )
 
 void ROUTER::Move( const VECTOR2I& aP, ITEM* endItem )
 {
+    if( m_sessionLog )
+        m_sessionLog->Log( SESSION_LOG::EVT_MOVE, aP, endItem );
+
     m_currentEnd = aP;
 
     switch( m_state )
@@ -373,6 +397,9 @@ void ROUTER::CommitRouting( NODE* aNode )
 
 bool ROUTER::FixRoute( const VECTOR2I& aP, ITEM* aEndItem, bool aForceFinish )
 {
+    if( m_sessionLog )
+        m_sessionLog->Log( SESSION_LOG::EVT_FIX, aP, aEndItem, aForceFinish );
+
     bool rv = false;
 
     switch( m_state )
@@ -398,6 +425,9 @@ bool ROUTER::FixRoute( const VECTOR2I& aP, ITEM* aEndItem, bool aForceFinish )
 
 void ROUTER::StopRouting()
 {
+    if( m_sessionLog && RoutingInProgress() )
+        m_sessionLog->Log( SESSION_LOG::EVT_STOP );
+
     // Update the ratsnest with new changes
 
     if( m_placer )
@@ -426,6 +456,9 @@ void ROUTER::StopRouting()
 
 void ROUTER::FlipPosture()
 {
+    if( m_sessionLog )
+        m_sessionLog->Log( SESSION_LOG::EVT_FLIP_POSTURE );
+
     if( m_state == ROUTE_TRACK )
     {
         m_placer->FlipPosture();
@@ -435,6 +468,9 @@ void ROUTER::FlipPosture()
 
 void ROUTER::SwitchLayer( int aLayer )
 {
+    if( m_sessionLog )
+        m_sessionLog->Log( SESSION_LOG::EVT_SWITCH_LAYER, VECTOR2I(), nullptr, aLayer );
+
     switch( m_state )
     {
     case ROUTE_TRACK:
@@ -448,6 +484,9 @@ void ROUTER::SwitchLayer( int aLayer )
 
 void ROUTER::ToggleViaPlacement()
 {
+    if( m_sessionLog )
+        m_sessionLog->Log( SESSION_LOG::EVT_TOGGLE_VIA );
+
     if( m_state == ROUTE_TRACK )
     {
         bool toggle = !m_placer->IsPlacingVia();
@@ -61,6 +61,7 @@ class VIA;
 class RULE_RESOLVER;
 class SHOVE;
 class DRAGGER;
+class SESSION_LOG;
 
 enum ROUTER_MODE {
     PNS_MODE_ROUTE_SINGLE = 1,
@@ -128,6 +129,9 @@ public:
 
     static ROUTER* GetInstance();
 
+    ///> Makes aRouter the router returned by GetInstance(), e.g. when its tool is started
+    static void SetInstance( ROUTER* aRouter );
+
     void ClearWorld();
     void SyncWorld();
 
@@ -223,6 +227,12 @@ public:
         return m_iface;
     }
 
+    /**
+     * Sets the log which records the routing sessions, to replay them later.
+     * @param aLog is the log, owned by the caller, or nullptr to stop recording.
+     */
+    void SetSessionLog( SESSION_LOG* aLog ) { m_sessionLog = aLog; }
+
 private:
     void movePlacing( const VECTOR2I& aP, ITEM* aItem );
     void moveDragging( const VECTOR2I& aP, ITEM* aItem );
@@ -261,6 +271,7 @@ private:
     std::unique_ptr< SHOVE >          m_shove;
 
     ROUTER_IFACE* m_iface;
+    SESSION_LOG* m_sessionLog;
 
     int m_iterLimit;
     bool m_showInterSteps;
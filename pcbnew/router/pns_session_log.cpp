@@ -0,0 +1,274 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <fstream>
+#include <sstream>
+
+#include <layers_id_colors_and_visibility.h>
+
+#include "pns_session_log.h"
+#include "pns_node.h"
+#include "pns_joint.h"
+#include "pns_segment.h"
+#include "pns_solid.h"
+#include "pns_via.h"
+
+namespace PNS {
+
+// The first line of a session file, with the version of the format
+static const char* const SESSION_HEADER = "pns_session 1";
+
+
+SESSION_LOG::SESSION_LOG() :
+    m_routerMode( 0 )
+{
+}
+
+
+void SESSION_LOG::Clear( int aRouterMode, const ROUTING_SETTINGS& aSettings,
+                         const SIZES_SETTINGS& aSizes )
+{
+    m_routerMode = aRouterMode;
+    m_settings = aSettings;
+    m_sizes = aSizes;
+    m_events.clear();
+}
+
+
+void SESSION_LOG::Log( EVENT_TYPE aType, const VECTOR2I& aP, const ITEM* aItem, int aArg )
+{
+    EVENT evt;
+
+    evt.m_type = aType;
+    evt.m_p = aP;
+    evt.m_arg = aArg;
+    evt.m_item = Identify( aItem );
+
+    m_events.push_back( evt );
+}
+
+
+SESSION_LOG::ITEM_ID SESSION_LOG::Identify( const ITEM* aItem )
+{
+    ITEM_ID id;
+
+    if( !aItem )
+        return id;
+
+    switch( aItem->Kind() )
+    {
+    case ITEM::SEGMENT_T:
+        id.m_a = static_cast<const SEGMENT*>( aItem )->Seg().A;
+        id.m_b = static_cast<const SEGMENT*>( aItem )->Seg().B;
+        break;
+
+    case ITEM::VIA_T:
+        id.m_a = static_cast<const VIA*>( aItem )->Pos();
+        break;
+
+    case ITEM::SOLID_T:
+        id.m_a = static_cast<const SOLID*>( aItem )->Pos();
+        break;
+
+    default:
+        // only the items of the world are passed to the router
+        return id;
+    }
+
+    id.m_kind = aItem->Kind();
+    id.m_net = aItem->Net();
+    id.m_layerStart = aItem->Layers().Start();
+    id.m_layerEnd = aItem->Layers().End();
+
+    return id;
+}
+
+
+ITEM* SESSION_LOG::FindItem( NODE* aWorld, const ITEM_ID& aId )
+{
+    if( !aId.m_kind )
+        return nullptr;
+
+    JOINT* jt = aWorld->FindJoint( aId.m_a, aId.m_layerStart, aId.m_net );
+
+    if( !jt )
+        return nullptr;
+
+    for( ITEM* item : jt->LinkList() )
+    {
+        if( item->Kind() != aId.m_kind || item->Layers().Start() != aId.m_layerStart
+                || item->Layers().End() != aId.m_layerEnd )
+            continue;
+
+        if( item->Kind() == ITEM::SEGMENT_T )
+        {
+            const SEG& s = static_cast<SEGMENT*>( item )->Seg();
+
+            if( ( s.A == aId.m_a && s.B == aId.m_b ) || ( s.A == aId.m_b && s.B == aId.m_a ) )
+                return item;
+        }
+        else
+        {
+            return item;
+        }
+    }
+
+    return nullptr;
+}
+
+
+bool SESSION_LOG::Save( const std::string& aFilename ) const
+{
+    std::ofstream out( aFilename );
+
+    if( !out )
+        return false;
+
+    // Some getters of the settings are not const
+    ROUTING_SETTINGS settings = m_settings;
+    SIZES_SETTINGS sizes = m_sizes;
+
+    out << SESSION_HEADER << std::endl;
+    out << "router_mode " << m_routerMode << std::endl;
+
+    out << "settings " << settings.Mode() << " " << settings.OptimizerEffort() << " "
+        << settings.ShoveVias() << " " << settings.RemoveLoops() << " "
+        << settings.SuggestFinish() << " " << settings.SmartPads() << " "
+        << settings.SmoothDraggedSegments() << " " << settings.JumpOverObstacles() << " "
+        << settings.CanViolateDRC() << " " << settings.GetFreeAngleMode() << " "
+        << settings.InlineDragEnabled() << std::endl;
+
+    out << "sizes " << sizes.TrackWidth() << " " << sizes.ViaDiameter() << " "
+        << sizes.ViaDrill() << " " << sizes.ViaType() << " " << sizes.DiffPairWidth() << " "
+        << sizes.DiffPairGap() << " " << sizes.DiffPairViaGap() << " "
+        << sizes.DiffPairViaGapSameAsTraceGap() << std::endl;
+
+    for( int layer = 0; layer < MAX_CU_LAYERS; layer++ )
+    {
+        OPT<int> paired = sizes.PairedLayer( layer );
+
+        if( paired && layer < *paired )
+            out << "layer_pair " << layer << " " << *paired << std::endl;
+    }
+
+    for( const EVENT& evt : m_events )
+    {
+        const ITEM_ID& id = evt.m_item;
+
+        out << "event " << evt.m_type << " " << evt.m_p.x << " " << evt.m_p.y << " "
+            << evt.m_arg << " " << id.m_kind << " " << id.m_net << " " << id.m_layerStart
+            << " " << id.m_layerEnd << " " << id.m_a.x << " " << id.m_a.y << " "
+            << id.m_b.x << " " << id.m_b.y << std::endl;
+    }
+
+    return out.good();
+}
+
+
+bool SESSION_LOG::Load( const std::string& aFilename )
+{
+    std::ifstream in( aFilename );
+    std::string line;
+
+    if( !std::getline( in, line ) || line != SESSION_HEADER )
+        return false;
+
+    m_routerMode = 0;
+    m_settings = ROUTING_SETTINGS();
+    m_sizes = SIZES_SETTINGS();
+    m_events.clear();
+
+    while( std::getline( in, line ) )
+    {
+        std::istringstream tokens( line );
+        std::string keyword;
+
+        tokens >> keyword;
+
+        if( keyword == "router_mode" )
+        {
+            tokens >> m_routerMode;
+        }
+        else if( keyword == "settings" )
+        {
+            int mode, effort;
+            bool shoveVias, removeLoops, suggestFinish, smartPads, smoothDragged, jumpOver;
+            bool canViolateDRC, freeAngle, inlineDrag;
+
+            tokens >> mode >> effort >> shoveVias >> removeLoops >> suggestFinish >> smartPads
+                   >> smoothDragged >> jumpOver >> canViolateDRC >> freeAngle >> inlineDrag;
+
+            m_settings.SetMode( (PNS_MODE) mode );
+            m_settings.SetOptimizerEffort( (PNS_OPTIMIZATION_EFFORT) effort );
+            m_settings.SetShoveVias( shoveVias );
+            m_settings.SetRemoveLoops( removeLoops );
+            m_settings.SetSuggestFinish( suggestFinish );
+            m_settings.SetSmartPads( smartPads );
+            m_settings.SetSmoothDraggedSegments( smoothDragged );
+            m_settings.SetJumpOverObstacles( jumpOver );
+            m_settings.SetCanViolateDRC( canViolateDRC );
+            m_settings.SetFreeAngleMode( freeAngle );
+            m_settings.SetInlineDragEnabled( inlineDrag );
+        }
+        else if( keyword == "sizes" )
+        {
+            int trackWidth, viaDiameter, viaDrill, viaType, dpWidth, dpGap, dpViaGap;
+            bool dpViaGapSameAsTraceGap;
+
+            tokens >> trackWidth >> viaDiameter >> viaDrill >> viaType >> dpWidth >> dpGap
+                   >> dpViaGap >> dpViaGapSameAsTraceGap;
+
+            m_sizes.SetTrackWidth( trackWidth );
+            m_sizes.SetViaDiameter( viaDiameter );
+            m_sizes.SetViaDrill( viaDrill );
+            m_sizes.SetViaType( (VIATYPE_T) viaType );
+            m_sizes.SetDiffPairWidth( dpWidth );
+            m_sizes.SetDiffPairGap( dpGap );
+            m_sizes.SetDiffPairViaGap( dpViaGap );
+            m_sizes.SetDiffPairViaGapSameAsTraceGap( dpViaGapSameAsTraceGap );
+        }
+        else if( keyword == "layer_pair" )
+        {
+            int l1, l2;
+
+            tokens >> l1 >> l2;
+            m_sizes.AddLayerPair( l1, l2 );
+        }
+        else if( keyword == "event" )
+        {
+            EVENT evt;
+            int type;
+            ITEM_ID& id = evt.m_item;
+
+            tokens >> type >> evt.m_p.x >> evt.m_p.y >> evt.m_arg >> id.m_kind >> id.m_net
+                   >> id.m_layerStart >> id.m_layerEnd >> id.m_a.x >> id.m_a.y
+                   >> id.m_b.x >> id.m_b.y;
+
+            evt.m_type = (EVENT_TYPE) type;
+            m_events.push_back( evt );
+        }
+
+        if( tokens.fail() )
+            return false;
+    }
+
+    return true;
+}
+
+}
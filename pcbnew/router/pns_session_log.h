@@ -0,0 +1,119 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PNS_SESSION_LOG_H
+#define __PNS_SESSION_LOG_H
+
+#include <string>
+#include <vector>
+
+#include <math/vector2d.h>
+
+#include "pns_routing_settings.h"
+#include "pns_sizes_settings.h"
+
+namespace PNS {
+
+class ITEM;
+class NODE;
+
+/**
+ * Class SESSION_LOG
+ *
+ * Records the calls made to the ROUTER during a routing session (from the start of a route
+ * or a drag to its end), with the settings of the router, so the session can be replayed
+ * on the same board by the pns_replay qa tool.
+ *
+ * The items passed to the router are recorded by their kind, net, layers and anchors, and
+ * are found again in the world of the replaying router by FindItem().
+ */
+class SESSION_LOG
+{
+public:
+    enum EVENT_TYPE
+    {
+        EVT_START_ROUTE = 0,    ///> ROUTER::StartRouting(), m_arg is the layer
+        EVT_START_DRAG,         ///> ROUTER::StartDragging(), m_arg is the drag mode
+        EVT_MOVE,               ///> ROUTER::Move()
+        EVT_FIX,                ///> ROUTER::FixRoute(), m_arg is the force finish flag
+        EVT_STOP,               ///> ROUTER::StopRouting()
+        EVT_SWITCH_LAYER,       ///> ROUTER::SwitchLayer(), m_arg is the layer
+        EVT_TOGGLE_VIA,         ///> ROUTER::ToggleViaPlacement()
+        EVT_FLIP_POSTURE        ///> ROUTER::FlipPosture()
+    };
+
+    ///> Identifies an item of the world, independently of its address
+    struct ITEM_ID
+    {
+        ITEM_ID() :
+            m_kind( 0 ), m_net( -1 ), m_layerStart( -1 ), m_layerEnd( -1 )
+        {}
+
+        int      m_kind;        ///< ITEM::PnsKind, 0 for no item
+        int      m_net;
+        int      m_layerStart;
+        int      m_layerEnd;
+        VECTOR2I m_a;           ///< start of a segment, position of another item
+        VECTOR2I m_b;           ///< end of a segment
+    };
+
+    struct EVENT
+    {
+        EVENT_TYPE m_type;
+        VECTOR2I   m_p;
+        int        m_arg;
+        ITEM_ID    m_item;
+    };
+
+    SESSION_LOG();
+
+    /**
+     * Function Clear()
+     * Removes all the events, and sets the settings of the new session.
+     */
+    void Clear( int aRouterMode, const ROUTING_SETTINGS& aSettings,
+                const SIZES_SETTINGS& aSizes );
+
+    void Log( EVENT_TYPE aType, const VECTOR2I& aP = VECTOR2I(), const ITEM* aItem = nullptr,
+              int aArg = 0 );
+
+    bool Save( const std::string& aFilename ) const;
+    bool Load( const std::string& aFilename );
+
+    int RouterMode() const { return m_routerMode; }
+    const ROUTING_SETTINGS& Settings() const { return m_settings; }
+    const SIZES_SETTINGS& Sizes() const { return m_sizes; }
+    const std::vector<EVENT>& Events() const { return m_events; }
+
+    ///> Returns the identifier of aItem, or an empty identifier for no item
+    static ITEM_ID Identify( const ITEM* aItem );
+
+    ///> Returns the item of aWorld identified by aId, or nullptr if there is none
+    static ITEM* FindItem( NODE* aWorld, const ITEM_ID& aId );
+
+private:
+    int m_routerMode;
+    ROUTING_SETTINGS m_settings;
+    SIZES_SETTINGS m_sizes;
+    std::vector<EVENT> m_events;
+};
+
+}
+
+#endif
@@ -32,6 +32,7 @@
 #include "pns_utils.h"
 #include "pns_router.h"
 #include "pns_topology.h"
+#include "pns_timing.h"
 
 #include "time_limit.h"
 
@@ -1086,6 +1087,8 @@ OPT_BOX2I SHOVE::totalAffectedArea() const
 
 SHOVE::SHOVE_STATUS SHOVE::ShoveLines( const LINE& aCurrentHead )
 {
+    TIMING::SCOPE timing( TP_SHOVE );
+
     SHOVE_STATUS st = SH_OK;
 
     m_multiLineMode = false;
@@ -1187,6 +1190,8 @@ SHOVE::SHOVE_STATUS SHOVE::ShoveLines( const LINE& aCurrentHead )
 
 SHOVE::SHOVE_STATUS SHOVE::ShoveMultiLines( const ITEM_SET& aHeadSet )
 {
+    TIMING::SCOPE timing( TP_SHOVE );
+
     SHOVE_STATUS st = SH_OK;
 
     m_multiLineMode = true;
@@ -1270,6 +1275,8 @@ SHOVE::SHOVE_STATUS SHOVE::ShoveMultiLines( const ITEM_SET& aHeadSet )
 
 SHOVE::SHOVE_STATUS SHOVE::ShoveDraggingVia( VIA* aVia, const VECTOR2I& aWhere, VIA** aNewVia )
 {
+    TIMING::SCOPE timing( TP_SHOVE );
+
     SHOVE_STATUS st = SH_OK;
 
     m_lineStack.clear();
@@ -0,0 +1,59 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pns_timing.h"
+
+namespace PNS {
+
+std::atomic<bool> TIMING::m_enabled( false );
+std::atomic<int64_t> TIMING::m_totalNs[TP_COUNT];
+
+
+void TIMING::Reset()
+{
+    for( int i = 0; i < TP_COUNT; i++ )
+        m_totalNs[i] = 0;
+}
+
+
+int64_t TIMING::TotalNs( TIMING_PHASE aPhase )
+{
+    return m_totalNs[aPhase];
+}
+
+
+const char* TIMING::PhaseName( TIMING_PHASE aPhase )
+{
+    switch( aPhase )
+    {
+    case TP_SHOVE:       return "shove";
+    case TP_WALKAROUND:  return "walkaround";
+    case TP_OPTIMIZER:   return "optimizer";
+    case TP_COLLISION:   return "collision";
+    default:             return "?";
+    }
+}
+
+
+void TIMING::add( TIMING_PHASE aPhase, std::chrono::steady_clock::duration aTime )
+{
+    m_totalNs[aPhase] += std::chrono::duration_cast<std::chrono::nanoseconds>( aTime ).count();
+}
+
+}
@@ -0,0 +1,99 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PNS_TIMING_H
+#define __PNS_TIMING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace PNS {
+
+///> Phases of the router whose time is measured
+enum TIMING_PHASE
+{
+    TP_SHOVE = 0,       ///> SHOVE::ShoveLines(), ShoveMultiLines() and ShoveDraggingVia()
+    TP_WALKAROUND,      ///> WALKAROUND::Route()
+    TP_OPTIMIZER,       ///> OPTIMIZER::Optimize()
+    TP_COLLISION,       ///> NODE::QueryColliding(), used by all the collision checks
+    TP_COUNT
+};
+
+/**
+ * Class TIMING
+ *
+ * Accumulates the time spent by the router in each phase, to measure its performance
+ * (see the pns_replay qa tool).  The times are inclusive: the collision queries of a shove
+ * are also counted in the shove, and the times of the threads of a phase are summed.
+ * Timing is disabled by default, and then costs a single test per measured call.
+ */
+class TIMING
+{
+public:
+    /**
+     * Class SCOPE
+     *
+     * Adds the time of its lifetime to a phase, when timing is enabled.
+     */
+    class SCOPE
+    {
+    public:
+        SCOPE( TIMING_PHASE aPhase ) :
+            m_phase( aPhase ),
+            m_enabled( IsEnabled() )
+        {
+            if( m_enabled )
+                m_start = std::chrono::steady_clock::now();
+        }
+
+        ~SCOPE()
+        {
+            if( m_enabled )
+                add( m_phase, std::chrono::steady_clock::now() - m_start );
+        }
+
+    private:
+        TIMING_PHASE m_phase;
+        bool m_enabled;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    static void Enable( bool aEnable ) { m_enabled = aEnable; }
+    static bool IsEnabled() { return m_enabled; }
+
+    ///> Clears the times of all the phases
+    static void Reset();
+
+    ///> Returns the time spent in aPhase since the last Reset(), in nanoseconds
+    static int64_t TotalNs( TIMING_PHASE aPhase );
+
+    ///> Returns the name of aPhase, for the reports
+    static const char* PhaseName( TIMING_PHASE aPhase );
+
+private:
+    static void add( TIMING_PHASE aPhase, std::chrono::steady_clock::duration aTime );
+
+    static std::atomic<bool> m_enabled;
+    static std::atomic<int64_t> m_totalNs[TP_COUNT];
+};
+
+}
+
+#endif
@@ -20,6 +20,8 @@
  */
 
 #include <wx/numdlg.h>
+#include <wx/filename.h>
+#include <wx/datetime.h>
 
 #include <functional>
 using namespace std::placeholders;
@@ -38,6 +40,8 @@ using namespace std::placeholders;
 #include <dialogs/dialog_pns_length_tuning_settings.h>
 #include <dialogs/dialog_track_via_size.h>
 #include <base_units.h>
+#include <advanced_config.h>
+#include <io_mgr.h>
 #include <bitmaps.h>
 #include <hotkeys.h>
 
@@ -54,6 +58,7 @@ using namespace std::placeholders;
 #include "pns_meander_placer.h" // fixme: move settings to separate header
 #include "pns_tune_status_popup.h"
 #include "pns_topology.h"
+#include "pns_session_log.h"
 
 #include <view/view.h>
 
@@ -89,6 +94,18 @@ TOOL_BASE::~TOOL_BASE()
 
 void TOOL_BASE::Reset( RESET_REASON aReason )
 {
+    // The world of the router follows the commits of the board: keep it when the tool
+    // is started again on the same board, as building it again takes long on large boards
+    if( aReason == RUN && m_router && m_iface->IsWorldUpToDate( board() ) )
+    {
+        // The router of the other tool can have been made since: the optimizer and the
+        // debug decorator use the current instance
+        ROUTER::SetInstance( m_router );
+        m_router->LoadSettings( m_savedSettings );
+        m_router->UpdateSizes( m_savedSizes );
+        return;
+    }
+
     delete m_gridHelper;
     delete m_iface;
     delete m_router;
@@ -264,8 +281,23 @@ bool TOOL_BASE::checkSnap( ITEM *aItem )
     return doSnap;
 }
 
+void TOOL_BASE::syncWorld()
+{
+    if( m_router->RoutingInProgress() || m_iface->IsWorldUpToDate( board() ) )
+        return;
+
+    // The items picked in the previous world are deleted with it
+    m_startItem = nullptr;
+    m_endItem = nullptr;
+
+    m_router->SyncWorld();
+}
+
+
 void TOOL_BASE::updateStartItem( const TOOL_EVENT& aEvent, bool aIgnorePads )
 {
+    syncWorld();
+
     int tl = getView()->GetTopLayer();
     VECTOR2I cp = controls()->GetCursorPosition( !aEvent.Modifier( MD_SHIFT ) );
     VECTOR2I p;
@@ -428,4 +460,52 @@ const VECTOR2I TOOL_BASE::snapToItem( bool aEnabled, ITEM* aItem, VECTOR2I aP)
     return anchor;
 }
 
+
+
+void TOOL_BASE::startSessionLog()
+{
+    const wxString& dir = ADVANCED_CFG::GetCfg().m_pnsSessionDir;
+
+    if( dir.IsEmpty() )
+        return;
+
+    // The sessions started in the same second are numbered
+    static int sessionCount = 0;
+
+    wxString name = wxString::Format( "pns_session_%s_%d",
+                                      wxDateTime::Now().Format( "%Y%m%d_%H%M%S" ),
+                                      ++sessionCount );
+    wxFileName fn( dir, name, "kicad_pcb" );
+
+    try
+    {
+        IO_MGR::Save( IO_MGR::KICAD_SEXP, fn.GetFullPath(), board() );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        wxLogTrace( "PNS", "Cannot save the board of the session: %s", ioe.What() );
+        return;
+    }
+
+    fn.ClearExt();
+    m_sessionLogName = fn.GetFullPath();
+    m_sessionLog.reset( new SESSION_LOG );
+    m_router->SetSessionLog( m_sessionLog.get() );
+}
+
+
+void TOOL_BASE::saveSessionLog()
+{
+    if( !m_sessionLog )
+        return;
+
+    wxString filename = m_sessionLogName + ".pns_session";
+
+    if( !m_sessionLog->Save( (const char*) filename.utf8_str() ) )
+        wxLogTrace( "PNS", "Cannot save the session %s", filename );
+
+    m_router->SetSessionLog( nullptr );
+    m_sessionLog.reset();
+}
+
 }
@@ -41,6 +41,8 @@ class PNS_TUNE_STATUS_POPUP;
 
 namespace PNS {
 
+class SESSION_LOG;
+
 class APIEXPORT TOOL_BASE : public PCB_TOOL
 {
 public:
@@ -61,6 +63,23 @@ protected:
     virtual void updateEndItem( const TOOL_EVENT& aEvent );
     void deleteTraces( ITEM* aStartItem, bool aWholeTrack );
 
+    /**
+     * Builds the world of the router again when it no longer follows the board, e.g.
+     * after a change made without a commit (see PNS_KICAD_IFACE::OnBoardInvalidated()).
+     * Nothing is done while a route is in progress.
+     */
+    void syncWorld();
+
+    /**
+     * Starts to record the next routing session of the router, if a directory is set for
+     * the sessions in the advanced config (see ADVANCED_CFG::m_pnsSessionDir).  The board is
+     * saved there at once, and the session by saveSessionLog().
+     */
+    void startSessionLog();
+
+    ///> Saves the session recorded since startSessionLog(), and stops the recording
+    void saveSessionLog();
+
     MSG_PANEL_ITEMS m_panelItems;
 
     ROUTING_SETTINGS m_savedSettings;     ///< Stores routing settings between router invocations
@@ -76,6 +95,9 @@ protected:
     GRID_HELPER* m_gridHelper;
     PNS_KICAD_IFACE* m_iface;
     ROUTER* m_router;
+
+    std::unique_ptr<SESSION_LOG> m_sessionLog;
+    wxString m_sessionLogName;          ///< the file name of the session, without extension
 };
 
 }
@@ -19,6 +19,12 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
 #include <core/optional.h>
 
 #include <geometry/shape_line_chain.h>
@@ -27,9 +33,121 @@
 #include "pns_optimizer.h"
 #include "pns_utils.h"
 #include "pns_router.h"
+#include "pns_timing.h"
 
 namespace PNS {
 
+#ifdef DEBUG
+// the two directions are walked by different threads
+static std::mutex logMutex;
+#endif
+
+// Below this iteration limit, a walk is too short to be worth a second thread
+static const int MIN_PARALLEL_ITERATION_LIMIT = 8;
+
+
+/**
+ * Class WALK_WORKER
+ *
+ * A thread kept between the calls of WALKAROUND::Route(), which walks one of the
+ * directions while the calling thread walks the other one.  Route() is called at each
+ * mouse move: starting a thread for each call would cost more than the walk itself.
+ * The thread ends after a second without work, and is started again by the next job.
+ */
+class WALK_WORKER
+{
+public:
+    WALK_WORKER() :
+        m_running( false ),
+        m_quit( false )
+    {
+    }
+
+    ~WALK_WORKER()
+    {
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+            m_quit = true;
+        }
+
+        m_wakeUp.notify_one();
+
+        if( m_thread.joinable() )
+            m_thread.join();
+    }
+
+    /**
+     * Runs aJob on the worker thread.
+     * @return false if the worker is busy with the job of another walkaround: aJob is
+     * not run then
+     */
+    bool Start( std::function<void()> aJob )
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+
+        if( m_job )
+            return false;
+
+        if( !m_running )
+        {
+            // the previous thread ended when it was idle
+            if( m_thread.joinable() )
+                m_thread.join();
+
+            m_thread = std::thread( &WALK_WORKER::run, this );
+            m_running = true;
+        }
+
+        m_job = std::move( aJob );
+        m_wakeUp.notify_one();
+        return true;
+    }
+
+    /**
+     * Waits for the end of the job run by Start()
+     */
+    void Wait()
+    {
+        std::unique_lock<std::mutex> lock( m_mutex );
+        m_done.wait( lock, [this]() { return !m_job; } );
+    }
+
+private:
+    void run()
+    {
+        std::unique_lock<std::mutex> lock( m_mutex );
+
+        while( true )
+        {
+            if( !m_wakeUp.wait_for( lock, std::chrono::seconds( 1 ),
+                                    [this]() { return m_quit || m_job; } ) || m_quit )
+            {
+                m_running = false;
+                return;
+            }
+
+            // The job is not modified until it is done: it can run without the lock
+            lock.unlock();
+            m_job();
+            lock.lock();
+
+            m_job = nullptr;
+            m_done.notify_all();
+        }
+    }
+
+    std::thread             m_thread;
+    std::mutex              m_mutex;
+    std::condition_variable m_wakeUp;
+    std::condition_variable m_done;
+    std::function<void()>   m_job;
+    bool                    m_running;
+    bool                    m_quit;
+};
+
+
+static WALK_WORKER walkWorker;
+
 void WALKAROUND::start( const LINE& aInitialPath )
 {
     m_iteration = 0;
@@ -58,6 +176,8 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
         aWindingDirection ? m_currentObstacle[0] : m_currentObstacle[1];
 
     bool& prev_recursive = aWindingDirection ? m_recursiveCollision[0] : m_recursiveCollision[1];
+    int& blockage_count =
+        aWindingDirection ? m_recursiveBlockageCount[0] : m_recursiveBlockageCount[1];
 
     if( !current_obs )
         return DONE;
@@ -68,9 +188,9 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
 
     if( ( current_obs->m_hull ).PointInside( last ) || ( current_obs->m_hull ).PointOnEdge( last ) )
     {
-        m_recursiveBlockageCount++;
+        blockage_count++;
 
-        if( m_recursiveBlockageCount < 3 )
+        if( blockage_count < 3 )
             aPath.Line().Append( current_obs->m_hull.NearestPoint( last ) );
         else
         {
@@ -88,12 +208,16 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
         return STUCK;
 
 #ifdef DEBUG
-    m_logger.NewGroup( aWindingDirection ? "walk-cw" : "walk-ccw", m_iteration );
-    m_logger.Log( &path_walk[0], 0, "path-walk" );
-    m_logger.Log( &path_pre[0], 1, "path-pre" );
-    m_logger.Log( &path_post[0], 4, "path-post" );
-    m_logger.Log( &current_obs->m_hull, 2, "hull" );
-    m_logger.Log( current_obs->m_item, 3, "item" );
+    {
+        std::lock_guard<std::mutex> lock( logMutex );
+
+        m_logger.NewGroup( aWindingDirection ? "walk-cw" : "walk-ccw", m_iteration );
+        m_logger.Log( &path_walk[0], 0, "path-walk" );
+        m_logger.Log( &path_pre[0], 1, "path-pre" );
+        m_logger.Log( &path_post[0], 4, "path-post" );
+        m_logger.Log( &current_obs->m_hull, 2, "hull" );
+        m_logger.Log( current_obs->m_item, 3, "item" );
+    }
 #endif
 
     int len_pre = path_walk[0].Length();
@@ -144,10 +268,40 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
 }
 
 
+void WALKAROUND::walk( int aDir, LINE& aPath, WALKAROUND_STATUS& aStatus, int& aLastStep,
+                       std::atomic<int>* aDoneStep )
+{
+    for( int i = 0; i < m_iterationLimit && aStatus != STUCK; i++ )
+    {
+        // the other direction was done first: Route() picks it without looking at this one
+        if( aDoneStep[1 - aDir] < i )
+            break;
+
+        WALKAROUND_STATUS st = singleStep( aPath, aDir == 0 );
+
+        if( st != aStatus )
+        {
+            aStatus = st;
+            aLastStep = i;
+        }
+
+        if( st == DONE )
+        {
+            aDoneStep[aDir] = i;
+            break;
+        }
+    }
+}
+
+
 WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
         LINE& aWalkPath, bool aOptimize )
 {
-    LINE path_cw( aInitialPath ), path_ccw( aInitialPath );
+    TIMING::SCOPE timing( TP_WALKAROUND );
+
+    LINE path[2] = { aInitialPath, aInitialPath };
+    LINE& path_cw = path[0];
+    LINE& path_ccw = path[1];
     WALKAROUND_STATUS s_cw = IN_PROGRESS, s_ccw = IN_PROGRESS;
     SHAPE_LINE_CHAIN best_path;
 
@@ -164,7 +318,7 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
     start( aInitialPath );
 
     m_currentObstacle[0] = m_currentObstacle[1] = nearestObstacle( aInitialPath );
-    m_recursiveBlockageCount = 0;
+    m_recursiveBlockageCount[0] = m_recursiveBlockageCount[1] = 0;
 
     aWalkPath = aInitialPath;
 
@@ -177,13 +331,66 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
         m_forceSingleDirection = false;
     }
 
+    // The two directions only query the world: walk them at the same time, then
+    // choose between them as if they had been walked step by step together.
+    WALKAROUND_STATUS status[2] = { s_cw, s_ccw };
+    int lastStep[2] = { -1, -1 };
+    std::atomic<int> doneStep[2];
+
+    doneStep[0] = doneStep[1] = m_iterationLimit;
+
+    // Without obstacle, both walks are done at the first step: no thread is needed
+    bool parallel = m_currentObstacle[0] && status[0] != STUCK && status[1] != STUCK
+                    && m_iterationLimit >= MIN_PARALLEL_ITERATION_LIMIT
+                    && std::thread::hardware_concurrency() > 1;
+
+    if( m_forceLongerPath )
+    {
+        // A direction done by clipping its path to an obstacle is stepped again while the
+        // other one is not done, and can be in progress again: the directions depend on
+        // each other, so they are walked together.
+        for( int i = 0; i < m_iterationLimit; i++ )
+        {
+            for( int dir = 0; dir < 2; dir++ )
+            {
+                if( status[dir] == STUCK )
+                    continue;
+
+                WALKAROUND_STATUS st = singleStep( path[dir], dir == 0 );
+
+                if( st != status[dir] )
+                {
+                    status[dir] = st;
+                    lastStep[dir] = i;
+                }
+            }
+
+            if( status[0] == status[1] && status[0] != IN_PROGRESS )
+                break;
+        }
+    }
+    else if( parallel && walkWorker.Start(
+            [&]() { walk( 1, path[1], status[1], lastStep[1], doneStep ); } ) )
+    {
+        walk( 0, path[0], status[0], lastStep[0], doneStep );
+        walkWorker.Wait();
+    }
+    else
+    {
+        for( int dir = 0; dir < 2; dir++ )
+        {
+            if( status[dir] != STUCK )
+                walk( dir, path[dir], status[dir], lastStep[dir], doneStep );
+        }
+    }
+
     while( m_iteration < m_iterationLimit )
     {
-        if( s_cw != STUCK )
-            s_cw = singleStep( path_cw, true );
+        if( m_iteration >= lastStep[0] )
+            s_cw = status[0];
 
-        if( s_ccw != STUCK )
-            s_ccw = singleStep( path_ccw, false );
+        if( m_iteration >= lastStep[1] )
+            s_ccw = status[1];
 
         if( ( s_cw == DONE && s_ccw == DONE ) || ( s_cw == STUCK && s_ccw == STUCK ) )
         {
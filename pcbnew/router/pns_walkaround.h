@@ -23,6 +23,7 @@
 #define __PNS_WALKAROUND_H
 
 #include <set>
+#include <atomic>
 
 #include "pns_line.h"
 #include "pns_node.h"
@@ -49,7 +50,7 @@ public:
         m_itemMask = ITEM::ANY_T;
 
         // Initialize other members, to avoid uninitialized variables.
-        m_recursiveBlockageCount = 0;
+        m_recursiveBlockageCount[0] = m_recursiveBlockageCount[1] = 0;
         m_recursiveCollision[0] = m_recursiveCollision[1] = false;
         m_iteration = 0;
         m_forceCw = false;
@@ -130,11 +131,26 @@ private:
     void start( const LINE& aInitialPath );
 
     WALKAROUND_STATUS singleStep( LINE& aPath, bool aWindingDirection );
+
+    /**
+     * Function walk()
+     *
+     * Walks around the obstacles in one direction, until the path is done or stuck.
+     * @param aDir 0 for the clockwise direction, 1 for the counter-clockwise one
+     * @param aPath the path to walk, the result on return
+     * @param aStatus the final status of the walk (IN_PROGRESS if it was not finished)
+     * @param aLastStep the iteration at which aStatus was reached
+     * @param aDoneStep for each direction, the iteration at which it was done. Updated
+     * for aDir: the walk stops when the other direction was done at an earlier iteration,
+     * as Route() will not use its result.  Not used when the longer path is wanted.
+     */
+    void walk( int aDir, LINE& aPath, WALKAROUND_STATUS& aStatus, int& aLastStep,
+               std::atomic<int>* aDoneStep );
     NODE::OPT_OBSTACLE nearestObstacle( const LINE& aPath );
 
     NODE* m_world;
 
-    int m_recursiveBlockageCount;
+    int m_recursiveBlockageCount[2];
     int m_iteration;
     int m_iterationLimit;
     int m_itemMask;
@@ -60,6 +60,7 @@ using namespace std::placeholders;
 #include "router_tool.h"
 #include "pns_segment.h"
 #include "pns_router.h"
+#include "pns_kicad_iface.h"
 
 using namespace KIGFX;
 
@@ -761,8 +762,11 @@ bool ROUTER_TOOL::prepareInteractive()
                         frame()->GetScreen()->m_Route_Layer_BOTTOM );
     m_router->UpdateSizes( sizes );
 
+    startSessionLog();
+
     if( !m_router->StartRouting( m_startSnapPoint, m_startItem, routingLayer ) )
     {
+        saveSessionLog();
         DisplayError( frame(), m_router->FailureReason() );
         highlightNet( false );
         controls()->SetAutoPan( false );
@@ -781,6 +785,7 @@ bool ROUTER_TOOL::prepareInteractive()
 bool ROUTER_TOOL::finishInteractive()
 {
     m_router->StopRouting();
+    saveSessionLog();
 
     controls()->SetAutoPan( false );
     controls()->ForceCursorPosition( false );
@@ -1026,10 +1031,14 @@ void ROUTER_TOOL::performDragging( int aMode )
     }
 
     m_gridHelper->SetAuxAxes( true, m_startSnapPoint, true );
+    startSessionLog();
     bool dragStarted = m_router->StartDragging( m_startSnapPoint, m_startItem, aMode );
 
     if( !dragStarted )
+    {
+        saveSessionLog();
         return;
+    }
 
     if( m_startItem && m_startItem->Net() >= 0 )
         highlightNet( true, m_startItem->Net() );
@@ -1063,6 +1072,7 @@ void ROUTER_TOOL::performDragging( int aMode )
     if( m_router->RoutingInProgress() )
         m_router->StopRouting();
 
+    saveSessionLog();
     m_startItem = nullptr;
 
     m_gridHelper->SetAuxAxes( false );
@@ -1162,7 +1172,9 @@ int ROUTER_TOOL::InlineDrag( const TOOL_EVENT& aEvent )
     Activate();
 
     m_toolMgr->RunAction( PCB_ACTIONS::selectionClear, true );
-    m_router->SyncWorld();
+
+    syncWorld();
+
     m_startItem = m_router->GetWorld()->FindItemByParent( item );
 
     if( m_startItem && m_startItem->IsLocked() )
@@ -1181,10 +1193,14 @@ int ROUTER_TOOL::InlineDrag( const TOOL_EVENT& aEvent )
     m_gridHelper->SetAuxAxes( true, p, true );
     int dragMode = aEvent.Parameter<int64_t> ();
 
+    startSessionLog();
     bool dragStarted = m_router->StartDragging( p, m_startItem, dragMode );
 
     if( !dragStarted )
+    {
+        saveSessionLog();
         return 0;
+    }
 
     m_gridHelper->SetAuxAxes( true, p, true );
     controls()->ShowCursor( true );
@@ -1214,6 +1230,7 @@ int ROUTER_TOOL::InlineDrag( const TOOL_EVENT& aEvent )
     if( m_router->RoutingInProgress() )
         m_router->StopRouting();
 
+    saveSessionLog();
     m_gridHelper->SetAuxAxes( false );
     controls()->SetAutoPan( false );
     controls()->ForceCursorPosition( false );
@@ -1238,7 +1255,9 @@ int ROUTER_TOOL::InlineBreakTrack( const TOOL_EVENT& aEvent )
     Activate();
 
     m_toolMgr->RunAction( PCB_ACTIONS::selectionClear, true );
-    m_router->SyncWorld();
+
+    syncWorld();
+
     m_startItem = m_router->GetWorld()->FindItemByParent( item );
     m_startSnapPoint = snapToItem( true, m_startItem, controls()->GetCursorPosition() );
 
@@ -96,6 +96,9 @@ void PCB_EDIT_FRAME::ImportSpecctraSession( wxCommandEvent& event )
     // todo: use undo/redo feature
     GetScreen()->ClearUndoRedoList();
 
+    // The tracks are replaced without a BOARD_COMMIT
+    GetBoard()->InvalidateIncrementalData();
+
     SPECCTRA_DB     db;
     LOCALE_IO       toggle;
 
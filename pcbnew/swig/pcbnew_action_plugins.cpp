@@ -269,6 +269,9 @@ void PCB_EDIT_FRAME::RunActionPlugin( ACTION_PLUGIN* aActionPlugin )
 
     currentPcb->m_Status_Pcb = 0;
 
+    // The plugin has changed (and possibly deleted) items without a BOARD_COMMIT
+    currentPcb->InvalidateIncrementalData();
+
     // Get back the undo buffer to fix some modifications
     PICKED_ITEMS_LIST* oldBuffer = NULL;
 
@@ -973,6 +973,9 @@ int PCBNEW_CONTROL::AppendBoard( PLUGIN& pi, wxString& fileName )
     brd->SynchronizeNetsAndNetClasses();
     brd->BuildConnectivity();
 
+    // The net classes (and so the clearances) may have changed
+    brd->InvalidateIncrementalData();
+
     // Synchronize layers
     // we should not ask PLUGINs to do these items:
     int copperLayerCount = brd->GetCopperLayerCount();
@@ -121,6 +121,7 @@ int ZONE_FILLER_TOOL::ZoneFillAll( const TOOL_EVENT& aEvent )
     }
 
     ZONE_FILLER filler( board(), &commit );
+    filler.SetIncremental( true );
     filler.SetProgressReporter(
             std::make_unique<WX_PROGRESS_REPORTER>( frame(), _( "Fill All Zones" ), 4 ) );
 
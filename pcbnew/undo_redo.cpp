@@ -586,6 +586,10 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
     }
 
     GetBoard()->SanitizeNetcodes();
+
+    // Undo/redo does not track the changed areas: next zone fill must be a full one,
+    // and the online DRC must index the board again
+    GetBoard()->InvalidateIncrementalData();
 }
 
 
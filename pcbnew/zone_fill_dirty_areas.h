@@ -0,0 +1,114 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __ZONE_FILL_DIRTY_AREAS_H
+#define __ZONE_FILL_DIRTY_AREAS_H
+
+#include <vector>
+#include <eda_rect.h>
+#include <class_board_item.h>
+
+/**
+ * Class ZONE_FILL_DIRTY_AREAS
+ * keeps the bounding boxes of the board items changed (by a BOARD_COMMIT) since the
+ * last zone fill, so ZONE_FILLER can recompute only the affected parts of the pours.
+ *
+ * The list is only meaningful when every change since the last fill went through a
+ * BOARD_COMMIT.  Any other kind of change (undo/redo, design rules edition, ...) must
+ * call Invalidate(), and the next fill will be a full one.
+ */
+class ZONE_FILL_DIRTY_AREAS
+{
+public:
+    ZONE_FILL_DIRTY_AREAS() :
+        m_valid( false )
+    {
+    }
+
+    /**
+     * Function Add
+     * records a changed area (usually the bounding box of an item, before or after
+     * its modification).
+     */
+    void Add( const EDA_RECT& aArea )
+    {
+        if( m_valid )
+            m_areas.push_back( aArea );
+    }
+
+    /**
+     * Function AddItem
+     * records the area of a changed item: its current bounding box, and the bounding
+     * box of its copy before the change, if any.  Markers have no effect on zones.
+     */
+    void AddItem( const BOARD_ITEM* aItem, const BOARD_ITEM* aCopy = nullptr )
+    {
+        if( aItem->Type() == PCB_MARKER_T )
+            return;
+
+        Add( aItem->GetBoundingBox() );
+
+        if( aCopy )
+            Add( aCopy->GetBoundingBox() );
+    }
+
+    /**
+     * Function Invalidate
+     * forgets the changed areas: the next zone fill must be a full fill.
+     */
+    void Invalidate()
+    {
+        m_valid = false;
+        m_areas.clear();
+    }
+
+    /**
+     * Function Reset
+     * is called when all the zones have been filled: nothing is dirty anymore.
+     */
+    void Reset()
+    {
+        m_valid = true;
+        m_areas.clear();
+    }
+
+    bool IsValid() const { return m_valid; }
+
+    const std::vector<EDA_RECT>& GetAreas() const { return m_areas; }
+
+    /**
+     * Function Truncate
+     * drops the areas recorded after the first aCount ones.
+     */
+    void Truncate( size_t aCount )
+    {
+        if( aCount < m_areas.size() )
+            m_areas.resize( aCount );
+    }
+
+private:
+    bool                    m_valid;
+    std::vector<EDA_RECT>   m_areas;
+};
+
+#endif
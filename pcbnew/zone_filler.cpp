@@ -28,6 +28,8 @@
 #include <mutex>
 #include <algorithm>
 #include <future>
+#include <map>
+#include <set>
 
 #include <class_board.h>
 #include <class_zone.h>
@@ -64,8 +66,15 @@ extern void CreateThermalReliefPadPolygon( SHAPE_POLY_SET& aCornerBuffer,
 static double s_thermalRot = 450;    // angle of stubs in thermal reliefs for round pads
 static const bool s_DumpZonesWhenFilling = false;
 
+// size of the tiles recomputed by an incremental zone refill
+static const int s_incrementalTileSize = Millimeter2iu( 5 );
+
+// smallest width of the strips of a zone filled in parallel
+static const int s_minStripWidth = Millimeter2iu( 10 );
+
 ZONE_FILLER::ZONE_FILLER(  BOARD* aBoard, COMMIT* aCommit ) :
-    m_board( aBoard ), m_commit( aCommit ), m_progressReporter( nullptr )
+    m_board( aBoard ), m_commit( aCommit ), m_progressReporter( nullptr ),
+    m_incremental( false ), m_spareThreads( 0 )
 {
 }
 
@@ -91,19 +100,58 @@ void ZONE_FILLER::SetProgressReporter( std::unique_ptr<WX_PROGRESS_REPORTER>&& a
 bool ZONE_FILLER::Fill( std::vector<ZONE_CONTAINER*> aZones, bool aCheck )
 {
     std::vector<CN_ZONE_ISOLATED_ISLAND_LIST> toFill;
+    std::map<ZONE_CONTAINER*, ZONE_PATCH> patches;
     auto connectivity = m_board->GetConnectivity();
+    ZONE_FILL_DIRTY_AREAS& dirtyAreas = m_board->ZoneFillDirtyAreas();
+    bool incremental = m_incremental && !aCheck && dirtyAreas.IsValid();
 
     std::unique_lock<std::mutex> lock( connectivity->GetLock(), std::try_to_lock );
 
     if( !lock )
         return false;
 
+    // The item index is only valid during this fill: it is released on every return
+    struct ITEM_INDEX_RELEASER
+    {
+        std::unique_ptr<ITEM_INDEX>& m_index;
+        ~ITEM_INDEX_RELEASER() { m_index.reset(); }
+    } indexReleaser{ m_itemIndex };
+
+    buildItemIndex();
+
     for( auto zone : aZones )
     {
         // Keepout zones are not filled
         if( zone->GetIsKeepout() )
             continue;
 
+        // In incremental mode, keep the current fill and recompute only the dirty tiles
+        if( incremental && zone->IsFilled() && !zone->RawPolysList().IsEmpty() )
+        {
+            std::vector<BOX2I> tiles;
+
+            if( collectDirtyTiles( zone, tiles ) )
+            {
+                // Nothing changed near this zone: its fill is up to date
+                if( tiles.empty() )
+                    continue;
+
+                ZONE_PATCH& patch = patches[zone];
+                patch.m_cached = zone->RawPolysList();
+
+                for( const BOX2I& tile : tiles )
+                {
+                    patch.m_clip.NewOutline();
+                    patch.m_clip.Append( tile.GetX(), tile.GetY() );
+                    patch.m_clip.Append( tile.GetRight(), tile.GetY() );
+                    patch.m_clip.Append( tile.GetRight(), tile.GetBottom() );
+                    patch.m_clip.Append( tile.GetX(), tile.GetBottom() );
+                }
+
+                patch.m_clip.Simplify( SHAPE_POLY_SET::PM_FAST );
+            }
+        }
+
         if( m_commit )
             m_commit->Modify( zone );
 
@@ -132,6 +180,28 @@ bool ZONE_FILLER::Fill( std::vector<ZONE_CONTAINER*> aZones, bool aCheck )
     size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(), toFill.size() );
     std::vector<std::future<size_t>> returns( parallelThreadCount );
 
+    // When there are fewer zones than cores, the spare cores are shared between the zones
+    // according to their size, so a single large zone is also filled in parallel
+    std::vector<int> zoneThreads( toFill.size(), 1 );
+    size_t coreCount = std::max<size_t>( 1, std::thread::hardware_concurrency() );
+
+    // The strip threads of all the zones are taken from this budget
+    m_spareThreads = (int) coreCount - (int) std::max<size_t>( 1, parallelThreadCount );
+
+    if( toFill.size() < coreCount )
+    {
+        double totalArea = 0.0;
+
+        for( auto& zone : toFill )
+            totalArea += (double) zone.m_zone->GetBoundingBox().GetArea();
+
+        for( size_t i = 0; i < toFill.size() && totalArea > 0.0; i++ )
+        {
+            double share = (double) toFill[i].m_zone->GetBoundingBox().GetArea() / totalArea;
+            zoneThreads[i] = std::max( 1, KiROUND( share * coreCount ) );
+        }
+    }
+
     auto fill_lambda = [&] ( PROGRESS_REPORTER* aReporter ) -> size_t
     {
         size_t num = 0;
@@ -140,7 +210,10 @@ bool ZONE_FILLER::Fill( std::vector<ZONE_CONTAINER*> aZones, bool aCheck )
         {
             ZONE_CONTAINER* zone = toFill[i].m_zone;
             SHAPE_POLY_SET rawPolys, finalPolys;
-            fillSingleZone( zone, rawPolys, finalPolys );
+            auto patch = patches.find( zone );
+
+            fillSingleZone( zone, rawPolys, finalPolys,
+                            patch != patches.end() ? &patch->second : nullptr, zoneThreads[i] );
 
             zone->SetRawPolysList( rawPolys );
             zone->SetFilledPolysList( finalPolys );
@@ -318,6 +391,9 @@ bool ZONE_FILLER::Fill( std::vector<ZONE_CONTAINER*> aZones, bool aCheck )
 
     connectivity->SetProgressReporter( nullptr );
 
+    // Our own commit marks the filled zones as dirty: this must be forgotten
+    size_t dirtyCount = dirtyAreas.GetAreas().size();
+
     if( m_commit )
     {
         m_commit->Push( _( "Fill Zone(s)" ), false );
@@ -332,12 +408,234 @@ bool ZONE_FILLER::Fill( std::vector<ZONE_CONTAINER*> aZones, bool aCheck )
         connectivity->RecalculateRatsnest();
     }
 
+    // Once every zone is up to date, the changed areas are no longer dirty
+    bool allZonesFilled = true;
+
+    for( auto zone : m_board->Zones() )
+    {
+        if( !zone->GetIsKeepout()
+            && std::find( aZones.begin(), aZones.end(), zone ) == aZones.end() )
+        {
+            allZonesFilled = false;
+            break;
+        }
+    }
+
+    if( allZonesFilled )
+        dirtyAreas.Reset();
+    else
+        dirtyAreas.Truncate( dirtyCount );
+
+    return true;
+}
+
+
+void ZONE_FILLER::buildItemIndex()
+{
+    m_itemIndex.reset( new ITEM_INDEX );
+
+    LSET copperLayers = LSET::AllCuMask();
+
+    auto addGraphicItem = [&]( BOARD_ITEM* aItem )
+    {
+        switch( aItem->Type() )
+        {
+        case PCB_LINE_T:
+        case PCB_TEXT_T:
+        case PCB_MODULE_EDGE_T:
+        case PCB_MODULE_TEXT_T:
+            break;
+
+        default:
+            return;
+        }
+
+        // A item on the Edge_Cuts is always seen as on any layer
+        LSET layers = aItem->IsOnLayer( Edge_Cuts ) ? copperLayers
+                                                    : aItem->GetLayerSet() & copperLayers;
+
+        if( layers.any() )
+            m_itemIndex->m_graphics.Insert( aItem, layers, aItem->GetBoundingBox() );
+    };
+
+    for( auto module : m_board->Modules() )
+    {
+        for( auto pad : module->Pads() )
+        {
+            LSET     layers = pad->GetLayerSet() & copperLayers;
+            EDA_RECT bbox = pad->GetBoundingBox();
+
+            // The hole of a pad makes a hole in the zones of all copper layers
+            if( pad->GetDrillSize().x != 0 || pad->GetDrillSize().y != 0 )
+            {
+                // The (possibly rotated) hole is inside this circle
+                int      radius = std::max( pad->GetDrillSize().x, pad->GetDrillSize().y ) / 2;
+                EDA_RECT hole( pad->GetPosition() - wxPoint( radius, radius ),
+                               wxSize( 2 * radius, 2 * radius ) );
+
+                bbox.Merge( hole );
+                layers = copperLayers;
+            }
+
+            bbox.Inflate( std::max( pad->GetClearance(), pad->GetThermalGap() ) );
+            m_itemIndex->m_pads.Insert( pad, layers, bbox );
+        }
+
+        addGraphicItem( &module->Reference() );
+        addGraphicItem( &module->Value() );
+
+        for( auto item : module->GraphicalItems() )
+            addGraphicItem( item );
+    }
+
+    for( auto track : m_board->Tracks() )
+    {
+        EDA_RECT bbox = track->GetBoundingBox();
+        bbox.Inflate( track->GetClearance() );
+        m_itemIndex->m_tracks.Insert( track, track->GetLayerSet() & copperLayers, bbox );
+    }
+
+    for( auto item : m_board->Drawings() )
+        addGraphicItem( item );
+
+    for( auto zone : m_board->Zones() )
+        m_itemIndex->m_zones.Insert( zone, zone->GetLayerSet() & copperLayers,
+                                     zone->GetBoundingBox() );
+}
+
+
+bool ZONE_FILLER::collectDirtyTiles( const ZONE_CONTAINER* aZone,
+        std::vector<BOX2I>& aTiles ) const
+{
+    const ZONE_FILL_DIRTY_AREAS& dirtyAreas = m_board->ZoneFillDirtyAreas();
+
+    if( !dirtyAreas.IsValid() )
+        return false;
+
+    // A changed item modifies the fill up to its clearance (or the thermal gap for pads)
+    // around its bounding box
+    int margin = m_board->GetDesignSettings().GetBiggestClearanceValue()
+                 + aZone->GetMinThickness() + aZone->GetThermalReliefGap();
+
+    BOX2I zoneBox = aZone->GetBoundingBox();
+    zoneBox.Normalize();
+
+    const int tileSize = s_incrementalTileSize;
+    int nx = zoneBox.GetWidth() / tileSize + 1;
+    int ny = zoneBox.GetHeight() / tileSize + 1;
+    std::vector<bool> dirty( nx * ny, false );
+    int dirtyCount = 0;
+
+    for( const EDA_RECT& area : dirtyAreas.GetAreas() )
+    {
+        BOX2I box = area;
+        box.Normalize();
+        box.Inflate( margin );
+
+        if( !box.Intersects( zoneBox ) )
+            continue;
+
+        int x0 = std::max( 0, ( box.GetX() - zoneBox.GetX() ) / tileSize );
+        int x1 = std::min( nx - 1, ( box.GetRight() - zoneBox.GetX() ) / tileSize );
+        int y0 = std::max( 0, ( box.GetY() - zoneBox.GetY() ) / tileSize );
+        int y1 = std::min( ny - 1, ( box.GetBottom() - zoneBox.GetY() ) / tileSize );
+
+        for( int y = y0; y <= y1; y++ )
+        {
+            for( int x = x0; x <= x1; x++ )
+            {
+                if( !dirty[ y * nx + x ] )
+                {
+                    dirty[ y * nx + x ] = true;
+                    dirtyCount++;
+                }
+            }
+        }
+    }
+
+    // Patching most of the zone is slower than filling it from scratch
+    if( dirtyCount * 2 > nx * ny )
+        return false;
+
+    // Merge the dirty tiles of each row
+    for( int y = 0; y < ny; y++ )
+    {
+        for( int x = 0; x < nx; x++ )
+        {
+            if( !dirty[ y * nx + x ] )
+                continue;
+
+            int start = x;
+
+            while( x + 1 < nx && dirty[ y * nx + x + 1 ] )
+                x++;
+
+            aTiles.emplace_back( VECTOR2I( zoneBox.GetX() + start * tileSize,
+                                           zoneBox.GetY() + y * tileSize ),
+                                 VECTOR2I( ( x - start + 1 ) * tileSize, tileSize ) );
+        }
+    }
+
+    // Unconnected thermal stubs are found from the fill around the whole pad, so the
+    // dirty area must include the full thermal relief of the pads it touches.
+    // The pads are found by the spatial index; a pad box added as a tile is itself
+    // searched for the pads it touches.
+    PCB_LAYER_ID          layer = aZone->GetLayer();
+    int                   reliefMargin = aZone->GetThermalReliefGap() + aZone->GetMinThickness();
+    std::set<BOARD_ITEM*> seenPads;
+
+    for( size_t ii = 0; ii < aTiles.size(); ii++ )
+    {
+        BOX2I queryBox = aTiles[ii];
+        queryBox.Inflate( reliefMargin );
+
+        m_itemIndex->m_pads.Query( layer, queryBox,
+                [&]( BOARD_ITEM* aItem ) -> bool
+                {
+                    if( !seenPads.insert( aItem ).second )
+                        return true;
+
+                    D_PAD* pad = static_cast<D_PAD*>( aItem );
+
+                    if( aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THERMAL
+                        && aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THT_THERMAL )
+                        return true;
+
+                    if( pad->GetNetCode() <= 0 || pad->GetNetCode() != aZone->GetNetCode() )
+                        return true;
+
+                    if( !pad->IsOnLayer( layer ) )
+                        return true;
+
+                    BOX2I padBox = pad->GetBoundingBox();
+                    padBox.Inflate( aZone->GetThermalReliefGap( pad ) + aZone->GetMinThickness() );
+
+                    bool touched = false;
+                    bool inside = false;
+
+                    for( const BOX2I& tile : aTiles )
+                    {
+                        touched |= tile.Intersects( padBox );
+                        inside |= tile.Contains( padBox );
+                    }
+
+                    // A pad found by its inflated index box only can still be reached
+                    // by a later tile
+                    if( !touched )
+                        seenPads.erase( aItem );
+                    else if( !inside )
+                        aTiles.push_back( padBox );
+
+                    return true;
+                } );
+    }
+
     return true;
 }
 
 
 void ZONE_FILLER::buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
-        SHAPE_POLY_SET& aFeatures ) const
+        SHAPE_POLY_SET& aFeatures, const BOX2I* aArea ) const
 {
     // Set the number of segments in arc approximations
     // Since we can no longer edit the segment count in pcbnew, we set
@@ -376,8 +674,41 @@ void ZONE_FILLER::buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
     EDA_RECT    zone_boundingbox = aZone->GetBoundingBox();
     int biggest_clearance = m_board->GetDesignSettings().GetBiggestClearanceValue();
     biggest_clearance = std::max( biggest_clearance, zone_clearance );
+
+    // When refilling only a part of the zone, items outside this part are not needed
+    if( aArea )
+    {
+        EDA_RECT area( wxPoint( aArea->GetX(), aArea->GetY() ),
+                       wxSize( aArea->GetWidth(), aArea->GetHeight() ) );
+        zone_boundingbox = zone_boundingbox.Common( area );
+    }
+
     zone_boundingbox.Inflate( biggest_clearance );
 
+    /* Only the items found by the spatial index near the zone are examined.
+     * The indexed boxes include the item clearance (and pad thermal gap): the query box
+     * must include the zone side of the clearances.
+     */
+    PCB_LAYER_ID layer = aZone->GetLayer();
+    BOX2I        query_box = zone_boundingbox;
+    query_box.Inflate( outline_half_thickness + aZone->GetThermalReliefGap() );
+
+    auto findCandidates = [&]( const BOARD_ITEM_RTREE& aIndex )
+    {
+        std::vector<BOARD_ITEM*> candidates;
+
+        aIndex.Query( layer, query_box,
+                [&]( BOARD_ITEM* aItem ) -> bool
+                {
+                    candidates.push_back( aItem );
+                    return true;
+                } );
+
+        return candidates;
+    };
+
+    std::vector<BOARD_ITEM*> pads = findCandidates( m_itemIndex->m_pads );
+
     /*
      * First : Add pads. Note: pads having the same net as zone are left in zone.
      * Thermal shapes will be created later if necessary
@@ -393,118 +724,112 @@ void ZONE_FILLER::buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
     MODULE  dummymodule( m_board );   // Creates a dummy parent
     D_PAD   dummypad( &dummymodule );
 
-    for( MODULE* module = m_board->m_Modules; module; module = module->Next() )
+    for( BOARD_ITEM* item : pads )
     {
-        D_PAD* nextpad;
+        D_PAD* pad = static_cast<D_PAD*>( item );
 
-        for( D_PAD* pad = module->PadsList(); pad != NULL; pad = nextpad )
+        if( !pad->IsOnLayer( aZone->GetLayer() ) )
         {
-            nextpad = pad->Next();      // pad pointer can be modified by next code, so
-                                        // calculate the next pad here
+            /* Test for pads that are on top or bottom only and have a hole.
+             * There are curious pads but they can be used for some components that are
+             * inside the board (in fact inside the hole. Some photo diodes and Leds are
+             * like this)
+             */
+            if( pad->GetDrillSize().x == 0 && pad->GetDrillSize().y == 0 )
+                continue;
 
-            if( !pad->IsOnLayer( aZone->GetLayer() ) )
-            {
-                /* Test for pads that are on top or bottom only and have a hole.
-                 * There are curious pads but they can be used for some components that are
-                 * inside the board (in fact inside the hole. Some photo diodes and Leds are
-                 * like this)
-                 */
-                if( pad->GetDrillSize().x == 0 && pad->GetDrillSize().y == 0 )
-                    continue;
+            // Use a dummy pad to calculate a hole shape that have the same dimension as
+            // the pad hole
+            dummypad.SetSize( pad->GetDrillSize() );
+            dummypad.SetOrientation( pad->GetOrientation() );
+            dummypad.SetShape( pad->GetDrillShape() == PAD_DRILL_SHAPE_OBLONG ?
+                    PAD_SHAPE_OVAL : PAD_SHAPE_CIRCLE );
+            dummypad.SetPosition( pad->GetPosition() );
 
-                // Use a dummy pad to calculate a hole shape that have the same dimension as
-                // the pad hole
-                dummypad.SetSize( pad->GetDrillSize() );
-                dummypad.SetOrientation( pad->GetOrientation() );
-                dummypad.SetShape( pad->GetDrillShape() == PAD_DRILL_SHAPE_OBLONG ?
-                        PAD_SHAPE_OVAL : PAD_SHAPE_CIRCLE );
-                dummypad.SetPosition( pad->GetPosition() );
+            pad = &dummypad;
+        }
 
-                pad = &dummypad;
-            }
+        // Note: netcode <=0 means not connected item
+        if( ( pad->GetNetCode() != aZone->GetNetCode() ) || ( pad->GetNetCode() <= 0 ) )
+        {
+            int item_clearance = pad->GetClearance() + outline_half_thickness;
+            item_boundingbox = pad->GetBoundingBox();
+            item_boundingbox.Inflate( item_clearance );
 
-            // Note: netcode <=0 means not connected item
-            if( ( pad->GetNetCode() != aZone->GetNetCode() ) || ( pad->GetNetCode() <= 0 ) )
+            if( item_boundingbox.Intersects( zone_boundingbox ) )
             {
-                int item_clearance = pad->GetClearance() + outline_half_thickness;
-                item_boundingbox = pad->GetBoundingBox();
-                item_boundingbox.Inflate( item_clearance );
+                int clearance = std::max( zone_clearance, item_clearance );
 
-                if( item_boundingbox.Intersects( zone_boundingbox ) )
+                // PAD_SHAPE_CUSTOM can have a specific keepout, to avoid to break the shape
+                if( pad->GetShape() == PAD_SHAPE_CUSTOM
+                    && pad->GetCustomShapeInZoneOpt() == CUST_PAD_SHAPE_IN_ZONE_CONVEXHULL )
                 {
-                    int clearance = std::max( zone_clearance, item_clearance );
-
-                    // PAD_SHAPE_CUSTOM can have a specific keepout, to avoid to break the shape
-                    if( pad->GetShape() == PAD_SHAPE_CUSTOM
-                        && pad->GetCustomShapeInZoneOpt() == CUST_PAD_SHAPE_IN_ZONE_CONVEXHULL )
+                    // the pad shape in zone can be its convex hull or
+                    // the shape itself
+                    SHAPE_POLY_SET outline( pad->GetCustomShapeAsPolygon() );
+                    outline.Inflate( KiROUND( clearance * correctionFactor ), segsPerCircle );
+                    pad->CustomShapeAsPolygonToBoardPosition( &outline,
+                            pad->GetPosition(), pad->GetOrientation() );
+
+                    if( pad->GetCustomShapeInZoneOpt() == CUST_PAD_SHAPE_IN_ZONE_CONVEXHULL )
                     {
-                        // the pad shape in zone can be its convex hull or
-                        // the shape itself
-                        SHAPE_POLY_SET outline( pad->GetCustomShapeAsPolygon() );
-                        outline.Inflate( KiROUND( clearance * correctionFactor ), segsPerCircle );
-                        pad->CustomShapeAsPolygonToBoardPosition( &outline,
-                                pad->GetPosition(), pad->GetOrientation() );
-
-                        if( pad->GetCustomShapeInZoneOpt() == CUST_PAD_SHAPE_IN_ZONE_CONVEXHULL )
-                        {
-                            std::vector<wxPoint> convex_hull;
-                            BuildConvexHull( convex_hull, outline );
-
-                            aFeatures.NewOutline();
-
-                            for( unsigned ii = 0; ii < convex_hull.size(); ++ii )
-                                aFeatures.Append( convex_hull[ii] );
-                        }
-                        else
-                            aFeatures.Append( outline );
+                        std::vector<wxPoint> convex_hull;
+                        BuildConvexHull( convex_hull, outline );
+
+                        aFeatures.NewOutline();
+
+                        for( unsigned ii = 0; ii < convex_hull.size(); ++ii )
+                            aFeatures.Append( convex_hull[ii] );
                     }
                     else
-                        pad->TransformShapeWithClearanceToPolygon( aFeatures,
-                                clearance, segsPerCircle, correctionFactor );
+                        aFeatures.Append( outline );
                 }
-
-                continue;
+                else
+                    pad->TransformShapeWithClearanceToPolygon( aFeatures,
+                            clearance, segsPerCircle, correctionFactor );
             }
 
-            // Pads are removed from zone if the setup is PAD_ZONE_CONN_NONE
-            // or if they have a custom shape and not PAD_ZONE_CONN_FULL,
-            // because a thermal relief will break
-            // the shape
-            if( aZone->GetPadConnection( pad ) == PAD_ZONE_CONN_NONE
-                || ( pad->GetShape() == PAD_SHAPE_CUSTOM && aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_FULL ) )
-            {
-                int gap = zone_clearance;
-                int thermalGap = aZone->GetThermalReliefGap( pad ) + outline_half_thickness;
-                gap = std::max( gap, thermalGap );
-                item_boundingbox = pad->GetBoundingBox();
-                item_boundingbox.Inflate( gap );
+            continue;
+        }
 
-                if( item_boundingbox.Intersects( zone_boundingbox ) )
+        // Pads are removed from zone if the setup is PAD_ZONE_CONN_NONE
+        // or if they have a custom shape and not PAD_ZONE_CONN_FULL,
+        // because a thermal relief will break
+        // the shape
+        if( aZone->GetPadConnection( pad ) == PAD_ZONE_CONN_NONE
+            || ( pad->GetShape() == PAD_SHAPE_CUSTOM && aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_FULL ) )
+        {
+            int gap = zone_clearance;
+            int thermalGap = aZone->GetThermalReliefGap( pad ) + outline_half_thickness;
+            gap = std::max( gap, thermalGap );
+            item_boundingbox = pad->GetBoundingBox();
+            item_boundingbox.Inflate( gap );
+
+            if( item_boundingbox.Intersects( zone_boundingbox ) )
+            {
+                // PAD_SHAPE_CUSTOM has a specific keepout, to avoid to break the shape
+                // the pad shape in zone can be its convex hull or the shape itself
+                if( pad->GetShape() == PAD_SHAPE_CUSTOM
+                    && pad->GetCustomShapeInZoneOpt() == CUST_PAD_SHAPE_IN_ZONE_CONVEXHULL )
                 {
-                    // PAD_SHAPE_CUSTOM has a specific keepout, to avoid to break the shape
-                    // the pad shape in zone can be its convex hull or the shape itself
-                    if( pad->GetShape() == PAD_SHAPE_CUSTOM
-                        && pad->GetCustomShapeInZoneOpt() == CUST_PAD_SHAPE_IN_ZONE_CONVEXHULL )
-                    {
-                        // the pad shape in zone can be its convex hull or
-                        // the shape itself
-                        SHAPE_POLY_SET outline( pad->GetCustomShapeAsPolygon() );
-                        outline.Inflate( KiROUND( gap * correctionFactor ), segsPerCircle );
-                        pad->CustomShapeAsPolygonToBoardPosition( &outline,
-                                pad->GetPosition(), pad->GetOrientation() );
+                    // the pad shape in zone can be its convex hull or
+                    // the shape itself
+                    SHAPE_POLY_SET outline( pad->GetCustomShapeAsPolygon() );
+                    outline.Inflate( KiROUND( gap * correctionFactor ), segsPerCircle );
+                    pad->CustomShapeAsPolygonToBoardPosition( &outline,
+                            pad->GetPosition(), pad->GetOrientation() );
 
-                        std::vector<wxPoint> convex_hull;
-                        BuildConvexHull( convex_hull, outline );
+                    std::vector<wxPoint> convex_hull;
+                    BuildConvexHull( convex_hull, outline );
 
-                        aFeatures.NewOutline();
+                    aFeatures.NewOutline();
 
-                        for( unsigned ii = 0; ii < convex_hull.size(); ++ii )
-                            aFeatures.Append( convex_hull[ii] );
-                    }
-                    else
-                        pad->TransformShapeWithClearanceToPolygon( aFeatures,
-                                gap, segsPerCircle, correctionFactor );
+                    for( unsigned ii = 0; ii < convex_hull.size(); ++ii )
+                        aFeatures.Append( convex_hull[ii] );
                 }
+                else
+                    pad->TransformShapeWithClearanceToPolygon( aFeatures,
+                            gap, segsPerCircle, correctionFactor );
             }
         }
     }
@@ -512,8 +837,10 @@ void ZONE_FILLER::buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
     /* Add holes (i.e. tracks and vias areas as polygons outlines)
      * in cornerBufferPolysToSubstract
      */
-    for( auto track : m_board->Tracks() )
+    for( BOARD_ITEM* item : findCandidates( m_itemIndex->m_tracks ) )
     {
+        TRACK* track = static_cast<TRACK*>( item );
+
         if( !track->IsOnLayer( aZone->GetLayer() ) )
             continue;
 
@@ -590,23 +917,14 @@ void ZONE_FILLER::buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
         }
     };
 
-    for( auto module : m_board->Modules() )
-    {
-        doGraphicItem( &module->Reference() );
-        doGraphicItem( &module->Value() );
-
-        for( auto item : module->GraphicalItems() )
-            doGraphicItem( item );
-    }
-
-    for( auto item : m_board->Drawings() )
+    for( BOARD_ITEM* item : findCandidates( m_itemIndex->m_graphics ) )
         doGraphicItem( item );
 
     /* Add zones outlines having an higher priority and keepout
      */
-    for( int ii = 0; ii < m_board->GetAreaCount(); ii++ )
+    for( BOARD_ITEM* item : findCandidates( m_itemIndex->m_zones ) )
     {
-        ZONE_CONTAINER* zone = m_board->GetArea( ii );
+        ZONE_CONTAINER* zone = static_cast<ZONE_CONTAINER*>( item );
 
         // If the zones share no common layers
         if( !aZone->CommonLayerExists( zone->GetLayerSet() ) )
@@ -654,41 +972,40 @@ void ZONE_FILLER::buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
 
     /* Remove thermal symbols
      */
-    for( auto module : m_board->Modules() )
+    for( BOARD_ITEM* item : pads )
     {
-        for( auto pad : module->Pads() )
-        {
-            // Rejects non-standard pads with tht-only thermal reliefs
-            if( aZone->GetPadConnection( pad ) == PAD_ZONE_CONN_THT_THERMAL
-                && pad->GetAttribute() != PAD_ATTRIB_STANDARD )
-                continue;
+        D_PAD* pad = static_cast<D_PAD*>( item );
 
-            if( aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THERMAL
-                && aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THT_THERMAL )
-                continue;
+        // Rejects non-standard pads with tht-only thermal reliefs
+        if( aZone->GetPadConnection( pad ) == PAD_ZONE_CONN_THT_THERMAL
+            && pad->GetAttribute() != PAD_ATTRIB_STANDARD )
+            continue;
 
-            if( !pad->IsOnLayer( aZone->GetLayer() ) )
-                continue;
+        if( aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THERMAL
+            && aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THT_THERMAL )
+            continue;
 
-            if( pad->GetNetCode() != aZone->GetNetCode() )
-                continue;
+        if( !pad->IsOnLayer( aZone->GetLayer() ) )
+            continue;
 
-            if( pad->GetNetCode() <= 0 )
-                continue;
+        if( pad->GetNetCode() != aZone->GetNetCode() )
+            continue;
 
-            item_boundingbox = pad->GetBoundingBox();
-            int thermalGap = aZone->GetThermalReliefGap( pad );
-            item_boundingbox.Inflate( thermalGap, thermalGap );
+        if( pad->GetNetCode() <= 0 )
+            continue;
 
-            if( item_boundingbox.Intersects( zone_boundingbox ) )
-            {
-                CreateThermalReliefPadPolygon( aFeatures,
-                        *pad, thermalGap,
-                        aZone->GetThermalReliefCopperBridge( pad ),
-                        aZone->GetMinThickness(),
-                        segsPerCircle,
-                        correctionFactor, s_thermalRot );
-            }
+        item_boundingbox = pad->GetBoundingBox();
+        int thermalGap = aZone->GetThermalReliefGap( pad );
+        item_boundingbox.Inflate( thermalGap, thermalGap );
+
+        if( item_boundingbox.Intersects( zone_boundingbox ) )
+        {
+            CreateThermalReliefPadPolygon( aFeatures,
+                    *pad, thermalGap,
+                    aZone->GetThermalReliefCopperBridge( pad ),
+                    aZone->GetMinThickness(),
+                    segsPerCircle,
+                    correctionFactor, s_thermalRot );
         }
     }
 }
@@ -725,7 +1042,8 @@ void ZONE_FILLER::buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
 void ZONE_FILLER::computeRawFilledAreas( const ZONE_CONTAINER* aZone,
         const SHAPE_POLY_SET& aSmoothedOutline,
         SHAPE_POLY_SET& aRawPolys,
-        SHAPE_POLY_SET& aFinalPolys ) const
+        SHAPE_POLY_SET& aFinalPolys,
+        const ZONE_PATCH* aPatch, int aThreadCount ) const
 {
     int outline_half_thickness = aZone->GetMinThickness() / 2;
 
@@ -747,30 +1065,131 @@ void ZONE_FILLER::computeRawFilledAreas( const ZONE_CONTAINER* aZone,
     solidAreas.Inflate( -outline_half_thickness, segsPerCircle );
     solidAreas.Simplify( SHAPE_POLY_SET::PM_FAST );
 
-    SHAPE_POLY_SET holes;
+    // Incremental refill: only the dirty part of the zone is recomputed
+    BOX2I patchBox;
+
+    if( aPatch )
+    {
+        solidAreas.BooleanIntersection( aPatch->m_clip, SHAPE_POLY_SET::PM_FAST );
+        patchBox = aPatch->m_clip.BBox();
+    }
 
     if( s_DumpZonesWhenFilling )
         dumper->Write( &solidAreas, "solid-areas" );
 
-    buildZoneFeatureHoleList( aZone, holes );
+    // Large zones are split in vertical strips, which are filled in parallel
+    BOX2I fillBox = solidAreas.BBox();
+    int stripCount = std::min( aThreadCount, fillBox.GetWidth() / s_minStripWidth );
+    int helperCount = 0;
 
-    if( s_DumpZonesWhenFilling )
-        dumper->Write( &holes, "feature-holes" );
+    // The strip threads are taken from the spare threads of the fill, so the zone threads
+    // and the strip threads of all the zones never exceed the core count
+    if( stripCount > 1 )
+    {
+        int spare = m_spareThreads.load();
 
-    holes.Simplify( SHAPE_POLY_SET::PM_FAST );
+        do
+        {
+            helperCount = std::max( 0, std::min( stripCount - 1, spare ) );
+        } while( helperCount > 0
+                 && !m_spareThreads.compare_exchange_weak( spare, spare - helperCount ) );
 
-    if( s_DumpZonesWhenFilling )
-        dumper->Write( &holes, "feature-holes-postsimplify" );
+        stripCount = helperCount + 1;
+    }
+
+    if( stripCount <= 1 )
+    {
+        SHAPE_POLY_SET holes;
+
+        buildZoneFeatureHoleList( aZone, holes, aPatch ? &patchBox : nullptr );
+
+        if( s_DumpZonesWhenFilling )
+            dumper->Write( &holes, "feature-holes" );
+
+        holes.Simplify( SHAPE_POLY_SET::PM_FAST );
+
+        if( s_DumpZonesWhenFilling )
+            dumper->Write( &holes, "feature-holes-postsimplify" );
+
+        // Generate the filled areas (currently, without thermal shapes, which will
+        // be created later).
+        // Use SHAPE_POLY_SET::PM_STRICTLY_SIMPLE to generate strictly simple polygons
+        // needed by Gerber files and Fracture()
+        solidAreas.BooleanSubtract( holes, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+    }
+    else
+    {
+        std::vector<SHAPE_POLY_SET> strips( stripCount );
+        std::atomic<int> nextStrip( 0 );
+
+        auto strip_lambda = [&]() -> size_t
+        {
+            size_t num = 0;
+
+            for( int i = nextStrip++; i < stripCount; i = nextStrip++ )
+            {
+                int64_t width = fillBox.GetWidth();
+                int left = fillBox.GetX() + (int) ( width * i / stripCount );
+                int right = fillBox.GetX() + (int) ( width * ( i + 1 ) / stripCount );
+                BOX2I stripBox( VECTOR2I( left, fillBox.GetY() ),
+                                VECTOR2I( right - left, fillBox.GetHeight() ) );
+
+                SHAPE_POLY_SET clip;
+                clip.NewOutline();
+                clip.Append( left, fillBox.GetY() );
+                clip.Append( right, fillBox.GetY() );
+                clip.Append( right, fillBox.GetBottom() );
+                clip.Append( left, fillBox.GetBottom() );
+
+                SHAPE_POLY_SET holes;
+                buildZoneFeatureHoleList( aZone, holes, &stripBox );
+                holes.Simplify( SHAPE_POLY_SET::PM_FAST );
+
+                strips[i] = solidAreas;
+                strips[i].BooleanIntersection( clip, SHAPE_POLY_SET::PM_FAST );
+                strips[i].BooleanSubtract( holes, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+                num++;
+            }
+
+            return num;
+        };
+
+        // The calling thread takes its share of the strips
+        std::vector<std::future<size_t>> returns( helperCount );
+
+        for( auto& ret : returns )
+            ret = std::async( std::launch::async, strip_lambda );
+
+        strip_lambda();
+
+        for( auto& ret : returns )
+            ret.wait();
+
+        m_spareThreads += helperCount;
+
+        // Merge the strips: the union welds their common edges
+        solidAreas.RemoveAllContours();
+
+        for( const SHAPE_POLY_SET& strip : strips )
+            solidAreas.Append( strip );
 
-    // Generate the filled areas (currently, without thermal shapes, which will
-    // be created later).
-    // Use SHAPE_POLY_SET::PM_STRICTLY_SIMPLE to generate strictly simple polygons
-    // needed by Gerber files and Fracture()
-    solidAreas.BooleanSubtract( holes, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+        solidAreas.Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+    }
 
     if( s_DumpZonesWhenFilling )
         dumper->Write( &solidAreas, "solid-areas-minus-holes" );
 
+    // Stitch the recomputed part into the previous fill
+    if( aPatch )
+    {
+        SHAPE_POLY_SET unchanged = aPatch->m_cached;
+        unchanged.BooleanSubtract( aPatch->m_clip, SHAPE_POLY_SET::PM_FAST );
+        solidAreas.BooleanAdd( unchanged, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+
+        if( s_DumpZonesWhenFilling )
+            dumper->Write( &solidAreas, "solid-areas-patched" );
+    }
+
     // Test thermal stubs connections and add polygons to remove unconnected stubs.
     // (this is a refinement for thermal relief shapes)
     // Note: we are using not fractured solid area polygons, to avoid a side effect of extra segments
@@ -783,7 +1202,7 @@ void ZONE_FILLER::computeRawFilledAreas( const ZONE_CONTAINER* aZone,
     if( aZone->GetNetCode() > 0 )
     {
         buildUnconnectedThermalStubsPolygonList( thermalHoles, aZone, solidAreas,
-                correctionFactor, s_thermalRot );
+                correctionFactor, s_thermalRot, aPatch ? &patchBox : nullptr );
 
     }
 
@@ -830,7 +1249,8 @@ void ZONE_FILLER::computeRawFilledAreas( const ZONE_CONTAINER* aZone,
  * ( holes are linked by overlapping segments to the main outline)
  */
 bool ZONE_FILLER::fillSingleZone( const ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aRawPolys,
-                                  SHAPE_POLY_SET& aFinalPolys ) const
+                                  SHAPE_POLY_SET& aFinalPolys, const ZONE_PATCH* aPatch,
+                                  int aThreadCount ) const
 {
     SHAPE_POLY_SET smoothedPoly;
 
@@ -843,7 +1263,8 @@ bool ZONE_FILLER::fillSingleZone( const ZONE_CONTAINER* aZone, SHAPE_POLY_SET& a
 
     if( aZone->IsOnCopperLayer() )
     {
-        computeRawFilledAreas( aZone, smoothedPoly, aRawPolys, aFinalPolys );
+        computeRawFilledAreas( aZone, smoothedPoly, aRawPolys, aFinalPolys, aPatch,
+                               aThreadCount );
     }
     else
     {
@@ -1027,13 +1448,15 @@ bool ZONE_FILLER::fillPolygonWithHorizontalSegments( const SHAPE_LINE_CHAIN& aPo
  * @param aZone = a pointer to the ZONE_CONTAINER  to examine.
  * @param aArcCorrection = arc correction factor.
  * @param aRoundPadThermalRotation = the rotation in 1.0 degree for thermal stubs in round pads
+ * @param aArea = if not null, only the pads near this area are tested
  */
 
 void ZONE_FILLER::buildUnconnectedThermalStubsPolygonList( SHAPE_POLY_SET& aCornerBuffer,
                                               const ZONE_CONTAINER*       aZone,
                                               const SHAPE_POLY_SET&       aRawFilledArea,
                                               double                aArcCorrection,
-                                              double                aRoundPadThermalRotation ) const
+                                              double                aRoundPadThermalRotation,
+                                              const BOX2I*          aArea ) const
 {
     SHAPE_LINE_CHAIN spokes;
     BOX2I itemBB;
@@ -1047,147 +1470,168 @@ void ZONE_FILLER::buildUnconnectedThermalStubsPolygonList( SHAPE_POLY_SET& aCorn
     biggest_clearance = std::max( biggest_clearance, zone_clearance );
     zoneBB.Inflate( biggest_clearance );
 
+    // Pads outside the refilled area keep their previous stubs
+    if( aArea )
+    {
+        BOX2I area = *aArea;
+        area.Inflate( biggest_clearance );
+
+        if( !zoneBB.Intersects( area ) )
+            return;
+
+        zoneBB = zoneBB.Intersect( area );
+    }
+
     // half size of the pen used to draw/plot zones outlines
     int pen_radius = aZone->GetMinThickness() / 2;
 
-    for( auto module : m_board->Modules() )
+    // Indexed pad boxes include the pad thermal gap, but not the zone one
+    std::vector<D_PAD*> pads;
+    BOX2I queryBB = zoneBB;
+    queryBB.Inflate( aZone->GetThermalReliefGap() );
+
+    m_itemIndex->m_pads.Query( aZone->GetLayer(), queryBB,
+            [&]( BOARD_ITEM* aItem ) -> bool
+            {
+                pads.push_back( static_cast<D_PAD*>( aItem ) );
+                return true;
+            } );
+
+    for( D_PAD* pad : pads )
     {
-        for( auto pad : module->Pads() )
-        {
-            // Rejects non-standard pads with tht-only thermal reliefs
-            if( aZone->GetPadConnection( pad ) == PAD_ZONE_CONN_THT_THERMAL
-             && pad->GetAttribute() != PAD_ATTRIB_STANDARD )
-                continue;
+        // Rejects non-standard pads with tht-only thermal reliefs
+        if( aZone->GetPadConnection( pad ) == PAD_ZONE_CONN_THT_THERMAL
+         && pad->GetAttribute() != PAD_ATTRIB_STANDARD )
+            continue;
 
-            if( aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THERMAL
-             && aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THT_THERMAL )
-                continue;
+        if( aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THERMAL
+         && aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THT_THERMAL )
+            continue;
 
-            if( !pad->IsOnLayer( aZone->GetLayer() ) )
-                continue;
+        if( !pad->IsOnLayer( aZone->GetLayer() ) )
+            continue;
 
-            if( pad->GetNetCode() != aZone->GetNetCode() )
-                continue;
+        if( pad->GetNetCode() != aZone->GetNetCode() )
+            continue;
 
-            // Calculate thermal bridge half width
-            int thermalBridgeWidth = aZone->GetThermalReliefCopperBridge( pad )
-                                     - aZone->GetMinThickness();
-            if( thermalBridgeWidth <= 0 )
-                continue;
+        // Calculate thermal bridge half width
+        int thermalBridgeWidth = aZone->GetThermalReliefCopperBridge( pad )
+                                 - aZone->GetMinThickness();
+        if( thermalBridgeWidth <= 0 )
+            continue;
 
-            // we need the thermal bridge half width
-            // with a small extra size to be sure we create a stub
-            // slightly larger than the actual stub
-            thermalBridgeWidth = ( thermalBridgeWidth + 4 ) / 2;
+        // we need the thermal bridge half width
+        // with a small extra size to be sure we create a stub
+        // slightly larger than the actual stub
+        thermalBridgeWidth = ( thermalBridgeWidth + 4 ) / 2;
 
-            int thermalReliefGap = aZone->GetThermalReliefGap( pad );
+        int thermalReliefGap = aZone->GetThermalReliefGap( pad );
 
-            itemBB = pad->GetBoundingBox();
-            itemBB.Inflate( thermalReliefGap );
-            if( !( itemBB.Intersects( zoneBB ) ) )
-                continue;
+        itemBB = pad->GetBoundingBox();
+        itemBB.Inflate( thermalReliefGap );
+        if( !( itemBB.Intersects( zoneBB ) ) )
+            continue;
 
-            // Thermal bridges are like a segment from a starting point inside the pad
-            // to an ending point outside the pad
+        // Thermal bridges are like a segment from a starting point inside the pad
+        // to an ending point outside the pad
 
-            // calculate the ending point of the thermal pad, outside the pad
-            VECTOR2I endpoint;
-            endpoint.x = ( pad->GetSize().x / 2 ) + thermalReliefGap;
-            endpoint.y = ( pad->GetSize().y / 2 ) + thermalReliefGap;
+        // calculate the ending point of the thermal pad, outside the pad
+        VECTOR2I endpoint;
+        endpoint.x = ( pad->GetSize().x / 2 ) + thermalReliefGap;
+        endpoint.y = ( pad->GetSize().y / 2 ) + thermalReliefGap;
 
-            // Calculate the starting point of the thermal stub
-            // inside the pad
-            VECTOR2I startpoint;
-            int copperThickness = aZone->GetThermalReliefCopperBridge( pad )
-                                  - aZone->GetMinThickness();
+        // Calculate the starting point of the thermal stub
+        // inside the pad
+        VECTOR2I startpoint;
+        int copperThickness = aZone->GetThermalReliefCopperBridge( pad )
+                              - aZone->GetMinThickness();
 
-            if( copperThickness < 0 )
-                copperThickness = 0;
+        if( copperThickness < 0 )
+            copperThickness = 0;
 
-            // Leave a small extra size to the copper area inside to pad
-            copperThickness += KiROUND( IU_PER_MM * 0.04 );
+        // Leave a small extra size to the copper area inside to pad
+        copperThickness += KiROUND( IU_PER_MM * 0.04 );
 
-            startpoint.x = std::min( pad->GetSize().x, copperThickness );
-            startpoint.y = std::min( pad->GetSize().y, copperThickness );
+        startpoint.x = std::min( pad->GetSize().x, copperThickness );
+        startpoint.y = std::min( pad->GetSize().y, copperThickness );
 
-            startpoint.x /= 2;
-            startpoint.y /= 2;
+        startpoint.x /= 2;
+        startpoint.y /= 2;
 
-            // This is a CIRCLE pad tweak
-            // for circle pads, the thermal stubs orientation is 45 deg
-            double fAngle = pad->GetOrientation();
-            if( pad->GetShape() == PAD_SHAPE_CIRCLE )
-            {
-                endpoint.x     = KiROUND( endpoint.x * aArcCorrection );
-                endpoint.y     = endpoint.x;
-                fAngle = aRoundPadThermalRotation;
-            }
+        // This is a CIRCLE pad tweak
+        // for circle pads, the thermal stubs orientation is 45 deg
+        double fAngle = pad->GetOrientation();
+        if( pad->GetShape() == PAD_SHAPE_CIRCLE )
+        {
+            endpoint.x     = KiROUND( endpoint.x * aArcCorrection );
+            endpoint.y     = endpoint.x;
+            fAngle = aRoundPadThermalRotation;
+        }
 
-            // contour line width has to be taken into calculation to avoid "thermal stub bleed"
-            endpoint.x += pen_radius;
-            endpoint.y += pen_radius;
-            // compute north, south, west and east points for zone connection.
-            ptTest[0] = VECTOR2I( 0, endpoint.y );       // lower point
-            ptTest[1] = VECTOR2I( 0, -endpoint.y );      // upper point
-            ptTest[2] = VECTOR2I( endpoint.x, 0 );       // right point
-            ptTest[3] = VECTOR2I( -endpoint.x, 0 );      // left point
-
-            // Test all sides
-            for( int i = 0; i < 4; i++ )
-            {
-                // rotate point
-                RotatePoint( ptTest[i], fAngle );
+        // contour line width has to be taken into calculation to avoid "thermal stub bleed"
+        endpoint.x += pen_radius;
+        endpoint.y += pen_radius;
+        // compute north, south, west and east points for zone connection.
+        ptTest[0] = VECTOR2I( 0, endpoint.y );       // lower point
+        ptTest[1] = VECTOR2I( 0, -endpoint.y );      // upper point
+        ptTest[2] = VECTOR2I( endpoint.x, 0 );       // right point
+        ptTest[3] = VECTOR2I( -endpoint.x, 0 );      // left point
+
+        // Test all sides
+        for( int i = 0; i < 4; i++ )
+        {
+            // rotate point
+            RotatePoint( ptTest[i], fAngle );
 
-                // translate point
-                ptTest[i] += pad->ShapePos();
+            // translate point
+            ptTest[i] += pad->ShapePos();
 
-                if( aRawFilledArea.Contains( ptTest[i] ) )
-                    continue;
+            if( aRawFilledArea.Contains( ptTest[i] ) )
+                continue;
 
-                spokes.Clear();
+            spokes.Clear();
 
-                // polygons are rectangles with width of copper bridge value
-                switch( i )
-                {
-                case 0:       // lower stub
-                    spokes.Append( -thermalBridgeWidth, endpoint.y );
-                    spokes.Append( +thermalBridgeWidth, endpoint.y );
-                    spokes.Append( +thermalBridgeWidth, startpoint.y );
-                    spokes.Append( -thermalBridgeWidth, startpoint.y );
-                    break;
-
-                case 1:       // upper stub
-                    spokes.Append( -thermalBridgeWidth, -endpoint.y );
-                    spokes.Append( +thermalBridgeWidth, -endpoint.y );
-                    spokes.Append( +thermalBridgeWidth, -startpoint.y );
-                    spokes.Append( -thermalBridgeWidth, -startpoint.y );
-                    break;
-
-                case 2:       // right stub
-                    spokes.Append( endpoint.x, -thermalBridgeWidth );
-                    spokes.Append( endpoint.x, thermalBridgeWidth );
-                    spokes.Append( +startpoint.x, thermalBridgeWidth );
-                    spokes.Append( +startpoint.x, -thermalBridgeWidth );
-                    break;
-
-                case 3:       // left stub
-                    spokes.Append( -endpoint.x, -thermalBridgeWidth );
-                    spokes.Append( -endpoint.x, thermalBridgeWidth );
-                    spokes.Append( -startpoint.x, thermalBridgeWidth );
-                    spokes.Append( -startpoint.x, -thermalBridgeWidth );
-                    break;
-                }
+            // polygons are rectangles with width of copper bridge value
+            switch( i )
+            {
+            case 0:       // lower stub
+                spokes.Append( -thermalBridgeWidth, endpoint.y );
+                spokes.Append( +thermalBridgeWidth, endpoint.y );
+                spokes.Append( +thermalBridgeWidth, startpoint.y );
+                spokes.Append( -thermalBridgeWidth, startpoint.y );
+                break;
+
+            case 1:       // upper stub
+                spokes.Append( -thermalBridgeWidth, -endpoint.y );
+                spokes.Append( +thermalBridgeWidth, -endpoint.y );
+                spokes.Append( +thermalBridgeWidth, -startpoint.y );
+                spokes.Append( -thermalBridgeWidth, -startpoint.y );
+                break;
+
+            case 2:       // right stub
+                spokes.Append( endpoint.x, -thermalBridgeWidth );
+                spokes.Append( endpoint.x, thermalBridgeWidth );
+                spokes.Append( +startpoint.x, thermalBridgeWidth );
+                spokes.Append( +startpoint.x, -thermalBridgeWidth );
+                break;
+
+            case 3:       // left stub
+                spokes.Append( -endpoint.x, -thermalBridgeWidth );
+                spokes.Append( -endpoint.x, thermalBridgeWidth );
+                spokes.Append( -startpoint.x, thermalBridgeWidth );
+                spokes.Append( -startpoint.x, -thermalBridgeWidth );
+                break;
+            }
 
-                aCornerBuffer.NewOutline();
+            aCornerBuffer.NewOutline();
 
-                // add computed polygon to list
-                for( int ic = 0; ic < spokes.PointCount(); ic++ )
-                {
-                    auto cpos = spokes.CPoint( ic );
-                    RotatePoint( cpos, fAngle );                               // Rotate according to module orientation
-                    cpos += pad->ShapePos();                              // Shift origin to position
-                    aCornerBuffer.Append( cpos );
-                }
+            // add computed polygon to list
+            for( int ic = 0; ic < spokes.PointCount(); ic++ )
+            {
+                auto cpos = spokes.CPoint( ic );
+                RotatePoint( cpos, fAngle );                               // Rotate according to module orientation
+                cpos += pad->ShapePos();                              // Shift origin to position
+                aCornerBuffer.Append( cpos );
             }
         }
     }
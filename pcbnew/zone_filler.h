@@ -26,8 +26,10 @@
 #ifndef __ZONE_FILLER_H
 #define __ZONE_FILLER_H
 
+#include <atomic>
 #include <vector>
 #include <class_zone.h>
+#include <board_item_rtree.h>
 
 class WX_PROGRESS_REPORTER;
 class BOARD;
@@ -45,12 +47,64 @@ public:
 
     void SetProgressReporter( std::unique_ptr<WX_PROGRESS_REPORTER>&& aReporter );
 
+    /**
+     * Function SetIncremental
+     * enables the incremental refill: a zone already filled is only recomputed inside
+     * the tiles touched by the board dirty areas (see BOARD::ZoneFillDirtyAreas()), and
+     * the result is merged into its current fill.  Zones without a usable fill, or when
+     * the dirty areas are not known, are filled from scratch.
+     */
+    void SetIncremental( bool aIncremental ) { m_incremental = aIncremental; }
+
     bool Fill( std::vector<ZONE_CONTAINER*> aZones, bool aCheck = false );
 
 private:
 
+    /**
+     * Part of a zone to recompute in incremental mode
+     */
+    struct ZONE_PATCH
+    {
+        SHAPE_POLY_SET  m_clip;     ///< union of the dirty tiles
+        SHAPE_POLY_SET  m_cached;   ///< the (raw) fill before the board changes
+    };
+
+    /**
+     * Spatial indexes of the board items which can create holes in the zones.
+     * The indexed boxes are inflated by the item clearance (and thermal gap for pads).
+     */
+    struct ITEM_INDEX
+    {
+        BOARD_ITEM_RTREE    m_pads;
+        BOARD_ITEM_RTREE    m_tracks;
+        BOARD_ITEM_RTREE    m_graphics;     ///< graphic items on copper and Edge_Cuts layers
+        BOARD_ITEM_RTREE    m_zones;
+    };
+
+    /**
+     * Function buildItemIndex
+     * builds the spatial indexes used by buildZoneFeatureHoleList(), once per fill.
+     * They are only read during the fill, so they are shared by all the filling threads.
+     */
+    void buildItemIndex();
+
+    /**
+     * Function collectDirtyTiles
+     * finds the tiles of aZone which can be affected by the board dirty areas.
+     * The item index must be built: the pads whose thermal relief is touched by the
+     * dirty tiles are found by it.
+     * @param aTiles = the list of dirty tiles to fill
+     * @return false if the zone must be filled from scratch (no usable dirty area list,
+     * or too many dirty tiles for an incremental refill to be worth it)
+     */
+    bool collectDirtyTiles( const ZONE_CONTAINER* aZone, std::vector<BOX2I>& aTiles ) const;
+
+    /**
+     * Function buildZoneFeatureHoleList
+     * @param aArea = if not null, only the items near this area are taken in account
+     */
     void buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
-            SHAPE_POLY_SET& aFeatures ) const;
+            SHAPE_POLY_SET& aFeatures, const BOX2I* aArea = nullptr ) const;
 
     /**
      * Function computeRawFilledAreas
@@ -62,12 +116,19 @@ private:
      * BuildFilledSolidAreasPolygons() call this function just after creating the
      *  filled copper area polygon (without clearance areas
      * @param aPcb: the current board
+     * @param aPatch: if not null, only the area aPatch->m_clip is recomputed and
+     * the result is merged into aPatch->m_cached
+     * @param aThreadCount: the number of threads to use: the zone is split in vertical
+     * strips whose holes are computed and subtracted in parallel, then merged.
+     * The extra threads are only started while m_spareThreads allows it.
      * _NG version uses SHAPE_POLY_SET instead of Boost.Polygon
      */
     void computeRawFilledAreas( const ZONE_CONTAINER* aZone,
             const SHAPE_POLY_SET& aSmoothedOutline,
             SHAPE_POLY_SET& aRawPolys,
-            SHAPE_POLY_SET& aFinalPolys ) const;
+            SHAPE_POLY_SET& aFinalPolys,
+            const ZONE_PATCH* aPatch = nullptr,
+            int aThreadCount = 1 ) const;
 
     bool fillPolygonWithHorizontalSegments( const SHAPE_LINE_CHAIN& aPolygon,
             ZONE_SEGMENT_FILL& aFillSegmList, int aStep ) const;
@@ -93,12 +154,14 @@ private:
      * @param aZone = a pointer to the ZONE_CONTAINER  to examine.
      * @param aArcCorrection = a pointer to the ZONE_CONTAINER  to examine.
      * @param aRoundPadThermalRotation = the rotation in 1.0 degree for thermal stubs in round pads
+     * @param aArea = if not null, only the pads near this area are tested
      */
     void buildUnconnectedThermalStubsPolygonList( SHAPE_POLY_SET& aCornerBuffer,
             const ZONE_CONTAINER* aZone,
             const SHAPE_POLY_SET&       aRawFilledArea,
             double aArcCorrection,
-            double aRoundPadThermalRotation ) const;
+            double aRoundPadThermalRotation,
+            const BOX2I* aArea = nullptr ) const;
 
     /**
      * Build the filled solid areas polygons from zone outlines (stored in m_Poly)
@@ -113,15 +176,25 @@ private:
      * (holes are linked to main outline by overlapping segments, and these polygons are shrinked
      * by aZone->GetMinThickness() / 2 to be drawn with a outline thickness = aZone->GetMinThickness()
      * aFinalPolys are polygons that will be drawn on screen and plotted
+     * @param aPatch: if not null, the zone is refilled incrementally (see ZONE_PATCH)
+     * @param aThreadCount: the number of threads available to fill this zone
      */
     bool fillSingleZone( const ZONE_CONTAINER* aZone,
             SHAPE_POLY_SET& aRawPolys,
-            SHAPE_POLY_SET& aFinalPolys ) const;
+            SHAPE_POLY_SET& aFinalPolys,
+            const ZONE_PATCH* aPatch = nullptr,
+            int aThreadCount = 1 ) const;
 
     BOARD* m_board;
     COMMIT* m_commit;
     WX_PROGRESS_REPORTER* m_progressReporter;
     std::unique_ptr<WX_PROGRESS_REPORTER> m_uniqueReporter;
+    std::unique_ptr<ITEM_INDEX> m_itemIndex;
+    bool m_incremental;
+
+    ///> Number of threads not used by the zone filling threads, that the zones can still
+    ///> use to fill their strips
+    mutable std::atomic<int> m_spareThreads;
 };
 
 #endif
@@ -0,0 +1,204 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the s-expression lexer, when its lines are not nul terminated
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+// Code under test
+#include <dsnlexer.h>
+#include <richio.h>
+
+
+/**
+ * A token, as returned by DSNLEXER::NextTok() and DSNLEXER::CurText()
+ */
+struct TOKEN
+{
+    int         m_tok;
+    std::string m_text;
+
+    bool operator==( const TOKEN& aOther ) const
+    {
+        return m_tok == aOther.m_tok && m_text == aOther.m_text;
+    }
+};
+
+
+std::ostream& operator<<( std::ostream& os, const TOKEN& aToken )
+{
+    os << "TOKEN[ " << aToken.m_tok << ", \"" << aToken.m_text << "\" ]";
+    return os;
+}
+
+
+/**
+ * Reads all the tokens of aReader
+ */
+static std::vector<TOKEN> readTokens( LINE_READER& aReader )
+{
+    DSNLEXER           lexer( nullptr, 0, &aReader );
+    std::vector<TOKEN> tokens;
+
+    for( int tok = lexer.NextTok(); tok != DSN_EOF; tok = lexer.NextTok() )
+        tokens.push_back( { tok, lexer.CurText() } );
+
+    return tokens;
+}
+
+
+struct LEXER_CASE
+{
+    std::string        m_name;
+    std::string        m_text;
+    std::vector<TOKEN> m_tokens;
+};
+
+
+static const std::vector<LEXER_CASE> lexer_cases = {
+    {
+        "number at the end of the text",
+        "(a 12",
+        { { DSN_LEFT, "(" }, { DSN_SYMBOL, "a" }, { DSN_NUMBER, "12" } },
+    },
+    {
+        "symbol at the end of the text",
+        "(a b",
+        { { DSN_LEFT, "(" }, { DSN_SYMBOL, "a" }, { DSN_SYMBOL, "b" } },
+    },
+    {
+        "crlf",
+        "(a\r\n 1.5)\r\n",
+        { { DSN_LEFT, "(" }, { DSN_SYMBOL, "a" }, { DSN_NUMBER, "1.5" }, { DSN_RIGHT, ")" } },
+    },
+    {
+        "string at the end of the text",
+        "(a \"b c\")",
+        { { DSN_LEFT, "(" }, { DSN_SYMBOL, "a" }, { DSN_STRING, "b c" }, { DSN_RIGHT, ")" } },
+    },
+    {
+        "escapes",
+        "(\"\\x41\\102\\n\")",
+        { { DSN_LEFT, "(" }, { DSN_STRING, "AB\n" }, { DSN_RIGHT, ")" } },
+    },
+    {
+        "escapes before the end of the string",
+        "(\"\\x4\" \"\\10\")",
+        { { DSN_LEFT, "(" }, { DSN_STRING, "\x04" }, { DSN_STRING, "\x08" }, { DSN_RIGHT, ")" } },
+    },
+};
+
+
+BOOST_AUTO_TEST_SUITE( DsnLexer )
+
+
+BOOST_AUTO_TEST_CASE( StringReader )
+{
+    for( const auto& c : lexer_cases )
+    {
+        BOOST_TEST_CONTEXT( c.m_name )
+        {
+            STRING_LINE_READER reader( c.m_text, wxT( "test" ) );
+            std::vector<TOKEN> tokens = readTokens( reader );
+
+            BOOST_CHECK_EQUAL_COLLECTIONS(
+                    tokens.begin(), tokens.end(), c.m_tokens.begin(), c.m_tokens.end() );
+        }
+    }
+}
+
+
+/**
+ * In a mapped file, the last line is followed by the end of the mapping: the lexer must
+ * not read past it
+ */
+BOOST_AUTO_TEST_CASE( MappedFileReader )
+{
+    for( const auto& c : lexer_cases )
+    {
+        BOOST_TEST_CONTEXT( c.m_name )
+        {
+            wxString fileName = wxFileName::CreateTempFileName( wxT( "qa_dsnlexer" ) );
+
+            {
+                wxFFile file( fileName, wxT( "wb" ) );
+                file.Write( c.m_text.data(), c.m_text.size() );
+            }
+
+            {
+                MAPPED_FILE_LINE_READER reader( fileName, 0, LINE_READER_LINE_DEFAULT_MAX, 1 );
+                BOOST_CHECK( reader.IsMapped() );
+
+                std::vector<TOKEN> tokens = readTokens( reader );
+
+                BOOST_CHECK_EQUAL_COLLECTIONS(
+                        tokens.begin(), tokens.end(), c.m_tokens.begin(), c.m_tokens.end() );
+            }
+
+            wxRemoveFile( fileName );
+        }
+    }
+}
+
+
+/**
+ * A string which is not terminated on its line is an error, even at the end of the text
+ */
+BOOST_AUTO_TEST_CASE( UnterminatedString )
+{
+    for( const std::string& text : { "(a \"bc", "(a \"bc\\", "(a \"b\\x4" } )
+    {
+        BOOST_TEST_CONTEXT( text )
+        {
+            STRING_LINE_READER reader( text, wxT( "test" ) );
+
+            BOOST_CHECK_THROW( readTokens( reader ), PARSE_ERROR );
+        }
+    }
+}
+
+
+/**
+ * CurLine() gives a nul terminated copy of the current line
+ */
+BOOST_AUTO_TEST_CASE( CurLine )
+{
+    STRING_LINE_READER reader( std::string( "(a\n(b c)" ), wxT( "test" ) );
+    DSNLEXER           lexer( nullptr, 0, &reader );
+
+    lexer.NextTok();
+    BOOST_CHECK_EQUAL( std::string( lexer.CurLine() ), "(a\n" );
+
+    lexer.NextTok();
+    lexer.NextTok();
+    BOOST_CHECK_EQUAL( std::string( lexer.CurLine() ), "(b c)" );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,225 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the apertures of the Gerber plotter
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <cstdlib>
+#include <fstream>
+
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+// Code under test
+#include <gbr_metadata.h>
+#include <plotter.h>
+
+
+/**
+ * A pad flashed with a basic aperture
+ */
+struct FLASH
+{
+    APERTURE::APERTURE_TYPE                    m_type;
+    wxSize                                     m_size;
+    GBR_APERTURE_METADATA::GBR_APERTURE_ATTRIB m_attribute;
+};
+
+
+/**
+ * The apertures of a Gerber file, as read from the file
+ */
+struct GERBER_APERTURES
+{
+    std::vector<int>  m_definedDCodes;   ///< the D codes of the aperture list, in file order
+    std::vector<char> m_definedShapes;   ///< the shape letter (C, R or O) of each of them
+    std::vector<int>  m_selectedDCodes;  ///< the D codes selected by the plot, in file order
+};
+
+
+static const auto NO_ATTRIB = GBR_APERTURE_METADATA::GBR_APERTURE_ATTRIB_NONE;
+static const auto SMD_ATTRIB = GBR_APERTURE_METADATA::GBR_APERTURE_ATTRIB_SMDPAD_CUDEF;
+static const auto VIA_ATTRIB = GBR_APERTURE_METADATA::GBR_APERTURE_ATTRIB_VIAPAD;
+
+
+/**
+ * Plots aFlashes in a Gerber file, and reads back its apertures
+ */
+static GERBER_APERTURES plotFlashes( const std::vector<FLASH>& aFlashes )
+{
+    wxString fileName = wxFileName::CreateTempFileName( wxT( "qa_gerber_plotter" ) );
+
+    {
+        GERBER_PLOTTER plotter;
+        plotter.SetViewport( wxPoint( 0, 0 ), 1.0, 1.0, false );
+        plotter.SetGerberCoordinatesFormat( 6 );
+        BOOST_REQUIRE( plotter.OpenFile( fileName ) );
+        BOOST_REQUIRE( plotter.StartPlot() );
+
+        wxPoint pos( 0, 0 );
+
+        for( const FLASH& flash : aFlashes )
+        {
+            GBR_METADATA metadata;
+            metadata.SetApertureAttrib( flash.m_attribute );
+            void* data = flash.m_attribute == NO_ATTRIB ? nullptr : &metadata;
+
+            switch( flash.m_type )
+            {
+            case APERTURE::Circle:
+                plotter.FlashPadCircle( pos, flash.m_size.x, FILLED, data );
+                break;
+
+            case APERTURE::Rect:
+                plotter.FlashPadRect( pos, flash.m_size, 0, FILLED, data );
+                break;
+
+            case APERTURE::Oval:
+                plotter.FlashPadOval( pos, flash.m_size, 0, FILLED, data );
+                break;
+
+            default:
+                BOOST_FAIL( "Unexpected aperture type" );
+            }
+
+            pos.x += 10000;
+        }
+
+        plotter.EndPlot();
+    }
+
+    GERBER_APERTURES apertures;
+    std::ifstream    file( fileName.fn_str() );
+    std::string      line;
+
+    while( std::getline( file, line ) )
+    {
+        if( line.compare( 0, 4, "%ADD" ) == 0 )
+        {
+            char* end;
+            apertures.m_definedDCodes.push_back( std::strtol( line.c_str() + 4, &end, 10 ) );
+            apertures.m_definedShapes.push_back( *end );
+        }
+        else if( line.size() > 2 && line[0] == 'D' && line.back() == '*' )
+        {
+            apertures.m_selectedDCodes.push_back( std::atoi( line.c_str() + 1 ) );
+        }
+    }
+
+    file.close();
+    wxRemoveFile( fileName );
+
+    return apertures;
+}
+
+
+/**
+ * Plots aFlashes, and checks the aperture list and the D codes selected by the plot
+ * @param aShapes the expected shape letters of the apertures, defined from D code 10
+ */
+static void checkApertures( const std::vector<FLASH>& aFlashes, const std::string& aShapes,
+                            const std::vector<int>& aSelectedDCodes )
+{
+    GERBER_APERTURES apertures = plotFlashes( aFlashes );
+    std::vector<int> definedDCodes;
+
+    for( size_t ii = 0; ii < aShapes.size(); ++ii )
+        definedDCodes.push_back( 10 + (int) ii );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( apertures.m_definedDCodes.begin(),
+            apertures.m_definedDCodes.end(), definedDCodes.begin(), definedDCodes.end() );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( apertures.m_definedShapes.begin(),
+            apertures.m_definedShapes.end(), aShapes.begin(), aShapes.end() );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( apertures.m_selectedDCodes.begin(),
+            apertures.m_selectedDCodes.end(), aSelectedDCodes.begin(), aSelectedDCodes.end() );
+}
+
+
+BOOST_AUTO_TEST_SUITE( GerberPlotter )
+
+
+/**
+ * Flashes of the same aperture use a single D code, selected again only when the
+ * aperture changes
+ */
+BOOST_AUTO_TEST_CASE( ApertureReuse )
+{
+    const std::vector<FLASH> flashes = {
+        { APERTURE::Circle, wxSize( 1000, 1000 ), NO_ATTRIB },
+        { APERTURE::Circle, wxSize( 1000, 1000 ), NO_ATTRIB },
+        { APERTURE::Rect, wxSize( 1000, 2000 ), NO_ATTRIB },
+        { APERTURE::Circle, wxSize( 1000, 1000 ), NO_ATTRIB },
+        { APERTURE::Rect, wxSize( 1000, 2000 ), NO_ATTRIB },
+    };
+
+    checkApertures( flashes, "CR", { 10, 11, 10, 11 } );
+}
+
+
+/**
+ * Apertures differing only by their type, their size or their attribute are different
+ */
+BOOST_AUTO_TEST_CASE( ApertureKey )
+{
+    const std::vector<FLASH> flashes = {
+        { APERTURE::Rect, wxSize( 1000, 2000 ), NO_ATTRIB },
+        { APERTURE::Oval, wxSize( 1000, 2000 ), NO_ATTRIB },
+        { APERTURE::Rect, wxSize( 2000, 1000 ), NO_ATTRIB },
+        { APERTURE::Rect, wxSize( 1000, 2000 ), SMD_ATTRIB },
+        { APERTURE::Rect, wxSize( 1000, 2000 ), VIA_ATTRIB },
+        { APERTURE::Circle, wxSize( 1000, 1000 ), NO_ATTRIB },
+        { APERTURE::Circle, wxSize( 1000, 1000 ), SMD_ATTRIB },
+        { APERTURE::Rect, wxSize( 1000, 2000 ), SMD_ATTRIB },
+        { APERTURE::Oval, wxSize( 1000, 2000 ), NO_ATTRIB },
+    };
+
+    checkApertures( flashes, "RORRRCC", { 10, 11, 12, 13, 14, 15, 16, 13, 11 } );
+}
+
+
+/**
+ * Apertures used again in reverse order keep the D codes of their creation
+ */
+BOOST_AUTO_TEST_CASE( ApertureOrder )
+{
+    const std::vector<FLASH> flashes = {
+        { APERTURE::Circle, wxSize( 1000, 1000 ), NO_ATTRIB },
+        { APERTURE::Circle, wxSize( 1100, 1100 ), NO_ATTRIB },
+        { APERTURE::Circle, wxSize( 1200, 1200 ), NO_ATTRIB },
+        { APERTURE::Rect, wxSize( 1000, 2000 ), NO_ATTRIB },
+        { APERTURE::Circle, wxSize( 1200, 1200 ), NO_ATTRIB },
+        { APERTURE::Circle, wxSize( 1100, 1100 ), NO_ATTRIB },
+        { APERTURE::Circle, wxSize( 1000, 1000 ), NO_ATTRIB },
+        { APERTURE::Rect, wxSize( 1000, 2000 ), NO_ATTRIB },
+    };
+
+    checkApertures( flashes, "CCCR", { 10, 11, 12, 13, 12, 11, 10, 13 } );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,225 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the search in the library tree
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <wx/tokenzr.h>
+
+// Code under test
+#include <eda_pattern_match.h>
+#include <lib_tree_model.h>
+
+
+/**
+ * A library item with a name and a search text (keywords and description)
+ */
+class TEST_LIB_TREE_ITEM : public LIB_TREE_ITEM
+{
+public:
+    TEST_LIB_TREE_ITEM( const wxString& aLibName, const wxString& aName,
+                        const wxString& aSearchText ) :
+        m_libName( aLibName ),
+        m_name( aName ),
+        m_searchText( aSearchText )
+    {
+    }
+
+    LIB_ID GetLibId() const override { return LIB_ID( m_libName, m_name ); }
+
+    const wxString& GetName() const override { return m_name; }
+    wxString GetLibNickname() const override { return m_libName; }
+
+    const wxString& GetDescription() override { return m_searchText; }
+
+    wxString GetSearchText() override { return m_searchText; }
+
+private:
+    wxString m_libName;
+    wxString m_name;
+    wxString m_searchText;
+};
+
+
+/**
+ * Two libraries, with ASCII and non ASCII names and search texts
+ */
+struct LIB_TREE_MODEL_FIXTURE
+{
+    LIB_TREE_MODEL_FIXTURE()
+    {
+        const std::vector<std::vector<const char*>> items = {
+            { "Device", "R_0805", "resistor res 0805 smd" },
+            { "Device", "R_0603", "resistor res 0603 smd" },
+            { "Device", "C_0805", "capacitor cap 0805 smd" },
+            { "Device", "L_Ω", "inductor 10µH" },
+            { "Device", "R_Résistance", "résistance variable" },
+            { "Amplifier", "LM358", "dual operational amplifier" },
+            { "Amplifier", "µA741", "single operational amplifier" },
+            { "Amplifier", "電源IC", "電源 regulator" },
+            { "Amplifier", "Résistance_Amp", "" },
+        };
+
+        for( const auto& item : items )
+        {
+            m_items.emplace_back( new TEST_LIB_TREE_ITEM( wxString::FromUTF8( item[0] ),
+                                                          wxString::FromUTF8( item[1] ),
+                                                          wxString::FromUTF8( item[2] ) ) );
+        }
+
+        LIB_TREE_NODE_LIB& device = m_tree.AddLib( "Device", "" );
+        LIB_TREE_NODE_LIB& amplifier = m_tree.AddLib( "Amplifier", "" );
+
+        for( const auto& item : m_items )
+        {
+            if( item->GetLibNickname() == "Device" )
+                device.AddItem( item.get() );
+            else
+                amplifier.AddItem( item.get() );
+        }
+    }
+
+    /**
+     * @return the scores of all the items for aSearch, scored as the tree model adapter
+     * does, in library and item order
+     */
+    std::vector<int> search( const wxString& aSearch )
+    {
+        m_tree.ResetScore();
+
+        wxStringTokenizer tokenizer( aSearch );
+
+        while( tokenizer.HasMoreTokens() )
+        {
+            const wxString       term = tokenizer.GetNextToken().Lower();
+            EDA_COMBINED_MATCHER matcher( term );
+
+            m_tree.UpdateScore( matcher );
+        }
+
+        std::vector<int> scores;
+
+        for( auto& lib : m_tree.Children )
+        {
+            for( auto& item : lib->Children )
+                scores.push_back( item->Score );
+        }
+
+        return scores;
+    }
+
+    void checkScores( const wxString& aSearch, const std::vector<int>& aExpected )
+    {
+        BOOST_TEST_CONTEXT( aSearch.ToUTF8().data() )
+        {
+            std::vector<int> scores = search( aSearch );
+
+            BOOST_CHECK_EQUAL_COLLECTIONS(
+                    scores.begin(), scores.end(), aExpected.begin(), aExpected.end() );
+        }
+    }
+
+    std::vector<std::unique_ptr<TEST_LIB_TREE_ITEM>> m_items;
+    LIB_TREE_NODE_ROOT                               m_tree;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( LibTreeModel, LIB_TREE_MODEL_FIXTURE )
+
+
+/**
+ * Terms shorter than a trigram are not narrowed by the index: a single character scores
+ * in the names, but not in the search texts
+ */
+BOOST_AUTO_TEST_CASE( ShortTerms )
+{
+    checkScores( "", { 1, 1, 1, 1, 1, 1, 1, 1, 1 } );
+    checkScores( "r", { 47, 47, 7, 7, 47, 26, 26, 26, 47 } );
+}
+
+
+/**
+ * Plain terms, narrowed by the index
+ */
+BOOST_AUTO_TEST_CASE( PlainTerms )
+{
+    checkScores( "r_0805", { 1001, 0, 0, 0, 0, 0, 0, 0, 0 } );
+    checkScores( "0805", { 45, 0, 45, 0, 0, 0, 0, 0, 0 } );
+    checkScores( "res smd", { 32, 32, 0, 0, 0, 0, 0, 0, 0 } );
+    checkScores( "xyz", { 0, 0, 0, 0, 0, 0, 0, 0, 0 } );
+}
+
+
+/**
+ * Terms found in a library name match all its items
+ */
+BOOST_AUTO_TEST_CASE( LibraryNameTerms )
+{
+    checkScores( "device", { 26, 26, 26, 26, 26, 0, 0, 0, 0 } );
+    checkScores( "amp", { 0, 0, 0, 0, 0, 26, 26, 26, 36 } );
+}
+
+
+/**
+ * Non ASCII terms, made of multibyte characters
+ */
+BOOST_AUTO_TEST_CASE( NonAsciiTerms )
+{
+    checkScores( wxString::FromUTF8( "résis" ), { 0, 0, 0, 0, 45, 0, 0, 0, 47 } );
+    checkScores( wxString::FromUTF8( "µa741" ), { 0, 0, 0, 0, 0, 0, 1001, 0, 0 } );
+    checkScores( wxString::FromUTF8( "電源 reg" ), { 0, 0, 0, 0, 0, 0, 0, 68, 0 } );
+}
+
+
+/**
+ * Terms with wildcard or regex syntax can match items without their trigrams
+ */
+BOOST_AUTO_TEST_CASE( PatternTerms )
+{
+    checkScores( "r_*805", { 43, 0, 0, 0, 0, 0, 0, 0, 0 } );
+    checkScores( "lm?58", { 0, 0, 0, 0, 0, 43, 0, 0, 0 } );
+    checkScores( "^lm3", { 0, 0, 0, 0, 0, 43, 0, 0, 0 } );
+    checkScores( "cap|res", { 21, 21, 21, 0, 0, 0, 0, 0, 0 } );
+}
+
+
+/**
+ * The index follows the items added after a search
+ */
+BOOST_AUTO_TEST_CASE( AddedItem )
+{
+    checkScores( "0402", { 0, 0, 0, 0, 0, 0, 0, 0, 0 } );
+
+    m_items.emplace_back( new TEST_LIB_TREE_ITEM( "Device", "R_0402", "resistor res 0402" ) );
+
+    auto& device = static_cast<LIB_TREE_NODE_LIB&>( *m_tree.Children[0] );
+    device.AddItem( m_items.back().get() );
+
+    checkScores( "0402", { 0, 0, 0, 0, 0, 45, 0, 0, 0, 0 } );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
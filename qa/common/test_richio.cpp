@@ -0,0 +1,187 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the line readers
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+// Code under test
+#include <richio.h>
+
+
+/**
+ * A temporary file holding a given text, removed at the end of the test
+ */
+class TEMP_TEXT_FILE
+{
+public:
+    TEMP_TEXT_FILE( const std::string& aText )
+    {
+        m_fileName = wxFileName::CreateTempFileName( wxT( "qa_richio" ) );
+
+        wxFFile file( m_fileName, wxT( "wb" ) );
+        file.Write( aText.data(), aText.size() );
+    }
+
+    ~TEMP_TEXT_FILE()
+    {
+        wxRemoveFile( m_fileName );
+    }
+
+    const wxString& GetFileName() const
+    {
+        return m_fileName;
+    }
+
+private:
+    wxString m_fileName;
+};
+
+
+/**
+ * Reads all the lines of aReader with ReadLineInPlace()
+ */
+static std::vector<std::string> readLinesInPlace( LINE_READER& aReader )
+{
+    std::vector<std::string> lines;
+    unsigned                 length = 0;
+
+    while( const char* line = aReader.ReadLineInPlace( &length ) )
+        lines.emplace_back( line, length );
+
+    // The end of the text is still reported after it was reached
+    BOOST_CHECK( aReader.ReadLineInPlace( &length ) == nullptr );
+    BOOST_CHECK_EQUAL( length, 0u );
+
+    return lines;
+}
+
+
+struct IN_PLACE_CASE
+{
+    std::string              m_name;
+    std::string              m_text;
+    std::vector<std::string> m_lines;   ///< the expected lines, with their line ends
+};
+
+
+static const std::vector<IN_PLACE_CASE> in_place_cases = {
+    { "empty", "", {} },
+    { "single line", "abc\n", { "abc\n" } },
+    { "no trailing newline", "abc\ndef", { "abc\n", "def" } },
+    { "crlf", "abc\r\ndef\r\n", { "abc\r\n", "def\r\n" } },
+    { "empty lines", "\n\nabc\n", { "\n", "\n", "abc\n" } },
+};
+
+
+BOOST_AUTO_TEST_SUITE( RichIo )
+
+
+BOOST_AUTO_TEST_CASE( StringReadLineInPlace )
+{
+    for( const auto& c : in_place_cases )
+    {
+        BOOST_TEST_CONTEXT( c.m_name )
+        {
+            STRING_LINE_READER reader( c.m_text, wxT( "test" ) );
+            std::vector<std::string> lines = readLinesInPlace( reader );
+
+            BOOST_CHECK_EQUAL_COLLECTIONS(
+                    lines.begin(), lines.end(), c.m_lines.begin(), c.m_lines.end() );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( MappedReadLineInPlace )
+{
+    for( const auto& c : in_place_cases )
+    {
+        BOOST_TEST_CONTEXT( c.m_name )
+        {
+            TEMP_TEXT_FILE file( c.m_text );
+
+            // Map any non empty file
+            MAPPED_FILE_LINE_READER reader(
+                    file.GetFileName(), 0, LINE_READER_LINE_DEFAULT_MAX, 1 );
+
+            BOOST_CHECK_EQUAL( reader.IsMapped(), !c.m_text.empty() );
+
+            std::vector<std::string> lines = readLinesInPlace( reader );
+
+            BOOST_CHECK_EQUAL_COLLECTIONS(
+                    lines.begin(), lines.end(), c.m_lines.begin(), c.m_lines.end() );
+
+            // The line number is also incremented by the reads at the end of the file
+            BOOST_CHECK_EQUAL( reader.LineNumber(), c.m_lines.size() + 2 );
+        }
+    }
+}
+
+
+/**
+ * Small files are read with stdio, and give the same lines
+ */
+BOOST_AUTO_TEST_CASE( UnmappedReadLineInPlace )
+{
+    for( const auto& c : in_place_cases )
+    {
+        BOOST_TEST_CONTEXT( c.m_name )
+        {
+            TEMP_TEXT_FILE          file( c.m_text );
+            MAPPED_FILE_LINE_READER reader( file.GetFileName() );
+
+            BOOST_CHECK( !reader.IsMapped() );
+
+            std::vector<std::string> lines = readLinesInPlace( reader );
+
+            BOOST_CHECK_EQUAL_COLLECTIONS(
+                    lines.begin(), lines.end(), c.m_lines.begin(), c.m_lines.end() );
+        }
+    }
+}
+
+
+/**
+ * ReadLine() of a mapped file gives nul terminated copies of the lines
+ */
+BOOST_AUTO_TEST_CASE( MappedReadLine )
+{
+    TEMP_TEXT_FILE          file( "abc\r\ndef" );
+    MAPPED_FILE_LINE_READER reader( file.GetFileName(), 0, LINE_READER_LINE_DEFAULT_MAX, 1 );
+
+    BOOST_REQUIRE( reader.IsMapped() );
+
+    BOOST_CHECK_EQUAL( std::string( reader.ReadLine() ), "abc\r\n" );
+    BOOST_CHECK_EQUAL( std::string( reader.ReadLine() ), "def" );
+    BOOST_CHECK( reader.ReadLine() == nullptr );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
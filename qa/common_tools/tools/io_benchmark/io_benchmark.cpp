@@ -25,6 +25,7 @@
 
 #include <wx/wx.h>
 #include <richio.h>
+#include <dsnlexer.h>
 
 #include <chrono>
 #include <ios>
@@ -157,6 +158,75 @@ static void bench_line_reader_reuse( const wxFileName& aFile, int aReps, BENCH_R
 }
 
 
+/**
+ * Benchmark using a given LINE_READER implementation, reading the lines
+ * in place (without copy when the reader supports it).
+ * The LINE_READER is recreated for each cycle.
+ */
+template<typename LR>
+static void bench_line_reader_in_place( const wxFileName& aFile, int aReps, BENCH_REPORT& report )
+{
+    for( int i = 0; i < aReps; ++i)
+    {
+        LR fstr( aFile.GetFullPath() );
+        unsigned len;
+
+        while( const char* line = fstr.ReadLineInPlace( &len ) )
+        {
+            report.linesRead++;
+            report.charAcc += (unsigned char) line[0];
+        }
+    }
+}
+
+
+/**
+ * Benchmark using a given LINE_READER implementation, reading the lines
+ * in place (without copy when the reader supports it).
+ * The LINE_READER is rewound for each cycle, not recreated.
+ */
+template<typename LR>
+static void bench_line_reader_in_place_reuse( const wxFileName& aFile, int aReps,
+                                              BENCH_REPORT& report )
+{
+    LR fstr( aFile.GetFullPath() );
+    for( int i = 0; i < aReps; ++i)
+    {
+        unsigned len;
+
+        while( const char* line = fstr.ReadLineInPlace( &len ) )
+        {
+            report.linesRead++;
+            report.charAcc += (unsigned char) line[0];
+        }
+
+        fstr.Rewind();
+    }
+}
+
+
+/**
+ * Benchmark tokenizing the file with a DSNLEXER reading from a given
+ * LINE_READER implementation. Each token counts as a "line".
+ * The LINE_READER is recreated for each cycle.
+ */
+template<typename LR>
+static void bench_lexer( const wxFileName& aFile, int aReps, BENCH_REPORT& report )
+{
+    for( int i = 0; i < aReps; ++i)
+    {
+        LR fstr( aFile.GetFullPath() );
+        DSNLEXER lexer( nullptr, 0, &fstr );
+
+        while( lexer.NextTok() != DSN_EOF )
+        {
+            report.linesRead++;
+            report.charAcc += (unsigned char) lexer.CurText()[0];
+        }
+    }
+}
+
+
 /**
  * Benchmark using STRING_LINE_READER on string data read into memory from a file
  * using std::ifstream, but read the data fresh from the file each time
@@ -313,8 +383,14 @@ static std::vector<BENCHMARK> benchmarkList =
     { 'F', bench_fstream_reuse, "std::fstream, reused" },
     { 'r', bench_line_reader<FILE_LINE_READER>, "RichIO FILE_L_R" },
     { 'R', bench_line_reader_reuse<FILE_LINE_READER>, "RichIO FILE_L_R, reused" },
+    { 'm', bench_line_reader<MAPPED_FILE_LINE_READER>, "RichIO MAPPED_FILE_L_R" },
+    { 'M', bench_line_reader_reuse<MAPPED_FILE_LINE_READER>, "RichIO MAPPED_FILE_L_R, reused" },
+    { 'p', bench_line_reader_in_place<MAPPED_FILE_LINE_READER>, "RichIO MAPPED_FILE_L_R, in place" },
+    { 'P', bench_line_reader_in_place_reuse<MAPPED_FILE_LINE_READER>, "RichIO MAPPED_FILE_L_R, in place, reused" },
     { 'n', bench_line_reader<IFSTREAM_LINE_READER>, "std::ifstream L_R" },
     { 'N', bench_line_reader_reuse<IFSTREAM_LINE_READER>, "std::ifstream L_R, reused" },
+    { 'l', bench_lexer<FILE_LINE_READER>, "DSNLEXER, FILE_L_R" },
+    { 'L', bench_lexer<MAPPED_FILE_LINE_READER>, "DSNLEXER, MAPPED_FILE_L_R" },
     { 's', bench_string_lr, "RichIO STRING_L_R"},
     { 'S', bench_string_lr_reuse, "RichIO STRING_L_R, reused"},
     { 'w', bench_wxis<wxFileInputStream>, "wxFileIStream" },
@@ -0,0 +1,273 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the net codes of the schematic netlist items
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+
+#include <sch_sheet.h>
+#include <sch_sheet_path.h>
+
+// Code under test
+#include <netlist_object.h>
+
+
+/**
+ * A root sheet using the same sub sheet twice, connected by sheet pins, local, global,
+ * power and bus labels.  Each item is given the net it belongs to, checked by hand.
+ */
+struct NETLIST_OBJECT_LIST_FIXTURE
+{
+    ///> The expected nets of the items
+    enum NET
+    {
+        BUS = 0,            ///< bus segments: in no net
+        ROOT_IN_A,          ///< root wires, CLK labels of the root and IN of the first instance
+        ROOT_IN_B,          ///< second sheet pin IN, and IN of the second instance
+        VCC,
+        GND,
+        UNCONNECTED,
+        NO_CONNECT,
+        D0,
+        D1,
+        CLK_A,              ///< local label CLK of the first instance
+        CLK_B,              ///< local label CLK of the second instance
+        OUT,                ///< hierarchical label without sheet pin
+        NET_COUNT
+    };
+
+    NETLIST_OBJECT_LIST_FIXTURE()
+    {
+        m_rootSheet.SetTimeStamp( 1 );
+        m_sheetA.SetTimeStamp( 2 );
+        m_sheetB.SetTimeStamp( 3 );
+
+        m_root.push_back( &m_rootSheet );
+        m_pathA = m_root;
+        m_pathA.push_back( &m_sheetA );
+        m_pathB = m_root;
+        m_pathB.push_back( &m_sheetB );
+
+        // Root sheet: a pin wired to a local label, and through a junction to a sheet pin
+        add( ROOT_IN_A, NET_PIN, m_root, wxPoint( 0, 0 ) );
+        add( ROOT_IN_A, NET_SEGMENT, m_root, wxPoint( 0, 0 ), wxPoint( 1000, 0 ) );
+        add( ROOT_IN_A, NET_SEGMENT, m_root, wxPoint( 1000, 0 ), wxPoint( 1000, 1000 ) );
+        add( ROOT_IN_A, NET_LABEL, m_root, wxPoint( 500, 0 ), wxPoint( 500, 0 ), "CLK" );
+        add( ROOT_IN_A, NET_SEGMENT, m_root, wxPoint( 1000, 500 ), wxPoint( 2000, 500 ) );
+        add( ROOT_IN_A, NET_JUNCTION, m_root, wxPoint( 1000, 500 ) );
+        add( ROOT_IN_A, NET_SHEETLABEL, m_root, wxPoint( 2000, 500 ), wxPoint( 2000, 500 ),
+             "IN" )->m_SheetPathInclude = m_pathA;
+
+        // The same sheet pin name for the other instance of the sub sheet
+        add( ROOT_IN_B, NET_SHEETLABEL, m_root, wxPoint( 2000, 1500 ), wxPoint( 2000, 1500 ),
+             "IN" )->m_SheetPathInclude = m_pathB;
+        add( ROOT_IN_B, NET_SEGMENT, m_root, wxPoint( 2000, 1500 ), wxPoint( 3000, 1500 ) );
+        add( ROOT_IN_B, NET_PIN, m_root, wxPoint( 3000, 1500 ) );
+
+        add( VCC, NET_GLOBLABEL, m_root, wxPoint( 4000, 0 ), wxPoint( 4000, 0 ), "VCC" );
+        add( VCC, NET_PIN, m_root, wxPoint( 4000, 0 ) );
+
+        add( GND, NET_PINLABEL, m_root, wxPoint( 7000, 0 ), wxPoint( 7000, 0 ), "GND" );
+        add( GND, NET_PIN, m_root, wxPoint( 7000, 0 ) );
+
+        add( UNCONNECTED, NET_PIN, m_root, wxPoint( 5000, 0 ) );
+        add( NO_CONNECT, NET_PIN, m_root, wxPoint( 6000, 0 ) );
+        add( NO_CONNECT, NET_NOCONNECT, m_root, wxPoint( 6000, 0 ) );
+
+        // A second local label of the same name, at the end of a wire
+        add( ROOT_IN_A, NET_SEGMENT, m_root, wxPoint( 0, 2000 ), wxPoint( 500, 2000 ) );
+        add( ROOT_IN_A, NET_PIN, m_root, wxPoint( 0, 2000 ) );
+        add( ROOT_IN_A, NET_LABEL, m_root, wxPoint( 500, 2000 ), wxPoint( 500, 2000 ), "CLK" );
+
+        // A bus in two segments, with the members of a bus label at each end, and a local
+        // label named as the first member
+        m_busItems.push_back( add( BUS, NET_BUS, m_root, wxPoint( 0, 3000 ),
+                                   wxPoint( 1000, 3000 ) ) );
+        m_busItems.push_back( add( BUS, NET_BUS, m_root, wxPoint( 1000, 3000 ),
+                                   wxPoint( 1000, 4000 ) ) );
+        m_busItems.push_back( add( D0, NET_BUSLABELMEMBER, m_root, wxPoint( 0, 3000 ),
+                                   wxPoint( 0, 3000 ), "D0", 0 ) );
+        m_busItems.push_back( add( D1, NET_BUSLABELMEMBER, m_root, wxPoint( 0, 3000 ),
+                                   wxPoint( 0, 3000 ), "D1", 1 ) );
+        m_busItems.push_back( add( D0, NET_BUSLABELMEMBER, m_root, wxPoint( 1000, 4000 ),
+                                   wxPoint( 1000, 4000 ), "BUS0", 0 ) );
+        m_busItems.push_back( add( D1, NET_BUSLABELMEMBER, m_root, wxPoint( 1000, 4000 ),
+                                   wxPoint( 1000, 4000 ), "BUS1", 1 ) );
+        add( D0, NET_LABEL, m_root, wxPoint( 3000, 3000 ), wxPoint( 3000, 3000 ), "D0" );
+        add( D0, NET_PIN, m_root, wxPoint( 3000, 3000 ) );
+
+        // The two instances of the sub sheet
+        for( const SCH_SHEET_PATH* path : { &m_pathA, &m_pathB } )
+        {
+            NET in = path == &m_pathA ? ROOT_IN_A : ROOT_IN_B;
+            NET clk = path == &m_pathA ? CLK_A : CLK_B;
+
+            add( in, NET_HIERLABEL, *path, wxPoint( 0, 0 ), wxPoint( 0, 0 ), "IN" );
+            add( in, NET_SEGMENT, *path, wxPoint( 0, 0 ), wxPoint( 1000, 0 ) );
+            add( in, NET_PIN, *path, wxPoint( 1000, 0 ) );
+
+            add( VCC, NET_PIN, *path, wxPoint( 2000, 0 ) );
+            add( VCC, NET_GLOBLABEL, *path, wxPoint( 2000, 0 ), wxPoint( 2000, 0 ), "VCC" );
+
+            add( clk, NET_PIN, *path, wxPoint( 3000, 0 ) );
+            add( clk, NET_LABEL, *path, wxPoint( 3000, 0 ), wxPoint( 3000, 0 ), "CLK" );
+
+            add( GND, NET_PIN, *path, wxPoint( 4000, 0 ) );
+            add( GND, NET_PINLABEL, *path, wxPoint( 4000, 0 ), wxPoint( 4000, 0 ), "GND" );
+        }
+
+        add( OUT, NET_PIN, m_pathA, wxPoint( 5000, 0 ) );
+        add( OUT, NET_HIERLABEL, m_pathA, wxPoint( 5000, 0 ), wxPoint( 5000, 0 ), "OUT" );
+    }
+
+    NETLIST_OBJECT* add( NET aNet, NETLIST_ITEM_T aType, const SCH_SHEET_PATH& aPath,
+                         const wxPoint& aStart, const wxPoint& aEnd,
+                         const wxString& aLabel = wxEmptyString, int aMember = 0 )
+    {
+        m_list.emplace_back( new NETLIST_OBJECT() );
+        m_nets.push_back( aNet );
+
+        NETLIST_OBJECT* item = m_list.back().get();
+        item->m_Type = aType;
+        item->m_SheetPath = aPath;
+        item->m_Start = aStart;
+        item->m_End = aEnd;
+        item->m_Label = aLabel;
+        item->m_Member = aMember;
+
+        return item;
+    }
+
+    NETLIST_OBJECT* add( NET aNet, NETLIST_ITEM_T aType, const SCH_SHEET_PATH& aPath,
+                         const wxPoint& aPos )
+    {
+        return add( aNet, aType, aPath, aPos, aPos );
+    }
+
+    /**
+     * Resolves the connections of copies of the fixture items, given to the list in
+     * order or in reverse order
+     * @return the net code and the bus net code of each fixture item, in fixture order
+     */
+    std::vector<std::pair<int, int>> resolve( bool aReversed )
+    {
+        NETLIST_OBJECT_LIST          list;
+        std::vector<NETLIST_OBJECT*> copies;
+
+        for( const auto& item : m_list )
+            copies.push_back( new NETLIST_OBJECT( *item ) );
+
+        for( size_t ii = 0; ii < copies.size(); ii++ )
+            list.push_back( copies[aReversed ? copies.size() - 1 - ii : ii] );
+
+        BOOST_REQUIRE( list.ResolveConnections() );
+
+        std::vector<std::pair<int, int>> codes;
+
+        for( NETLIST_OBJECT* item : copies )
+            codes.emplace_back( item->GetNet(), item->m_BusNetCode );
+
+        return codes;
+    }
+
+    SCH_SHEET      m_rootSheet;
+    SCH_SHEET      m_sheetA;
+    SCH_SHEET      m_sheetB;
+    SCH_SHEET_PATH m_root;
+    SCH_SHEET_PATH m_pathA;
+    SCH_SHEET_PATH m_pathB;
+
+    std::vector<std::unique_ptr<NETLIST_OBJECT>> m_list;
+    std::vector<NET>                             m_nets;        ///< expected net of each item
+    std::vector<NETLIST_OBJECT*>                 m_busItems;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( NetlistObjectList, NETLIST_OBJECT_LIST_FIXTURE )
+
+
+/**
+ * The items are in the expected nets, whatever their order in the list: bus segments
+ * have no net code, the nets have consecutive codes from 1
+ */
+BOOST_AUTO_TEST_CASE( ExpectedNets )
+{
+    for( bool reversed : { false, true } )
+    {
+        BOOST_TEST_CONTEXT( "Reversed list " << reversed )
+        {
+            std::vector<std::pair<int, int>> codes = resolve( reversed );
+            std::map<NET, int>               netCodes;
+            std::set<int>                    usedCodes;
+
+            for( size_t ii = 0; ii < codes.size(); ii++ )
+            {
+                BOOST_TEST_CONTEXT( "Item " << ii )
+                {
+                    int code = codes[ii].first;
+                    auto it = netCodes.emplace( m_nets[ii], code ).first;
+
+                    BOOST_CHECK_EQUAL( code, it->second );
+                    usedCodes.insert( code );
+                }
+            }
+
+            BOOST_CHECK_EQUAL( netCodes[BUS], 0 );
+
+            // A different code for each net
+            BOOST_CHECK_EQUAL( netCodes.size(), (size_t) NET_COUNT );
+            BOOST_CHECK_EQUAL( usedCodes.size(), (size_t) NET_COUNT );
+            BOOST_CHECK_EQUAL( *usedCodes.rbegin(), NET_COUNT - 1 );
+        }
+    }
+}
+
+
+/**
+ * The bus segments and the members of the labels on the bus have the same bus net code
+ */
+BOOST_AUTO_TEST_CASE( BusNetCode )
+{
+    std::vector<std::pair<int, int>> codes = resolve( false );
+    std::set<int>                    busCodes;
+
+    for( size_t ii = 0; ii < m_list.size(); ii++ )
+    {
+        if( std::find( m_busItems.begin(), m_busItems.end(), m_list[ii].get() )
+                != m_busItems.end() )
+            busCodes.insert( codes[ii].second );
+    }
+
+    BOOST_CHECK_EQUAL( busCodes.size(), (size_t) 1 );
+    BOOST_CHECK_NE( *busCodes.begin(), 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,247 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "erc_benchmark.h"
+
+#include <iostream>
+
+#include <common.h>
+
+#include <general.h>
+#include <class_libentry.h>
+#include <lib_pin.h>
+#include <sch_component.h>
+#include <sch_line.h>
+#include <sch_marker.h>
+#include <sch_screen.h>
+#include <sch_sheet.h>
+#include <sch_sheet_path.h>
+#include <netlist_object.h>
+#include <erc.h>
+
+#include <qa_utils/scoped_timer.h>
+
+
+using ERC_DURATION = std::chrono::milliseconds;
+
+extern int DiagErc[PINTYPE_COUNT][PINTYPE_COUNT];
+extern int DefaultDiagErc[PINTYPE_COUNT][PINTYPE_COUNT];
+
+
+/**
+ * Build a library part with an input or output pin 1 on the left, and an output pin 2
+ * on the right.
+ */
+static std::unique_ptr<LIB_PART> buildPart( const wxString& aName, ELECTRICAL_PINTYPE aPin1Type )
+{
+    std::unique_ptr<LIB_PART> part( new LIB_PART( aName ) );
+    part->GetReferenceField().SetText( "U" );
+
+    LIB_PIN* pin = new LIB_PIN( part.get() );
+    pin->SetNumber( "1" );
+    pin->SetName( "A" );
+    pin->SetType( aPin1Type );
+    pin->SetPosition( wxPoint( -200, 0 ) );
+    part->AddDrawItem( pin );
+
+    pin = new LIB_PIN( part.get() );
+    pin->SetNumber( "2" );
+    pin->SetName( "Y" );
+    pin->SetType( PIN_OUTPUT );
+    pin->SetPosition( wxPoint( 200, 0 ) );
+    part->AddDrawItem( pin );
+
+    return part;
+}
+
+
+/**
+ * Build the screen shared by all the sheet instances: a chain of aComponentCount
+ * buffers, each output wired to the input of the next one.  One component out of 5
+ * has an output as pin 1, which gives a pin to pin error, and the ends of the chain
+ * are not connected.
+ */
+static SCH_SCREEN* buildSubScreen( int aComponentCount, LIB_PART& aBuffer, LIB_PART& aDriver )
+{
+    SCH_SCREEN* screen = new SCH_SCREEN( nullptr );
+
+    for( int ii = 0; ii < aComponentCount; ++ii )
+    {
+        wxPoint    pos( ii * 600, 0 );
+        LIB_PART&  part = ( ii % 5 == 4 ) ? aDriver : aBuffer;
+
+        screen->Append( new SCH_COMPONENT( part, LIB_ID( wxEmptyString, part.GetName() ),
+                                           nullptr, 1, 0, pos ) );
+
+        if( ii > 0 )
+        {
+            SCH_LINE* wire = new SCH_LINE( pos - wxPoint( 400, 0 ), LAYER_WIRE );
+            wire->SetEndPoint( pos - wxPoint( 200, 0 ) );
+            screen->Append( wire );
+        }
+    }
+
+    return screen;
+}
+
+
+/**
+ * @return the ERC markers of all the screens, as in the ERC report
+ */
+static std::vector<wxString> getMarkers()
+{
+    std::vector<wxString> markers;
+    SCH_SCREENS           screens;
+
+    for( SCH_SCREEN* screen = screens.GetFirst(); screen; screen = screens.GetNext() )
+    {
+        for( SCH_ITEM* item = screen->GetDrawItems(); item; item = item->Next() )
+        {
+            if( item->Type() == SCH_MARKER_T )
+                markers.push_back( static_cast<SCH_MARKER*>( item )->GetReporter()
+                                           .ShowReport( MILLIMETRES ) );
+        }
+    }
+
+    return markers;
+}
+
+
+int erc_benchmark_func( int argc, char* argv[] )
+{
+    auto& os = std::cout;
+
+    long sheetCount = 200;
+    long componentCount = 200;
+    long threadCount = 0;
+
+    if( argc >= 2 && !wxString( argv[1] ).ToLong( &sheetCount ) )
+        sheetCount = 0;
+
+    if( argc >= 3 )
+        wxString( argv[2] ).ToLong( &componentCount );
+
+    if( argc >= 4 )
+        wxString( argv[3] ).ToLong( &threadCount );
+
+    if( sheetCount <= 0 || componentCount <= 0 || threadCount < 0 )
+    {
+        os << "Usage: " << argv[0] << " [SHEETS] [COMPONENTS] [THREADS]\n\n";
+        os << "Runs the ERC tests of the nets of a synthetic hierarchy of SHEETS instances\n"
+              "(default 200) of a sheet of COMPONENTS components (default 200), on one\n"
+              "thread and on THREADS threads (default one per core), and checks that the\n"
+              "markers are the same.\n";
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    os << "ERC Bench Mark Util" << std::endl;
+    os << "  Sheets:         " << (int) sheetCount << std::endl;
+    os << "  Components:     " << (int) ( sheetCount * componentCount ) << std::endl;
+
+    // The pin to pin matrix is the default one of the ERC dialog
+    memcpy( DiagErc, DefaultDiagErc, sizeof( DiagErc ) );
+
+    std::unique_ptr<LIB_PART> buffer = buildPart( "BUF", PIN_INPUT );
+    std::unique_ptr<LIB_PART> driver = buildPart( "DRV", PIN_OUTPUT );
+
+    // The sheet list and the ERC use the global root sheet
+    SCH_SHEET* root = new SCH_SHEET();
+    root->SetScreen( new SCH_SCREEN( nullptr ) );
+    root->SetFileName( "erc_benchmark.sch" );
+    g_RootSheet = root;
+
+    SCH_SCREEN* subScreen = buildSubScreen( componentCount, *buffer, *driver );
+
+    for( int ii = 0; ii < sheetCount; ++ii )
+    {
+        SCH_SHEET* sheet = new SCH_SHEET( wxPoint( ii * 2000, 0 ) );
+        sheet->SetTimeStamp( ii + 1 );
+        sheet->SetName( wxString::Format( "Sheet%d", ii + 1 ) );
+        sheet->SetFileName( "erc_benchmark_sub.sch" );
+        sheet->SetScreen( subScreen );
+        root->GetScreen()->Append( sheet );
+    }
+
+    // Annotate each instance
+    SCH_SHEET_LIST sheets( root );
+    int            refNumber = 0;
+
+    for( SCH_SHEET_PATH& sheet : sheets )
+    {
+        for( SCH_ITEM* item = sheet.LastDrawList(); item; item = item->Next() )
+        {
+            if( item->Type() == SCH_COMPONENT_T )
+                static_cast<SCH_COMPONENT*>( item )->SetRef(
+                        &sheet, wxString::Format( "U%d", ++refNumber ) );
+        }
+    }
+
+    NETLIST_OBJECT_LIST netlist;
+    netlist.BuildNetListInfo( sheets );
+
+    os << "  Net items:      " << (int) netlist.size() << std::endl;
+    os << std::endl;
+
+    const unsigned threadCounts[] = { 1, (unsigned) threadCount };
+    std::vector<wxString> markers[2];
+
+    for( int ii = 0; ii < 2; ++ii )
+    {
+        SCH_SCREENS().DeleteAllMarkers( MARKER_BASE::MARKER_ERC );
+
+        ERC_DURATION duration;
+        {
+            SCOPED_TIMER<ERC_DURATION> timer( duration );
+            TestNetConnections( &netlist, true, true, threadCounts[ii] );
+        }
+
+        markers[ii] = getMarkers();
+
+        wxString threads = wxString::Format( "%u thread(s)", threadCounts[ii] );
+
+        if( threadCounts[ii] == 0 )
+            threads = "1 thread per core";
+
+        os << wxString::Format( "%-30s %d markers in %d ms", threads, (int) markers[ii].size(),
+                                (int) duration.count() )
+           << std::endl;
+    }
+
+    g_RootSheet = nullptr;
+    delete root;
+
+    if( markers[0] != markers[1] )
+    {
+        os << "The markers depend on the number of threads" << std::endl;
+        return KI_TEST::RET_CODES::TOOL_SPECIFIC;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+KI_TEST::UTILITY_PROGRAM erc_benchmark_tool = {
+    "erc_benchmark",
+    "Benchmark the ERC of a synthetic hierarchy with many sheet instances",
+    erc_benchmark_func,
+};
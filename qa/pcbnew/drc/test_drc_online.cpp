@@ -0,0 +1,179 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <memory>
+
+#include <class_board.h>
+#include <class_marker_pcb.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <drc.h>
+
+
+/**
+ * A board with three horizontal tracks far from each other, checked by a DRC without UI
+ * which follows its changes (the online DRC).
+ */
+struct DRC_ONLINE_FIXTURE
+{
+    DRC_ONLINE_FIXTURE() :
+        m_drc( &m_board, MILLIMETRES,
+               [&]( MARKER_PCB* aMarker )
+               {
+                   m_markers.emplace_back( aMarker );
+               } )
+    {
+        m_board.Add( new NETINFO_ITEM( &m_board, "GND", 1 ) );
+        m_board.Add( new NETINFO_ITEM( &m_board, "SIG", 2 ) );
+        m_board.SynchronizeNetsAndNetClasses();
+
+        m_trackA = addTrack( 0, 1 );
+        m_trackB = addTrack( Millimeter2iu( 10 ), 2 );
+        m_trackC = addTrack( Millimeter2iu( 20 ), 2 );
+
+        m_board.BuildConnectivity();
+
+        m_drc.SetBoard( &m_board );
+        m_drc.RunTests();
+
+        // Only the markers of the online checks are of interest
+        m_markers.clear();
+    }
+
+    TRACK* addTrack( int aY, int aNetCode )
+    {
+        TRACK* track = new TRACK( &m_board );
+        track->SetStart( wxPoint( 0, aY ) );
+        track->SetEnd( wxPoint( Millimeter2iu( 10 ), aY ) );
+        track->SetWidth( Millimeter2iu( 0.25 ) );
+        track->SetLayer( F_Cu );
+        track->SetNetCode( aNetCode );
+        m_board.Add( track );
+        return track;
+    }
+
+    /**
+     * @return the number of markers between aItemA and aItemB
+     */
+    int countMarkers( const BOARD_ITEM* aItemA, const BOARD_ITEM* aItemB ) const
+    {
+        int count = 0;
+
+        for( const std::unique_ptr<MARKER_PCB>& marker : m_markers )
+        {
+            const void* mainItem = marker->GetReporter().GetMainItemWeakRef();
+            const void* auxItem = marker->GetReporter().GetAuxItemWeakRef();
+
+            if( ( mainItem == aItemA && auxItem == aItemB )
+                || ( mainItem == aItemB && auxItem == aItemA ) )
+                count++;
+        }
+
+        return count;
+    }
+
+    // The board is destroyed after the DRC which listens to it
+    BOARD                                    m_board;
+    std::vector<std::unique_ptr<MARKER_PCB>> m_markers;
+    DRC                                      m_drc;
+    TRACK*                                   m_trackA;
+    TRACK*                                   m_trackB;
+    TRACK*                                   m_trackC;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( DrcOnline, DRC_ONLINE_FIXTURE )
+
+
+/**
+ * A track moved near another one by a commit gets a clearance marker
+ */
+BOOST_AUTO_TEST_CASE( MovedTrack )
+{
+    BOOST_CHECK_EQUAL( countMarkers( m_trackA, m_trackC ), 0 );
+
+    m_trackC->Move( wxPoint( 0, Millimeter2iu( 0.3 ) - m_trackC->GetStart().y ) );
+    m_board.NotifyItemsChanged( { m_trackC }, {} );
+
+    BOOST_CHECK_EQUAL( countMarkers( m_trackA, m_trackC ), 1 );
+}
+
+
+/**
+ * A track deleted without a commit (as done by the action plugins or the legacy canvas)
+ * must not be used by the next online check: the board is indexed again
+ */
+BOOST_AUTO_TEST_CASE( DeletedWithoutCommit )
+{
+    m_board.Remove( m_trackB );
+    delete m_trackB;
+    m_board.InvalidateIncrementalData();
+
+    // Move the track at the place of the deleted one, then next to the first one
+    m_trackC->Move( wxPoint( 0, Millimeter2iu( 10 ) - m_trackC->GetStart().y ) );
+    m_board.NotifyItemsChanged( { m_trackC }, {} );
+
+    BOOST_CHECK( m_markers.empty() );
+
+    m_trackC->Move( wxPoint( 0, Millimeter2iu( 0.3 ) - m_trackC->GetStart().y ) );
+    m_board.NotifyItemsChanged( { m_trackC }, {} );
+
+    BOOST_CHECK_EQUAL( m_markers.size(), 1u );
+    BOOST_CHECK_EQUAL( countMarkers( m_trackA, m_trackC ), 1 );
+}
+
+
+/**
+ * A zone filled near a track (as after a refill) is tested against the tracks under it
+ */
+BOOST_AUTO_TEST_CASE( ChangedZone )
+{
+    m_drc.SetSettings( true, false, true, false, false, true, wxEmptyString, false );
+    m_drc.RunTests();
+    m_markers.clear();
+
+    ZONE_CONTAINER* zone = new ZONE_CONTAINER( &m_board );
+    zone->SetLayer( F_Cu );
+    zone->SetNetCode( 1 );
+
+    SHAPE_POLY_SET fill;
+    fill.NewOutline();
+    fill.Append( 0, Millimeter2iu( 20.1 ) );
+    fill.Append( Millimeter2iu( 10 ), Millimeter2iu( 20.1 ) );
+    fill.Append( Millimeter2iu( 10 ), Millimeter2iu( 25 ) );
+    fill.Append( 0, Millimeter2iu( 25 ) );
+
+    zone->Outline()->Append( fill );
+    zone->SetFilledPolysList( fill );
+    zone->SetIsFilled( true );
+
+    m_board.Add( zone );
+    m_board.NotifyItemsChanged( { zone }, {} );
+
+    BOOST_CHECK_EQUAL( countMarkers( m_trackC, zone ), 1 );
+    BOOST_CHECK_EQUAL( countMarkers( m_trackB, zone ), 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
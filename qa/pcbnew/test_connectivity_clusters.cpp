@@ -0,0 +1,203 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_track.h>
+#include <connectivity/connectivity_algo.h>
+#include <connectivity/connectivity_data.h>
+
+
+/**
+ * A board with a net made of three chained tracks, T1 - T2 - T3, and a separate
+ * track T4 on the same net.
+ */
+struct CONNECTIVITY_CLUSTERS_FIXTURE
+{
+    CONNECTIVITY_CLUSTERS_FIXTURE()
+    {
+        m_board.Add( new NETINFO_ITEM( &m_board, "GND", 1 ) );
+
+        m_t1 = addTrack( 0, 10 );
+        m_t2 = addTrack( 10, 20 );
+        m_t3 = addTrack( 20, 30 );
+        m_t4 = addTrack( 40, 50 );
+
+        m_board.BuildConnectivity();
+    }
+
+    ~CONNECTIVITY_CLUSTERS_FIXTURE()
+    {
+        for( TRACK* track : m_removed )
+            delete track;
+    }
+
+    /// Adds a horizontal track on net 1, from aStartX to aEndX (mm)
+    TRACK* addTrack( int aStartX, int aEndX )
+    {
+        TRACK* track = new TRACK( &m_board );
+        track->SetStart( wxPoint( Millimeter2iu( aStartX ), 0 ) );
+        track->SetEnd( wxPoint( Millimeter2iu( aEndX ), 0 ) );
+        track->SetWidth( Millimeter2iu( 0.25 ) );
+        track->SetLayer( F_Cu );
+        track->SetNetCode( 1 );
+        m_board.Add( track );
+        return track;
+    }
+
+    void removeTrack( TRACK* aTrack )
+    {
+        m_board.Remove( aTrack );
+        m_removed.push_back( aTrack );
+    }
+
+    /**
+     * @return true if aItemA and aItemB are in the same cluster of aClusters
+     */
+    static bool sameCluster( const CN_CONNECTIVITY_ALGO::CLUSTERS& aClusters,
+                             const BOARD_CONNECTED_ITEM* aItemA,
+                             const BOARD_CONNECTED_ITEM* aItemB )
+    {
+        for( const CN_CLUSTER_PTR& cluster : aClusters )
+        {
+            if( cluster->Contains( aItemA ) )
+                return cluster->Contains( aItemB );
+        }
+
+        return false;
+    }
+
+    /**
+     * Checks that the clusters kept by the board connectivity are the clusters found by
+     * a connectivity built from scratch
+     */
+    void checkSameAsRebuild()
+    {
+        std::vector<BOARD_CONNECTED_ITEM*> items;
+
+        for( TRACK* track : m_board.Tracks() )
+            items.push_back( track );
+
+        const auto& clusters = m_board.GetConnectivity()->GetConnectivityAlgo()->GetClusters();
+
+        CN_CONNECTIVITY_ALGO rebuilt;
+        rebuilt.Build( &m_board );
+        const auto& expected = rebuilt.GetClusters();
+
+        for( BOARD_CONNECTED_ITEM* itemA : items )
+        {
+            for( BOARD_CONNECTED_ITEM* itemB : items )
+            {
+                BOOST_CHECK_EQUAL( sameCluster( clusters, itemA, itemB ),
+                                   sameCluster( expected, itemA, itemB ) );
+            }
+        }
+    }
+
+    const CN_CONNECTIVITY_ALGO::CLUSTERS& clusters()
+    {
+        return m_board.GetConnectivity()->GetConnectivityAlgo()->GetClusters();
+    }
+
+    BOARD               m_board;
+    TRACK*              m_t1;
+    TRACK*              m_t2;
+    TRACK*              m_t3;
+    TRACK*              m_t4;
+    std::vector<TRACK*> m_removed;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ConnectivityClusters, CONNECTIVITY_CLUSTERS_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( Initial )
+{
+    BOOST_CHECK( sameCluster( clusters(), m_t1, m_t3 ) );
+    BOOST_CHECK( !sameCluster( clusters(), m_t1, m_t4 ) );
+
+    checkSameAsRebuild();
+}
+
+
+/**
+ * Deleting the bridging track splits the cluster in two
+ */
+BOOST_AUTO_TEST_CASE( SplitByRemoval )
+{
+    clusters();
+    removeTrack( m_t2 );
+
+    BOOST_CHECK( !sameCluster( clusters(), m_t1, m_t3 ) );
+    BOOST_CHECK( !sameCluster( clusters(), m_t3, m_t4 ) );
+
+    checkSameAsRebuild();
+}
+
+
+/**
+ * Deleting a track at the end of a chain does not split it
+ */
+BOOST_AUTO_TEST_CASE( RemovalWithoutSplit )
+{
+    clusters();
+    removeTrack( m_t3 );
+
+    BOOST_CHECK( sameCluster( clusters(), m_t1, m_t2 ) );
+
+    checkSameAsRebuild();
+}
+
+
+/**
+ * Adding a track between two clusters merges them
+ */
+BOOST_AUTO_TEST_CASE( MergeByAddition )
+{
+    clusters();
+    TRACK* bridge = addTrack( 30, 40 );
+
+    BOOST_CHECK( sameCluster( clusters(), m_t1, m_t4 ) );
+    BOOST_CHECK( sameCluster( clusters(), bridge, m_t4 ) );
+
+    checkSameAsRebuild();
+}
+
+
+/**
+ * A split followed by a merge gives back a single cluster
+ */
+BOOST_AUTO_TEST_CASE( SplitThenMerge )
+{
+    clusters();
+    removeTrack( m_t2 );
+    BOOST_CHECK( !sameCluster( clusters(), m_t1, m_t3 ) );
+
+    addTrack( 5, 25 );
+    BOOST_CHECK( sameCluster( clusters(), m_t1, m_t3 ) );
+
+    checkSameAsRebuild();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
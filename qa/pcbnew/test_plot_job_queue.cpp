@@ -0,0 +1,167 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <fstream>
+#include <sstream>
+
+// For the temp directory logic: can be std::filesystem in C++17
+#include <boost/filesystem.hpp>
+
+#include <class_board.h>
+#include <class_track.h>
+#include <reporter.h>
+#include <plot_job_queue.h>
+
+
+/**
+ * A two layer board with tracks and vias on a few nets
+ */
+struct PLOT_JOB_QUEUE_FIXTURE
+{
+    PLOT_JOB_QUEUE_FIXTURE()
+    {
+        m_board.SetFileName( "qa_plot_job_queue.kicad_pcb" );
+
+        for( int net = 1; net <= 4; net++ )
+        {
+            m_board.Add( new NETINFO_ITEM( &m_board, wxString::Format( "N%d", net ), net ) );
+
+            wxPoint start( Millimeter2iu( 5 ), Millimeter2iu( 5 * net ) );
+            wxPoint end( Millimeter2iu( 30 ), Millimeter2iu( 5 * net ) );
+
+            TRACK* track = new TRACK( &m_board );
+            track->SetStart( start );
+            track->SetEnd( end );
+            track->SetWidth( Millimeter2iu( 0.25 * net ) );
+            track->SetLayer( net % 2 ? F_Cu : B_Cu );
+            track->SetNetCode( net );
+            m_board.Add( track );
+
+            VIA* via = new VIA( &m_board );
+            via->SetPosition( end );
+            via->SetEnd( end );
+            via->SetWidth( Millimeter2iu( 0.8 ) );
+            via->SetDrill( Millimeter2iu( 0.4 ) );
+            via->SetLayerPair( F_Cu, B_Cu );
+            via->SetNetCode( net );
+            m_board.Add( via );
+        }
+
+        m_board.SynchronizeNetsAndNetClasses();
+
+        m_plotOpts.SetFormat( PLOT_FORMAT_GERBER );
+    }
+
+    ~PLOT_JOB_QUEUE_FIXTURE()
+    {
+        for( const auto& dir : m_dirs )
+            boost::filesystem::remove_all( dir );
+    }
+
+    /**
+     * Plots the layers in a new directory
+     * @return the contents of the files, in layer order
+     */
+    std::vector<std::string> plot( unsigned aThreadCount )
+    {
+        boost::filesystem::path dir = boost::filesystem::temp_directory_path()
+                                      / boost::filesystem::unique_path( "qa_plot_%%%%%%%%" );
+        boost::filesystem::create_directory( dir );
+        m_dirs.push_back( dir );
+
+        PLOT_JOB_QUEUE           plotJobs( &m_board, m_plotOpts );
+        std::vector<std::string> fileNames;
+
+        for( PCB_LAYER_ID layer : { F_Cu, B_Cu, F_Mask, B_Mask } )
+        {
+            fileNames.push_back( ( dir / m_board.GetStandardLayerName( layer ).ToStdString() )
+                                         .string() + ".gbr" );
+            plotJobs.AddLayer( layer, fileNames.back() );
+        }
+
+        BOOST_REQUIRE_EQUAL( plotJobs.Run( NULL_REPORTER::GetInstance(), aThreadCount ), 0 );
+
+        std::vector<std::string> contents;
+
+        for( const std::string& fileName : fileNames )
+            contents.push_back( readWithoutDate( fileName ) );
+
+        return contents;
+    }
+
+    /**
+     * @return the file contents, without the lines of the plot date
+     */
+    static std::string readWithoutDate( const std::string& aFileName )
+    {
+        std::ifstream      file( aFileName );
+        std::ostringstream contents;
+        std::string        line;
+
+        BOOST_REQUIRE( file.good() );
+
+        while( std::getline( file, line ) )
+        {
+            if( line.find( "CreationDate" ) != std::string::npos
+                || line.find( "G04 Created by" ) != std::string::npos )
+                continue;
+
+            contents << line << '\n';
+        }
+
+        return contents.str();
+    }
+
+    BOARD                                m_board;
+    PCB_PLOT_PARAMS                      m_plotOpts;
+    std::vector<boost::filesystem::path> m_dirs;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( PlotJobQueue, PLOT_JOB_QUEUE_FIXTURE )
+
+
+/**
+ * The Gerber files plotted on several threads are the same as the files plotted one
+ * after the other (except for their plot date)
+ */
+BOOST_AUTO_TEST_CASE( SerialAndParallelSame )
+{
+    std::vector<std::string> serial = plot( 1 );
+    std::vector<std::string> parallel = plot( 4 );
+
+    BOOST_REQUIRE_EQUAL( serial.size(), parallel.size() );
+
+    for( size_t i = 0; i < serial.size(); i++ )
+    {
+        BOOST_TEST_CONTEXT( "Layer file " << i )
+        {
+            BOOST_CHECK( !serial[i].empty() );
+            BOOST_CHECK( serial[i] == parallel[i] );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
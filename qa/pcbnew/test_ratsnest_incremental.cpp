@@ -0,0 +1,173 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_track.h>
+#include <connectivity/connectivity_data.h>
+#include <ratsnest_data.h>
+
+
+/**
+ * A net made of four short tracks, which are not connected:
+ *
+ *   T0: (0, 0) - (1, 0) mm     T1: (4, 0) - (5, 0) mm
+ *   T3: (0, 8) - (1, 8) mm     T2: (4, 4) - (5, 4) mm
+ *
+ * The shortest lines are T0-T1 (3 mm), T1-T2 (4 mm) and T2-T3 (5 mm): the ratsnest is
+ * 12 mm long.
+ */
+struct RATSNEST_INCREMENTAL_FIXTURE
+{
+    RATSNEST_INCREMENTAL_FIXTURE()
+    {
+        m_board.Add( new NETINFO_ITEM( &m_board, "GND", 1 ) );
+
+        m_tracks.push_back( addTrack( 0, 0 ) );
+        m_tracks.push_back( addTrack( 4, 0 ) );
+        m_tracks.push_back( addTrack( 4, 4 ) );
+        m_tracks.push_back( addTrack( 0, 8 ) );
+
+        m_board.BuildConnectivity();
+    }
+
+    ~RATSNEST_INCREMENTAL_FIXTURE()
+    {
+        for( TRACK* track : m_removed )
+            delete track;
+    }
+
+    /**
+     * Adds a 1 mm horizontal track starting at ( aX, aY ) mm
+     */
+    TRACK* addTrack( int aX, int aY )
+    {
+        TRACK* track = new TRACK( &m_board );
+        track->SetStart( wxPoint( Millimeter2iu( aX ), Millimeter2iu( aY ) ) );
+        track->SetEnd( track->GetStart() + wxPoint( Millimeter2iu( 1 ), 0 ) );
+        track->SetWidth( Millimeter2iu( 0.25 ) );
+        track->SetLayer( F_Cu );
+        track->SetNetCode( 1 );
+        m_board.Add( track );
+        return track;
+    }
+
+    /**
+     * Updates the ratsnest from the previous one, and checks its number of lines and
+     * its length
+     */
+    void checkRatsnest( size_t aLineCount, int aLengthMm )
+    {
+        auto connectivity = m_board.GetConnectivity();
+        connectivity->RecalculateRatsnest();
+
+        const std::vector<CN_EDGE>& edges = connectivity->GetRatsnestForNet( 1 )->GetEdges();
+        int                         length = 0;
+
+        for( const CN_EDGE& edge : edges )
+            length += edge.GetWeight();
+
+        BOOST_CHECK_EQUAL( edges.size(), aLineCount );
+        BOOST_CHECK_EQUAL( length, Millimeter2iu( aLengthMm ) );
+    }
+
+    BOARD               m_board;
+    std::vector<TRACK*> m_tracks;
+    std::vector<TRACK*> m_removed;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( RatsnestIncremental, RATSNEST_INCREMENTAL_FIXTURE )
+
+
+/**
+ * The ratsnest built with the board
+ */
+BOOST_AUTO_TEST_CASE( Initial )
+{
+    checkRatsnest( 3, 12 );
+}
+
+
+/**
+ * T3 is moved next to T2, as a drag does: T3-T2 is 3 mm long, and T1-T2 or T0-T3 4 mm
+ */
+BOOST_AUTO_TEST_CASE( MovedTrack )
+{
+    checkRatsnest( 3, 12 );
+
+    m_tracks[3]->Move( wxPoint( 0, Millimeter2iu( -4 ) ) );
+    m_board.GetConnectivity()->Update( m_tracks[3] );
+
+    checkRatsnest( 3, 10 );
+}
+
+
+/**
+ * Without T1, T0 and T3 are connected to T2 by 5 mm lines.  A track added at (8, 0) mm
+ * is connected to T2 by a 5 mm line too.
+ */
+BOOST_AUTO_TEST_CASE( RemovedAndAddedTracks )
+{
+    checkRatsnest( 3, 12 );
+
+    m_board.Remove( m_tracks[1] );
+    m_removed.push_back( m_tracks[1] );
+
+    checkRatsnest( 2, 10 );
+
+    addTrack( 8, 0 );
+
+    checkRatsnest( 3, 15 );
+}
+
+
+/**
+ * The dynamic ratsnest of T3, shown while it is moved, links it to the nearest node of
+ * the rest of the net: the start of T2, 5 mm away
+ */
+BOOST_AUTO_TEST_CASE( DynamicRatsnest )
+{
+    auto                     connectivity = m_board.GetConnectivity();
+    std::vector<BOARD_ITEM*> movedItems = { m_tracks[3] };
+
+    connectivity->RecalculateRatsnest();
+    connectivity->ComputeDynamicRatsnest( movedItems );
+
+    std::vector<RN_DYNAMIC_LINE> lines;
+
+    for( const RN_DYNAMIC_LINE& line : connectivity->GetDynamicRatsnest() )
+    {
+        if( line.netCode == 1 )
+            lines.push_back( line );
+    }
+
+    BOOST_REQUIRE_EQUAL( lines.size(), 1u );
+    BOOST_CHECK_EQUAL( lines[0].a, VECTOR2I( Millimeter2iu( 4 ), Millimeter2iu( 4 ) ) );
+    BOOST_CHECK_EQUAL( lines[0].b, VECTOR2I( Millimeter2iu( 1 ), Millimeter2iu( 8 ) ) );
+
+    connectivity->ClearDynamicRatsnest();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
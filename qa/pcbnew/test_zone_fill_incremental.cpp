@@ -0,0 +1,170 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <memory>
+
+#include <class_board.h>
+#include <class_marker_pcb.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <connectivity/connectivity_data.h>
+#include <zone_filler.h>
+
+
+/**
+ * A board with a net 1 zone, a net 1 track which anchors the zone (so it is not an
+ * insulated island), and a net 2 track far from it, which makes a hole in the zone.
+ */
+struct ZONE_FILL_INCREMENTAL_FIXTURE
+{
+    ZONE_FILL_INCREMENTAL_FIXTURE()
+    {
+        m_board.Add( new NETINFO_ITEM( &m_board, "GND", 1 ) );
+        m_board.Add( new NETINFO_ITEM( &m_board, "SIG", 2 ) );
+        m_board.SynchronizeNetsAndNetClasses();
+
+        m_zone = new ZONE_CONTAINER( &m_board );
+        m_zone->SetLayer( F_Cu );
+        m_zone->SetNetCode( 1 );
+        m_zone->Outline()->NewOutline();
+        m_zone->Outline()->Append( 0, 0 );
+        m_zone->Outline()->Append( Millimeter2iu( 50 ), 0 );
+        m_zone->Outline()->Append( Millimeter2iu( 50 ), Millimeter2iu( 50 ) );
+        m_zone->Outline()->Append( 0, Millimeter2iu( 50 ) );
+        m_board.Add( m_zone );
+
+        m_board.Add( makeTrack( wxPoint( Millimeter2iu( 5 ), Millimeter2iu( 5 ) ), 1 ) );
+
+        m_track = makeTrack( m_probe, 2 );
+        m_board.Add( m_track );
+
+        m_board.BuildConnectivity();
+    }
+
+    TRACK* makeTrack( const wxPoint& aCentre, int aNetCode )
+    {
+        TRACK* track = new TRACK( &m_board );
+        track->SetStart( aCentre - wxPoint( Millimeter2iu( 2 ), 0 ) );
+        track->SetEnd( aCentre + wxPoint( Millimeter2iu( 2 ), 0 ) );
+        track->SetWidth( Millimeter2iu( 0.5 ) );
+        track->SetLayer( F_Cu );
+        track->SetNetCode( aNetCode );
+        return track;
+    }
+
+    bool fill()
+    {
+        ZONE_FILLER filler( &m_board );
+        filler.SetIncremental( true );
+        return filler.Fill( { m_zone } );
+    }
+
+    bool isProbeFilled() const
+    {
+        return m_zone->GetFilledPolysList().Contains( VECTOR2I( m_probe ) );
+    }
+
+    /**
+     * Change the net of the net 2 track, the way the connectivity does after a commit.
+     * @return the copy of the track before the change
+     */
+    std::unique_ptr<BOARD_ITEM> moveTrackToZoneNet()
+    {
+        std::unique_ptr<BOARD_ITEM> copy( static_cast<BOARD_ITEM*>( m_track->Clone() ) );
+        m_track->SetNetCode( 1 );
+        m_board.GetConnectivity()->Update( m_track );
+        return copy;
+    }
+
+    BOARD           m_board;
+    ZONE_CONTAINER* m_zone;
+    TRACK*          m_track;
+    const wxPoint   m_probe = wxPoint( Millimeter2iu( 40 ), Millimeter2iu( 40 ) );
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ZoneFillIncremental, ZONE_FILL_INCREMENTAL_FIXTURE )
+
+
+/**
+ * Without a dirty area, a filled zone is not computed again: its fill is the same as
+ * a full refill
+ */
+BOOST_AUTO_TEST_CASE( NothingDirty )
+{
+    BOOST_REQUIRE( fill() );
+    BOOST_REQUIRE( m_board.ZoneFillDirtyAreas().IsValid() );
+    BOOST_CHECK( m_board.ZoneFillDirtyAreas().GetAreas().empty() );
+
+    BOOST_REQUIRE( fill() );
+    BOOST_CHECK( !isProbeFilled() );
+
+    MD5_HASH incremental = m_zone->GetFilledPolysList().GetHash();
+
+    m_board.InvalidateIncrementalData();
+    BOOST_REQUIRE( fill() );
+    BOOST_CHECK( !isProbeFilled() );
+    BOOST_CHECK( incremental == m_zone->GetFilledPolysList().GetHash() );
+}
+
+
+/**
+ * A track whose net is changed by the connectivity is recorded with its old copy: the
+ * hole of its old net is filled by the next incremental refill, as by a full refill
+ */
+BOOST_AUTO_TEST_CASE( NetChange )
+{
+    BOOST_REQUIRE( fill() );
+    BOOST_CHECK( !isProbeFilled() );
+
+    std::unique_ptr<BOARD_ITEM> copy = moveTrackToZoneNet();
+    m_board.ZoneFillDirtyAreas().AddItem( m_track, copy.get() );
+
+    BOOST_REQUIRE( fill() );
+    BOOST_CHECK( isProbeFilled() );
+
+    SHAPE_POLY_SET incremental = m_zone->GetFilledPolysList();
+
+    m_board.InvalidateIncrementalData();
+    BOOST_REQUIRE( fill() );
+    BOOST_CHECK( isProbeFilled() );
+    BOOST_CHECK_EQUAL( incremental.OutlineCount(), m_zone->GetFilledPolysList().OutlineCount() );
+}
+
+
+/**
+ * Markers do not change the zones
+ */
+BOOST_AUTO_TEST_CASE( MarkersIgnored )
+{
+    BOOST_REQUIRE( fill() );
+
+    MARKER_PCB marker( &m_board );
+    m_board.ZoneFillDirtyAreas().AddItem( &marker );
+
+    BOOST_CHECK( m_board.ZoneFillDirtyAreas().GetAreas().empty() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
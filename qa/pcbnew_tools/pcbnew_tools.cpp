@@ -23,8 +23,12 @@
 
 #include <qa_utils/utility_program.h>
 
+#include "tools/batch_drc/batch_drc.h"
+#include "tools/batch_plot/batch_plot.h"
 #include "tools/drc_tool/drc_tool.h"
 #include "tools/pcb_parser/pcb_parser_tool.h"
+#include "tools/plot_benchmark/plot_benchmark.h"
+#include "tools/pns_replay/pns_replay.h"
 #include "tools/polygon_generator/polygon_generator.h"
 #include "tools/polygon_triangulation/polygon_triangulation.h"
 
@@ -35,8 +39,12 @@
  * it's effective enough. When you have a new tool, add it to this list.
  */
 const static std::vector<KI_TEST::UTILITY_PROGRAM*> known_tools = {
+    &batch_drc_tool,
+    &batch_plot_tool,
     &drc_tool,
     &pcb_parser_tool,
+    &plot_benchmark_tool,
+    &pns_replay_tool,
     &polygon_generator_tool,
     &polygon_triangulation_tool,
 };
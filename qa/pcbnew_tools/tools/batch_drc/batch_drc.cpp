@@ -0,0 +1,307 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "batch_drc.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <common.h>
+
+#include <wx/cmdline.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <class_board.h>
+#include <class_marker_pcb.h>
+#include <drc.h>
+#include <drc_item.h>
+
+#include <qa_utils/scoped_timer.h>
+
+
+using DRC_DURATION = std::chrono::microseconds;
+
+
+/**
+ * Format a string as a JSON string literal
+ */
+static std::string jsonString( const wxString& aStr )
+{
+    std::string out = "\"";
+
+    for( char c : std::string( TO_UTF8( aStr ) ) )
+    {
+        switch( c )
+        {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n";  break;
+        case '\r': out += "\\r";  break;
+        case '\t': out += "\\t";  break;
+
+        default:
+            if( (unsigned char) c < 0x20 )
+            {
+                char buf[8];
+                snprintf( buf, sizeof( buf ), "\\u%04x", (unsigned char) c );
+                out += buf;
+            }
+            else
+            {
+                out += c;
+            }
+        }
+    }
+
+    return out + "\"";
+}
+
+
+/**
+ * Write the DRC report in JSON:
+ *
+ * {
+ *   "board": "file.kicad_pcb",
+ *   "time_us": 12345,
+ *   "violations": 3,
+ *   "tests": [ { "name": "track_clearance", "time_us": 1234, "violations": 2 }, ... ],
+ *   "markers": [ { "code": 4, "description": "...", "item_a": "...", "item_b": "..." }, ... ]
+ * }
+ */
+static void writeReport( std::ostream& aStream, const std::string& aFilename,
+                         const DRC_DURATION& aDuration, const DRC& aDrc,
+                         const std::vector<std::unique_ptr<MARKER_PCB>>& aMarkers,
+                         bool aListMarkers )
+{
+    const std::vector<DRC::TEST_STATS>& stats = aDrc.GetTestStats();
+    int                                 violations = 0;
+
+    for( const DRC::TEST_STATS& test : stats )
+        violations += test.m_violations;
+
+    aStream << "{\n";
+    aStream << "  \"board\": " << jsonString( aFilename ) << ",\n";
+    aStream << "  \"time_us\": " << aDuration.count() << ",\n";
+    aStream << "  \"violations\": " << violations << ",\n";
+    aStream << "  \"tests\": [";
+
+    for( size_t ii = 0; ii < stats.size(); ++ii )
+    {
+        aStream << ( ii ? ",\n" : "\n" );
+        aStream << "    { \"name\": " << jsonString( stats[ii].m_name )
+                << ", \"time_us\": " << stats[ii].m_duration.count()
+                << ", \"violations\": " << stats[ii].m_violations << " }";
+    }
+
+    aStream << "\n  ]";
+
+    if( aListMarkers )
+    {
+        aStream << ",\n  \"markers\": [";
+
+        for( size_t ii = 0; ii < aMarkers.size(); ++ii )
+        {
+            const DRC_ITEM& item = aMarkers[ii]->GetReporter();
+
+            aStream << ( ii ? ",\n" : "\n" );
+            aStream << "    { \"code\": " << item.GetErrorCode()
+                    << ", \"description\": " << jsonString( item.GetErrorText() )
+                    << ", \"item_a\": " << jsonString( item.GetMainText() );
+
+            if( item.HasSecondItem() )
+                aStream << ", \"item_b\": " << jsonString( item.GetAuxiliaryText() );
+
+            aStream << " }";
+        }
+
+        aStream << "\n  ]";
+    }
+
+    aStream << "\n}" << std::endl;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "v",
+            "verbose",
+            _( "print progress information" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "z",
+            "refill-zones",
+            _( "refill all the zones before running the DRC" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "Z",
+            "zone-clearance",
+            _( "test the clearance between tracks and copper zones" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "a",
+            "all-track-errors",
+            _( "report all the errors of each track, not only the first one" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "m",
+            "markers",
+            _( "list the DRC markers in the report" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "o",
+            "output",
+            _( "JSON report file (default: standard output)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "input file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+/**
+ * Tool=specific return codes
+ */
+enum BATCH_DRC_RET_CODES
+{
+    PARSE_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    WRITE_FAILED,
+
+    /// The DRC found violations (so the tool can gate a CI job)
+    DRC_VIOLATIONS,
+};
+
+
+int batch_drc_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program runs the full DRC on a PCB file, without user interface, "
+               "and writes a JSON report with the run time and the violation count of "
+               "each test." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const bool verbose = cl_parser.Found( "verbose" );
+
+    std::string filename;
+
+    if( cl_parser.GetParamCount() )
+    {
+        filename = cl_parser.GetParam( 0 ).ToStdString();
+    }
+
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !board )
+        return BATCH_DRC_RET_CODES::PARSE_FAILED;
+
+    board->BuildConnectivity();
+
+    std::vector<std::unique_ptr<MARKER_PCB>> markers;
+
+    DRC drc( board.get(), EDA_UNITS_T::MILLIMETRES,
+            [&]( MARKER_PCB* aMarker )
+            {
+                markers.push_back( std::unique_ptr<MARKER_PCB>( aMarker ) );
+            } );
+
+    drc.SetSettings( true, true, cl_parser.Found( "zone-clearance" ), true,
+                     cl_parser.Found( "refill-zones" ), cl_parser.Found( "all-track-errors" ),
+                     wxEmptyString, false );
+
+    if( verbose )
+        std::cerr << "Running DRC on " << ( filename.empty() ? "stdin" : filename ) << std::endl;
+
+    DRC_DURATION duration;
+    {
+        SCOPED_TIMER<DRC_DURATION> timer( duration );
+        drc.RunTests( nullptr );
+    }
+
+    wxString output;
+    bool     ok;
+
+    if( cl_parser.Found( "output", &output ) )
+    {
+        std::ofstream out( output.ToStdString() );
+
+        writeReport( out, filename, duration, drc, markers, cl_parser.Found( "markers" ) );
+        ok = out.good();
+    }
+    else
+    {
+        writeReport( std::cout, filename, duration, drc, markers, cl_parser.Found( "markers" ) );
+        ok = std::cout.good();
+    }
+
+    if( !ok )
+        return BATCH_DRC_RET_CODES::WRITE_FAILED;
+
+    for( const DRC::TEST_STATS& test : drc.GetTestStats() )
+    {
+        if( test.m_violations )
+            return BATCH_DRC_RET_CODES::DRC_VIOLATIONS;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+/*
+ * Define the tool interface
+ */
+KI_TEST::UTILITY_PROGRAM batch_drc_tool = {
+    "batch_drc",
+    "Run the full DRC on a PCB and write a JSON report",
+    batch_drc_main_func,
+};
@@ -0,0 +1,215 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "batch_plot.h"
+
+#include <iostream>
+#include <string>
+
+#include <common.h>
+
+#include <wx/cmdline.h>
+#include <wx/filename.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <class_board.h>
+#include <plotter.h>
+#include <reporter.h>
+#include <pcbplot.h>
+#include <plot_job_queue.h>
+#include <gendrill_Excellon_writer.h>
+
+#include <qa_utils/scoped_timer.h>
+
+
+using PLOT_DURATION = std::chrono::microseconds;
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "v",
+            "verbose",
+            _( "print the plot time" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "d",
+            "drill",
+            _( "also create the Excellon drill files" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "j",
+            "jobs",
+            _( "number of threads (default: one per core, 1 plots one file at a time)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "o",
+            "output-dir",
+            _( "output directory (default: current directory)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "input file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+/**
+ * Tool=specific return codes
+ */
+enum BATCH_PLOT_RET_CODES
+{
+    PARSE_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+
+    /// At least one plot file could not be created
+    PLOT_FAILED,
+};
+
+
+int batch_plot_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program plots the Gerber files of the layers selected in the plot "
+               "settings of a PCB file, and optionally its drill files, without user "
+               "interface.  The files are the same whatever the number of threads." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const bool verbose = cl_parser.Found( "verbose" );
+
+    std::string filename;
+
+    if( cl_parser.GetParamCount() )
+    {
+        filename = cl_parser.GetParam( 0 ).ToStdString();
+    }
+
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !board )
+        return BATCH_PLOT_RET_CODES::PARSE_FAILED;
+
+    // The plot file names are built from the board file name
+    board->SetFileName( filename.empty() ? wxString( "board" ) : wxString( filename ) );
+
+    wxString outputDir = wxFileName::GetCwd();
+    cl_parser.Found( "output-dir", &outputDir );
+
+    long threadCount = 0;
+    cl_parser.Found( "jobs", &threadCount );
+
+    PCB_PLOT_PARAMS plotOpts = board->GetPlotOptions();
+    plotOpts.SetFormat( PLOT_FORMAT_GERBER );
+
+    PLOT_JOB_QUEUE plotJobs( board.get(), plotOpts );
+
+    // The drill files are the longest job: start them first
+    if( cl_parser.Found( "drill" ) )
+    {
+        BOARD* brd = board.get();
+
+        // The drill writer translates its messages, which cannot be done by a plot thread:
+        // the job reports its own message instead
+        wxString msg = wxString::Format( "Drill files created in \"%s\".", outputDir );
+
+        plotJobs.AddJob( [brd, outputDir, msg]( REPORTER& aReporter )
+                {
+                    EXCELLON_WRITER excellonWriter( brd );
+                    excellonWriter.SetFormat( true );
+                    excellonWriter.SetOptions( false, false, wxPoint( 0, 0 ), false );
+                    excellonWriter.CreateDrillandMapFilesSet( outputDir, true, false, nullptr );
+                    aReporter.Report( msg, REPORTER::RPT_ACTION );
+                } );
+    }
+
+    for( LSEQ seq = plotOpts.GetLayerSelection().UIOrder();  seq;  ++seq )
+    {
+        PCB_LAYER_ID layer = *seq;
+
+        // Skip the copper layers which are selected but not enabled (see DIALOG_PLOT::Plot())
+        if( ( LSET::AllCuMask() & ~board->GetEnabledLayers() )[layer] )
+            continue;
+
+        wxFileName fn( board->GetFileName() );
+        wxString   file_ext = plotOpts.GetUseGerberProtelExtensions()
+                                      ? GetGerberProtelExtension( layer )
+                                      : GetDefaultPlotExtension( PLOT_FORMAT_GERBER );
+
+        BuildPlotFileName( &fn, outputDir, board->GetLayerName( layer ), file_ext );
+        plotJobs.AddLayer( layer, fn.GetFullPath() );
+    }
+
+    if( verbose )
+        std::cerr << "Plotting " << ( filename.empty() ? "stdin" : filename ) << std::endl;
+
+    PLOT_DURATION duration;
+    int           failures;
+    {
+        SCOPED_TIMER<PLOT_DURATION> timer( duration );
+        failures = plotJobs.Run( STDOUT_REPORTER::GetInstance(), (unsigned) threadCount );
+    }
+
+    if( verbose )
+        std::cerr << "Plot time: " << duration.count() << " us" << std::endl;
+
+    if( failures )
+        return BATCH_PLOT_RET_CODES::PLOT_FAILED;
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+/*
+ * Define the tool interface
+ */
+KI_TEST::UTILITY_PROGRAM batch_plot_tool = {
+    "batch_plot",
+    "Plot the Gerber files of a PCB, and its drill files, on several threads",
+    batch_plot_main_func,
+};
@@ -0,0 +1,178 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "plot_benchmark.h"
+
+#include <iostream>
+
+#include <common.h>
+
+#include <wx/filename.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <plotter.h>
+#include <pcbplot.h>
+
+#include <qa_utils/scoped_timer.h>
+
+
+using PLOT_DURATION = std::chrono::milliseconds;
+
+/// Number of pads of each footprint of the synthetic board
+static const int PADS_PER_MODULE = 100;
+
+
+/**
+ * Build a board with aPadCount SMD pads on a 1 mm grid.  The pads have aSizeCount
+ * different sizes, and the shapes cycle through circle, rect and oval, so the Gerber
+ * plotter has about 3 * aSizeCount apertures to manage.
+ */
+static std::unique_ptr<BOARD> buildBoard( int aPadCount, int aSizeCount )
+{
+    std::unique_ptr<BOARD> board( new BOARD );
+
+    const PAD_SHAPE_T shapes[] = { PAD_SHAPE_CIRCLE, PAD_SHAPE_RECT, PAD_SHAPE_OVAL };
+    const int         columns = 1000;
+    MODULE*           module = nullptr;
+
+    for( int ii = 0; ii < aPadCount; ++ii )
+    {
+        if( ii % PADS_PER_MODULE == 0 )
+        {
+            module = new MODULE( board.get() );
+            module->SetReference( wxString::Format( "U%d", ii / PADS_PER_MODULE + 1 ) );
+            board->Add( module, ADD_APPEND );
+        }
+
+        wxPoint pos( Millimeter2iu( ii % columns ), Millimeter2iu( ii / columns ) );
+        int     size = Millimeter2iu( 0.2 ) + ( ii % aSizeCount ) * Millimeter2iu( 0.0005 );
+
+        D_PAD* pad = new D_PAD( module );
+        pad->SetName( wxString::Format( "%d", ii % PADS_PER_MODULE + 1 ) );
+        pad->SetAttribute( PAD_ATTRIB_SMD );
+        pad->SetLayerSet( D_PAD::SMDMask() );
+        pad->SetShape( shapes[ ( ii / aSizeCount ) % 3 ] );
+        pad->SetSize( wxSize( size, size * 3 / 2 ) );
+        pad->SetPosition( pos );
+        pad->SetPos0( pos );
+        module->Add( pad, ADD_APPEND );
+    }
+
+    return board;
+}
+
+
+static PLOT_DURATION plotLayer( BOARD* aBoard, PCB_LAYER_ID aLayer, const wxString& aFullFileName )
+{
+    PCB_PLOT_PARAMS plotOpts;
+    plotOpts.SetFormat( PLOT_FORMAT_GERBER );
+    plotOpts.SetUseGerberX2format( true );
+    plotOpts.SetIncludeGerberNetlistInfo( true );
+
+    LOCALE_IO     toggle;
+    PLOT_DURATION duration;
+
+    {
+        SCOPED_TIMER<PLOT_DURATION> timer( duration );
+
+        PLOTTER* plotter = StartPlotBoard( aBoard, &plotOpts, aLayer, aFullFileName,
+                                           wxEmptyString );
+
+        if( !plotter )
+            return PLOT_DURATION( -1 );
+
+        PlotOneBoardLayer( aBoard, plotter, aLayer, plotOpts );
+        plotter->EndPlot();
+        delete plotter;
+    }
+
+    return duration;
+}
+
+
+int plot_benchmark_func( int argc, char* argv[] )
+{
+    auto& os = std::cout;
+
+    if( argc < 2 )
+    {
+        os << "Usage: " << argv[0] << " <OUTPUT_DIR> [PADS] [SIZES]\n\n";
+        os << "Plots the front copper and mask layers of a synthetic board with PADS pads\n"
+              "(default 100000) of SIZES different sizes (default 1000) in Gerber format.\n";
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    wxFileName outDir = wxFileName::DirName( argv[1] );
+
+    long padCount = 100000;
+    long sizeCount = 1000;
+
+    if( argc >= 3 )
+        wxString( argv[2] ).ToLong( &padCount );
+
+    if( argc >= 4 )
+        wxString( argv[3] ).ToLong( &sizeCount );
+
+    if( padCount <= 0 || sizeCount <= 0 )
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    os << "Plot Bench Mark Util" << std::endl;
+    os << "  Pads:           " << (int) padCount << std::endl;
+    os << "  Pad sizes:      " << (int) sizeCount << std::endl;
+    os << std::endl;
+
+    std::unique_ptr<BOARD> board = buildBoard( padCount, sizeCount );
+
+    const PCB_LAYER_ID layers[] = { F_Cu, F_Mask };
+
+    for( PCB_LAYER_ID layer : layers )
+    {
+        wxString name = "plot_benchmark-" + board->GetLayerName( layer );
+        name.Replace( ".", "_" );
+
+        wxFileName fn( outDir.GetPath(), name, GERBER_PLOTTER::GetDefaultFileExtension() );
+
+        PLOT_DURATION duration = plotLayer( board.get(), layer, fn.GetFullPath() );
+
+        if( duration.count() < 0 )
+        {
+            os << "Unable to create file " << fn.GetFullPath() << std::endl;
+            return KI_TEST::RET_CODES::TOOL_SPECIFIC;
+        }
+
+        os << wxString::Format( "%-30s %d pads in %d ms", board->GetLayerName( layer ),
+                                (int) padCount, (int) duration.count() )
+           << std::endl;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+KI_TEST::UTILITY_PROGRAM plot_benchmark_tool = {
+    "plot_benchmark",
+    "Benchmark the Gerber plot of a synthetic board with many pads",
+    plot_benchmark_func,
+};
@@ -0,0 +1,275 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "pns_replay.h"
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+
+#include <common.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <class_board.h>
+#include <router/pns_debug_decorator.h>
+#include <router/pns_kicad_iface.h>
+#include <router/pns_router.h>
+#include <router/pns_session_log.h>
+#include <router/pns_timing.h>
+
+#include <qa_utils/scoped_timer.h>
+
+
+using MOVE_DURATION = std::chrono::nanoseconds;
+
+/// The measured times of one kind, in nanoseconds: the whole moves, or one router phase
+using TIMES = std::vector<int64_t>;
+
+
+/**
+ * Replay the events of aSession in aRouter, and add the time of each move, and of each
+ * router phase during the move, to aMoveTimes and aPhaseTimes.
+ * @return the number of items of the session which are not found in the world
+ */
+static int replaySession( PNS::ROUTER& aRouter, const PNS::SESSION_LOG& aSession,
+                          TIMES& aMoveTimes, TIMES aPhaseTimes[] )
+{
+    int missingItems = 0;
+
+    for( const PNS::SESSION_LOG::EVENT& evt : aSession.Events() )
+    {
+        PNS::ITEM* item = PNS::SESSION_LOG::FindItem( aRouter.GetWorld(), evt.m_item );
+
+        if( evt.m_item.m_kind && !item )
+            missingItems++;
+
+        switch( evt.m_type )
+        {
+        case PNS::SESSION_LOG::EVT_START_ROUTE:
+            aRouter.StartRouting( evt.m_p, item, evt.m_arg );
+            break;
+
+        case PNS::SESSION_LOG::EVT_START_DRAG:
+            aRouter.StartDragging( evt.m_p, item, evt.m_arg );
+            break;
+
+        case PNS::SESSION_LOG::EVT_MOVE:
+        {
+            MOVE_DURATION duration;
+
+            PNS::TIMING::Reset();
+
+            {
+                SCOPED_TIMER<MOVE_DURATION> timer( duration );
+                aRouter.Move( evt.m_p, item );
+            }
+
+            aMoveTimes.push_back( duration.count() );
+
+            for( int phase = 0; phase < PNS::TP_COUNT; phase++ )
+                aPhaseTimes[phase].push_back( PNS::TIMING::TotalNs( (PNS::TIMING_PHASE) phase ) );
+
+            break;
+        }
+
+        case PNS::SESSION_LOG::EVT_FIX:
+            aRouter.FixRoute( evt.m_p, item, evt.m_arg != 0 );
+            break;
+
+        case PNS::SESSION_LOG::EVT_STOP:
+            aRouter.StopRouting();
+            break;
+
+        case PNS::SESSION_LOG::EVT_SWITCH_LAYER:
+            aRouter.SwitchLayer( evt.m_arg );
+            break;
+
+        case PNS::SESSION_LOG::EVT_TOGGLE_VIA:
+            aRouter.ToggleViaPlacement();
+            break;
+
+        case PNS::SESSION_LOG::EVT_FLIP_POSTURE:
+            aRouter.FlipPosture();
+            break;
+        }
+    }
+
+    if( aRouter.RoutingInProgress() )
+        aRouter.StopRouting();
+
+    return missingItems;
+}
+
+
+/**
+ * Print the percentiles of aTimes (nearest rank), in microseconds
+ */
+static void reportTimes( std::ostream& aStream, const std::string& aName, TIMES aTimes )
+{
+    if( aTimes.empty() )
+        return;
+
+    std::sort( aTimes.begin(), aTimes.end() );
+
+    auto percentile = [&]( int aPercent ) -> double
+    {
+        size_t rank = ( aTimes.size() * aPercent + 99 ) / 100;
+        return aTimes[ std::max<size_t>( rank, 1 ) - 1 ] / 1000.0;
+    };
+
+    aStream << wxString::Format( "%-12s %12.1f %12.1f %12.1f %12.1f", aName, percentile( 50 ),
+                                 percentile( 90 ), percentile( 99 ), aTimes.back() / 1000.0 )
+            << std::endl;
+}
+
+
+/**
+ * Print the counters of the router (see PNS::DEBUG_DECORATOR::AddToCounter()), and the
+ * hit rate of the caches counted by a pair of "<name>.hits" and "<name>.misses" counters
+ */
+static void reportCounters( std::ostream& aStream, const std::map<std::string, int64_t>& aCounters )
+{
+    const std::string hitsSuffix = ".hits";
+
+    for( const auto& counter : aCounters )
+    {
+        aStream << wxString::Format( "%-40s %lld", counter.first, (long long) counter.second )
+                << std::endl;
+    }
+
+    for( const auto& counter : aCounters )
+    {
+        const std::string& name = counter.first;
+
+        if( name.size() <= hitsSuffix.size()
+                || name.compare( name.size() - hitsSuffix.size(), hitsSuffix.size(), hitsSuffix ) )
+            continue;
+
+        std::string cache = name.substr( 0, name.size() - hitsSuffix.size() );
+        auto misses = aCounters.find( cache + ".misses" );
+
+        if( misses == aCounters.end() || counter.second + misses->second == 0 )
+            continue;
+
+        double rate = 100.0 * counter.second / ( counter.second + misses->second );
+
+        aStream << wxString::Format( "%-40s %.1f %%", cache + " hit rate", rate ) << std::endl;
+    }
+}
+
+
+int pns_replay_func( int argc, char* argv[] )
+{
+    auto& os = std::cout;
+
+    if( argc < 3 )
+    {
+        os << "Usage: " << argv[0] << " <BOARD> <SESSION> [REPEAT]\n\n";
+        os << "Replays a routing session recorded by the interactive router (see the\n"
+              "PnsSessionDir advanced config key) on the board it was recorded from, REPEAT\n"
+              "times (default 1), and prints the percentiles of the latency of the moves and\n"
+              "of the router phases during the moves.\n";
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long repeat = 1;
+
+    if( argc >= 4 )
+        wxString( argv[3] ).ToLong( &repeat );
+
+    if( repeat <= 0 )
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( argv[1] );
+
+    if( !board )
+        return KI_TEST::RET_CODES::TOOL_SPECIFIC;
+
+    PNS::SESSION_LOG session;
+
+    if( !session.Load( argv[2] ) )
+    {
+        os << "Unable to read the session " << argv[2] << std::endl;
+        return KI_TEST::RET_CODES::TOOL_SPECIFIC;
+    }
+
+    // Without view and host tool, the router runs headless, and does not modify the board
+    PNS_KICAD_IFACE iface;
+    iface.SetBoard( board.get() );
+
+    PNS::ROUTER router;
+    router.SetInterface( &iface );
+    router.SetMode( (PNS::ROUTER_MODE) session.RouterMode() );
+    router.LoadSettings( session.Settings() );
+    router.UpdateSizes( session.Sizes() );
+
+    TIMES moveTimes;
+    TIMES phaseTimes[PNS::TP_COUNT];
+    int   missingItems = 0;
+
+    PNS::TIMING::Enable( true );
+
+    for( int ii = 0; ii < repeat; ii++ )
+    {
+        // The routed items are committed to the world: start again from the board
+        router.SyncWorld();
+        missingItems += replaySession( router, session, moveTimes, phaseTimes );
+    }
+
+    PNS::TIMING::Enable( false );
+
+    os << "PNS Replay Util" << std::endl;
+    os << "  Events:         " << session.Events().size() << std::endl;
+    os << "  Moves:          " << moveTimes.size() << std::endl;
+
+    if( missingItems )
+        os << "  Missing items:  " << missingItems << std::endl;
+
+    os << std::endl;
+
+    os << wxString::Format( "%-12s %12s %12s %12s %12s", "[us]", "p50", "p90", "p99", "max" )
+       << std::endl;
+
+    reportTimes( os, "move", moveTimes );
+
+    for( int phase = 0; phase < PNS::TP_COUNT; phase++ )
+        reportTimes( os, PNS::TIMING::PhaseName( (PNS::TIMING_PHASE) phase ), phaseTimes[phase] );
+
+    const std::map<std::string, int64_t>& counters = iface.GetDebugDecorator()->Counters();
+
+    if( !counters.empty() )
+    {
+        os << std::endl;
+        reportCounters( os, counters );
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+KI_TEST::UTILITY_PROGRAM pns_replay_tool = {
+    "pns_replay",
+    "Replay a recorded routing session and report the router latency",
+    pns_replay_func,
+};